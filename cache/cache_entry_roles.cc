@@ -101,4 +101,18 @@ std::string BlockCacheEntryStatsMapKeys::UsedPercent(CacheEntryRole role) {
   return GetPrefixedCacheEntryRoleName(kPrefix, role);
 }
 
+std::string BlockCacheEntryStatsMapKeys::AdmittedCount(CacheEntryRole role) {
+  const static std::string kPrefix = "admitted.";
+  return GetPrefixedCacheEntryRoleName(kPrefix, role);
+}
+
+std::string BlockCacheEntryStatsMapKeys::RejectedCount(CacheEntryRole role) {
+  const static std::string kPrefix = "rejected.";
+  return GetPrefixedCacheEntryRoleName(kPrefix, role);
+}
+
+std::string BlockCacheEntryStatsMapKeys::OwnerUsedBytes(CacheOwnerId owner) {
+  return "owner_bytes." + std::to_string(owner);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
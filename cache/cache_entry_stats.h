@@ -142,8 +142,11 @@ class CacheEntryStatsCollector {
         }
       }
     }
-    // If we reach here, shared entry is in cache with handle `h`.
-    assert(cache.get()->GetCacheItemHelper(h) == cache.GetBasicHelper());
+    // If we reach here, shared entry is in cache with handle `h`. Through a
+    // CacheOwnerView, its helper is a copy of the basic one tagged with the
+    // owner.
+    assert(cache.get()->GetCacheItemHelper(h)->del_cb ==
+           cache.GetBasicHelper()->del_cb);
 
     // Build an aliasing shared_ptr that keeps `ptr` in cache while there
     // are references.
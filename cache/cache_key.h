@@ -6,6 +6,7 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 
 #include "rocksdb/rocksdb_namespace.h"
 #include "rocksdb/slice.h"
@@ -127,6 +128,25 @@ class OffsetableCacheKey : private CacheKey {
     return CacheKey(file_num_etc64_, offset_etc64_ ^ offset);
   }
 
+  // The inverse of WithOffset(): if `key` is a CacheKey returned by
+  // WithOffset() on this base key, sets `*offset` and returns true.
+  inline bool GetOffset(const Slice &key, uint64_t *offset) const {
+    assert(!IsEmpty());
+    uint64_t file_num_etc64;
+    uint64_t offset_etc64;
+    if (key.size() != kCacheKeySize) {
+      return false;
+    }
+    std::memcpy(&file_num_etc64, key.data(), sizeof(file_num_etc64));
+    if (file_num_etc64 != file_num_etc64_) {
+      return false;
+    }
+    std::memcpy(&offset_etc64, key.data() + sizeof(file_num_etc64),
+                sizeof(offset_etc64));
+    *offset = offset_etc64 ^ offset_etc64_;
+    return true;
+  }
+
   // The "common prefix" is a shared prefix for all the returned CacheKeys.
   // It is specific to the file but the same for all offsets within the file.
   static constexpr size_t kCommonPrefixSize = 8;
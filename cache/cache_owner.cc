@@ -0,0 +1,91 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/cache_owner.h"
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "port/port.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// A copy of a helper, and of its helper without secondary cache support,
+// attributing entries to an owner
+struct OwnedHelpers {
+  OwnedHelpers(const Cache::CacheItemHelper& base, CacheOwnerId owner)
+      : without_secondary_compat(base.role, base.del_cb),
+        helper(base.role, base.del_cb) {
+    if (base.IsSecondaryCacheCompatible()) {
+      helper = Cache::CacheItemHelper(base.role, base.del_cb, base.size_cb,
+                                      base.saveto_cb, base.create_cb,
+                                      &without_secondary_compat);
+    }
+    without_secondary_compat.owner_id = owner;
+    helper.owner_id = owner;
+  }
+
+  Cache::CacheItemHelper without_secondary_compat;
+  Cache::CacheItemHelper helper;
+};
+
+struct HelperAndOwnerHash {
+  size_t operator()(
+      const std::pair<const Cache::CacheItemHelper*, CacheOwnerId>& p) const {
+    return std::hash<const void*>()(p.first) * 31 + p.second;
+  }
+};
+
+class OwnedHelperRegistry {
+ public:
+  static OwnedHelperRegistry& Get() {
+    // Never destroyed, as cache entries might still refer to the helpers
+    static OwnedHelperRegistry* registry = new OwnedHelperRegistry();
+    return *registry;
+  }
+
+  const Cache::CacheItemHelper* GetOwnedHelper(
+      const Cache::CacheItemHelper* helper, CacheOwnerId owner) {
+    auto key = std::make_pair(helper, owner);
+    {
+      ReadLock lock(&mutex_);
+      auto it = helpers_.find(key);
+      if (it != helpers_.end()) {
+        return &it->second->helper;
+      }
+    }
+    WriteLock lock(&mutex_);
+    auto& owned = helpers_[key];
+    if (!owned) {
+      owned.reset(new OwnedHelpers(*helper, owner));
+    }
+    return &owned->helper;
+  }
+
+ private:
+  port::RWMutex mutex_;
+  std::unordered_map<std::pair<const Cache::CacheItemHelper*, CacheOwnerId>,
+                     std::unique_ptr<OwnedHelpers>, HelperAndOwnerHash>
+      helpers_;
+};
+}  // namespace
+
+const Cache::CacheItemHelper* CacheOwnerView::GetOwnedHelper(
+    const CacheItemHelper* helper) const {
+  if (helper->owner_id == owner_) {
+    return helper;
+  }
+  return OwnedHelperRegistry::Get().GetOwnedHelper(helper, owner_);
+}
+
+std::shared_ptr<Cache> NewCacheOwnerView(std::shared_ptr<Cache> cache,
+                                         CacheOwnerId owner) {
+  return std::make_shared<CacheOwnerView>(std::move(cache), owner);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,132 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "rocksdb/advanced_cache.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Per-owner usage and capacity limits of a cache (see NewCacheOwnerView()),
+// shared by all of its shards. Entries are attributed to the owner in their
+// CacheItemHelper. Shards call Charge() and Uncharge() wherever they add or
+// remove an entry's charge from their usage, ask ShouldReject() before
+// inserting, and prefer evicting entries for which IsOverSoftLimit().
+class CacheOwnerPartitions {
+ public:
+  static constexpr size_t kNumOwners =
+      size_t{std::numeric_limits<CacheOwnerId>::max()} + 1;
+
+  CacheOwnerPartitions() {
+    for (size_t i = 0; i < kNumOwners; ++i) {
+      soft_limits_[i].StoreRelaxed(SIZE_MAX);
+      hard_limits_[i].StoreRelaxed(SIZE_MAX);
+    }
+  }
+
+  void SetLimits(CacheOwnerId owner, size_t soft_limit, size_t hard_limit) {
+    soft_limits_[owner].StoreRelaxed(soft_limit);
+    hard_limits_[owner].StoreRelaxed(hard_limit);
+  }
+
+  size_t GetUsage(CacheOwnerId owner) const {
+    return usages_[owner].LoadRelaxed();
+  }
+
+  void Charge(const Cache::CacheItemHelper* helper, size_t charge) {
+    if (helper->owner_id != kUnownedCacheEntry) {
+      usages_[helper->owner_id].FetchAddRelaxed(charge);
+    }
+  }
+
+  void Uncharge(const Cache::CacheItemHelper* helper, size_t charge) {
+    if (helper->owner_id != kUnownedCacheEntry) {
+      usages_[helper->owner_id].FetchSubRelaxed(charge);
+    }
+  }
+
+  // Whether a new entry must not be inserted. An owner never exceeds its hard
+  // limit, and only exceeds its soft limit while the cache (shard) has room
+  // without evicting.
+  bool ShouldReject(const Cache::CacheItemHelper* helper, size_t charge,
+                    bool needs_eviction) const {
+    CacheOwnerId owner = helper->owner_id;
+    if (owner == kUnownedCacheEntry) {
+      return false;
+    }
+    size_t new_usage = usages_[owner].LoadRelaxed() + charge;
+    return new_usage > hard_limits_[owner].LoadRelaxed() ||
+           (needs_eviction && new_usage > soft_limits_[owner].LoadRelaxed());
+  }
+
+  bool IsOverSoftLimit(const Cache::CacheItemHelper* helper) const {
+    CacheOwnerId owner = helper->owner_id;
+    return owner != kUnownedCacheEntry &&
+           usages_[owner].LoadRelaxed() > soft_limits_[owner].LoadRelaxed();
+  }
+
+ private:
+  std::array<RelaxedAtomic<size_t>, kNumOwners> usages_;
+  std::array<RelaxedAtomic<size_t>, kNumOwners> soft_limits_;
+  std::array<RelaxedAtomic<size_t>, kNumOwners> hard_limits_;
+};
+
+// See NewCacheOwnerView()
+class CacheOwnerView : public CacheWrapper {
+ public:
+  CacheOwnerView(std::shared_ptr<Cache> target, CacheOwnerId owner)
+      : CacheWrapper(std::move(target)), owner_(owner) {}
+
+  const char* Name() const override { return "CacheOwnerView"; }
+
+  Status Insert(const Slice& key, ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge,
+                Handle** handle = nullptr, Priority priority = Priority::LOW,
+                const Slice& compressed = Slice(),
+                CompressionType type = kNoCompression) override {
+    return target_->Insert(key, value, GetOwnedHelper(helper), charge, handle,
+                           priority, compressed, type);
+  }
+
+  Handle* CreateStandalone(const Slice& key, ObjectPtr obj,
+                           const CacheItemHelper* helper, size_t charge,
+                           bool allow_uncharged) override {
+    return target_->CreateStandalone(key, obj, GetOwnedHelper(helper), charge,
+                                     allow_uncharged);
+  }
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                 CreateContext* create_context,
+                 Priority priority = Priority::LOW,
+                 Statistics* stats = nullptr) override {
+    // The helper is used for entries created from the secondary cache
+    return target_->Lookup(key, helper ? GetOwnedHelper(helper) : nullptr,
+                           create_context, priority, stats);
+  }
+
+  void StartAsyncLookup(AsyncLookupHandle& async_handle) override {
+    if (async_handle.helper) {
+      async_handle.helper = GetOwnedHelper(async_handle.helper);
+    }
+    target_->StartAsyncLookup(async_handle);
+  }
+
+ private:
+  // Returns a helper equivalent to `helper` attributing entries to this
+  // view's owner. Such helpers are created once per process for each helper
+  // and owner and never freed, as entries might outlive the view.
+  const CacheItemHelper* GetOwnedHelper(const CacheItemHelper* helper) const;
+
+  const CacheOwnerId owner_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
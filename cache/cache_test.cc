@@ -1013,6 +1013,122 @@ TEST_P(CacheTest, CacheHostSeed) {
   fprintf(stderr, "kHostHashSeed -> %u\n", (unsigned)expected_seed);
 }
 
+TEST_P(CacheTest, FrequencyAdmissionResistsScan) {
+  // Block-sized entries, as the LRUCache sketch is sized for them
+  constexpr int kCharge = 4096;
+  constexpr int kHotKeys = 90;
+  constexpr int kScanKeys = 2000;
+  estimated_value_size_ = kCharge;
+  auto run = [&](bool frequency_admission, uint64_t* rejected) {
+    auto cache = NewCache(100 * kCharge, [=](ShardedCacheOptions& opts) {
+      opts.num_shard_bits = 0;
+      opts.metadata_charge_policy = kDontChargeCacheMetadata;
+      opts.frequency_admission = frequency_admission;
+    });
+    auto lookup_or_insert = [&](int key) {
+      if (Lookup(cache, key) == key) {
+        return true;
+      }
+      Insert(cache, key, key, kCharge);
+      return false;
+    };
+    // A working set that fits, looked up repeatedly
+    for (int round = 0; round < 5; ++round) {
+      for (int i = 0; i < kHotKeys; ++i) {
+        lookup_or_insert(i);
+      }
+    }
+    // A scan of keys read once, much larger than the cache, while the
+    // working set is still in use
+    int hot_hits = 0;
+    for (int i = 0; i < kScanKeys; ++i) {
+      EXPECT_FALSE(lookup_or_insert(1000 + i));
+      hot_hits += lookup_or_insert(i % kHotKeys);
+    }
+    uint64_t admitted = 0;
+    cache->GetAdmissionCounts(CacheEntryRole::kMisc, &admitted, rejected);
+    return hot_hits;
+  };
+
+  uint64_t rejected = 0;
+  int hits_without_admission = run(false, &rejected);
+  ASSERT_EQ(rejected, 0);
+  int hits_with_admission = run(true, &rejected);
+  ASSERT_GT(rejected, kScanKeys / 2);
+  // Eviction in AutoHyperClockCache is less exact about keeping the working
+  // set than in the others
+  ASSERT_GT(hits_with_admission, kScanKeys / 4);
+  ASSERT_GT(hits_with_admission, 4 * hits_without_admission);
+}
+
+TEST_P(LRUCacheTest, FrequencyAdmissionRejectedInsertReturnsHandle) {
+  auto cache = NewCache(2, [=](ShardedCacheOptions& opts) {
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    opts.frequency_admission = true;
+  });
+  for (int i = 0; i < 2; ++i) {
+    Insert(cache, i, i);
+    for (int j = 0; j < 5; ++j) {
+      ASSERT_EQ(Lookup(cache, i), i);
+    }
+  }
+  // Evicting either entry for a key never looked up is rejected, but the
+  // caller still gets a usable handle.
+  Cache::Handle* handle = nullptr;
+  ASSERT_OK(cache->Insert(EncodeKey(2), EncodeValue(2), &kHelper, /*charge*/ 1,
+                          &handle));
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(DecodeValue(cache->Value(handle)), 2);
+  ASSERT_EQ(Lookup(cache, 2), -1);
+  cache->Release(handle);
+  ASSERT_EQ(Lookup(cache, 0), 0);
+  ASSERT_EQ(Lookup(cache, 1), 1);
+  ASSERT_LE(cache->GetUsage(), 2U);
+  ASSERT_EQ(deleted_values_, std::vector<int>({2}));
+}
+
+TEST_P(CacheTest, OwnerCapacityLimits) {
+  auto cache = NewCache(100, [=](ShardedCacheOptions& opts) {
+    opts.num_shard_bits = 0;
+    opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  });
+  auto owner1 = NewCacheOwnerView(cache, 1);
+  auto owner2 = NewCacheOwnerView(cache, 2);
+  ASSERT_TRUE(cache->SetOwnerCapacityLimits(kUnownedCacheEntry, 10, 20)
+                  .IsInvalidArgument());
+  ASSERT_TRUE(cache->SetOwnerCapacityLimits(1, 30, 20).IsInvalidArgument());
+  ASSERT_OK(cache->SetOwnerCapacityLimits(1, 10, 20));
+
+  // The hard limit applies even while the cache has room
+  for (int i = 0; i < 50; ++i) {
+    Insert(owner1, i, i);
+  }
+  ASSERT_EQ(cache->GetOwnerUsage(1), 20U);
+  ASSERT_EQ(cache->GetUsage(), 20U);
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_EQ(Lookup(cache, i), i);
+  }
+
+  // Beyond the soft limit, an owner may not evict others' entries
+  for (int i = 1000; i < 1080; ++i) {
+    Insert(owner2, i, i);
+  }
+  ASSERT_EQ(cache->GetOwnerUsage(2), 80U);
+  ASSERT_EQ(cache->GetUsage(), 100U);
+  Insert(owner1, 100, 100);
+  ASSERT_EQ(Lookup(cache, 100), -1);
+  ASSERT_EQ(cache->GetOwnerUsage(1), 20U);
+  ASSERT_EQ(cache->GetOwnerUsage(2), 80U);
+
+  // Usage is returned to the owner when entries leave the cache
+  Erase(owner1, 0);
+  ASSERT_EQ(cache->GetOwnerUsage(1), 19U);
+  cache->EraseUnRefEntries();
+  ASSERT_EQ(cache->GetOwnerUsage(1), 0U);
+  ASSERT_EQ(cache->GetOwnerUsage(2), 0U);
+}
+
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, CacheTest,
                         secondary_cache_test_util::GetTestingCacheTypes());
 INSTANTIATE_TEST_CASE_P(CacheTestInstance, LRUCacheTest,
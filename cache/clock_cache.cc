@@ -96,6 +96,7 @@ inline void Unref(const ClockHandle& h, uint64_t count = 1) {
 }
 
 inline bool ClockUpdate(ClockHandle& h, BaseClockTable::EvictionData* data,
+                        const CacheOwnerPartitions* owner_partitions,
                         bool* purgeable = nullptr) {
   uint64_t meta;
   if (purgeable) {
@@ -131,8 +132,11 @@ inline bool ClockUpdate(ClockHandle& h, BaseClockTable::EvictionData* data,
     data->seen_pinned_count++;
     return false;
   }
+  // Entries of owners over their soft limit are evicted without waiting for
+  // their countdown to expire.
   if ((meta >> ClockHandle::kStateShift == ClockHandle::kStateVisible) &&
-      acquire_count > 0) {
+      acquire_count > 0 &&
+      !(owner_partitions && owner_partitions->IsOverSoftLimit(h.helper))) {
     // Decrement clock
     uint64_t new_count =
         std::min(acquire_count - 1, uint64_t{ClockHandle::kMaxCountdown} - 1);
@@ -397,6 +401,7 @@ HandleImpl* BaseClockTable::StandaloneInsert(
   h->meta.Store(meta);
   // Keep track of how much of usage is standalone
   standalone_usage_.FetchAddRelaxed(proto.GetTotalCharge());
+  ChargeOwner(proto);
   return h;
 }
 
@@ -553,6 +558,10 @@ inline bool BaseClockTable::ChargeUsageMaybeEvictNonStrict(
 }
 
 void BaseClockTable::TrackAndReleaseEvictedEntry(ClockHandle* h) {
+  if (admission_) {
+    admission_->RecordEviction(AdmissionHash(h->hashed_key));
+  }
+  UnchargeOwner(*h);
   bool took_value_ownership = false;
   if (eviction_callback_) {
     // For key reconstructed from hash
@@ -586,6 +595,36 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
   using HandleImpl = typename Table::HandleImpl;
   Table& derived = static_cast<Table&>(*this);
 
+  // Frequency admission only considers insertions that would need to evict
+  // something, where eviction picks a victim per the clock algorithm. The
+  // victim is not known ahead of eviction, so the recent average of evicted
+  // entries stands in for it.
+  const size_t total_charge = proto.GetTotalCharge();
+  const bool strict = eec_and_scl & kStrictCapacityLimitBit;
+  const bool needs_eviction = usage_.LoadRelaxed() + total_charge > capacity;
+  const bool owner_rejected =
+      owner_partitions_ &&
+      owner_partitions_->ShouldReject(proto.helper, total_charge,
+                                      needs_eviction);
+  if (owner_rejected ||
+      (admission_ && !strict && needs_eviction &&
+       !admission_->Admit(AdmissionHash(proto.hashed_key),
+                          admission_->GetRecentVictimFrequency(),
+                          proto.helper->role))) {
+    if (handle == nullptr) {
+      // As if inserted and immediately evicted
+      proto.FreeData(allocator_);
+      return Status::OK();
+    }
+    if (strict) {
+      return Status::MemoryLimit(
+          "Insert failed due to cache owner capacity limit.");
+    }
+    usage_.FetchAddRelaxed(total_charge);
+    *handle = StandaloneInsert<HandleImpl>(proto);
+    return Status::OkOverwritten();
+  }
+
   typename Table::InsertState state;
   derived.StartInsert(state);
 
@@ -599,7 +638,6 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
   // Usage/capacity handling is somewhat different depending on
   // strict_capacity_limit, but mostly pessimistic.
   bool use_standalone_insert = false;
-  const size_t total_charge = proto.GetTotalCharge();
   // NOTE: we can use eec_and_scl as eviction_effort_cap below because
   // strict_capacity_limit=true is supposed to disable the limit on eviction
   // effort, and a large value effectively does that.
@@ -648,6 +686,7 @@ Status BaseClockTable::Insert(const ClockHandleBasicData& proto,
 
     if (e) {
       // Successfully inserted
+      ChargeOwner(proto);
       if (handle) {
         *handle = e;
       }
@@ -730,6 +769,10 @@ FixedHyperClockTable::FixedHyperClockTable(
       occupancy_limit_(static_cast<size_t>((uint64_t{1} << length_bits_) *
                                            kStrictLoadFactor)),
       array_(new HandleImpl[size_t{1} << length_bits_]) {
+  if (opts.frequency_admission) {
+    admission_.reset(new FrequencyAdmission(occupancy_limit_));
+  }
+  owner_partitions_ = opts.owner_partitions;
   if (metadata_charge_policy ==
       CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
     usage_.FetchAddRelaxed(size_t{GetTableSize()} * sizeof(HandleImpl));
@@ -947,6 +990,7 @@ bool FixedHyperClockTable::Release(HandleImpl* h, bool useful,
     // Took ownership
     size_t total_charge = h->GetTotalCharge();
     if (UNLIKELY(h->IsStandalone())) {
+      UnchargeOwner(*h);
       h->FreeData(allocator_);
       // Delete standalone handle
       delete h;
@@ -954,6 +998,7 @@ bool FixedHyperClockTable::Release(HandleImpl* h, bool useful,
       usage_.FetchSubRelaxed(total_charge);
     } else {
       Rollback(h->hashed_key, h);
+      UnchargeOwner(*h);
       FreeDataMarkEmpty(*h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -1010,6 +1055,7 @@ void FixedHyperClockTable::Erase(const UniqueId64x2& hashed_key) {
                 // Took ownership
                 assert(hashed_key == h->hashed_key);
                 size_t total_charge = h->GetTotalCharge();
+                UnchargeOwner(*h);
                 FreeDataMarkEmpty(*h, allocator_);
                 ReclaimEntryUsage(total_charge);
                 // We already have a copy of hashed_key in this case, so OK to
@@ -1049,6 +1095,7 @@ void FixedHyperClockTable::EraseUnRefEntries() {
       // Took ownership
       size_t total_charge = h.GetTotalCharge();
       Rollback(h.hashed_key, &h);
+      UnchargeOwner(h);
       FreeDataMarkEmpty(h, allocator_);
       ReclaimEntryUsage(total_charge);
     }
@@ -1135,7 +1182,7 @@ inline void FixedHyperClockTable::Evict(size_t requested_charge, InsertState&,
   for (;;) {
     for (size_t i = 0; i < step_size; i++) {
       HandleImpl& h = array_[ModTableSize(Lower32of64(old_clock_pointer + i))];
-      bool evicting = ClockUpdate(h, data);
+      bool evicting = ClockUpdate(h, data, owner_partitions_);
       if (evicting) {
         Rollback(h.hashed_key, &h);
         TrackAndReleaseEvictedEntry(&h);
@@ -1299,6 +1346,10 @@ typename ClockCacheShard<Table>::HandleImpl* ClockCacheShard<Table>::Lookup(
   if (UNLIKELY(key.size() != kCacheKeySize)) {
     return nullptr;
   }
+  if (FrequencyAdmission* admission = table_.GetAdmission()) {
+    admission->RecordAccess(Table::AdmissionHash(hashed_key),
+                            table_.GetOccupancy());
+  }
   return table_.Lookup(hashed_key);
 }
 
@@ -1406,6 +1457,18 @@ size_t ClockCacheShard<Table>::GetTableAddressCount() const {
   return table_.GetTableSize();
 }
 
+template <class Table>
+void ClockCacheShard<Table>::GetAdmissionCounts(CacheEntryRole role,
+                                                uint64_t* admitted,
+                                                uint64_t* rejected) const {
+  if (const FrequencyAdmission* admission = table_.GetAdmission()) {
+    admission->GetCounts(role, admitted, rejected);
+  } else {
+    *admitted = 0;
+    *rejected = 0;
+  }
+}
+
 // Explicit instantiation
 template class ClockCacheShard<FixedHyperClockTable>;
 template class ClockCacheShard<AutoHyperClockTable>;
@@ -1420,6 +1483,7 @@ BaseHyperClockCache<Table>::BaseHyperClockCache(
   MemoryAllocator* alloc = this->memory_allocator();
   this->InitShards([&](Shard* cs) {
     typename Table::Opts table_opts{opts};
+    table_opts.owner_partitions = &this->owner_partitions_;
     new (cs) Shard(per_shard, opts.strict_capacity_limit,
                    opts.metadata_charge_policy, alloc,
                    &this->eviction_callback_, &this->hash_seed_, table_opts);
@@ -1969,6 +2033,11 @@ AutoHyperClockTable::AutoHyperClockTable(
       grow_frontier_(GetTableSize()),
       clock_pointer_mask_(
           BottomNBits(UINT64_MAX, LengthInfoToMinShift(length_info_.Load()))) {
+  if (opts.frequency_admission) {
+    // Sized for the largest table the cache can grow to
+    admission_.reset(new FrequencyAdmission(array_.Count()));
+  }
+  owner_partitions_ = opts.owner_partitions;
   if (metadata_charge_policy ==
       CacheMetadataChargePolicy::kFullChargeCacheMetadata) {
     // NOTE: ignoring page boundaries for simplicity
@@ -2677,7 +2746,7 @@ void AutoHyperClockTable::PurgeImplLocked(OpData* op_data,
       assert(home == BottomNBits(h->hashed_key[1], home_shift));
       if constexpr (kIsClockUpdateChain) {
         // Clock update and/or check for purgeable (under (de)construction)
-        if (ClockUpdate(*h, data, &purgeable)) {
+        if (ClockUpdate(*h, data, owner_partitions_, &purgeable)) {
           // Remember for finishing eviction
           op_data->push_back(h);
           // Entries for eviction become purgeable
@@ -3349,6 +3418,7 @@ bool AutoHyperClockTable::TryEraseHandle(HandleImpl* h, bool holding_ref,
                                       << ClockHandle::kStateShift));
   // Took ownership
   // TODO? Delay freeing?
+  UnchargeOwner(*h);
   h->FreeData(allocator_);
   size_t total_charge = h->total_charge;
   if (UNLIKELY(h->IsStandalone())) {
@@ -3440,6 +3510,7 @@ void AutoHyperClockTable::EraseUnRefEntries() {
         h.meta.CasStrong(old_meta, uint64_t{ClockHandle::kStateConstruction}
                                        << ClockHandle::kStateShift)) {
       // Took ownership
+      UnchargeOwner(h);
       h.FreeData(allocator_);
       usage_.FetchSubRelaxed(h.total_charge);
       // NOTE: could be more efficient with a dedicated variant of
@@ -18,6 +18,8 @@
 #include <string>
 
 #include "cache/cache_key.h"
+#include "cache/cache_owner.h"
+#include "cache/frequency_admission.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/malloc.h"
@@ -379,8 +381,12 @@ class BaseClockTable {
     explicit BaseOpts(int _eviction_effort_cap)
         : eviction_effort_cap(_eviction_effort_cap) {}
     explicit BaseOpts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {}
+        : eviction_effort_cap(opts.eviction_effort_cap),
+          frequency_admission(opts.frequency_admission) {}
     int eviction_effort_cap;
+    bool frequency_admission = false;
+    // Owned by the cache. nullptr if not tracking owner usage.
+    CacheOwnerPartitions* owner_partitions = nullptr;
   };
 
   BaseClockTable(CacheMetadataChargePolicy metadata_charge_policy,
@@ -419,6 +425,15 @@ class BaseClockTable {
     return eviction_effort_exceeded_count_.LoadRelaxed();
   }
 
+  // nullptr unless frequency admission is enabled
+  FrequencyAdmission* GetAdmission() const { return admission_.get(); }
+
+  // The part of a hashed key used by frequency admission, independent of the
+  // bits used for sharding.
+  static uint64_t AdmissionHash(const UniqueId64x2& hashed_key) {
+    return hashed_key[1];
+  }
+
   struct EvictionData {
     size_t freed_charge = 0;
     size_t freed_count = 0;
@@ -427,6 +442,19 @@ class BaseClockTable {
 
   void TrackAndReleaseEvictedEntry(ClockHandle* h);
 
+  // Attribute an entry's charge to its owner, when it is added to or removed
+  // from usage_.
+  void ChargeOwner(const ClockHandleBasicData& h) {
+    if (owner_partitions_) {
+      owner_partitions_->Charge(h.helper, h.GetTotalCharge());
+    }
+  }
+  void UnchargeOwner(const ClockHandleBasicData& h) {
+    if (owner_partitions_) {
+      owner_partitions_->Uncharge(h.helper, h.GetTotalCharge());
+    }
+  }
+
 #ifndef NDEBUG
   // Acquire N references
   void TEST_RefN(ClockHandle& handle, size_t n);
@@ -508,6 +536,13 @@ class BaseClockTable {
 
   // A reference to ShardedCacheBase::hash_seed_
   const uint32_t& hash_seed_;
+
+  // See ShardedCacheOptions::frequency_admission. Set by the derived table's
+  // constructor if enabled.
+  std::unique_ptr<FrequencyAdmission> admission_;
+
+  // See BaseOpts::owner_partitions. Set by the derived table's constructor.
+  CacheOwnerPartitions* owner_partitions_ = nullptr;
 };
 
 // Hash table for cache entries with size determined at creation time.
@@ -543,8 +578,7 @@ class FixedHyperClockTable : public BaseClockTable {
     explicit Opts(size_t _estimated_value_size, int _eviction_effort_cap)
         : BaseOpts(_eviction_effort_cap),
           estimated_value_size(_estimated_value_size) {}
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge > 0);
       estimated_value_size = opts.estimated_entry_charge;
     }
@@ -833,8 +867,7 @@ class AutoHyperClockTable : public BaseClockTable {
         : BaseOpts(_eviction_effort_cap),
           min_avg_value_size(_min_avg_value_size) {}
 
-    explicit Opts(const HyperClockCacheOptions& opts)
-        : BaseOpts(opts.eviction_effort_cap) {
+    explicit Opts(const HyperClockCacheOptions& opts) : BaseOpts(opts) {
       assert(opts.estimated_entry_charge == 0);
       min_avg_value_size = opts.min_avg_entry_charge;
     }
@@ -1071,6 +1104,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) ClockCacheShard final : public CacheShardBase {
 
   size_t GetTableAddressCount() const;
 
+  void GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                          uint64_t* rejected) const;
+
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr obj,
                                size_t charge,
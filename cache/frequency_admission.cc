@@ -0,0 +1,88 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/frequency_admission.h"
+
+#include <algorithm>
+
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Each 64-bit word holds 16 4-bit counters.
+constexpr int kCountersPerWordBits = 4;
+constexpr uint64_t kCounterMax = 15;
+// Clears the bit that the halving shift moves into the top of each counter.
+constexpr uint64_t kHalveMask = 0x7777777777777777ULL;
+// Four counters per entry keeps collisions rare at 2 bytes per entry.
+constexpr size_t kCountersPerEntry = 4;
+constexpr size_t kMinCounters = 64;
+}  // namespace
+
+FrequencySketch::FrequencySketch(size_t expected_entries) {
+  size_t counters =
+      std::max(kMinCounters, std::max(expected_entries, size_t{1}) *
+                                 kCountersPerEntry);
+  counter_bits_ = FloorLog2(counters - 1) + 1;
+  num_words_ = size_t{1} << (counter_bits_ - kCountersPerWordBits);
+  words_.reset(new RelaxedAtomic<uint64_t>[num_words_]);
+}
+
+void FrequencySketch::GetCounterIndexes(
+    uint64_t hash, std::array<size_t, kDepth>* indexes) const {
+  // Double hashing of two remixes of `hash`, keeping the well mixed upper
+  // bits of each row's product.
+  uint64_t a = hash * 0x9E3779B97F4A7C15ULL;
+  uint64_t b = ((hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ULL) | 1;
+  for (int i = 0; i < kDepth; ++i) {
+    (*indexes)[i] = static_cast<size_t>((a + i * b) >> (64 - counter_bits_));
+  }
+}
+
+void FrequencySketch::Increment(uint64_t hash, size_t current_entries) {
+  std::array<size_t, kDepth> indexes;
+  GetCounterIndexes(hash, &indexes);
+  for (size_t index : indexes) {
+    auto& word = words_[index >> kCountersPerWordBits];
+    int shift = static_cast<int>(BottomNBits(index, kCountersPerWordBits)) * 4;
+    uint64_t old_word = word.LoadRelaxed();
+    do {
+      if (((old_word >> shift) & kCounterMax) == kCounterMax) {
+        break;
+      }
+    } while (!word.CasWeakRelaxed(old_word, old_word + (uint64_t{1} << shift)));
+  }
+
+  size_t sample_size = std::max(current_entries, size_t{1}) * 10;
+  size_t accesses = accesses_since_aging_.FetchAddRelaxed(1) + 1;
+  // Only the thread that resets the access count ages the counters.
+  if (accesses >= sample_size &&
+      accesses_since_aging_.CasStrongRelaxed(accesses, 0)) {
+    Age();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+  std::array<size_t, kDepth> indexes;
+  GetCounterIndexes(hash, &indexes);
+  uint64_t result = kCounterMax;
+  for (size_t index : indexes) {
+    int shift = static_cast<int>(BottomNBits(index, kCountersPerWordBits)) * 4;
+    uint64_t word = words_[index >> kCountersPerWordBits].LoadRelaxed();
+    result = std::min(result, (word >> shift) & kCounterMax);
+  }
+  return static_cast<uint32_t>(result);
+}
+
+void FrequencySketch::Age() {
+  for (size_t i = 0; i < num_words_; ++i) {
+    uint64_t old_word = words_[i].LoadRelaxed();
+    while (!words_[i].CasWeakRelaxed(old_word, (old_word >> 1) & kHalveMask)) {
+    }
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,111 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "rocksdb/cache.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A count-min sketch of recent key access frequencies, with 4-bit saturating
+// counters that are all halved ("aged") after a number of recorded accesses
+// proportional to the number of entries in the cache, so that the estimates
+// follow changes in the workload (TinyLFU). All operations are lock-free and
+// use only relaxed atomics: a lost update or an access racing with aging only
+// makes an estimate slightly less precise.
+class FrequencySketch {
+ public:
+  // `expected_entries` is the largest number of entries the cache is expected
+  // to hold. It determines the size of the sketch, which is not changed
+  // afterwards.
+  explicit FrequencySketch(size_t expected_entries);
+
+  // Records an access to the key with the given hash. The counters are aged
+  // once the number of accesses since the last aging reaches ten times
+  // `current_entries`.
+  void Increment(uint64_t hash, size_t current_entries);
+
+  // Returns the estimated number of recent accesses to the key with the given
+  // hash, between 0 and 15.
+  uint32_t Estimate(uint64_t hash) const;
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + num_words_ * sizeof(RelaxedAtomic<uint64_t>);
+  }
+
+ private:
+  static constexpr int kDepth = 4;
+
+  void GetCounterIndexes(uint64_t hash,
+                         std::array<size_t, kDepth>* indexes) const;
+  void Age();
+
+  int counter_bits_;
+  size_t num_words_;
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> words_;
+  RelaxedAtomic<size_t> accesses_since_aging_{};
+};
+
+// Frequency-based admission for a cache shard (see
+// ShardedCacheOptions::frequency_admission). The shard records every lookup
+// and, when an insertion requires evicting an entry, consults Admit() with
+// the estimated frequency of the entry it would evict. Insertions of keys
+// looked up less often than the victim are rejected.
+class FrequencyAdmission {
+ public:
+  explicit FrequencyAdmission(size_t expected_entries)
+      : sketch_(expected_entries) {}
+
+  void RecordAccess(uint64_t hash, size_t current_entries) {
+    sketch_.Increment(hash, current_entries);
+  }
+
+  uint32_t EstimateFrequency(uint64_t hash) const {
+    return sketch_.Estimate(hash);
+  }
+
+  // For caches without an exact eviction order, such as HyperClockCache: the
+  // estimated frequency of recently evicted entries is tracked as a moving
+  // average and used as the victim frequency.
+  void RecordEviction(uint64_t hash) {
+    uint32_t old_frequency = recent_victim_frequency_.LoadRelaxed();
+    recent_victim_frequency_.StoreRelaxed(
+        (old_frequency + sketch_.Estimate(hash) + 1) / 2);
+  }
+
+  uint32_t GetRecentVictimFrequency() const {
+    return recent_victim_frequency_.LoadRelaxed();
+  }
+
+  // Returns whether an entry for the key with the given hash should be
+  // inserted at the expense of an entry with `victim_frequency`, and counts
+  // the decision under `role`.
+  bool Admit(uint64_t hash, uint32_t victim_frequency, CacheEntryRole role) {
+    bool admit = sketch_.Estimate(hash) >= victim_frequency;
+    auto& counts = admit ? admitted_ : rejected_;
+    counts[static_cast<size_t>(role)].FetchAddRelaxed(1);
+    return admit;
+  }
+
+  void GetCounts(CacheEntryRole role, uint64_t* admitted,
+                 uint64_t* rejected) const {
+    *admitted = admitted_[static_cast<size_t>(role)].LoadRelaxed();
+    *rejected = rejected_[static_cast<size_t>(role)].LoadRelaxed();
+  }
+
+ private:
+  FrequencySketch sketch_;
+  RelaxedAtomic<uint32_t> recent_victim_frequency_{};
+  std::array<RelaxedAtomic<uint64_t>, kNumCacheEntryRoles> admitted_;
+  std::array<RelaxedAtomic<uint64_t>, kNumCacheEntryRoles> rejected_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
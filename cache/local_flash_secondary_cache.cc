@@ -0,0 +1,520 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_flash_secondary_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr size_t kRecordHeaderSize = 3 * sizeof(uint32_t) + 2;
+const std::string kSegmentFileSuffix = ".lfcseg";
+
+std::string NewRecord(const Slice& key, size_t value_size, CompressionType type,
+                      CacheTier source) {
+  std::string record;
+  record.resize(kRecordHeaderSize + key.size() + value_size);
+  char* p = &record[0];
+  EncodeFixed32(p + 4, static_cast<uint32_t>(key.size()));
+  EncodeFixed32(p + 8, static_cast<uint32_t>(value_size));
+  p[12] = static_cast<char>(type);
+  p[13] = static_cast<char>(source);
+  memcpy(p + kRecordHeaderSize, key.data(), key.size());
+  return record;
+}
+
+char* RecordValue(std::string* record, size_t key_size) {
+  return &(*record)[kRecordHeaderSize + key_size];
+}
+
+void SealRecord(std::string* record) {
+  EncodeFixed32(&(*record)[0],
+                crc32c::Mask(crc32c::Value(record->data() + 4,
+                                           record->size() - 4)));
+}
+}  // namespace
+
+class LocalFlashSecondaryCache::ResultHandle
+    : public SecondaryCacheResultHandle {
+ public:
+  ResultHandle(const Slice& key, const Cache::CacheItemHelper* helper,
+               Cache::CreateContext* create_context,
+               std::shared_ptr<FileSystem> fs)
+      : key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context),
+        fs_(std::move(fs)) {}
+
+  ~ResultHandle() override {
+    if (io_handle_ != nullptr) {
+      if (!read_done_.load(std::memory_order_acquire)) {
+        std::vector<void*> io_handles{io_handle_};
+        fs_->AbortIO(io_handles).PermitUncheckedError();
+      }
+      del_fn_(io_handle_);
+    }
+  }
+
+  bool IsReady() override {
+    if (!completed_ && read_done_.load(std::memory_order_acquire)) {
+      Complete();
+    }
+    return completed_;
+  }
+
+  void Wait() override {
+    if (!completed_ && !read_done_.load(std::memory_order_acquire)) {
+      std::vector<void*> io_handles{io_handle_};
+      fs_->Poll(io_handles, 1).PermitUncheckedError();
+    }
+    Complete();
+  }
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return size_; }
+
+  // Reads the record from a written segment
+  void StartRead(std::shared_ptr<Segment>&& segment, const Location& loc,
+                 bool wait) {
+    segment_ = std::move(segment);
+    scratch_.reset(new char[loc.size]);
+    req_.offset = loc.offset;
+    req_.len = loc.size;
+    req_.scratch = scratch_.get();
+    IOOptions io_opts;
+    if (!wait) {
+      IOStatus s = segment_->file->ReadAsync(req_, io_opts, &OnReadDone, this,
+                                             &io_handle_, &del_fn_,
+                                             /*dbg=*/nullptr);
+      if (s.ok()) {
+        return;
+      }
+      // Fall back on a synchronous read
+      s.PermitUncheckedError();
+      io_handle_ = nullptr;
+    }
+    req_.status = segment_->file->Read(req_.offset, req_.len, io_opts,
+                                       &req_.result, req_.scratch,
+                                       /*dbg=*/nullptr);
+    read_done_.store(true, std::memory_order_release);
+    Complete();
+  }
+
+  // Creates the value from a record already in memory
+  void CompleteFrom(std::string&& record) {
+    record_ = std::move(record);
+    req_.result = Slice(record_);
+    req_.status = IOStatus::OK();
+    read_done_.store(true, std::memory_order_release);
+    Complete();
+  }
+
+  void* io_handle() const { return completed_ ? nullptr : io_handle_; }
+
+ private:
+  static void OnReadDone(FSReadRequest& req, void* arg) {
+    auto* self = static_cast<ResultHandle*>(arg);
+    assert(&req == &self->req_);
+    (void)req;
+    self->read_done_.store(true, std::memory_order_release);
+  }
+
+  void Complete() {
+    if (completed_) {
+      return;
+    }
+    assert(read_done_.load(std::memory_order_acquire));
+    completed_ = true;
+    const Slice& data = req_.result;
+    if (!req_.status.ok() || data.size() < kRecordHeaderSize) {
+      return;
+    }
+    uint32_t key_size = DecodeFixed32(data.data() + 4);
+    uint32_t value_size = DecodeFixed32(data.data() + 8);
+    if (data.size() != kRecordHeaderSize + key_size + value_size ||
+        crc32c::Unmask(DecodeFixed32(data.data())) !=
+            crc32c::Value(data.data() + 4, data.size() - 4) ||
+        Slice(data.data() + kRecordHeaderSize, key_size) != key_) {
+      // Treat corruption as a miss
+      return;
+    }
+    auto type = static_cast<CompressionType>(data[12]);
+    auto source = static_cast<CacheTier>(data[13]);
+    Slice value(data.data() + kRecordHeaderSize + key_size, value_size);
+    Status s = helper_->create_cb(value, type, source, create_context_,
+                                  /*allocator=*/nullptr, &value_, &size_);
+    if (!s.ok()) {
+      value_ = nullptr;
+      size_ = 0;
+    }
+    // The buffers are no longer needed
+    segment_.reset();
+    scratch_.reset();
+    record_.clear();
+    record_.shrink_to_fit();
+  }
+
+  const std::string key_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+  const std::shared_ptr<FileSystem> fs_;
+  // Keeps the file open until the read completes
+  std::shared_ptr<Segment> segment_;
+  FSReadRequest req_;
+  std::unique_ptr<char[]> scratch_;
+  std::string record_;
+  void* io_handle_ = nullptr;
+  IOHandleDeleter del_fn_;
+  std::atomic<bool> read_done_{false};
+  bool completed_ = false;
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+};
+
+LocalFlashSecondaryCache::LocalFlashSecondaryCache(
+    const LocalFlashSecondaryCacheOptions& opts)
+    : opts_(opts),
+      fs_(opts.fs ? opts.fs : FileSystem::Default()),
+      max_sealed_segments_(
+          std::max(size_t{1},
+                   opts.capacity / std::max(size_t{1}, opts.segment_size))),
+      active_(std::make_shared<Segment>(next_segment_number_++)) {}
+
+LocalFlashSecondaryCache::~LocalFlashSecondaryCache() {
+  std::vector<std::string> files;
+  for (uint64_t number : reclamation_queue_) {
+    files.push_back(SegmentFileName(number));
+  }
+  DeleteFiles(files);
+}
+
+Status LocalFlashSecondaryCache::Open() {
+  if (opts_.path.empty()) {
+    return Status::InvalidArgument("LocalFlashSecondaryCache needs a path");
+  }
+  if (opts_.segment_size == 0 || opts_.segment_size > UINT32_MAX) {
+    return Status::InvalidArgument(
+        "LocalFlashSecondaryCache segment_size must be in (0, 4GB]");
+  }
+  IOOptions io_opts;
+  IOStatus s = fs_->CreateDirIfMissing(opts_.path, io_opts, /*dbg=*/nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> children;
+  s = fs_->GetChildren(opts_.path, io_opts, &children, /*dbg=*/nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> stale_files;
+  for (const auto& child : children) {
+    if (EndsWith(child, kSegmentFileSuffix)) {
+      stale_files.push_back(opts_.path + "/" + child);
+    }
+  }
+  DeleteFiles(stale_files);
+  return Status::OK();
+}
+
+std::string LocalFlashSecondaryCache::SegmentFileName(uint64_t number) const {
+  return opts_.path + "/" + std::to_string(number) + kSegmentFileSuffix;
+}
+
+Status LocalFlashSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr obj,
+                                        const Cache::CacheItemHelper* helper,
+                                        bool /*force_insert*/) {
+  if (!helper->IsSecondaryCacheCompatible()) {
+    return Status::OK();
+  }
+  size_t size = helper->size_cb(obj);
+  std::string record =
+      NewRecord(key, size, kNoCompression, CacheTier::kVolatileTier);
+  Status s = helper->saveto_cb(obj, 0, size, RecordValue(&record, key.size()));
+  if (!s.ok()) {
+    return s;
+  }
+  return InsertRecord(key, std::move(record));
+}
+
+Status LocalFlashSecondaryCache::InsertSaved(const Slice& key,
+                                             const Slice& saved,
+                                             CompressionType type,
+                                             CacheTier source) {
+  std::string record = NewRecord(key, saved.size(), type, source);
+  memcpy(RecordValue(&record, key.size()), saved.data(), saved.size());
+  return InsertRecord(key, std::move(record));
+}
+
+Status LocalFlashSecondaryCache::InsertRecord(const Slice& key,
+                                              std::string&& record) {
+  if (record.size() > opts_.segment_size) {
+    // As if inserted and immediately reclaimed
+    return Status::OK();
+  }
+  SealRecord(&record);
+  std::shared_ptr<Segment> sealed;
+  {
+    MutexLock l(&mutex_);
+    if (active_->buffer.size() + record.size() > opts_.segment_size) {
+      sealed = std::move(active_);
+      segments_.emplace(sealed->number, sealed);
+      active_ = std::make_shared<Segment>(next_segment_number_++);
+    }
+    if (active_->buffer.empty()) {
+      active_->buffer.reserve(opts_.segment_size);
+    }
+    Location loc{active_->number,
+                 static_cast<uint32_t>(active_->buffer.size()),
+                 static_cast<uint32_t>(record.size())};
+    active_->buffer.append(record);
+    active_->keys.push_back(key.ToString());
+    index_[active_->keys.back()] = loc;
+  }
+  if (sealed) {
+    return WriteSegment(sealed);
+  }
+  return Status::OK();
+}
+
+Status LocalFlashSecondaryCache::WriteSegment(
+    const std::shared_ptr<Segment>& segment) {
+  const std::string fname = SegmentFileName(segment->number);
+  FileOptions file_opts;
+  IOOptions io_opts;
+  std::unique_ptr<FSWritableFile> writable;
+  IOStatus s = fs_->NewWritableFile(fname, file_opts, &writable,
+                                    /*dbg=*/nullptr);
+  if (s.ok()) {
+    s = writable->Append(segment->buffer, io_opts, /*dbg=*/nullptr);
+  }
+  if (s.ok()) {
+    s = writable->Close(io_opts, /*dbg=*/nullptr);
+  }
+  std::unique_ptr<FSRandomAccessFile> file;
+  if (s.ok()) {
+    s = fs_->NewRandomAccessFile(fname, file_opts, &file, /*dbg=*/nullptr);
+  }
+
+  std::vector<std::string> files_to_delete;
+  {
+    MutexLock l(&mutex_);
+    if (s.ok()) {
+      segment->file = std::move(file);
+      std::string().swap(segment->buffer);
+      reclamation_queue_.push_back(segment->number);
+      ReclaimSegments(&files_to_delete);
+    } else {
+      // Lose the entries
+      DropSegment(segment->number, /*files_to_delete=*/nullptr);
+      files_to_delete.push_back(fname);
+    }
+  }
+  DeleteFiles(files_to_delete);
+  return s;
+}
+
+void LocalFlashSecondaryCache::ReclaimSegments(
+    std::vector<std::string>* files_to_delete) {
+  mutex_.AssertHeld();
+  while (reclamation_queue_.size() > max_sealed_segments_) {
+    if (opts_.reclamation_policy == LocalFlashReclamationPolicy::kClock) {
+      // Second chance for segments accessed since the last pass, at most
+      // one full rotation
+      for (size_t i = 0; i < reclamation_queue_.size(); ++i) {
+        Segment& segment = *segments_[reclamation_queue_.front()];
+        if (!segment.accessed) {
+          break;
+        }
+        segment.accessed = false;
+        reclamation_queue_.push_back(reclamation_queue_.front());
+        reclamation_queue_.pop_front();
+      }
+    }
+    uint64_t victim = reclamation_queue_.front();
+    reclamation_queue_.pop_front();
+    DropSegment(victim, files_to_delete);
+  }
+}
+
+void LocalFlashSecondaryCache::DropSegment(
+    uint64_t number, std::vector<std::string>* files_to_delete) {
+  mutex_.AssertHeld();
+  auto it = segments_.find(number);
+  assert(it != segments_.end());
+  for (const auto& key : it->second->keys) {
+    auto index_it = index_.find(key);
+    // Unless overwritten by a later insertion or erased
+    if (index_it != index_.end() &&
+        index_it->second.segment_number == number) {
+      index_.erase(index_it);
+    }
+  }
+  segments_.erase(it);
+  if (files_to_delete) {
+    files_to_delete->push_back(SegmentFileName(number));
+  }
+}
+
+void LocalFlashSecondaryCache::DeleteFiles(
+    const std::vector<std::string>& files) {
+  for (const auto& fname : files) {
+    // Best effort, as the space is reused by later segments anyway
+    fs_->DeleteFile(fname, IOOptions(), /*dbg=*/nullptr)
+        .PermitUncheckedError();
+  }
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> LocalFlashSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool advise_erase,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  assert(helper->create_cb);
+  kept_in_sec_cache = false;
+  std::shared_ptr<Segment> segment;
+  Location loc;
+  std::string record;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(key.ToString());
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    loc = it->second;
+    if (loc.segment_number == active_->number) {
+      segment = active_;
+    } else {
+      segment = segments_.at(loc.segment_number);
+    }
+    segment->accessed = true;
+    if (segment->file == nullptr) {
+      // Not yet written
+      record.assign(segment->buffer, loc.offset, loc.size);
+      segment.reset();
+    }
+    if (advise_erase) {
+      index_.erase(it);
+    } else {
+      kept_in_sec_cache = true;
+    }
+  }
+
+  std::unique_ptr<ResultHandle> handle(
+      new ResultHandle(key, helper, create_context, fs_));
+  if (segment) {
+    handle->StartRead(std::move(segment), loc, wait);
+  } else {
+    handle->CompleteFrom(std::move(record));
+  }
+  if (handle->IsReady() && handle->Value() == nullptr) {
+    // Miss after all
+    kept_in_sec_cache = false;
+    return nullptr;
+  }
+  return handle;
+}
+
+void LocalFlashSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  // The space is reclaimed with the segment
+  index_.erase(key.ToString());
+}
+
+void LocalFlashSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<void*> io_handles;
+  for (auto* handle : handles) {
+    if (!handle->IsReady()) {
+      void* io_handle = static_cast<ResultHandle*>(handle)->io_handle();
+      if (io_handle) {
+        io_handles.push_back(io_handle);
+      }
+    }
+  }
+  if (!io_handles.empty()) {
+    fs_->Poll(io_handles, io_handles.size()).PermitUncheckedError();
+  }
+  for (auto* handle : handles) {
+    handle->Wait();
+  }
+}
+
+Status LocalFlashSecondaryCache::SetCapacity(size_t capacity) {
+  std::vector<std::string> files_to_delete;
+  {
+    MutexLock l(&mutex_);
+    max_sealed_segments_ =
+        std::max(size_t{1}, capacity / opts_.segment_size);
+    ReclaimSegments(&files_to_delete);
+  }
+  DeleteFiles(files_to_delete);
+  return Status::OK();
+}
+
+Status LocalFlashSecondaryCache::GetCapacity(size_t& capacity) {
+  MutexLock l(&mutex_);
+  capacity = max_sealed_segments_ * opts_.segment_size;
+  return Status::OK();
+}
+
+std::string LocalFlashSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(20000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    segment_size : %" ROCKSDB_PRIszt "\n",
+           opts_.segment_size);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    reclamation_policy : %s\n",
+           opts_.reclamation_policy == LocalFlashReclamationPolicy::kClock
+               ? "clock"
+               : "fifo");
+  ret.append(buffer);
+  return ret;
+}
+
+Status LocalFlashSecondaryCache::TEST_SealActiveSegment() {
+  std::shared_ptr<Segment> sealed;
+  {
+    MutexLock l(&mutex_);
+    if (active_->buffer.empty()) {
+      return Status::OK();
+    }
+    sealed = std::move(active_);
+    segments_.emplace(sealed->number, sealed);
+    active_ = std::make_shared<Segment>(next_segment_number_++);
+  }
+  return WriteSegment(sealed);
+}
+
+size_t LocalFlashSecondaryCache::TEST_NumSealedSegments() {
+  MutexLock l(&mutex_);
+  return reclamation_queue_.size();
+}
+
+Status NewLocalFlashSecondaryCache(const LocalFlashSecondaryCacheOptions& opts,
+                                   std::shared_ptr<SecondaryCache>* result) {
+  auto cache = std::make_shared<LocalFlashSecondaryCache>(opts);
+  Status s = cache->Open();
+  if (s.ok()) {
+    *result = std::move(cache);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,132 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// See LocalFlashSecondaryCacheOptions.
+//
+// Each entry is stored as a record
+//   masked crc32c (fixed32) | key size (fixed32) | value size (fixed32) |
+//   compression type (1 byte) | source cache tier (1 byte) | key | value
+// where the checksum covers everything after it. Records are appended to the
+// buffer of the active segment under mutex_. When it is full, the segment is
+// sealed: a new active segment is started and the full buffer is written to
+// the segment's file outside of the mutex. Until the file is written, lookups
+// copy records from the buffer. Afterwards the buffer is freed and lookups
+// read the file, which stays open while a read of it is in flight even if
+// the segment is reclaimed meanwhile.
+class LocalFlashSecondaryCache : public SecondaryCache {
+ public:
+  explicit LocalFlashSecondaryCache(
+      const LocalFlashSecondaryCacheOptions& opts);
+  ~LocalFlashSecondaryCache() override;
+
+  // Creates the directory and deletes stale segment files. Must be called,
+  // and succeed, before the cache is used.
+  Status Open();
+
+  const char* Name() const override { return "LocalFlashSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr obj,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type = kNoCompression,
+                     CacheTier source = CacheTier::kVolatileTier) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  bool SupportForceErase() const override { return true; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status SetCapacity(size_t capacity) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  // Seals the active segment, if it has any entries, and writes it to flash
+  Status TEST_SealActiveSegment();
+  // Number of segments written to flash
+  size_t TEST_NumSealedSegments();
+
+ private:
+  class ResultHandle;
+
+  struct Segment {
+    explicit Segment(uint64_t _number) : number(_number) {}
+
+    const uint64_t number;
+    // Records, until the segment is written to file
+    std::string buffer;
+    // Set once the segment is written
+    std::unique_ptr<FSRandomAccessFile> file;
+    // Keys of the records, to drop from the index on reclamation
+    std::vector<std::string> keys;
+    // For LocalFlashReclamationPolicy::kClock
+    bool accessed = false;
+  };
+
+  struct Location {
+    uint64_t segment_number;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  std::string SegmentFileName(uint64_t number) const;
+
+  Status InsertRecord(const Slice& key, std::string&& record);
+
+  // Writes a sealed segment to its file and then reclaims segments beyond
+  // the capacity. Requires mutex_ not held.
+  Status WriteSegment(const std::shared_ptr<Segment>& segment);
+
+  // Drops segments until the sealed ones fit in the capacity. Returns the
+  // files to delete once mutex_ is released. Requires mutex_ held.
+  void ReclaimSegments(std::vector<std::string>* files_to_delete);
+
+  // Requires mutex_ held.
+  void DropSegment(uint64_t number,
+                   std::vector<std::string>* files_to_delete);
+
+  void DeleteFiles(const std::vector<std::string>& files);
+
+  const LocalFlashSecondaryCacheOptions opts_;
+  const std::shared_ptr<FileSystem> fs_;
+
+  port::Mutex mutex_;
+  size_t max_sealed_segments_;
+  uint64_t next_segment_number_ = 1;
+  std::shared_ptr<Segment> active_;
+  // All segments other than active_, including those being written
+  std::map<uint64_t, std::shared_ptr<Segment>> segments_;
+  // Numbers of written segments, oldest first (or in clock order)
+  std::deque<uint64_t> reclamation_queue_;
+  std::unordered_map<std::string, Location> index_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,213 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/local_flash_secondary_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "rocksdb/cache.h"
+#include "test_util/secondary_cache_test_util.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+using secondary_cache_test_util::TestCreateContext;
+using secondary_cache_test_util::WithCacheType;
+using TestItem = WithCacheType::TestItem;
+
+class LocalFlashSecondaryCacheTest : public testing::Test,
+                                     public TestCreateContext {
+ public:
+  LocalFlashSecondaryCacheTest()
+      : path_(test::PerThreadDBPath("local_flash_secondary_cache_test")) {}
+
+ protected:
+  static std::string Key(int i) {
+    // 16 bytes like block cache keys
+    char buf[17];
+    snprintf(buf, sizeof(buf), "key%013d", i);
+    return buf;
+  }
+
+  std::shared_ptr<LocalFlashSecondaryCache> NewFlashCache(
+      size_t capacity, size_t segment_size,
+      LocalFlashReclamationPolicy policy) {
+    LocalFlashSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = capacity;
+    opts.segment_size = segment_size;
+    opts.reclamation_policy = policy;
+    std::shared_ptr<SecondaryCache> cache;
+    EXPECT_OK(NewLocalFlashSecondaryCache(opts, &cache));
+    return std::static_pointer_cast<LocalFlashSecondaryCache>(cache);
+  }
+
+  // Returns the value for `key`, or an empty string on miss
+  std::string Lookup(SecondaryCache* cache, const std::string& key,
+                     bool wait = true, bool advise_erase = false) {
+    bool kept_in_sec_cache = false;
+    auto handle = cache->Lookup(key, WithCacheType::GetHelper(), this, wait,
+                                advise_erase, /*stats=*/nullptr,
+                                kept_in_sec_cache);
+    if (!handle) {
+      return "";
+    }
+    EXPECT_EQ(kept_in_sec_cache, !advise_erase);
+    if (!wait) {
+      handle->Wait();
+    }
+    EXPECT_TRUE(handle->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    if (!item) {
+      return "";
+    }
+    EXPECT_EQ(handle->Size(), item->Size());
+    return item->ToString();
+  }
+
+  const std::string path_;
+};
+
+TEST_F(LocalFlashSecondaryCacheTest, InsertAndLookup) {
+  auto cache = NewFlashCache(1 << 20, 64 << 10,
+                             LocalFlashReclamationPolicy::kFIFO);
+  Random rnd(301);
+  std::string value1 = rnd.RandomString(1000);
+  std::string value2 = rnd.RandomString(2000);
+  TestItem item2(value2.data(), value2.size());
+
+  ASSERT_EQ(Lookup(cache.get(), Key(1)), "");
+  ASSERT_OK(cache->InsertSaved(Key(1), value1));
+  ASSERT_OK(cache->Insert(Key(2), &item2, WithCacheType::GetHelper(),
+                          /*force_insert=*/false));
+  // From the active segment
+  ASSERT_EQ(Lookup(cache.get(), Key(1)), value1);
+  ASSERT_EQ(Lookup(cache.get(), Key(2), /*wait=*/false), value2);
+
+  // From flash, with both synchronous and asynchronous reads
+  ASSERT_OK(cache->TEST_SealActiveSegment());
+  ASSERT_EQ(cache->TEST_NumSealedSegments(), 1);
+  ASSERT_EQ(Lookup(cache.get(), Key(1)), value1);
+  ASSERT_EQ(Lookup(cache.get(), Key(2), /*wait=*/false), value2);
+
+  bool kept_in_sec_cache = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle1 =
+      cache->Lookup(Key(1), WithCacheType::GetHelper(), this, /*wait=*/false,
+                    /*advise_erase=*/false, /*stats=*/nullptr,
+                    kept_in_sec_cache);
+  std::unique_ptr<SecondaryCacheResultHandle> handle2 =
+      cache->Lookup(Key(2), WithCacheType::GetHelper(), this, /*wait=*/false,
+                    /*advise_erase=*/false, /*stats=*/nullptr,
+                    kept_in_sec_cache);
+  ASSERT_NE(handle1, nullptr);
+  ASSERT_NE(handle2, nullptr);
+  cache->WaitAll({handle1.get(), handle2.get()});
+  ASSERT_TRUE(handle1->IsReady());
+  ASSERT_TRUE(handle2->IsReady());
+  std::unique_ptr<TestItem> val1(static_cast<TestItem*>(handle1->Value()));
+  std::unique_ptr<TestItem> val2(static_cast<TestItem*>(handle2->Value()));
+  ASSERT_EQ(val1->ToString(), value1);
+  ASSERT_EQ(val2->ToString(), value2);
+
+  // Erasing
+  ASSERT_EQ(Lookup(cache.get(), Key(1), /*wait=*/true, /*advise_erase=*/true),
+            value1);
+  ASSERT_EQ(Lookup(cache.get(), Key(1)), "");
+  cache->Erase(Key(2));
+  ASSERT_EQ(Lookup(cache.get(), Key(2)), "");
+
+  // A failure to create the object is a miss
+  ASSERT_OK(cache->InsertSaved(Key(3), value1));
+  SetFailCreate(true);
+  ASSERT_EQ(Lookup(cache.get(), Key(3)), "");
+  SetFailCreate(false);
+  ASSERT_EQ(Lookup(cache.get(), Key(3)), value1);
+}
+
+TEST_F(LocalFlashSecondaryCacheTest, SegmentReclamation) {
+  for (auto policy : {LocalFlashReclamationPolicy::kFIFO,
+                      LocalFlashReclamationPolicy::kClock}) {
+    constexpr size_t kSegmentSize = 8 << 10;
+    // Two segments on flash, about seven entries each
+    auto cache = NewFlashCache(2 * kSegmentSize, kSegmentSize, policy);
+    Random rnd(301);
+    std::string value = rnd.RandomString(1000);
+    for (int i = 0; i < 14; ++i) {
+      ASSERT_OK(cache->InsertSaved(Key(i), value));
+    }
+    ASSERT_OK(cache->TEST_SealActiveSegment());
+    ASSERT_EQ(cache->TEST_NumSealedSegments(), 2);
+    ASSERT_EQ(Lookup(cache.get(), Key(0)), value);
+
+    // A third segment reclaims one of the others
+    for (int i = 14; i < 21; ++i) {
+      ASSERT_OK(cache->InsertSaved(Key(i), value));
+    }
+    ASSERT_OK(cache->TEST_SealActiveSegment());
+    ASSERT_EQ(cache->TEST_NumSealedSegments(), 2);
+    ASSERT_EQ(Lookup(cache.get(), Key(20)), value);
+    if (policy == LocalFlashReclamationPolicy::kFIFO) {
+      // The oldest segment, despite the lookup
+      ASSERT_EQ(Lookup(cache.get(), Key(0)), "");
+      ASSERT_EQ(Lookup(cache.get(), Key(13)), value);
+    } else {
+      // The segment not looked up since the last reclamation
+      ASSERT_EQ(Lookup(cache.get(), Key(0)), value);
+      ASSERT_EQ(Lookup(cache.get(), Key(13)), "");
+    }
+
+    // Shrinking the capacity reclaims segments right away
+    ASSERT_OK(cache->SetCapacity(kSegmentSize));
+    ASSERT_EQ(cache->TEST_NumSealedSegments(), 1);
+    size_t capacity = 0;
+    ASSERT_OK(cache->GetCapacity(capacity));
+    ASSERT_EQ(capacity, kSegmentSize);
+
+    // Entries larger than a segment are not cached
+    std::string large_value = rnd.RandomString(kSegmentSize);
+    ASSERT_OK(cache->InsertSaved(Key(100), large_value));
+    ASSERT_EQ(Lookup(cache.get(), Key(100)), "");
+  }
+}
+
+TEST_F(LocalFlashSecondaryCacheTest, AsNvmTierOfTieredCache) {
+  auto flash_cache = NewFlashCache(1 << 20, 64 << 10,
+                                   LocalFlashReclamationPolicy::kClock);
+  TieredCacheOptions opts;
+  LRUCacheOptions lru_opts;
+  lru_opts.num_shard_bits = 0;
+  lru_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+  opts.cache_opts = &lru_opts;
+  opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
+  opts.adm_policy = TieredAdmissionPolicy::kAdmPolicyThreeQueue;
+  opts.total_capacity = 64 << 10;
+  opts.compressed_secondary_ratio = 0.5;
+  opts.comp_cache_opts.compression_type = kNoCompression;
+  opts.nvm_sec_cache = flash_cache;
+  std::shared_ptr<Cache> cache = NewTieredCache(opts);
+  ASSERT_NE(cache, nullptr);
+
+  // Warm the flash tier directly, then find the entry through the cache
+  Random rnd(301);
+  std::string value = rnd.RandomString(1000);
+  ASSERT_OK(flash_cache->InsertSaved(Key(1), value));
+  Cache::Handle* handle =
+      cache->Lookup(Key(1), WithCacheType::GetHelper(), this,
+                    Cache::Priority::LOW, /*stats=*/nullptr);
+  ASSERT_NE(handle, nullptr);
+  ASSERT_EQ(static_cast<TestItem*>(cache->Value(handle))->ToString(), value);
+  cache->Release(handle);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
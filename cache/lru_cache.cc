@@ -120,7 +120,9 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
                              CacheMetadataChargePolicy metadata_charge_policy,
                              int max_upper_hash_bits,
                              MemoryAllocator* allocator,
-                             const Cache::EvictionCallback* eviction_callback)
+                             const Cache::EvictionCallback* eviction_callback,
+                             bool frequency_admission,
+                             CacheOwnerPartitions* owner_partitions)
     : CacheShardBase(metadata_charge_policy),
       capacity_(0),
       high_pri_pool_usage_(0),
@@ -134,13 +136,20 @@ LRUCacheShard::LRUCacheShard(size_t capacity, bool strict_capacity_limit,
       usage_(0),
       lru_usage_(0),
       mutex_(use_adaptive_mutex),
-      eviction_callback_(*eviction_callback) {
+      eviction_callback_(*eviction_callback),
+      owner_partitions_(owner_partitions) {
   // Make empty circular linked list.
   lru_.next = &lru_;
   lru_.prev = &lru_;
   lru_low_pri_ = &lru_;
   lru_bottom_pri_ = &lru_;
   SetCapacity(capacity);
+  if (frequency_admission) {
+    // Entry charges are not known upfront; size the sketch for typical
+    // block-sized entries.
+    constexpr size_t kAssumedEntryCharge = 4096;
+    admission_.reset(new FrequencyAdmission(capacity / kAssumedEntryCharge));
+  }
 }
 
 void LRUCacheShard::EraseUnRefEntries() {
@@ -154,8 +163,7 @@ void LRUCacheShard::EraseUnRefEntries() {
       LRU_Remove(old);
       table_.Remove(old->key(), old->hash);
       old->SetInCache(false);
-      assert(usage_ >= old->total_charge);
-      usage_ -= old->total_charge;
+      SubtractUsage(old);
       last_reference_list.push_back(old);
     }
   }
@@ -321,18 +329,36 @@ void LRUCacheShard::MaintainPoolSize() {
   }
 }
 
+void LRUCacheShard::EvictEntry(LRUHandle* e,
+                               autovector<LRUHandle*>* deleted) {
+  // LRU list contains only elements which can be evicted.
+  assert(e->InCache() && !e->HasRefs());
+  LRU_Remove(e);
+  table_.Remove(e->key(), e->hash);
+  e->SetInCache(false);
+  SubtractUsage(e);
+  deleted->push_back(e);
+}
+
 void LRUCacheShard::EvictFromLRU(size_t charge,
                                  autovector<LRUHandle*>* deleted) {
+  if (owner_partitions_) {
+    // Entries of owners over their soft limit go first, among the oldest
+    // few entries so that eviction stays cheap.
+    constexpr int kMaxOverLimitScan = 16;
+    LRUHandle* e = lru_.next;
+    for (int i = 0; i < kMaxOverLimitScan && e != &lru_ &&
+                    (usage_ + charge) > capacity_;
+         ++i) {
+      LRUHandle* next = e->next;
+      if (owner_partitions_->IsOverSoftLimit(e->helper)) {
+        EvictEntry(e, deleted);
+      }
+      e = next;
+    }
+  }
   while ((usage_ + charge) > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
-    // LRU list contains only elements which can be evicted.
-    assert(old->InCache() && !old->HasRefs());
-    LRU_Remove(old);
-    table_.Remove(old->key(), old->hash);
-    old->SetInCache(false);
-    assert(usage_ >= old->total_charge);
-    usage_ -= old->total_charge;
-    deleted->push_back(old);
+    EvictEntry(lru_.next, deleted);
   }
 }
 
@@ -377,48 +403,79 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
   {
     DMutexLock l(mutex_);
 
-    // Free the space following strict LRU policy until enough space
-    // is freed or the lru list is empty.
-    EvictFromLRU(e->total_charge, &last_reference_list);
-
-    if ((usage_ + e->total_charge) > capacity_ &&
-        (strict_capacity_limit_ || handle == nullptr)) {
+    bool needs_eviction = usage_ + e->total_charge > capacity_;
+    bool rejected =
+        (owner_partitions_ &&
+         owner_partitions_->ShouldReject(e->helper, e->total_charge,
+                                         needs_eviction)) ||
+        (admission_ && !strict_capacity_limit_ && needs_eviction &&
+         lru_.next != &lru_ &&
+         !admission_->Admit(e->hash,
+                            admission_->EstimateFrequency(lru_.next->hash),
+                            e->helper->role));
+    if (rejected) {
+      // Rejected by owner limits or frequency admission, as if the entry was
+      // inserted and evicted immediately, without evicting anything else.
       e->SetInCache(false);
       if (handle == nullptr) {
-        // Don't insert the entry but still return ok, as if the entry inserted
-        // into cache and get evicted immediately.
         last_reference_list.push_back(e);
-      } else {
+      } else if (strict_capacity_limit_) {
         free(e);
         e = nullptr;
         *handle = nullptr;
-        s = Status::MemoryLimit("Insert failed due to LRU cache being full.");
+        s = Status::MemoryLimit(
+            "Insert failed due to cache owner capacity limit.");
+      } else {
+        // The caller gets a reference to an entry outside the table, charged
+        // like a standalone entry until released.
+        e->SetIsStandalone(true);
+        e->Ref();
+        AddUsage(e);
+        *handle = e;
       }
     } else {
-      // Insert into the cache. Note that the cache might get larger than its
-      // capacity if not enough space was freed up.
-      LRUHandle* old = table_.Insert(e);
-      usage_ += e->total_charge;
-      if (old != nullptr) {
-        s = Status::OkOverwritten();
-        assert(old->InCache());
-        old->SetInCache(false);
-        if (!old->HasRefs()) {
-          // old is on LRU because it's in cache and its reference count is 0.
-          LRU_Remove(old);
-          assert(usage_ >= old->total_charge);
-          usage_ -= old->total_charge;
-          last_reference_list.push_back(old);
+      // Free the space following strict LRU policy until enough space
+      // is freed or the lru list is empty.
+      EvictFromLRU(e->total_charge, &last_reference_list);
+
+      if ((usage_ + e->total_charge) > capacity_ &&
+          (strict_capacity_limit_ || handle == nullptr)) {
+        e->SetInCache(false);
+        if (handle == nullptr) {
+          // Don't insert the entry but still return ok, as if the entry
+          // inserted into cache and get evicted immediately.
+          last_reference_list.push_back(e);
+        } else {
+          free(e);
+          e = nullptr;
+          *handle = nullptr;
+          s = Status::MemoryLimit("Insert failed due to LRU cache being full.");
         }
-      }
-      if (handle == nullptr) {
-        LRU_Insert(e);
       } else {
-        // If caller already holds a ref, no need to take one here.
-        if (!e->HasRefs()) {
-          e->Ref();
+        // Insert into the cache. Note that the cache might get larger than its
+        // capacity if not enough space was freed up.
+        LRUHandle* old = table_.Insert(e);
+        AddUsage(e);
+        if (old != nullptr) {
+          s = Status::OkOverwritten();
+          assert(old->InCache());
+          old->SetInCache(false);
+          if (!old->HasRefs()) {
+            // old is on LRU because it's in cache and its reference count is 0.
+            LRU_Remove(old);
+            SubtractUsage(old);
+            last_reference_list.push_back(old);
+          }
+        }
+        if (handle == nullptr) {
+          LRU_Insert(e);
+        } else {
+          // If caller already holds a ref, no need to take one here.
+          if (!e->HasRefs()) {
+            e->Ref();
+          }
+          *handle = e;
         }
-        *handle = e;
       }
     }
   }
@@ -434,6 +491,9 @@ LRUHandle* LRUCacheShard::Lookup(const Slice& key, uint32_t hash,
                                  Cache::Priority /*priority*/,
                                  Statistics* /*stats*/) {
   DMutexLock l(mutex_);
+  if (admission_) {
+    admission_->RecordAccess(hash, table_.GetOccupancyCount());
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->InCache());
@@ -497,8 +557,7 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
     }
     // If about to be freed, then decrement the cache usage.
     if (must_free) {
-      assert(usage_ >= e->total_charge);
-      usage_ -= e->total_charge;
+      SubtractUsage(e);
     }
   }
 
@@ -581,7 +640,7 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
         e = nullptr;
       }
     } else {
-      usage_ += e->total_charge;
+      AddUsage(e);
     }
   }
 
@@ -601,8 +660,7 @@ void LRUCacheShard::Erase(const Slice& key, uint32_t hash) {
       if (!e->HasRefs()) {
         // The entry is in LRU since it's in hash and has no external references
         LRU_Remove(e);
-        assert(usage_ >= e->total_charge);
-        usage_ -= e->total_charge;
+        SubtractUsage(e);
         last_reference = true;
       }
     }
@@ -636,6 +694,16 @@ size_t LRUCacheShard::GetTableAddressCount() const {
   return size_t{1} << table_.GetLengthBits();
 }
 
+void LRUCacheShard::GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                                       uint64_t* rejected) const {
+  if (admission_) {
+    admission_->GetCounts(role, admitted, rejected);
+  } else {
+    *admitted = 0;
+    *rejected = 0;
+  }
+}
+
 void LRUCacheShard::AppendPrintableOptions(std::string& str) const {
   const int kBufferSize = 200;
   char buffer[kBufferSize];
@@ -657,7 +725,8 @@ LRUCache::LRUCache(const LRUCacheOptions& opts) : ShardedCache(opts) {
                            opts.high_pri_pool_ratio, opts.low_pri_pool_ratio,
                            opts.use_adaptive_mutex, opts.metadata_charge_policy,
                            /* max_upper_hash_bits */ 32 - opts.num_shard_bits,
-                           alloc, &eviction_callback_);
+                           alloc, &eviction_callback_,
+                           opts.frequency_admission, &owner_partitions_);
   });
 }
 
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 
+#include "cache/frequency_admission.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/likely.h"
@@ -271,7 +272,9 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
                 bool use_adaptive_mutex,
                 CacheMetadataChargePolicy metadata_charge_policy,
                 int max_upper_hash_bits, MemoryAllocator* allocator,
-                const Cache::EvictionCallback* eviction_callback);
+                const Cache::EvictionCallback* eviction_callback,
+                bool frequency_admission = false,
+                CacheOwnerPartitions* owner_partitions = nullptr);
 
  public:  // Type definitions expected as parameter to ShardedCache
   using HandleImpl = LRUHandle;
@@ -324,6 +327,8 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
   size_t GetPinnedUsage() const;
   size_t GetOccupancyCount() const;
   size_t GetTableAddressCount() const;
+  void GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                          uint64_t* rejected) const;
 
   void ApplyToSomeEntries(
       const std::function<void(const Slice& key, Cache::ObjectPtr value,
@@ -371,6 +376,25 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   void NotifyEvicted(const autovector<LRUHandle*>& evicted_handles);
 
+  // Removes an unreferenced entry from the LRU list and the table, for
+  // eviction. Requires mutex_.
+  void EvictEntry(LRUHandle* e, autovector<LRUHandle*>* deleted);
+
+  // Update usage_, and the usage of the entry's owner. Require mutex_.
+  void AddUsage(const LRUHandle* e) {
+    usage_ += e->total_charge;
+    if (owner_partitions_) {
+      owner_partitions_->Charge(e->helper, e->total_charge);
+    }
+  }
+  void SubtractUsage(const LRUHandle* e) {
+    assert(usage_ >= e->total_charge);
+    usage_ -= e->total_charge;
+    if (owner_partitions_) {
+      owner_partitions_->Uncharge(e->helper, e->total_charge);
+    }
+  }
+
   LRUHandle* CreateHandle(const Slice& key, uint32_t hash,
                           Cache::ObjectPtr value,
                           const Cache::CacheItemHelper* helper, size_t charge);
@@ -438,6 +462,12 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   // A reference to Cache::eviction_callback_
   const Cache::EvictionCallback& eviction_callback_;
+
+  // See ShardedCacheOptions::frequency_admission. nullptr if disabled.
+  std::unique_ptr<FrequencyAdmission> admission_;
+
+  // Owned by the LRUCache. nullptr for shards created without one.
+  CacheOwnerPartitions* const owner_partitions_;
 };
 
 class LRUCache
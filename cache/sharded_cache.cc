@@ -74,6 +74,19 @@ size_t ShardedCacheBase::GetPerShardCapacity() const {
   return ComputePerShardCapacity(GetCapacity());
 }
 
+Status ShardedCacheBase::SetOwnerCapacityLimits(CacheOwnerId owner,
+                                                size_t soft_limit,
+                                                size_t hard_limit) {
+  if (owner == kUnownedCacheEntry) {
+    return Status::InvalidArgument("Cannot limit unowned entries");
+  }
+  if (soft_limit > hard_limit) {
+    return Status::InvalidArgument("soft_limit exceeds hard_limit");
+  }
+  owner_partitions_.SetLimits(owner, soft_limit, hard_limit);
+  return Status::OK();
+}
+
 uint64_t ShardedCacheBase::NewId() {
   return last_id_.fetch_add(1, std::memory_order_relaxed);
 }
@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <string>
 
+#include "cache/cache_owner.h"
 #include "port/lang.h"
 #include "port/port.h"
 #include "rocksdb/advanced_cache.h"
@@ -70,6 +71,8 @@ class CacheShardBase {
   size_t GetPinnedUsage() const = 0;
   size_t GetOccupancyCount() const = 0;
   size_t GetTableAddressCount() const = 0;
+  void GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                          uint64_t* rejected) const = 0;
   // Handles iterating over roughly `average_entries_per_lock` entries, using
   // `state` to somehow record where it last ended up. Caller initially uses
   // *state == 0 and implementation sets *state = SIZE_MAX to indicate
@@ -108,6 +111,12 @@ class ShardedCacheBase : public Cache {
 
   uint32_t GetHashSeed() const override { return hash_seed_; }
 
+  Status SetOwnerCapacityLimits(CacheOwnerId owner, size_t soft_limit,
+                                size_t hard_limit) override;
+  size_t GetOwnerUsage(CacheOwnerId owner) const override {
+    return owner_partitions_.GetUsage(owner);
+  }
+
  protected:  // fns
   virtual void AppendPrintableOptions(std::string& str) const = 0;
   size_t GetPerShardCapacity() const;
@@ -122,6 +131,9 @@ class ShardedCacheBase : public Cache {
   bool strict_capacity_limit_;
   size_t capacity_;
   mutable port::Mutex config_mutex_;
+
+  // Shared with all shards
+  CacheOwnerPartitions owner_partitions_;
 };
 
 // Generic cache interface that shards cache by hash of keys. 2^num_shard_bits
@@ -235,6 +247,18 @@ class ShardedCache : public ShardedCacheBase {
   size_t GetTableAddressCount() const override {
     return SumOverShards2(&CacheShard::GetTableAddressCount);
   }
+  void GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                          uint64_t* rejected) const override {
+    *admitted = 0;
+    *rejected = 0;
+    ForEachShard([&](const CacheShard* cs) {
+      uint64_t shard_admitted = 0;
+      uint64_t shard_rejected = 0;
+      cs->GetAdmissionCounts(role, &shard_admitted, &shard_rejected);
+      *admitted += shard_admitted;
+      *rejected += shard_rejected;
+    });
+  }
   void ApplyToAllEntries(
       const std::function<void(const Slice& key, ObjectPtr value, size_t charge,
                                const CacheItemHelper* helper)>& callback,
@@ -0,0 +1,173 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/block_cache_hot_set.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "cache/cache_key.h"
+#include "file/filename.h"
+#include "rocksdb/advanced_cache.h"
+#include "table/block_based/block_based_table_reader.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint32_t kHotSetFormatVersion = 2;
+}  // namespace
+
+void BlockCacheHotSet::Collect(
+    Cache* cache, const std::vector<std::pair<uint64_t, UniqueId64x2>>& files) {
+  // Cache keys of blocks of the same file share their first bytes
+  std::vector<OffsetableCacheKey> base_keys;
+  base_keys.reserve(files.size());
+  std::unordered_map<std::string, size_t> file_by_prefix;
+  for (size_t i = 0; i < files.size(); ++i) {
+    UniqueId64x2 unique_id = files[i].second;
+    base_keys.push_back(OffsetableCacheKey::FromInternalUniqueId(&unique_id));
+    file_by_prefix.emplace(base_keys[i].CommonPrefixSlice().ToString(), i);
+  }
+  std::vector<std::vector<uint64_t>> offsets(files.size());
+  std::string prefix;
+  cache->ApplyToAllEntries(
+      [&](const Slice& key, Cache::ObjectPtr /*obj*/, size_t /*charge*/,
+          const Cache::CacheItemHelper* helper) {
+        if (helper == nullptr || helper->role != CacheEntryRole::kDataBlock ||
+            key.size() != kCacheKeySize) {
+          return;
+        }
+        prefix.assign(key.data(), OffsetableCacheKey::kCommonPrefixSize);
+        auto it = file_by_prefix.find(prefix);
+        if (it == file_by_prefix.end()) {
+          return;
+        }
+        uint64_t offset;
+        if (BlockBasedTable::GetBlockOffset(base_keys[it->second], key,
+                                            &offset)) {
+          offsets[it->second].push_back(offset);
+        }
+      },
+      {});
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (offsets[i].empty()) {
+      continue;
+    }
+    auto& file_blocks = files_[files[i].first];
+    file_blocks.unique_id = files[i].second;
+    auto& file_offsets = file_blocks.offsets;
+    file_offsets.insert(file_offsets.end(), offsets[i].begin(),
+                        offsets[i].end());
+    std::sort(file_offsets.begin(), file_offsets.end());
+    file_offsets.erase(std::unique(file_offsets.begin(), file_offsets.end()),
+                       file_offsets.end());
+  }
+}
+
+uint64_t BlockCacheHotSet::NumBlocks() const {
+  uint64_t num_blocks = 0;
+  for (const auto& file : files_) {
+    num_blocks += file.second.offsets.size();
+  }
+  return num_blocks;
+}
+
+void BlockCacheHotSet::EncodeTo(std::string* dst) const {
+  size_t start = dst->size();
+  PutVarint32(dst, kHotSetFormatVersion);
+  PutVarint64(dst, files_.size());
+  for (const auto& file : files_) {
+    PutVarint64(dst, file.first);
+    PutFixed64(dst, file.second.unique_id[0]);
+    PutFixed64(dst, file.second.unique_id[1]);
+    PutVarint64(dst, file.second.offsets.size());
+    uint64_t prev = 0;
+    for (uint64_t offset : file.second.offsets) {
+      PutVarint64(dst, offset - prev);
+      prev = offset;
+    }
+  }
+  PutFixed32(dst, crc32c::Mask(crc32c::Value(dst->data() + start,
+                                             dst->size() - start)));
+}
+
+Status BlockCacheHotSet::DecodeFrom(const Slice& src) {
+  files_.clear();
+  if (src.size() < sizeof(uint32_t)) {
+    return Status::Corruption("Block cache hot set too short");
+  }
+  Slice input(src.data(), src.size() - sizeof(uint32_t));
+  uint32_t expected_crc =
+      crc32c::Unmask(DecodeFixed32(src.data() + input.size()));
+  if (crc32c::Value(input.data(), input.size()) != expected_crc) {
+    return Status::Corruption("Block cache hot set checksum mismatch");
+  }
+  uint32_t version;
+  uint64_t num_files;
+  if (!GetVarint32(&input, &version) || !GetVarint64(&input, &num_files)) {
+    return Status::Corruption("Block cache hot set header");
+  }
+  if (version != kHotSetFormatVersion) {
+    return Status::NotSupported("Block cache hot set format version",
+                                std::to_string(version));
+  }
+  for (uint64_t i = 0; i < num_files; ++i) {
+    uint64_t file_number;
+    UniqueId64x2 unique_id;
+    uint64_t num_blocks;
+    if (!GetVarint64(&input, &file_number) ||
+        !GetFixed64(&input, &unique_id[0]) ||
+        !GetFixed64(&input, &unique_id[1]) ||
+        !GetVarint64(&input, &num_blocks)) {
+      files_.clear();
+      return Status::Corruption("Block cache hot set file entry");
+    }
+    auto& file_blocks = files_[file_number];
+    file_blocks.unique_id = unique_id;
+    auto& offsets = file_blocks.offsets;
+    uint64_t offset = 0;
+    for (uint64_t j = 0; j < num_blocks; ++j) {
+      uint64_t delta;
+      if (!GetVarint64(&input, &delta)) {
+        files_.clear();
+        return Status::Corruption("Block cache hot set block offset");
+      }
+      offset += delta;
+      offsets.push_back(offset);
+    }
+  }
+  return Status::OK();
+}
+
+IOStatus BlockCacheHotSet::Write(FileSystem* fs,
+                                 const std::string& dbname) const {
+  std::string data;
+  EncodeTo(&data);
+  const std::string fname = BlockCacheHotSetFileName(dbname);
+  const std::string tmp_fname = TempBlockCacheHotSetFileName(dbname);
+  IOStatus s = WriteStringToFile(fs, data, tmp_fname, /*should_sync=*/true);
+  if (s.ok()) {
+    s = fs->RenameFile(tmp_fname, fname, IOOptions(), /*dbg=*/nullptr);
+  }
+  if (!s.ok()) {
+    fs->DeleteFile(tmp_fname, IOOptions(), /*dbg=*/nullptr)
+        .PermitUncheckedError();
+  }
+  return s;
+}
+
+IOStatus BlockCacheHotSet::Read(FileSystem* fs, const std::string& dbname) {
+  std::string data;
+  IOStatus s = ReadFileToString(fs, BlockCacheHotSetFileName(dbname), &data);
+  if (s.ok()) {
+    s = status_to_io_status(DecodeFrom(data));
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
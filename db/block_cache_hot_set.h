@@ -0,0 +1,67 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rocksdb/file_system.h"
+#include "rocksdb/status.h"
+#include "table/unique_id_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Cache;
+
+// The data blocks of SST files found in a block cache, which are persisted
+// in the DB directory to warm up the block cache on the next DB::Open. See
+// DBOptions::block_cache_warmup.
+//
+// Encoding:
+//   version (varint32) | number of files (varint64) |
+//   for each file: file number (varint64) | unique id (2 x fixed64) |
+//                  number of blocks (varint64) |
+//                  delta-encoded block offsets (varint64 each) |
+//   masked crc32c of everything before it (fixed32)
+class BlockCacheHotSet {
+ public:
+  struct FileBlocks {
+    // Tells the file apart from a later one with the same number, e.g. after
+    // the DB is destroyed and recreated
+    UniqueId64x2 unique_id{};
+    // Sorted offsets of the data blocks in the block cache
+    std::vector<uint64_t> offsets;
+  };
+  // File number -> blocks
+  using Files = std::map<uint64_t, FileBlocks>;
+
+  // Adds the data blocks in `cache` of the files with the given numbers and
+  // internal unique ids.
+  void Collect(Cache* cache,
+               const std::vector<std::pair<uint64_t, UniqueId64x2>>& files);
+
+  const Files& files() const { return files_; }
+
+  uint64_t NumBlocks() const;
+
+  void EncodeTo(std::string* dst) const;
+  Status DecodeFrom(const Slice& src);
+
+  // Atomically replaces the hot set file of DB `dbname`. Not thread-safe
+  // with other writes to the same DB.
+  IOStatus Write(FileSystem* fs, const std::string& dbname) const;
+  // NotFound if the DB has no hot set file
+  IOStatus Read(FileSystem* fs, const std::string& dbname);
+
+ private:
+  Files files_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -18,6 +18,7 @@
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
 #include "db/internal_stats.h"
+#include "db/l0_key_filter.h"
 #include "db/merge_helper.h"
 #include "db/output_validator.h"
 #include "db/range_del_aggregator.h"
@@ -75,7 +76,7 @@ Status BuildTable(
     Env::WriteLifeTimeHint write_hint, const std::string* full_history_ts_low,
     BlobFileCompletionCallback* blob_callback, Version* version,
     uint64_t* num_input_entries, uint64_t* memtable_payload_bytes,
-    uint64_t* memtable_garbage_bytes) {
+    uint64_t* memtable_garbage_bytes, std::vector<uint64_t>* l0_key_hashes) {
   assert((tboptions.column_family_id ==
           TablePropertiesCollectorFactory::Context::kUnknownColumnFamily) ==
          tboptions.column_family_name.empty());
@@ -262,6 +263,14 @@ Status BuildTable(
         break;
       }
       builder->Add(key_after_flush, value_after_flush);
+      if (l0_key_hashes != nullptr) {
+        uint64_t hash = L0KeyFilter::HashKey(
+            StripTimestampFromUserKey(ikey.user_key, ts_sz));
+        // Versions of a key are adjacent
+        if (l0_key_hashes->empty() || l0_key_hashes->back() != hash) {
+          l0_key_hashes->push_back(hash);
+        }
+      }
 
       s = meta->UpdateBoundaries(key_after_flush, value_after_flush,
                                  ikey.sequence, ikey.type);
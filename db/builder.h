@@ -71,6 +71,7 @@ Status BuildTable(
     BlobFileCompletionCallback* blob_callback = nullptr,
     Version* version = nullptr, uint64_t* num_input_entries = nullptr,
     uint64_t* memtable_payload_bytes = nullptr,
-    uint64_t* memtable_garbage_bytes = nullptr);
+    uint64_t* memtable_garbage_bytes = nullptr,
+    std::vector<uint64_t>* l0_key_hashes = nullptr);
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -25,6 +25,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/internal_stats.h"
 #include "db/job_context.h"
+#include "db/l0_key_filter.h"
 #include "db/range_del_aggregator.h"
 #include "db/table_properties_collector.h"
 #include "db/version_set.h"
@@ -597,6 +598,10 @@ ColumnFamilyData::ColumnFamilyData(
                           internal_stats_->GetBlobFileReadHist(), io_tracer));
     blob_source_.reset(new BlobSource(ioptions(), db_id, db_session_id,
                                       blob_file_cache_.get()));
+    if (ioptions_.l0_key_filter_bits_per_key > 0) {
+      l0_key_filter_.reset(
+          new L0KeyFilter(ioptions_.l0_key_filter_bits_per_key));
+    }
 
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
@@ -1542,6 +1547,12 @@ Status ColumnFamilyData::ValidateOptions(
           " runs but is smaller than the compaction trigger "
           "level0_file_num_compaction_trigger.");
     }
+    if (cf_options.compaction_options_universal.lazy_leveling_tiering_factor ==
+        1) {
+      return Status::NotSupported(
+          "CompactionOptionsUniversal::lazy_leveling_tiering_factor should be "
+          "0 or at least 2.");
+    }
   }
   return s;
 }
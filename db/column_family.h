@@ -49,6 +49,7 @@ class InstrumentedMutexLock;
 struct SuperVersionContext;
 class BlobFileCache;
 class BlobSource;
+class L0KeyFilter;
 
 extern const double kIncSlowdownRatio;
 // This file contains a list of data structures for managing column family
@@ -402,6 +403,8 @@ class ColumnFamilyData {
 
   TableCache* table_cache() const { return table_cache_.get(); }
   BlobSource* blob_source() const { return blob_source_.get(); }
+  // nullptr unless l0_key_filter_bits_per_key > 0
+  L0KeyFilter* l0_key_filter() const { return l0_key_filter_.get(); }
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -621,6 +624,8 @@ class ColumnFamilyData {
   std::unique_ptr<TableCache> table_cache_;
   std::unique_ptr<BlobFileCache> blob_file_cache_;
   std::unique_ptr<BlobSource> blob_source_;
+  // Outlives the Versions, which are freed in the destructor body
+  std::unique_ptr<L0KeyFilter> l0_key_filter_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
@@ -9,11 +9,13 @@
 
 #include "db/compaction/compaction.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <vector>
 
 #include "db/column_family.h"
 #include "db/dbformat.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "logging/logging.h"
 #include "rocksdb/compaction_filter.h"
 #include "rocksdb/sst_partitioner.h"
@@ -604,6 +606,138 @@ void Compaction::AddInputDeletions(VersionEdit* out_edit) {
   }
 }
 
+namespace {
+// Returns true if the range tombstones in `iter`, which belong to
+// `tombstone_file`, delete every key of `file`. See Compaction::FindRangeDeletedInputs().
+bool RangeTombstonesCoverFile(const InternalKeyComparator& icmp,
+                              const FileMetaData& tombstone_file,
+                              FragmentedRangeTombstoneIterator* iter,
+                              const FileMetaData& file,
+                              const std::vector<SequenceNumber>& snapshots) {
+  const Comparator* ucmp = icmp.user_comparator();
+  const Slice smallest = file.smallest.user_key();
+  const Slice largest = file.largest.user_key();
+  // Tombstones only apply within the key range of their file, which may have
+  // been truncated at either end. It must include every entry of `file`.
+  InternalKey first_entry(smallest, file.fd.largest_seqno, kValueTypeForSeek);
+  if (icmp.Compare(tombstone_file.smallest, first_entry) > 0 ||
+      ucmp->Compare(tombstone_file.largest.user_key(), largest) <= 0) {
+    return false;
+  }
+
+  // Walk the fragments from `smallest` and require them to cover up to and
+  // including `largest` without gaps, each with a tombstone newer than the
+  // file. No snapshot may fall between the file's oldest entry and the
+  // tombstone, or the snapshot could still see keys of the file.
+  Slice covered_until = smallest;
+  iter->Seek(smallest);
+  for (; iter->Valid(); iter->TopNext()) {
+    if (ucmp->Compare(iter->start_key(), covered_until) > 0) {
+      return false;
+    }
+    SequenceNumber seq = iter->seq();
+    if (seq <= file.fd.largest_seqno) {
+      return false;
+    }
+    auto snapshot = std::lower_bound(snapshots.begin(), snapshots.end(),
+                                     file.fd.smallest_seqno);
+    if (snapshot != snapshots.end() && *snapshot < seq) {
+      return false;
+    }
+    covered_until = iter->end_key();
+    if (ucmp->Compare(covered_until, largest) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // anonymous namespace
+
+std::vector<FileMetaData*> Compaction::FindRangeDeletedInputs(
+    const ReadOptions& read_options,
+    const std::vector<SequenceNumber>& snapshots) const {
+  std::vector<FileMetaData*> result;
+  const InternalKeyComparator& icmp = cfd_->internal_comparator();
+  if (icmp.user_comparator()->timestamp_size() > 0) {
+    return result;
+  }
+
+  std::vector<std::pair<const FileMetaData*,
+                        std::unique_ptr<FragmentedRangeTombstoneIterator>>>
+      tombstone_files;
+  for (const auto& input_level : inputs_) {
+    for (const FileMetaData* f : input_level.files) {
+      if (f->init_stats_from_file && f->num_range_deletions == 0) {
+        // Known to have no tombstones, so no need to open it
+        continue;
+      }
+      std::unique_ptr<FragmentedRangeTombstoneIterator> iter;
+      Status s = cfd_->table_cache()->GetRangeTombstoneIterator(
+          read_options, icmp, *f,
+          mutable_cf_options_.block_protection_bytes_per_key, &iter);
+      if (!s.ok()) {
+        // Not an error for the compaction; it reads every file instead.
+        return {};
+      }
+      if (iter != nullptr && !iter->empty()) {
+        tombstone_files.emplace_back(f, std::move(iter));
+      }
+    }
+  }
+  if (tombstone_files.empty()) {
+    return result;
+  }
+
+  for (const auto& input_level : inputs_) {
+    for (FileMetaData* f : input_level.files) {
+      // Dropping a file that references blobs would bypass blob garbage
+      // accounting.
+      if (f->oldest_blob_file_number != kInvalidBlobFileNumber) {
+        continue;
+      }
+      for (auto& tombstone_file : tombstone_files) {
+        if (tombstone_file.first != f &&
+            RangeTombstonesCoverFile(icmp, *tombstone_file.first,
+                                     tombstone_file.second.get(), *f,
+                                     snapshots)) {
+          result.push_back(f);
+          break;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+bool Compaction::IsRangeDeletedInput(const FileMetaData* f) const {
+  return std::find(range_deleted_inputs_.begin(), range_deleted_inputs_.end(),
+                   f) != range_deleted_inputs_.end();
+}
+
+void Compaction::SetRangeDeletedInputs(std::vector<FileMetaData*> files) {
+  range_deleted_inputs_ = std::move(files);
+  if (range_deleted_inputs_.empty()) {
+    return;
+  }
+  input_levels_boundaries_.resize(num_input_levels());
+  for (size_t which = 0; which < num_input_levels(); which++) {
+    const CompactionInputFiles& input = inputs_[which];
+    std::vector<FileMetaData*> files_to_read;
+    for (size_t i = 0; i < input.size(); i++) {
+      if (!IsRangeDeletedInput(input[i])) {
+        files_to_read.push_back(input[i]);
+        if (!input.atomic_compaction_unit_boundaries.empty()) {
+          input_levels_boundaries_[which].push_back(
+              input.atomic_compaction_unit_boundaries[i]);
+        }
+      }
+    }
+    if (files_to_read.size() != input.size()) {
+      DoGenerateLevelFilesBrief(&input_levels_[which], files_to_read, &arena_);
+    }
+  }
+}
+
 bool Compaction::KeyNotExistsBeyondOutputLevel(
     const Slice& user_key, std::vector<size_t>* level_ptrs) const {
   assert(input_version_ != nullptr);
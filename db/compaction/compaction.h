@@ -160,6 +160,10 @@ class Compaction {
   const std::vector<AtomicCompactionUnitBoundary>* boundaries(
       size_t compaction_input_level) const {
     assert(compaction_input_level < inputs_.size());
+    if (!input_levels_boundaries_.empty()) {
+      // Matches input_levels() after SetRangeDeletedInputs().
+      return &input_levels_boundaries_[compaction_input_level];
+    }
     return &inputs_[compaction_input_level].atomic_compaction_unit_boundaries;
   }
 
@@ -176,10 +180,30 @@ class Compaction {
   const std::vector<CompactionInputFiles>* inputs() { return &inputs_; }
 
   // Returns the LevelFilesBrief of the specified compaction input level.
+  // Files set by SetRangeDeletedInputs() are not included.
   const LevelFilesBrief* input_levels(size_t compaction_input_level) const {
     return &input_levels_[compaction_input_level];
   }
 
+  // Returns the input files all of whose keys are deleted by a range
+  // tombstone in another input file that is newer than every key of the file
+  // and visible to every snapshot in `snapshots` that can see any of them.
+  // Such files can be dropped without being read. Reads the range tombstones
+  // of the input files, so must be called without holding the DB mutex.
+  std::vector<FileMetaData*> FindRangeDeletedInputs(
+      const ReadOptions& read_options,
+      const std::vector<SequenceNumber>& snapshots) const;
+
+  // Excludes `files` (from FindRangeDeletedInputs()) from input_levels(), so
+  // the compaction does not read them. AddInputDeletions() still deletes
+  // them. Must be called before the compaction starts reading its inputs.
+  void SetRangeDeletedInputs(std::vector<FileMetaData*> files);
+
+  const std::vector<FileMetaData*>& range_deleted_inputs() const {
+    return range_deleted_inputs_;
+  }
+  bool IsRangeDeletedInput(const FileMetaData* f) const;
+
   // Maximum size of files to build during this compaction.
   uint64_t max_output_file_size() const { return max_output_file_size_; }
 
@@ -393,6 +417,12 @@ class Compaction {
 
   uint32_t max_subcompactions() const { return max_subcompactions_; }
 
+  // Lowers the number of subcompactions, e.g. to fit a memory limit
+  void set_max_subcompactions(uint32_t max_subcompactions) {
+    assert(max_subcompactions <= max_subcompactions_);
+    max_subcompactions_ = max_subcompactions;
+  }
+
   bool enable_blob_garbage_collection() const {
     return enable_blob_garbage_collection_;
   }
@@ -513,6 +543,13 @@ class Compaction {
   // A copy of inputs_, organized more closely in memory
   autovector<LevelFilesBrief, 2> input_levels_;
 
+  // Input files that are deleted without being read, see
+  // SetRangeDeletedInputs(), and the atomic compaction unit boundaries of
+  // the remaining files in input_levels_, if any were excluded.
+  std::vector<FileMetaData*> range_deleted_inputs_;
+  std::vector<std::vector<AtomicCompactionUnitBoundary>>
+      input_levels_boundaries_;
+
   // State used to check for number of overlapping grandparent files
   // (grandparent == "output_level_ + 1")
   std::vector<FileMetaData*> grandparents_;
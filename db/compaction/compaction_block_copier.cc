@@ -0,0 +1,160 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_block_copier.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "db/column_family.h"
+#include "db/table_cache.h"
+#include "db/version_set.h"
+#include "table/table_builder.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Output keys to skip lookups for after an offer that was not copied, first
+// and at most
+constexpr uint64_t kMinBackoff = 16;
+constexpr uint64_t kMaxBackoff = 4096;
+}  // namespace
+
+bool CompactionBlockCopier::IsSupported(const Compaction* compaction) {
+  const ImmutableOptions* ioptions = compaction->immutable_options();
+  // A compaction filter or blob files change values, and the keys of data
+  // blocks with user-defined timestamps may be stored without them
+  return ioptions->compaction_copy_data_blocks &&
+         ioptions->compaction_filter == nullptr &&
+         ioptions->compaction_filter_factory == nullptr &&
+         !compaction->mutable_cf_options()->enable_blob_files &&
+         ioptions->user_comparator->timestamp_size() == 0 &&
+         ioptions->table_factory->IsInstanceOf(
+             TableFactory::kBlockBasedTableName());
+}
+
+CompactionBlockCopier::CompactionBlockCopier(const Compaction* compaction)
+    : compaction_(compaction),
+      icmp_(compaction->column_family_data()->internal_comparator()),
+      table_cache_(compaction->column_family_data()->table_cache()),
+      read_options_(Env::IOActivity::kCompaction),
+      backoff_(kMinBackoff) {
+  read_options_.fill_cache = false;
+  for (size_t i = 0; i < compaction->num_input_levels(); ++i) {
+    const LevelFilesBrief* files = compaction->input_levels(i);
+    if (compaction->level(i) == 0) {
+      for (size_t j = 0; j < files->num_files; ++j) {
+        runs_.push_back({files, static_cast<int>(j), /*exhausted=*/false});
+      }
+    } else if (files->num_files > 0) {
+      runs_.push_back({files, /*file_index=*/-1, /*exhausted=*/false});
+    }
+  }
+}
+
+const FileMetaData* CompactionBlockCopier::FindFile(const SortedRun& run,
+                                                    const Slice& key) const {
+  size_t index;
+  if (run.file_index >= 0) {
+    index = static_cast<size_t>(run.file_index);
+    if (icmp_.Compare(run.files->files[index].largest_key, key) < 0) {
+      return nullptr;
+    }
+  } else {
+    index = static_cast<size_t>(
+        ROCKSDB_NAMESPACE::FindFile(icmp_, *run.files, key));
+    if (index >= run.files->num_files) {
+      return nullptr;
+    }
+  }
+  return run.files->files[index].file_metadata;
+}
+
+void CompactionBlockCopier::RecordResult(bool copied) {
+  if (copied) {
+    backoff_ = kMinBackoff;
+  } else {
+    keys_to_skip_ = backoff_;
+    backoff_ = std::min(backoff_ * 2, kMaxBackoff);
+  }
+}
+
+void CompactionBlockCopier::BeforeAdd(const Slice& key,
+                                      TableBuilder* builder) {
+  if (check_builder_ != nullptr) {
+    RecordResult(check_builder_ == builder &&
+                 builder->NumRawDataBlocksCopied() > copied_before_check_);
+    check_builder_ = nullptr;
+  }
+  if (keys_to_skip_ > 0) {
+    --keys_to_skip_;
+    return;
+  }
+  if (!next_lookup_.empty()) {
+    int cmp = icmp_.Compare(key, next_lookup_);
+    if (cmp < 0 || (cmp == 0 && !next_lookup_inclusive_)) {
+      return;
+    }
+  }
+  if (offer_builder_ != nullptr) {
+    // The key is past the offered block
+    check_builder_ = offer_builder_;
+    copied_before_check_ = copied_before_offer_;
+    offer_builder_ = nullptr;
+  }
+
+  std::unique_ptr<RawDataBlock> offer;
+  next_lookup_.clear();
+  for (SortedRun& run : runs_) {
+    if (run.exhausted) {
+      continue;
+    }
+    const FileMetaData* file = FindFile(run, key);
+    if (file == nullptr) {
+      run.exhausted = true;
+      continue;
+    }
+    auto block = std::make_unique<RawDataBlock>();
+    Status s = table_cache_->ReadRawDataBlock(
+        read_options_, icmp_, *file,
+        compaction_->mutable_cf_options()->block_protection_bytes_per_key, key,
+        block.get());
+    if (s.IsNotFound()) {
+      continue;
+    } else if (!s.ok()) {
+      // Not copying from this run does not affect the output
+      run.exhausted = true;
+      continue;
+    }
+    int cmp = icmp_.Compare(block->first_key, key);
+    if (cmp == 0) {
+      offer = std::move(block);
+      break;
+    }
+    // The run has no block starting before its next block, or before the
+    // key after the block holding `key`
+    const std::string& next = cmp > 0 ? block->first_key : block->last_key;
+    if (next_lookup_.empty() || icmp_.Compare(next, next_lookup_) < 0 ||
+        (cmp > 0 && next == next_lookup_)) {
+      next_lookup_ = next;
+      next_lookup_inclusive_ = cmp > 0;
+    }
+  }
+  if (offer == nullptr) {
+    return;
+  }
+
+  next_lookup_ = offer->last_key;
+  next_lookup_inclusive_ = false;
+  const uint64_t copied = builder->NumRawDataBlocksCopied();
+  if (builder->OfferRawDataBlock(std::move(offer))) {
+    offer_builder_ = builder;
+    copied_before_offer_ = copied;
+  } else {
+    RecordResult(/*copied=*/false);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
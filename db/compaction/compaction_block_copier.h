@@ -0,0 +1,79 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "db/compaction/compaction.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TableBuilder;
+class TableCache;
+
+// Offers the output table builder of a compaction the data blocks of its
+// input files that the next output keys may rebuild exactly (see
+// `compaction_copy_data_blocks`).
+//
+// Before each output key is added, it looks for input data blocks starting
+// with the key, one per sorted run, and offers the first one found. The
+// builder copies the block if the keys it adds fill a block identical to it.
+// Keys up to the end of the offered block, or up to the next possible block
+// start, are not looked up again. After an offer that was not copied,
+// lookups are skipped for a number of keys that doubles up to a limit, so
+// that key ranges merged from several inputs cost little.
+class CompactionBlockCopier {
+ public:
+  // Returns whether data blocks can be copied in the compaction
+  static bool IsSupported(const Compaction* compaction);
+
+  explicit CompactionBlockCopier(const Compaction* compaction);
+
+  // Called before `key` is added to `builder`
+  void BeforeAdd(const Slice& key, TableBuilder* builder);
+
+ private:
+  struct SortedRun {
+    const LevelFilesBrief* files;
+    // For L0, the one file of the run, and for other levels, -1
+    int file_index;
+    bool exhausted;
+  };
+
+  const FileMetaData* FindFile(const SortedRun& run, const Slice& key) const;
+
+  // Records whether an offer was copied
+  void RecordResult(bool copied);
+
+  const Compaction* const compaction_;
+  const InternalKeyComparator& icmp_;
+  TableCache* const table_cache_;
+  ReadOptions read_options_;
+  std::vector<SortedRun> runs_;
+
+  // No lookups until a key compares > next_lookup_, or >= it if
+  // next_lookup_inclusive_. Empty for the first key.
+  std::string next_lookup_;
+  bool next_lookup_inclusive_ = false;
+
+  // The builder of the offer for the block being added, and its number of
+  // copied blocks before the offer
+  const TableBuilder* offer_builder_ = nullptr;
+  uint64_t copied_before_offer_ = 0;
+  // The same, for an offered block that the builder writes while adding the
+  // current key, so the result is known at the next key
+  const TableBuilder* check_builder_ = nullptr;
+  uint64_t copied_before_check_ = 0;
+
+  uint64_t keys_to_skip_ = 0;
+  uint64_t backoff_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
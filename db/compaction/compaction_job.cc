@@ -101,6 +101,8 @@ const char* GetCompactionReasonString(CompactionReason compaction_reason) {
       return "RoundRobinTtl";
     case CompactionReason::kRefitLevel:
       return "RefitLevel";
+    case CompactionReason::kDeletePersistence:
+      return "DeletePersistence";
     case CompactionReason::kNumOfReasons:
       // fall through
     default:
@@ -259,6 +261,30 @@ void CompactionJob::Prepare() {
   write_hint_ = cfd->CalculateSSTWriteHint(c->output_level());
   bottommost_level_ = c->bottommost_level();
 
+  // Input files whose keys are all deleted by range tombstones of other
+  // inputs are deleted by this compaction without being read.
+  if (snapshot_checker_ == nullptr) {
+    std::vector<FileMetaData*> range_deleted_inputs;
+    {
+      InstrumentedMutexUnlock unlock_guard(db_mutex_);
+      range_deleted_inputs = c->FindRangeDeletedInputs(
+          ReadOptions(Env::IOActivity::kCompaction), existing_snapshots_);
+    }
+    if (!range_deleted_inputs.empty()) {
+      uint64_t bytes = 0;
+      for (const FileMetaData* f : range_deleted_inputs) {
+        bytes += f->fd.GetFileSize();
+      }
+      ROCKS_LOG_INFO(db_options_.info_log,
+                     "[%s] [JOB %d] Dropping %" ROCKSDB_PRIszt
+                     " range-deleted input files (%" PRIu64
+                     " bytes) without reading them",
+                     cfd->GetName().c_str(), job_id_,
+                     range_deleted_inputs.size(), bytes);
+      c->SetRangeDeletedInputs(std::move(range_deleted_inputs));
+    }
+  }
+
   if (c->ShouldFormSubcompactions()) {
     StopWatch sw(db_options_.clock, stats_, SUBCOMPACTION_SETUP_TIME);
     GenSubcompactionBoundaries();
@@ -286,9 +312,14 @@ void CompactionJob::Prepare() {
   // collect all seqno->time information from the input files which will be used
   // to encode seqno->time to the output files.
 
-  uint64_t preserve_time_duration =
+  const uint64_t tiering_time_duration =
       std::max(c->immutable_options()->preserve_internal_time_seconds,
                c->immutable_options()->preclude_last_level_data_seconds);
+  // The delete persistence deadline also needs the mapping, to compute the
+  // output files' oldest_tombstone_time, but it does not preserve seqnos.
+  uint64_t preserve_time_duration =
+      std::max(tiering_time_duration,
+               c->mutable_cf_options()->max_delete_persistence_seconds);
 
   if (preserve_time_duration > 0) {
     const ReadOptions read_options(Env::IOActivity::kCompaction);
@@ -317,9 +348,11 @@ void CompactionJob::Prepare() {
       ROCKS_LOG_WARN(db_options_.info_log,
                      "Failed to get current time in compaction: Status: %s",
                      s.ToString().c_str());
-      // preserve all time information
-      preserve_time_min_seqno_ = 0;
-      preclude_last_level_min_seqno_ = 0;
+      if (tiering_time_duration > 0) {
+        // preserve all time information
+        preserve_time_min_seqno_ = 0;
+        preclude_last_level_min_seqno_ = 0;
+      }
       seqno_to_time_mapping_.Enforce();
     } else {
       seqno_to_time_mapping_.Enforce(_current_time);
@@ -984,6 +1017,18 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options,
     stream << "file_fsync_nanos" << compaction_job_stats_->file_fsync_nanos;
     stream << "file_prepare_write_nanos"
            << compaction_job_stats_->file_prepare_write_nanos;
+    stream << "file_read_nanos" << compaction_job_stats_->file_read_nanos;
+    stream << "block_decompress_nanos"
+           << compaction_job_stats_->block_decompress_nanos;
+    stream << "merge_operator_nanos"
+           << compaction_job_stats_->merge_operator_nanos;
+    stream << "compaction_filter_nanos"
+           << compaction_job_stats_->compaction_filter_nanos;
+    stream << "block_compress_nanos"
+           << compaction_job_stats_->block_compress_nanos;
+    stream << "filter_build_nanos"
+           << compaction_job_stats_->filter_build_nanos;
+    stream << "index_build_nanos" << compaction_job_stats_->index_build_nanos;
   }
 
   stream << "lsm_state";
@@ -1235,9 +1280,11 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   uint64_t prev_prepare_write_nanos = 0;
   uint64_t prev_cpu_write_nanos = 0;
   uint64_t prev_cpu_read_nanos = 0;
+  InternalStats::CompactionStageStats prev_stage_stats;
   if (measure_io_stats_) {
     prev_perf_level = GetPerfLevel();
     SetPerfLevel(PerfLevel::kEnableTimeAndCPUTimeExceptForMutex);
+    prev_stage_stats = InternalStats::CompactionStageStats::FromThreadCounters();
     prev_write_nanos = IOSTATS(write_nanos);
     prev_fsync_nanos = IOSTATS(fsync_nanos);
     prev_range_sync_nanos = IOSTATS(range_sync_nanos);
@@ -1290,7 +1337,7 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       input, cfd->user_comparator(), &merge, versions_->LastSequence(),
       &existing_snapshots_, earliest_snapshot_,
       earliest_write_conflict_snapshot_, job_snapshot_seq, snapshot_checker_,
-      env_, ShouldReportDetailedTime(env_, stats_),
+      env_, measure_io_stats_ || ShouldReportDetailedTime(env_, stats_),
       /*expect_valid_internal_key=*/true, range_del_agg.get(),
       blob_file_builder.get(), db_options_.allow_data_in_errors,
       db_options_.enforce_single_del_contracts, manual_compaction_canceled_,
@@ -1396,6 +1443,8 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
       c_iter_stats.num_single_del_fallthru;
   sub_compact->compaction_job_stats.num_single_del_mismatch =
       c_iter_stats.num_single_del_mismatch;
+  sub_compact->compaction_job_stats.compaction_filter_nanos =
+      c_iter_stats.total_filter_time;
   sub_compact->compaction_job_stats.total_input_raw_key_bytes +=
       c_iter_stats.total_input_raw_key_bytes;
   sub_compact->compaction_job_stats.total_input_raw_value_bytes +=
@@ -1467,6 +1516,21 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
         IOSTATS(range_sync_nanos) - prev_range_sync_nanos;
     sub_compact->compaction_job_stats.file_prepare_write_nanos +=
         IOSTATS(prepare_write_nanos) - prev_prepare_write_nanos;
+    InternalStats::CompactionStageStats stage_stats =
+        InternalStats::CompactionStageStats::FromThreadCounters();
+    stage_stats.Subtract(prev_stage_stats);
+    sub_compact->compaction_job_stats.file_read_nanos +=
+        stage_stats.file_read_nanos;
+    sub_compact->compaction_job_stats.block_decompress_nanos +=
+        stage_stats.block_decompress_nanos;
+    sub_compact->compaction_job_stats.merge_operator_nanos +=
+        stage_stats.merge_operator_nanos;
+    sub_compact->compaction_job_stats.block_compress_nanos +=
+        stage_stats.block_compress_nanos;
+    sub_compact->compaction_job_stats.filter_build_nanos +=
+        stage_stats.filter_build_nanos;
+    sub_compact->compaction_job_stats.index_build_nanos +=
+        stage_stats.index_build_nanos;
     sub_compact->compaction_job_stats.cpu_micros -=
         (IOSTATS(cpu_write_nanos) - prev_cpu_write_nanos +
          IOSTATS(cpu_read_nanos) - prev_cpu_read_nanos) /
@@ -1967,6 +2031,11 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       preclude_last_level_min_seqno_ == kMaxSequenceNumber
           ? preclude_last_level_min_seqno_
           : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
+  const VersionStorageInfo* vstorage =
+      sub_compact->compaction->input_version()->storage_info();
+  for (int level = 0; level < vstorage->num_levels(); ++level) {
+    tboptions.level_bytes.push_back(vstorage->NumLevelBytes(level));
+  }
 
   outputs.NewBuilder(tboptions);
 
@@ -2016,6 +2085,10 @@ bool CompactionJob::UpdateCompactionStats(uint64_t* num_input_range_del) {
     }
     for (size_t i = 0; i < num_input_files; ++i) {
       const FileMetaData* file_meta = compaction->input(input_level, i);
+      if (compaction->IsRangeDeletedInput(file_meta)) {
+        // Deleted without being read.
+        continue;
+      }
       *bytes_read += file_meta->fd.GetFileSize();
       uint64_t file_input_entries = file_meta->num_entries;
       uint64_t file_num_range_del = file_meta->num_range_deletions;
@@ -2062,6 +2135,12 @@ void CompactionJob::UpdateCompactionJobStats(
       stats.num_input_files_in_output_level;
   compaction_job_stats_->num_input_files_at_output_level =
       stats.num_input_files_in_output_level;
+  compaction_job_stats_->num_range_deleted_input_files =
+      compact_->compaction->range_deleted_inputs().size();
+  compaction_job_stats_->range_deleted_input_bytes = 0;
+  for (const FileMetaData* f : compact_->compaction->range_deleted_inputs()) {
+    compaction_job_stats_->range_deleted_input_bytes += f->fd.GetFileSize();
+  }
 
   // output information
   compaction_job_stats_->total_output_bytes = stats.bytes_written;
@@ -0,0 +1,89 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_memory_limiter.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "db/compaction/compaction.h"
+#include "db/memtable.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Builder memory per output key: filter builders keep a 64-bit hash per key,
+// Ribbon ones about twice as much while solving, and index builders a
+// fraction of that
+constexpr uint64_t kBuilderBytesPerKey = 16;
+}  // namespace
+
+CompactionMemoryLimiter::CompactionMemoryLimiter(uint64_t limit)
+    : limit_(limit), usage_(0) {}
+
+std::unique_ptr<CompactionMemoryToken> CompactionMemoryLimiter::GetToken(
+    uint64_t bytes, Admission admission) {
+  uint64_t usage = usage_.load(std::memory_order_relaxed);
+  for (;;) {
+    if (admission != Admission::kAlways && limit_ > 0 &&
+        usage + bytes > limit_ &&
+        (admission == Admission::kIfFits || usage > 0)) {
+      return nullptr;
+    }
+    if (usage_.compare_exchange_weak(usage, usage + bytes,
+                                     std::memory_order_relaxed)) {
+      return std::make_unique<CompactionMemoryToken>(this, bytes);
+    }
+  }
+}
+
+uint64_t CompactionMemoryLimiter::EstimateCompactionMemory(
+    const Compaction& c, uint32_t num_subcompactions, size_t readahead_size,
+    size_t file_buffer_size) {
+  // Each subcompaction reads every L0 file and one file per other level at
+  // once
+  uint64_t num_inputs = 0;
+  uint64_t input_bytes = 0;
+  uint64_t input_entries = 0;
+  for (size_t i = 0; i < c.num_input_levels(); ++i) {
+    const std::vector<FileMetaData*>& files = *c.inputs(i);
+    if (files.empty()) {
+      continue;
+    }
+    num_inputs += c.level(i) == 0 ? files.size() : 1;
+    for (const FileMetaData* f : files) {
+      input_bytes += f->fd.GetFileSize();
+      input_entries += f->num_entries;
+    }
+  }
+  // And builds one output file at a time
+  uint64_t output_entries = input_entries;
+  if (input_bytes > c.max_output_file_size()) {
+    output_entries = static_cast<uint64_t>(
+        static_cast<double>(input_entries) *
+        static_cast<double>(c.max_output_file_size()) /
+        static_cast<double>(input_bytes));
+  }
+  const uint64_t per_subcompaction =
+      num_inputs * std::max(readahead_size, kMinReadaheadSize) +
+      file_buffer_size + output_entries * kBuilderBytesPerKey;
+  return per_subcompaction * std::max(num_subcompactions, uint32_t{1});
+}
+
+uint64_t CompactionMemoryLimiter::EstimateFlushMemory(
+    const autovector<MemTable*>& mems, size_t file_buffer_size) {
+  uint64_t entries = 0;
+  for (const MemTable* mem : mems) {
+    entries += mem->num_entries();
+  }
+  return file_buffer_size + entries * kBuilderBytesPerKey;
+}
+
+CompactionMemoryToken::~CompactionMemoryToken() {
+  assert(limiter_->usage_.load(std::memory_order_relaxed) >= bytes_);
+  limiter_->usage_.fetch_sub(bytes_, std::memory_order_relaxed);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,92 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "util/autovector.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Compaction;
+class CompactionMemoryToken;
+class MemTable;
+
+// Accounts the memory that running compactions and flushes are estimated to
+// use against `compaction_memory_limit`, so that compactions that do not fit
+// can be shrunk or deferred before they start (see DBImpl::
+// ReserveCompactionMemory()). The estimates cover input readahead, output
+// file buffers, and the filter and index builders, which keep state for
+// every key of the output file being built.
+class CompactionMemoryLimiter {
+ public:
+  // 0 means no limit
+  explicit CompactionMemoryLimiter(uint64_t limit);
+
+  // No copying allowed
+  CompactionMemoryLimiter(const CompactionMemoryLimiter&) = delete;
+  CompactionMemoryLimiter& operator=(const CompactionMemoryLimiter&) = delete;
+
+  enum class Admission {
+    kIfFits,
+    // Also if nothing else is reserved, so that a job larger than the limit
+    // can still run alone
+    kIfFitsOrIdle,
+    kAlways,
+  };
+
+  // Reserves `bytes` until the token is destroyed, or returns nullptr if
+  // `admission` does not allow it
+  std::unique_ptr<CompactionMemoryToken> GetToken(uint64_t bytes,
+                                                  Admission admission);
+
+  uint64_t GetUsage() const { return usage_.load(std::memory_order_relaxed); }
+  uint64_t GetLimit() const { return limit_; }
+
+  // Estimated memory used by compaction `c` when run with
+  // `num_subcompactions` subcompactions, `readahead_size` bytes of
+  // compaction readahead, and output file buffers of `file_buffer_size`
+  static uint64_t EstimateCompactionMemory(const Compaction& c,
+                                           uint32_t num_subcompactions,
+                                           size_t readahead_size,
+                                           size_t file_buffer_size);
+
+  // Estimated memory used by flushing `mems`, beyond the memtables
+  static uint64_t EstimateFlushMemory(const autovector<MemTable*>& mems,
+                                      size_t file_buffer_size);
+
+  // The readahead a compaction is shrunk to, which is also the auto
+  // readahead the block-based table reader grows to without compaction
+  // readahead
+  static constexpr size_t kMinReadaheadSize = 256 << 10;
+
+ private:
+  friend class CompactionMemoryToken;
+
+  const uint64_t limit_;
+  std::atomic<uint64_t> usage_;
+};
+
+class CompactionMemoryToken {
+ public:
+  CompactionMemoryToken(CompactionMemoryLimiter* limiter, uint64_t bytes)
+      : limiter_(limiter), bytes_(bytes) {}
+  ~CompactionMemoryToken();
+
+  uint64_t bytes() const { return bytes_; }
+
+ private:
+  CompactionMemoryLimiter* limiter_;
+  uint64_t bytes_;
+
+  // no copying allowed
+  CompactionMemoryToken(const CompactionMemoryToken&) = delete;
+  void operator=(const CompactionMemoryToken&) = delete;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -410,6 +410,9 @@ Status CompactionOutputs::AddToOutput(
   if (!s.ok()) {
     return s;
   }
+  if (block_copier_) {
+    block_copier_->BeforeAdd(key, builder_.get());
+  }
   builder_->Add(key, value);
 
   stats_.num_output_records++;
@@ -746,8 +749,10 @@ Status CompactionOutputs::AddRangeDels(
 void CompactionOutputs::FillFilesToCutForTtl() {
   if (compaction_->immutable_options()->compaction_style !=
           kCompactionStyleLevel ||
-      compaction_->immutable_options()->compaction_pri !=
-          kMinOverlappingRatio ||
+      (compaction_->immutable_options()->compaction_pri !=
+           kMinOverlappingRatio &&
+       compaction_->immutable_options()->compaction_pri !=
+           kReadHotOverlappingRatio) ||
       compaction_->mutable_cf_options()->ttl == 0 ||
       compaction_->num_input_levels() < 2 || compaction_->bottommost_level()) {
     return;
@@ -797,6 +802,10 @@ CompactionOutputs::CompactionOutputs(const Compaction* compaction,
   }
 
   level_ptrs_ = std::vector<size_t>(compaction_->number_levels(), 0);
+
+  if (CompactionBlockCopier::IsSupported(compaction)) {
+    block_copier_.reset(new CompactionBlockCopier(compaction));
+  }
 }
 
 }  // namespace ROCKSDB_NAMESPACE
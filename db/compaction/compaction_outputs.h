@@ -12,6 +12,7 @@
 
 #include "db/blob/blob_garbage_meter.h"
 #include "db/compaction/compaction.h"
+#include "db/compaction/compaction_block_copier.h"
 #include "db/compaction/compaction_iterator.h"
 #include "db/internal_stats.h"
 #include "db/output_validator.h"
@@ -314,6 +315,9 @@ class CompactionOutputs {
   const bool is_penultimate_level_;
   std::unique_ptr<CompactionRangeDelAggregator> range_del_agg_ = nullptr;
 
+  // nullptr unless data blocks of the input files can be copied
+  std::unique_ptr<CompactionBlockCopier> block_copier_;
+
   // partitioner information
   std::string last_key_for_partitioner_;
   std::unique_ptr<SstPartitioner> partitioner_;
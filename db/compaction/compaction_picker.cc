@@ -277,6 +277,15 @@ bool CompactionPicker::RangeOverlapWithCompaction(
       }
     }
   }
+  for (const PendingFlushOutput& f : pending_flush_outputs_) {
+    if (level <= f.level &&
+        ucmp->CompareWithoutTimestamp(smallest_user_key,
+                                      f.largest_user_key) <= 0 &&
+        ucmp->CompareWithoutTimestamp(largest_user_key,
+                                      f.smallest_user_key) >= 0) {
+      return true;
+    }
+  }
   // Did not overlap with any running compaction in level `level`
   return false;
 }
@@ -1168,6 +1177,26 @@ void CompactionPicker::UnregisterCompaction(Compaction* c) {
   compactions_in_progress_.erase(c);
 }
 
+void CompactionPicker::RegisterPendingFlushOutput(
+    uint64_t file_number, int level, const Slice& smallest_user_key,
+    const Slice& largest_user_key) {
+  assert(level > 0);
+  pending_flush_outputs_.push_back({file_number, level,
+                                    smallest_user_key.ToString(),
+                                    largest_user_key.ToString()});
+}
+
+void CompactionPicker::UnregisterPendingFlushOutput(uint64_t file_number) {
+  for (auto it = pending_flush_outputs_.begin();
+       it != pending_flush_outputs_.end(); ++it) {
+    if (it->file_number == file_number) {
+      pending_flush_outputs_.erase(it);
+      return;
+    }
+  }
+  assert(false);
+}
+
 void CompactionPicker::PickFilesMarkedForCompaction(
     const std::string& cf_name, VersionStorageInfo* vstorage, int* start_level,
     int* output_level, CompactionInputFiles* start_level_inputs) {
@@ -137,7 +137,8 @@ class CompactionPicker {
   }
 
   // Return true if the passed key range overlap with a compaction output
-  // that is currently running.
+  // that is currently running, or with a pending flush output (see
+  // RegisterPendingFlushOutput()) to `level` or below.
   bool RangeOverlapWithCompaction(const Slice& smallest_user_key,
                                   const Slice& largest_user_key,
                                   int level) const;
@@ -218,6 +219,14 @@ class CompactionPicker {
   // Remove this compaction from the set of running compactions
   void UnregisterCompaction(Compaction* c);
 
+  // Register the output file of a flush to `level` > 0 until the flush is
+  // installed, so that no compaction puts older data for its key range into
+  // `level` or above in the meantime
+  void RegisterPendingFlushOutput(uint64_t file_number, int level,
+                                  const Slice& smallest_user_key,
+                                  const Slice& largest_user_key);
+  void UnregisterPendingFlushOutput(uint64_t file_number);
+
   std::set<Compaction*>* level0_compactions_in_progress() {
     return &level0_compactions_in_progress_;
   }
@@ -244,6 +253,17 @@ class CompactionPicker {
   // Protected by DB mutex
   std::unordered_set<Compaction*> compactions_in_progress_;
 
+  struct PendingFlushOutput {
+    uint64_t file_number;
+    int level;
+    std::string smallest_user_key;
+    std::string largest_user_key;
+  };
+  // Keeps track of the flush output files to levels below L0 that are not
+  // installed yet.
+  // Protected by DB mutex
+  std::vector<PendingFlushOutput> pending_flush_outputs_;
+
   const InternalKeyComparator* const icmp_;
 };
 
@@ -27,6 +27,9 @@ bool LevelCompactionPicker::NeedsCompaction(
   if (!vstorage->FilesMarkedForPeriodicCompaction().empty()) {
     return true;
   }
+  if (!vstorage->FilesMarkedForDeletePersistence().empty()) {
+    return true;
+  }
   if (!vstorage->BottommostFilesMarkedForCompaction().empty()) {
     return true;
   }
@@ -303,6 +306,14 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     return;
   }
 
+  // Pushing tombstones down before their deadline
+  PickFileToCompact(vstorage_->FilesMarkedForDeletePersistence(),
+                    CompactToNextLevel::kSkipLastLevel);
+  if (!start_level_inputs_.empty()) {
+    compaction_reason_ = CompactionReason::kDeletePersistence;
+    return;
+  }
+
   // Periodic Compaction
   PickFileToCompact(vstorage_->FilesMarkedForPeriodicCompaction(),
                     ioptions_.level_compaction_dynamic_level_bytes
@@ -114,6 +114,10 @@ class UniversalCompactionBuilder {
   // because some files are being compacted.
   Compaction* PickPeriodicCompaction();
 
+  // Pick a lazy leveling compaction, see
+  // `CompactionOptionsUniversal::lazy_leveling_tiering_factor`
+  Compaction* PickLazyLevelingCompaction();
+
   bool ShouldSkipLastSortedRunForSizeAmpCompaction() const {
     assert(!sorted_runs_.empty());
     return ioptions_.preclude_last_level_data_seconds > 0 &&
@@ -517,8 +521,15 @@ Compaction* UniversalCompactionBuilder::PickCompaction() {
 
   if (c == nullptr &&
       sorted_runs_.size() >= static_cast<size_t>(file_num_compaction_trigger)) {
-    // Check for size amplification.
-    if ((c = PickCompactionToReduceSizeAmp()) != nullptr) {
+    if (mutable_cf_options_.compaction_options_universal
+            .lazy_leveling_tiering_factor >= 2) {
+      // Lazy leveling bounds size amplification and sorted runs by itself
+      if ((c = PickLazyLevelingCompaction()) != nullptr) {
+        ROCKS_LOG_BUFFER(log_buffer_,
+                         "[%s] Universal: compacting for lazy leveling\n",
+                         cf_name_.c_str());
+      }
+    } else if ((c = PickCompactionToReduceSizeAmp()) != nullptr) {
       TEST_SYNC_POINT("PickCompactionToReduceSizeAmpReturnNonnullptr");
       ROCKS_LOG_BUFFER(log_buffer_, "[%s] Universal: compacting for size amp\n",
                        cf_name_.c_str());
@@ -1448,6 +1459,8 @@ Compaction* UniversalCompactionBuilder::PickCompactionWithSortedRunRange(
     } else if (compaction_reason ==
                CompactionReason::kUniversalSizeAmplification) {
       comp_reason_print_string = "size amp";
+    } else if (compaction_reason == CompactionReason::kUniversalSortedRunNum) {
+      comp_reason_print_string = "sorted run num";
     } else {
       assert(false);
       comp_reason_print_string = "unknown: ";
@@ -1465,6 +1478,8 @@ Compaction* UniversalCompactionBuilder::PickCompactionWithSortedRunRange(
   int output_level;
   if (end_index == sorted_runs_.size() - 1) {
     output_level = max_output_level;
+  } else if (sorted_runs_[end_index + 1].level == 0) {
+    output_level = 0;
   } else {
     // if it's not including all sorted_runs, it can only output to the level
     // above the `end_index + 1` sorted_run.
@@ -1565,6 +1580,92 @@ Compaction* UniversalCompactionBuilder::PickPeriodicCompaction() {
   return c;
 }
 
+Compaction* UniversalCompactionBuilder::PickLazyLevelingCompaction() {
+  const unsigned int factor =
+      mutable_cf_options_.compaction_options_universal
+          .lazy_leveling_tiering_factor;
+  assert(factor >= 2);
+  assert(!sorted_runs_.empty());
+  // Tier 0 holds runs of about the size of a flushed file. Compression makes
+  // them smaller than write_buffer_size, so the smallest L0 file is used
+  // when there is one.
+  uint64_t base_size = mutable_cf_options_.write_buffer_size;
+  for (const SortedRun& sr : sorted_runs_) {
+    if (sr.level == 0) {
+      base_size = std::min(base_size, sr.size);
+    }
+  }
+  base_size = std::max(base_size, uint64_t{1});
+  auto tier_of = [&](uint64_t size) {
+    int tier = 0;
+    for (double tier_size = static_cast<double>(base_size) * factor;
+         static_cast<double>(size) >= tier_size; tier_size *= factor) {
+      ++tier;
+    }
+    return tier;
+  };
+
+  const size_t last_index = sorted_runs_.size() - 1;
+  const int last_tier = tier_of(sorted_runs_[last_index].size);
+  // Find the newest tier with `factor` runs. Runs get older and larger
+  // towards the last one, so the runs of a tier are consecutive.
+  for (size_t start_index = 0; start_index < last_index;) {
+    const int tier = tier_of(sorted_runs_[start_index].size);
+    size_t end_index = start_index;
+    bool being_compacted = sorted_runs_[start_index].being_compacted;
+    uint64_t merged_size = sorted_runs_[start_index].size;
+    while (end_index + 1 < last_index &&
+           tier_of(sorted_runs_[end_index + 1].size) == tier) {
+      ++end_index;
+      being_compacted |= sorted_runs_[end_index].being_compacted;
+      merged_size += sorted_runs_[end_index].size;
+    }
+    if (!being_compacted && end_index - start_index + 1 >= factor) {
+      if (tier_of(merged_size) < last_tier) {
+        ROCKS_LOG_BUFFER(
+            log_buffer_,
+            "[%s] Universal: lazy leveling merging %" ROCKSDB_PRIszt
+            " sorted runs of tier %d\n",
+            cf_name_.c_str(), end_index - start_index + 1, tier);
+        return PickCompactionWithSortedRunRange(
+            start_index, end_index, CompactionReason::kUniversalSortedRunNum);
+      }
+      // The merged run would be as large as the tier of the last run, so it
+      // is merged into the last run, along with any runs in between
+      for (size_t i = end_index + 1; i <= last_index; ++i) {
+        being_compacted |= sorted_runs_[i].being_compacted;
+      }
+      if (!being_compacted) {
+        ROCKS_LOG_BUFFER(log_buffer_,
+                         "[%s] Universal: lazy leveling merging sorted runs of "
+                         "tier %d into the last sorted run of tier %d\n",
+                         cf_name_.c_str(), tier, last_tier);
+        return PickCompactionToOldest(start_index,
+                                      CompactionReason::kUniversalSortedRunNum);
+      }
+    }
+    start_index = end_index + 1;
+  }
+
+  // Runs of unusual sizes, e.g. after deletions, may leave tiers without
+  // `factor` consecutive runs. Bound the number of runs to what the tiers
+  // above the last run can hold.
+  size_t num_sr_not_compacted = 0;
+  for (const SortedRun& sr : sorted_runs_) {
+    if (!sr.being_compacted) {
+      ++num_sr_not_compacted;
+    }
+  }
+  const size_t max_num_runs =
+      static_cast<size_t>(factor) * static_cast<size_t>(last_tier + 1);
+  if (num_sr_not_compacted > max_num_runs) {
+    return PickCompactionToReduceSortedRuns(
+        UINT_MAX,
+        static_cast<unsigned int>(num_sr_not_compacted - max_num_runs + 1));
+  }
+  return nullptr;
+}
+
 uint64_t UniversalCompactionBuilder::GetMaxOverlappingBytes() const {
   if (!mutable_cf_options_.compaction_options_universal.incremental) {
     return std::numeric_limits<uint64_t>::max();
@@ -619,6 +619,34 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionJobStats, file_prepare_write_nanos),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"file_read_nanos",
+         {offsetof(struct CompactionJobStats, file_read_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_decompress_nanos",
+         {offsetof(struct CompactionJobStats, block_decompress_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"merge_operator_nanos",
+         {offsetof(struct CompactionJobStats, merge_operator_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_filter_nanos",
+         {offsetof(struct CompactionJobStats, compaction_filter_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_compress_nanos",
+         {offsetof(struct CompactionJobStats, block_compress_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"filter_build_nanos",
+         {offsetof(struct CompactionJobStats, filter_build_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"index_build_nanos",
+         {offsetof(struct CompactionJobStats, index_build_nanos),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"smallest_output_key_prefix",
          {offsetof(struct CompactionJobStats, smallest_output_key_prefix),
           OptionType::kEncodedString, OptionVerificationType::kNormal,
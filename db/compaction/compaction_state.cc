@@ -41,6 +41,7 @@ void CompactionState::AggregateCompactionStats(
   for (const auto& sc : sub_compact_states) {
     sc.AggregateCompactionStats(compaction_stats);
     compaction_job_stats.Add(sc.compaction_job_stats);
+    compaction_stats.stats.stage_stats.Add(sc.compaction_job_stats);
   }
 }
 }  // namespace ROCKSDB_NAMESPACE
@@ -19,6 +19,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/db_test_util.h"
 #include "env/unique_id_gen.h"
+#include "file/filename.h"
 #include "port/stack_trace.h"
 #include "rocksdb/persistent_cache.h"
 #include "rocksdb/statistics.h"
@@ -467,6 +468,109 @@ TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringFlush) {
             options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmUpFromPreviousHotSet) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.block_cache_warmup = true;
+  options.block_cache_hot_set_persist_period_sec = 0;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  // One key per data block
+  table_options.block_size = kValueSize;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_OK(Put(Key(static_cast<int>(i)), value));
+  }
+  ASSERT_OK(Flush());
+  // Make half of the blocks hot
+  for (size_t i = 0; i < kNumBlocks / 2; i++) {
+    ASSERT_EQ(value, Get(Key(static_cast<int>(i))));
+  }
+  ASSERT_OK(db_->Close());
+  ASSERT_OK(env_->FileExists(BlockCacheHotSetFileName(dbname_)));
+
+  // A new block cache is warmed up with the hot blocks only
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  static_cast_with_check<DBImpl>(db_)->TEST_WaitForBlockCacheWarmup();
+  ASSERT_EQ(kNumBlocks / 2,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+  // The warm-up's own reads count as misses
+  const uint64_t warmup_misses =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS);
+  for (size_t i = 0; i < kNumBlocks / 2; i++) {
+    ASSERT_EQ(value, Get(Key(static_cast<int>(i))));
+  }
+  ASSERT_EQ(warmup_misses,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(kNumBlocks / 2,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_HIT));
+  ASSERT_EQ(value, Get(Key(static_cast<int>(kNumBlocks - 1))));
+  ASSERT_EQ(warmup_misses + 1,
+            options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+}
+
+TEST_F(DBBlockCacheTest, HotSetOfReplacedFiles) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.block_cache_warmup = true;
+  options.block_cache_hot_set_persist_period_sec = 0;
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.block_size = kValueSize;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string value(kValueSize, 'a');
+  auto write_and_read = [&]() {
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_OK(Put(Key(static_cast<int>(i)), value));
+    }
+    ASSERT_OK(Flush());
+    for (size_t i = 0; i < kNumBlocks; i++) {
+      ASSERT_EQ(value, Get(Key(static_cast<int>(i))));
+    }
+  };
+  write_and_read();
+  std::vector<LiveFileMetaData> old_files;
+  db_->GetLiveFilesMetaData(&old_files);
+  ASSERT_OK(db_->Close());
+  const std::string hot_set_file = BlockCacheHotSetFileName(dbname_);
+  std::string old_hot_set;
+  ASSERT_OK(ReadFileToString(env_, hot_set_file, &old_hot_set));
+
+  // DestroyDB removes the hot set, and a new DB reuses the file numbers
+  Destroy(options);
+  ASSERT_TRUE(env_->FileExists(hot_set_file).IsNotFound());
+  Reopen(options);
+  write_and_read();
+  std::vector<LiveFileMetaData> new_files;
+  db_->GetLiveFilesMetaData(&new_files);
+  ASSERT_EQ(1, old_files.size());
+  ASSERT_EQ(1, new_files.size());
+  ASSERT_EQ(old_files[0].file_number, new_files[0].file_number);
+  ASSERT_OK(db_->Close());
+
+  // The old hot set does not warm up the blocks of the new file
+  ASSERT_OK(WriteStringToFile(env_, old_hot_set, hot_set_file));
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  Reopen(options);
+  static_cast_with_check<DBImpl>(db_)->TEST_WaitForBlockCacheWarmup();
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+}
+
 // This test cache data, index and filter blocks during flush.
 class DBBlockCacheTest1 : public DBTestBase,
                           public ::testing::WithParamInterface<uint32_t> {
@@ -1236,6 +1340,38 @@ TEST_F(DBBlockCacheTest, HyperClockCacheReportProblems) {
   EXPECT_EQ(logger->PopCounts(), (std::array<int, 3>{{0, 1, 0}}));
 }
 
+TEST_F(DBBlockCacheTest, CacheOwnerViewAsBlockCache) {
+  std::shared_ptr<Cache> cache = NewLRUCache(1 << 25, 0, false);
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewCacheOwnerView(cache, 1);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(Get(Key(i)), "value" + std::to_string(i));
+  }
+  ASSERT_GT(cache->GetOwnerUsage(1), 0);
+
+  // The stats collector is inserted through the view too
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kBlockCacheEntryStats,
+                                  &values));
+  // Entry charges, without the metadata GetOwnerUsage() includes
+  const uint64_t owner_used =
+      std::stoull(values[BlockCacheEntryStatsMapKeys::OwnerUsedBytes(1)]);
+  ASSERT_GT(owner_used, 0);
+  ASSERT_LE(owner_used, cache->GetOwnerUsage(1));
+  ASSERT_NE(values[BlockCacheEntryStatsMapKeys::EntryCount(
+                CacheEntryRole::kDataBlock)],
+            "0");
+}
+
 class DBBlockCacheTypeTest
     : public DBBlockCacheTest,
       public secondary_cache_test_util::WithCacheTypeParam {};
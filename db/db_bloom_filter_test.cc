@@ -15,6 +15,7 @@
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_reservation_manager.h"
 #include "db/db_test_util.h"
+#include "db/l0_key_filter.h"
 #include "options/options_helper.h"
 #include "port/stack_trace.h"
 #include "rocksdb/advanced_options.h"
@@ -44,6 +45,7 @@ const std::string kStandard128Ribbon =
     test::Standard128RibbonFilterPolicy::kClassName();
 const std::string kAutoBloom = BloomFilterPolicy::kClassName();
 const std::string kAutoRibbon = RibbonFilterPolicy::kClassName();
+const std::string kBinaryFuse = BinaryFuseFilterPolicy::kClassName();
 
 enum class FilterPartitioning {
   kUnpartitionedFilter,
@@ -683,8 +685,9 @@ TEST_P(DBBloomFilterTestWithFormatParams, BloomFilter) {
     uint64_t filter_size = ParseUint64(props["filter_size"]);
     EXPECT_LE(filter_size,
               (PartitionFilters() ? 12 : 11) * nkeys / /*bits / byte*/ 8);
-    if (bfp_impl_ == kAutoRibbon) {
-      // Sometimes using Ribbon filter which is more space-efficient
+    if (bfp_impl_ == kAutoRibbon || bfp_impl_ == kBinaryFuse) {
+      // Sometimes using Ribbon or binary fuse filter, which is more
+      // space-efficient
       EXPECT_GE(filter_size, 7 * nkeys / /*bits / byte*/ 8);
     } else {
       // Always Bloom
@@ -907,6 +910,8 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(kAutoBloom, FilterPartitioning::kUnpartitionedFilter,
                         test::kDefaultFormatVersion),
         std::make_tuple(kAutoRibbon, FilterPartitioning::kUnpartitionedFilter,
+                        test::kDefaultFormatVersion),
+        std::make_tuple(kBinaryFuse, FilterPartitioning::kUnpartitionedFilter,
                         test::kDefaultFormatVersion)));
 
 INSTANTIATE_TEST_CASE_P(
@@ -921,6 +926,8 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(kAutoBloom, FilterPartitioning::kUnpartitionedFilter,
                         kLatestFormatVersion),
         std::make_tuple(kAutoRibbon, FilterPartitioning::kUnpartitionedFilter,
+                        kLatestFormatVersion),
+        std::make_tuple(kBinaryFuse, FilterPartitioning::kUnpartitionedFilter,
                         kLatestFormatVersion)));
 #endif  // !defined(ROCKSDB_VALGRIND_RUN) || defined(ROCKSDB_FULL_VALGRIND_RUN)
 
@@ -955,6 +962,84 @@ TEST_F(DBBloomFilterTest, BloomFilterRate) {
   }
 }
 
+TEST_F(DBBloomFilterTest, L0KeyFilter) {
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.disable_auto_compactions = true;
+  options.l0_key_filter_bits_per_key = 10;
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Every file spans almost all keys, so that only filters rule files out
+  constexpr int kNumFiles = 8;
+  constexpr int kNumKeys = 1000;
+  auto write_files = [&](const std::string& suffix) {
+    for (int f = 0; f < kNumFiles; ++f) {
+      for (int i = f; i < kNumKeys; i += kNumFiles) {
+        ASSERT_OK(Put(Key(i), Key(i) + suffix));
+      }
+      ASSERT_OK(Flush());
+    }
+  };
+  auto check_and_count_useful = [&](const std::string& suffix) {
+    EXPECT_OK(options.statistics->Reset());
+    for (int i = 0; i < kNumKeys; ++i) {
+      EXPECT_EQ(Key(i) + suffix, Get(Key(i)));
+    }
+    return TestGetTickerCount(options, BLOOM_FILTER_USEFUL);
+  };
+
+  write_files("a");
+  ASSERT_EQ(NumTableFilesAtLevel(0), kNumFiles);
+  // Without the L0 key filter, each Get would check the table filters of
+  // (kNumFiles - 1) / 2 newer files on average
+  ASSERT_LT(check_and_count_useful("a"), kNumKeys / 10);
+
+  // Newer versions and deletes are found in files the filter covers, and
+  // range deletions in files it does not cover
+  ASSERT_OK(Put(Key(0), "new"));
+  ASSERT_OK(Delete(Key(1)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), Key(2),
+                       Key(4)));
+  ASSERT_OK(Put(Key(5), "new"));
+  ASSERT_OK(Flush());
+  auto check_updates = [&]() {
+    ASSERT_EQ("new", Get(Key(0)));
+    ASSERT_EQ("NOT_FOUND", Get(Key(1)));
+    ASSERT_EQ("NOT_FOUND", Get(Key(2)));
+    ASSERT_EQ("NOT_FOUND", Get(Key(3)));
+    ASSERT_EQ(Key(4) + "a", Get(Key(4)));
+    ASSERT_EQ("new", Get(Key(5)));
+  };
+  check_updates();
+
+  // Files recovered on open are not covered
+  Reopen(options);
+  check_updates();
+
+  // More L0 files than the filter has slots
+  for (int f = 0; f < L0KeyFilter::kMaxFiles + 2; ++f) {
+    ASSERT_OK(Put(Key(kNumKeys + f), "v"));
+    ASSERT_OK(Flush());
+  }
+  for (int f = 0; f < L0KeyFilter::kMaxFiles + 2; ++f) {
+    ASSERT_EQ("v", Get(Key(kNumKeys + f)));
+  }
+  check_updates();
+
+  // Slots of compacted files are reused
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(NumTableFilesAtLevel(0), 0);
+  write_files("b");
+  ASSERT_LT(check_and_count_useful("b"), kNumKeys / 10);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(check_and_count_useful("b"), 0);
+}
+
 namespace {
 struct CompatibilityConfig {
   std::shared_ptr<const FilterPolicy> policy;
@@ -4006,6 +4091,146 @@ TEST_F(DBBloomFilterTest, SstQueryFilter) {
   EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
 }
 
+TEST_F(DBBloomFilterTest, WholeKeyRangeSstQueryFilter) {
+  using experimental::MakeSharedWholeKeyRangeSQFC;
+  using experimental::SstQueryFilterConfigs;
+  using experimental::SstQueryFilterConfigsManager;
+
+  SstQueryFilterConfigs configs = {{MakeSharedWholeKeyRangeSQFC()}, nullptr};
+  std::shared_ptr<SstQueryFilterConfigsManager> configs_manager;
+  ASSERT_OK(SstQueryFilterConfigsManager::MakeShared({{1, {{"foo", configs}}}},
+                                                     &configs_manager));
+  std::shared_ptr<SstQueryFilterConfigsManager::Factory> factory;
+  ASSERT_OK(configs_manager->MakeSharedFactory("foo", 1, &factory));
+
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  options.table_properties_collector_factories.push_back(factory);
+  DestroyAndReopen(options);
+
+  // Files with overlapping key ranges, and gaps between their keys
+  ASSERT_OK(Put("t0010", "val"));
+  ASSERT_OK(Put("t0020", "val"));
+  ASSERT_OK(Put("t0900", "val"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(Put("t0015", "val"));
+  ASSERT_OK(Put("t0017", "val"));
+  ASSERT_OK(Put("t0500", "val"));
+  ASSERT_OK(Flush());
+
+  using Keys = std::vector<std::string>;
+  auto RangeQueryKeys = [factory, db = db_](std::string lb, std::string ub) {
+    Slice lb_slice = lb;
+    Slice ub_slice = ub;
+
+    ReadOptions ro;
+    ro.iterate_lower_bound = &lb_slice;
+    ro.iterate_upper_bound = &ub_slice;
+    ro.table_filter = factory->GetTableFilterForRangeQuery(lb_slice, ub_slice);
+    std::unique_ptr<Iterator> it(db->NewIterator(ro));
+    Keys ret;
+    for (it->Seek(lb_slice); it->Valid(); it->Next()) {
+      ret.push_back(it->key().ToString());
+    }
+    EXPECT_OK(it->status());
+    return ret;
+  };
+
+  // Filtered from both files, with the range between their keys, and the
+  // upper bound excluded
+  EXPECT_EQ(RangeQueryKeys("t0016", "t0017"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
+  EXPECT_EQ(RangeQueryKeys("t0019", "t0020"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
+
+  // Filtered from one file
+  EXPECT_EQ(RangeQueryKeys("t0011", "t0016"), Keys({"t0015"}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+  EXPECT_EQ(RangeQueryKeys("t0020", "t0021"), Keys({"t0020"}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+
+  // Keys are found anywhere in range
+  EXPECT_EQ(RangeQueryKeys("t0", "t1"),
+            Keys({"t0010", "t0015", "t0017", "t0020", "t0500", "t0900"}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 2);
+  EXPECT_EQ(RangeQueryKeys("t0600", "t0800"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
+
+  // Not filtered when the stored prefix of a key ("t050") is in range
+  EXPECT_EQ(RangeQueryKeys("t0021", "t0500"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+}
+
+TEST_F(DBBloomFilterTest, WholeKeyRangeSstQueryFilterMaxPrefixes) {
+  using experimental::KeySegmentsExtractor;
+  using experimental::MakeSharedWholeKeyRangeSQFC;
+  using experimental::SstQueryFilterConfigs;
+  using experimental::SstQueryFilterConfigsManager;
+
+  // At most 2 prefixes per file
+  SstQueryFilterConfigs configs = {
+      {MakeSharedWholeKeyRangeSQFC(
+          /*suffix_bytes=*/1, KeySegmentsExtractor::KeyCategorySet::All(),
+          /*max_prefixes=*/2)},
+      nullptr};
+  std::shared_ptr<SstQueryFilterConfigsManager> configs_manager;
+  ASSERT_OK(SstQueryFilterConfigsManager::MakeShared({{1, {{"foo", configs}}}},
+                                                     &configs_manager));
+  std::shared_ptr<SstQueryFilterConfigsManager::Factory> factory;
+  ASSERT_OK(configs_manager->MakeSharedFactory("foo", 1, &factory));
+
+  Options options = CurrentOptions();
+  options.statistics = CreateDBStatistics();
+  options.table_properties_collector_factories.push_back(factory);
+  DestroyAndReopen(options);
+
+  // Two clusters of keys, "a00*" and "z00*"
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put("a00" + std::to_string(i) + "xyz", "val"));
+    ASSERT_OK(Put("z00" + std::to_string(i) + "xyz", "val"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(Put("m", "val"));
+  ASSERT_OK(Flush());
+
+  using Keys = std::vector<std::string>;
+  auto RangeQueryKeys = [factory, db = db_](std::string lb, std::string ub) {
+    Slice lb_slice = lb;
+    Slice ub_slice = ub;
+
+    ReadOptions ro;
+    ro.iterate_lower_bound = &lb_slice;
+    ro.iterate_upper_bound = &ub_slice;
+    ro.table_filter = factory->GetTableFilterForRangeQuery(lb_slice, ub_slice);
+    std::unique_ptr<Iterator> it(db->NewIterator(ro));
+    Keys ret;
+    for (it->Seek(lb_slice); it->Valid(); it->Next()) {
+      ret.push_back(it->key().ToString());
+    }
+    EXPECT_OK(it->status());
+    return ret;
+  };
+
+  // Keys are still found with the prefixes shortened to "a00" and "z00"
+  EXPECT_EQ(RangeQueryKeys("a0035", "a0055"), Keys({"a004xyz", "a005xyz"}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+  EXPECT_EQ(RangeQueryKeys("z009", "z1"), Keys({"z009xyz"}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+
+  // Filtered between the clusters
+  EXPECT_EQ(RangeQueryKeys("b", "l"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
+  EXPECT_EQ(RangeQueryKeys("a01", "m"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 0);
+
+  // Not filtered within a cluster anymore, as it would be with the prefixes
+  // "a005x" and "a006x"
+  EXPECT_EQ(RangeQueryKeys("a005y", "a006"), Keys({}));
+  EXPECT_EQ(TestGetAndResetTickerCount(options, NON_LAST_LEVEL_SEEK_DATA), 1);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
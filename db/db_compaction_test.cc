@@ -2749,6 +2749,52 @@ TEST_P(DBCompactionTestWithParam, ConvertCompactionStyle) {
   ASSERT_EQ(keys_in_db, expected_keys);
 }
 
+TEST_F(DBCompactionTest, CopyDataBlocks) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compaction_copy_data_blocks = true;
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(rnd.RandomString(100));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+  // Zero the sequence numbers, so that they stay the same below
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  ASSERT_EQ(options.statistics->getTickerCount(NUMBER_DATA_BLOCKS_COPIED), 0);
+
+  // Only the data blocks around the new key are rebuilt. Without kForce, the
+  // last level is not recompacted, which would copy every block again.
+  ASSERT_OK(Put(Key(500) + "a", "new"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(NumTableFilesAtLevel(0), 0);
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(props.size(), 1);
+  const uint64_t num_data_blocks = props.begin()->second->num_data_blocks;
+  const uint64_t copied =
+      options.statistics->getTickerCount(NUMBER_DATA_BLOCKS_COPIED);
+  ASSERT_GT(copied, num_data_blocks / 2);
+  ASSERT_LT(copied, num_data_blocks);
+
+  Reopen(options);
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(Get(Key(i)), values[i]);
+  }
+  ASSERT_EQ(Get(Key(500) + "a"), "new");
+  ASSERT_OK(db_->VerifyChecksum());
+}
+
 TEST_F(DBCompactionTest, L0_CompactionBug_Issue44_a) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -5244,6 +5290,117 @@ TEST_F(DBCompactionTest, LevelPeriodicCompactionOffpeak) {
   }
 }
 
+TEST_F(DBCompactionTest, LevelDeletePersistence) {
+  env_->SetMockSleep();
+  const uint64_t kDeadline = 24 * 60 * 60;
+
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.max_open_files = -1;
+  options.level_compaction_dynamic_level_bytes = true;
+  options.max_delete_persistence_seconds = kDeadline;
+  DestroyAndReopen(options);
+
+  int delete_persistence_compactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* compaction = static_cast<Compaction*>(arg);
+        if (compaction->compaction_reason() ==
+            CompactionReason::kDeletePersistence) {
+          delete_persistence_compactions++;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+
+  ASSERT_OK(Delete(Key(5)));
+  ASSERT_OK(Flush());
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  uint64_t oldest_tombstone_time = 0;
+  for (const auto& item : props) {
+    if (item.second->num_deletions > 0) {
+      oldest_tombstone_time = item.second->oldest_tombstone_time;
+    }
+  }
+  ASSERT_GT(oldest_tombstone_time, 0);
+
+  // Within the deadline, the tombstone stays in L0. Flushing a file that
+  // does not overlap it recomputes the files to compact.
+  env_->MockSleepForSeconds(static_cast<int>(kDeadline / 2));
+  ASSERT_OK(Put("zzz", "value"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("2,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(0, delete_persistence_compactions);
+
+  // Past it, the file with the tombstone is compacted into the last level
+  env_->MockSleepForSeconds(static_cast<int>(kDeadline / 2) + 1);
+  ASSERT_OK(Put("zzzz", "value"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("2,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(1, delete_persistence_compactions);
+  props.clear();
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  for (const auto& item : props) {
+    ASSERT_EQ(item.second->num_deletions, 0);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+}
+
+TEST_F(DBCompactionTest, DeletePersistenceTimeAfterCompactionWithOldData) {
+  env_->SetMockSleep();
+  const uint64_t kDeadline = 24 * 60 * 60;
+
+  Options options = CurrentOptions();
+  options.env = env_;
+  options.max_open_files = -1;
+  options.level_compaction_dynamic_level_bytes = true;
+  options.max_delete_persistence_seconds = kDeadline;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+
+  // Long after the old data was written, reopen (which records a seqno to
+  // time entry) and delete one of its keys. The snapshot keeps the
+  // tombstone in the compaction output.
+  env_->MockSleepForSeconds(static_cast<int>(10 * kDeadline));
+  int64_t delete_time = 0;
+  ASSERT_OK(env_->GetCurrentTime(&delete_time));
+  Reopen(options);
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Delete(Key(5)));
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+
+  // The output inherits the oldest ancestor time of the old data, but the
+  // tombstone time comes from its own seqno.
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(1, props.size());
+  const auto& tp = props.begin()->second;
+  ASSERT_EQ(1, tp->num_deletions);
+  ASSERT_LT(tp->creation_time, static_cast<uint64_t>(delete_time) - kDeadline);
+  ASSERT_GE(tp->oldest_tombstone_time, static_cast<uint64_t>(delete_time));
+
+  db_->ReleaseSnapshot(snapshot);
+}
+
 TEST_F(DBCompactionTest, LevelPeriodicCompactionWithOldDB) {
   // This test makes sure that periodic compactions are working with a DB
   // where file_creation_time of some files is 0.
@@ -6251,6 +6408,88 @@ TEST_F(DBCompactionTest, CompactionLimiter) {
   ASSERT_OK(dbfull()->TEST_WaitForCompact());
 }
 
+TEST_F(DBCompactionTest, CompactionMemoryLimitDefers) {
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_background_compactions = 2;
+  // Every compaction is estimated to use more, so they run one at a time
+  options.compaction_memory_limit = 1;
+  env_->SetBackgroundThreads(2, Env::Priority::LOW);
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  // The first compaction runs once another one is deferred
+  std::atomic<int> num_deferred{0};
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"DBImpl::BackgroundCompaction:DeferredForMemory",
+        "DBImpl::BackgroundCompaction:NonTrivial:BeforeRun"}});
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:DeferredForMemory",
+      [&](void* /*arg*/) { ++num_deferred; });
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::BackgroundCompaction:NonTrivial:BeforeRun", [&](void* /*arg*/) {
+        uint64_t usage = 0;
+        EXPECT_TRUE(db_->GetIntProperty(DB::Properties::kCompactionMemoryUsage,
+                                        &usage));
+        EXPECT_GT(usage, 0);
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Overlapping files, which are not trivially moved
+  for (int cf = 0; cf < 2; ++cf) {
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_OK(Put(cf, Key(0), "value" + std::to_string(i)));
+      ASSERT_OK(Put(cf, Key(1), "value" + std::to_string(i)));
+      ASSERT_OK(Flush(cf));
+    }
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_GE(num_deferred.load(), 1);
+  for (int cf = 0; cf < 2; ++cf) {
+    ASSERT_EQ(NumTableFilesAtLevel(0, cf), 0);
+    ASSERT_EQ(NumTableFilesAtLevel(1, cf), 1);
+  }
+  uint64_t usage = 1;
+  ASSERT_TRUE(
+      db_->GetIntProperty(DB::Properties::kCompactionMemoryUsage, &usage));
+  ASSERT_EQ(usage, 0);
+}
+
+TEST_F(DBCompactionTest, CompactionMemoryLimitShrinks) {
+  Options options = CurrentOptions();
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_subcompactions = 4;
+  options.compaction_readahead_size = 2 << 20;
+  options.writable_file_max_buffer_size = 1 << 20;
+  // A compaction of two files is estimated to use about 5MB per
+  // subcompaction, for the readahead and output buffer
+  options.compaction_memory_limit = 6 << 20;
+  DestroyAndReopen(options);
+
+  uint32_t num_subcompactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "DBImpl::ReserveCompactionMemory:Shrunk", [&](void* arg) {
+        auto c = static_cast<Compaction*>(arg);
+        num_subcompactions = c->max_subcompactions();
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK(Put(Key(0), "value" + std::to_string(i)));
+    ASSERT_OK(Put(Key(1), "value" + std::to_string(i)));
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(num_subcompactions, 1);
+  ASSERT_EQ(NumTableFilesAtLevel(0), 0);
+  ASSERT_EQ(NumTableFilesAtLevel(1), 1);
+}
+
 INSTANTIATE_TEST_CASE_P(DBCompactionTestWithParam, DBCompactionTestWithParam,
                         ::testing::Values(std::make_tuple(1, true),
                                           std::make_tuple(1, false),
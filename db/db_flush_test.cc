@@ -10,12 +10,14 @@
 #include <atomic>
 #include <limits>
 
+#include "db/compaction/compaction_picker.h"
 #include "db/db_impl/db_impl.h"
 #include "db/db_test_util.h"
 #include "env/mock_env.h"
 #include "file/filename.h"
 #include "port/port.h"
 #include "port/stack_trace.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/utilities/transaction_db.h"
 #include "test_util/sync_point.h"
 #include "test_util/testutil.h"
@@ -2829,6 +2831,60 @@ TEST_P(DBAtomicFlushTest, AtomicFlushRollbackSomeJobs) {
   Destroy(options);
 }
 
+TEST_P(DBAtomicFlushTest, AtomicFlushRollbackReleasesL0KeyFilterSlots) {
+  bool atomic_flush = GetParam();
+  if (!atomic_flush) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.atomic_flush = atomic_flush;
+  options.l0_key_filter_bits_per_key = 10;
+  options.max_bgerror_resume_count = 0;
+  CreateAndReopenWithCF({"pikachu", "eevee"}, options);
+  size_t num_cfs = handles_.size();
+  ASSERT_EQ(3, num_cfs);
+
+  // The flush job run first fails after the others have written their files
+  // and added them to the L0 key filters
+  std::atomic<int> num_runs{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "FlushJob::WriteLevel0Table:s", [&](void* arg) {
+        if (num_runs.fetch_add(1) == static_cast<int>(num_cfs) - 1) {
+          IOStatus s = IOStatus::IOError("Injected");
+          s.SetRetryable(true);
+          *static_cast<Status*>(arg) = s;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  WriteOptions wopts;
+  wopts.disableWAL = true;
+  for (size_t i = 0; i != num_cfs; ++i) {
+    int cf_id = static_cast<int>(i);
+    ASSERT_OK(Put(cf_id, "key", "value", wopts));
+  }
+  ASSERT_NOK(dbfull()->Flush(FlushOptions(), handles_));
+  for (size_t i = 0; i != num_cfs; ++i) {
+    auto cfh = static_cast<ColumnFamilyHandleImpl*>(handles_[i]);
+    ASSERT_EQ(1, cfh->cfd()->imm()->NumNotFlushed());
+  }
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The files of the rolled back flush released their slots, so the files of
+  // the retried flush get the first ones again
+  ASSERT_OK(dbfull()->Resume());
+  ASSERT_OK(dbfull()->Flush(FlushOptions(), handles_));
+  for (size_t i = 0; i != num_cfs; ++i) {
+    auto cfh = static_cast<ColumnFamilyHandleImpl*>(handles_[i]);
+    const auto& l0_files =
+        cfh->cfd()->current()->storage_info()->LevelFiles(0);
+    ASSERT_EQ(1, l0_files.size());
+    ASSERT_EQ(0, l0_files[0]->l0_key_filter_slot);
+  }
+}
+
 TEST_P(DBAtomicFlushTest, FlushMultipleCFs_DropSomeBeforeRequestFlush) {
   bool atomic_flush = GetParam();
   if (!atomic_flush) {
@@ -3504,6 +3560,132 @@ TEST_F(DBFlushTest, DBStuckAfterAtomicFlushError) {
   ASSERT_OK(dbfull()->TEST_WaitForBackgroundWork());
   ASSERT_EQ(1, NumTableFilesAtLevel(0));
 }
+
+TEST_F(DBFlushTest, FlushToLowestNonOverlappingLevel) {
+  Options options = CurrentOptions();
+  options.flush_to_lowest_nonoverlapping_level = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  options.level_compaction_dynamic_level_bytes = false;
+  DestroyAndReopen(options);
+
+  // Disjoint key ranges go to the last level
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 10; ++j) {
+      ASSERT_OK(Put(Key(i * 10 + j), "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("0,0,0,3", FilesPerLevel());
+
+  // Overwrites go right above the files they overlap
+  ASSERT_OK(Put(Key(5), "new1"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,0,1,3", FilesPerLevel());
+  ASSERT_OK(Put(Key(5), "new2"));
+  ASSERT_OK(Put(Key(25), "new2"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("0,1,1,3", FilesPerLevel());
+  ASSERT_OK(Put(Key(15), "new3"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,1,1,3", FilesPerLevel());
+
+  Reopen(options);
+  ASSERT_EQ("new2", Get(Key(5)));
+  ASSERT_EQ("new3", Get(Key(15)));
+  ASSERT_EQ("new2", Get(Key(25)));
+  ASSERT_EQ("v0", Get(Key(6)));
+
+  // With level_compaction_dynamic_level_bytes, only the base level and below
+  // are used
+  options.level_compaction_dynamic_level_bytes = true;
+  DestroyAndReopen(options);
+  ASSERT_OK(Put(Key(0), "v"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put(Key(0), "v"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ("1,0,0,1", FilesPerLevel());
+}
+
+TEST_F(DBFlushTest, FlushToLowestNonOverlappingLevelBlocksCompaction) {
+  Options options = CurrentOptions();
+  options.flush_to_lowest_nonoverlapping_level = true;
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  options.level_compaction_dynamic_level_bytes = false;
+  DestroyAndReopen(options);
+  ColumnFamilyData* cfd =
+      static_cast_with_check<ColumnFamilyHandleImpl>(db_->DefaultColumnFamily())
+          ->cfd();
+
+  // Until the flush is installed, compactions may not output older data to
+  // its key range on its level or above
+  int checks = 0;
+  SyncPoint::GetInstance()->SetCallBack("FlushJob::InstallResults", [&](void*) {
+    CompactionPicker* picker = cfd->compaction_picker();
+    ASSERT_TRUE(picker->RangeOverlapWithCompaction(Key(5), Key(5), 3));
+    ASSERT_TRUE(picker->RangeOverlapWithCompaction(Key(5), Key(20), 1));
+    ASSERT_FALSE(picker->RangeOverlapWithCompaction(Key(20), Key(30), 3));
+    ++checks;
+  });
+  SyncPoint::GetInstance()->EnableProcessing();
+  for (int j = 0; j < 10; ++j) {
+    ASSERT_OK(Put(Key(j), "v"));
+  }
+  ASSERT_OK(Flush());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  ASSERT_EQ(1, checks);
+  ASSERT_EQ("0,0,0,1", FilesPerLevel());
+  ASSERT_FALSE(
+      cfd->compaction_picker()->RangeOverlapWithCompaction(Key(5), Key(5), 3));
+}
+
+TEST_F(DBFlushTest, PartitionedFlush) {
+  Options options = CurrentOptions();
+  options.max_flush_partitions = 4;
+  options.target_file_size_base = 16 << 10;
+  options.disable_auto_compactions = true;
+  // Files are cut where the key prefix changes every 100 keys
+  options.sst_partitioner_factory = NewSstPartitionerFixedPrefixFactory(7);
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_OK(Put(Key(i), "old"));
+  }
+  const Snapshot* snapshot = db_->GetSnapshot();
+  std::vector<std::string> values;
+  for (int i = 0; i < 2000; ++i) {
+    values.push_back(rnd.RandomString(100));
+    ASSERT_OK(Put(Key(i), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  // The files are installed together and do not overlap
+  ASSERT_EQ(4, NumTableFilesAtLevel(0));
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::sort(files.begin(), files.end(),
+            [](const LiveFileMetaData& a, const LiveFileMetaData& b) {
+              return a.smallestkey < b.smallestkey;
+            });
+  for (size_t i = 1; i < files.size(); ++i) {
+    ASSERT_LT(files[i - 1].largestkey, files[i].smallestkey);
+    ASSERT_EQ("00", files[i].smallestkey.substr(files[i].smallestkey.size() -
+                                                2));
+  }
+
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+    ASSERT_EQ("old", Get(Key(i), snapshot));
+  }
+  db_->ReleaseSnapshot(snapshot);
+  Reopen(options);
+  for (int i = 0; i < 2000; ++i) {
+    ASSERT_EQ(values[i], Get(Key(i)));
+  }
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -28,6 +28,7 @@
 
 #include "db/arena_wrapped_db_iter.h"
 #include "db/attribute_group_iterator_impl.h"
+#include "db/block_cache_hot_set.h"
 #include "db/builder.h"
 #include "db/coalescing_iterator.h"
 #include "db/compaction/compaction_job.h"
@@ -83,6 +84,7 @@
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
 #include "rocksdb/merge_operator.h"
+#include "rocksdb/rate_limiter.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/stats_history.h"
 #include "rocksdb/status.h"
@@ -218,6 +220,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       num_running_compactions_(0),
       bg_flush_scheduled_(0),
       num_running_flushes_(0),
+      compaction_memory_limiter_(
+          immutable_db_options_.compaction_memory_limit),
       bg_purge_scheduled_(0),
       disable_delete_obsolete_files_(0),
       pending_purge_obsolete_files_(0),
@@ -286,6 +290,13 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
   periodic_task_functions_.emplace(
       PeriodicTaskType::kRecordSeqnoTime, [this]() {
         this->RecordSeqnoToTimeMapping(/*populate_historical_seconds=*/0);
+        this->ScheduleDeletePersistenceCompactions();
+      });
+  periodic_task_functions_.emplace(
+      PeriodicTaskType::kPersistBlockCacheHotSet, [this]() {
+        if (!this->shutdown_initiated_) {
+          this->PersistBlockCacheHotSet();
+        }
       });
 
   versions_.reset(new VersionSet(
@@ -555,6 +566,14 @@ Status DBImpl::CloseHelper() {
   if (HasPendingManualCompaction()) {
     DisableManualCompaction();
   }
+  // The warm-up stops on shutting_down_. Record the block cache hot set only
+  // after that, as it is in the block cache.
+  if (block_cache_warmup_thread_.joinable()) {
+    block_cache_warmup_thread_.join();
+  }
+  if (persist_block_cache_hot_set_) {
+    PersistBlockCacheHotSet();
+  }
   mutex_.Lock();
   // Unschedule all tasks for this DB
   for (uint8_t i = 0; i < static_cast<uint8_t>(TaskType::kCount); i++) {
@@ -836,10 +855,13 @@ Status DBImpl::RegisterRecordSeqnoTimeWorker(const ReadOptions& read_options,
     InstrumentedMutexLock l(&mutex_);
 
     for (auto cfd : *versions_->GetColumnFamilySet()) {
-      // preserve time is the max of 2 options.
+      // preserve time is the max of 2 options, and of the delete persistence
+      // deadline, which needs write times to compute oldest_tombstone_time.
       uint64_t preserve_seconds =
-          std::max(cfd->ioptions()->preserve_internal_time_seconds,
-                   cfd->ioptions()->preclude_last_level_data_seconds);
+          std::max({cfd->ioptions()->preserve_internal_time_seconds,
+                    cfd->ioptions()->preclude_last_level_data_seconds,
+                    cfd->GetLatestMutableCFOptions()
+                        ->max_delete_persistence_seconds});
       if (!cfd->IsDropped() && preserve_seconds > 0) {
         min_preserve_seconds = std::min(preserve_seconds, min_preserve_seconds);
         max_preserve_seconds = std::max(preserve_seconds, max_preserve_seconds);
@@ -976,6 +998,174 @@ size_t DBImpl::EstimateInMemoryStatsHistorySize() const {
   return size_total;
 }
 
+Status DBImpl::StartBlockCacheWarmup() {
+  if (!immutable_db_options_.block_cache_warmup) {
+    return Status::OK();
+  }
+  persist_block_cache_hot_set_ = true;
+  if (immutable_db_options_.block_cache_hot_set_persist_period_sec > 0) {
+    Status s = periodic_task_scheduler_.Register(
+        PeriodicTaskType::kPersistBlockCacheHotSet,
+        periodic_task_functions_.at(PeriodicTaskType::kPersistBlockCacheHotSet),
+        immutable_db_options_.block_cache_hot_set_persist_period_sec);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  block_cache_warmup_thread_ =
+      port::Thread([this]() { WarmUpBlockCacheFromHotSet(); });
+  return Status::OK();
+}
+
+void DBImpl::PersistBlockCacheHotSet() {
+  TEST_SYNC_POINT("DBImpl::PersistBlockCacheHotSet:Start");
+  // The live files of each block cache. Blocks of files with no unique id in
+  // the manifest can't be found from their cache keys.
+  std::vector<std::shared_ptr<Cache>> caches;
+  std::vector<std::vector<std::pair<uint64_t, UniqueId64x2>>> files;
+  InstrumentedMutexLock persist_lock(&block_cache_hot_set_mutex_);
+  {
+    InstrumentedMutexLock l(&mutex_);
+    for (auto cfd : *versions_->GetColumnFamilySet()) {
+      if (cfd->IsDropped() || !cfd->initialized()) {
+        continue;
+      }
+      const auto* table_options =
+          cfd->ioptions()
+              ->table_factory->GetOptions<BlockBasedTableOptions>();
+      if (table_options == nullptr || table_options->block_cache == nullptr) {
+        continue;
+      }
+      size_t i = std::find(caches.begin(), caches.end(),
+                           table_options->block_cache) -
+                 caches.begin();
+      if (i == caches.size()) {
+        caches.push_back(table_options->block_cache);
+        files.emplace_back();
+      }
+      const auto* vstorage = cfd->current()->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); ++level) {
+        for (const auto* f : vstorage->LevelFiles(level)) {
+          if (f->unique_id == kNullUniqueId64x2) {
+            continue;
+          }
+          files[i].emplace_back(f->fd.GetNumber(), f->unique_id);
+        }
+      }
+    }
+  }
+
+  BlockCacheHotSet hot_set;
+  for (size_t i = 0; i < caches.size(); ++i) {
+    hot_set.Collect(caches[i].get(), files[i]);
+  }
+  IOStatus s = hot_set.Write(fs_.get(), dbname_);
+  if (s.ok()) {
+    ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                   "Persisted block cache hot set of %" PRIu64
+                   " blocks in %zu files",
+                   hot_set.NumBlocks(), hot_set.files().size());
+  } else {
+    ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                   "Failed to persist block cache hot set: %s",
+                   s.ToString().c_str());
+  }
+}
+
+void DBImpl::WarmUpBlockCacheFromHotSet() {
+  BlockCacheHotSet hot_set;
+  IOStatus io_s = hot_set.Read(fs_.get(), dbname_);
+  if (!io_s.ok()) {
+    if (!io_s.IsNotFound()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to read block cache hot set: %s",
+                     io_s.ToString().c_str());
+    }
+    return;
+  }
+
+  std::unique_ptr<RateLimiter> rate_limiter;
+  if (immutable_db_options_.block_cache_warmup_bytes_per_sec > 0) {
+    rate_limiter.reset(NewGenericRateLimiter(static_cast<int64_t>(
+        immutable_db_options_.block_cache_warmup_bytes_per_sec)));
+  }
+  uint64_t bytes_read = 0;
+  auto before_read = [&](uint64_t block_size) {
+    if (shutting_down_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    size_t remaining = static_cast<size_t>(block_size);
+    while (rate_limiter && remaining > 0) {
+      remaining -= rate_limiter->RequestToken(remaining, /*alignment=*/0,
+                                              Env::IO_LOW, stats_,
+                                              RateLimiter::OpType::kRead);
+    }
+    bytes_read += block_size;
+    return true;
+  };
+
+  ReadOptions read_options;
+  uint64_t num_files = 0;
+  Status s;
+  // Files are in increasing order of number, roughly by age, and the blocks
+  // of each file in increasing order of offset
+  for (const auto& [file_number, file_blocks] : hot_set.files()) {
+    ColumnFamilyData* cfd = nullptr;
+    Version* version = nullptr;
+    const FileMetaData* meta = nullptr;
+    {
+      InstrumentedMutexLock l(&mutex_);
+      if (shutting_down_.load(std::memory_order_acquire)) {
+        break;
+      }
+      for (auto c : *versions_->GetColumnFamilySet()) {
+        if (c->IsDropped() || !c->initialized()) {
+          continue;
+        }
+        meta = c->current()->storage_info()->GetFileMetaDataByNumber(
+            file_number);
+        if (meta != nullptr && meta->unique_id != file_blocks.unique_id) {
+          // Another file with the same number, e.g. of a recreated DB
+          meta = nullptr;
+          break;
+        }
+        if (meta != nullptr) {
+          cfd = c;
+          version = c->current();
+          version->Ref();
+          break;
+        }
+      }
+    }
+    if (meta == nullptr) {
+      // Compacted away or replaced since
+      continue;
+    }
+    s = cfd->table_cache()->WarmUpBlockCache(
+        read_options, cfd->internal_comparator(), *meta,
+        version->GetMutableCFOptions().block_protection_bytes_per_key,
+        file_blocks.offsets, before_read);
+    {
+      InstrumentedMutexLock l(&mutex_);
+      version->Unref();
+    }
+    if (s.IsIncomplete()) {
+      break;
+    }
+    if (!s.ok() && !s.IsNotSupported()) {
+      ROCKS_LOG_WARN(immutable_db_options_.info_log,
+                     "Failed to warm up block cache from file #%" PRIu64
+                     ": %s",
+                     file_number, s.ToString().c_str());
+    }
+    ++num_files;
+  }
+  ROCKS_LOG_INFO(immutable_db_options_.info_log,
+                 "Block cache warm-up read %" PRIu64 " bytes from %" PRIu64
+                 " files",
+                 bytes_read, num_files);
+}
+
 void DBImpl::PersistStats() {
   TEST_SYNC_POINT("DBImpl::PersistStats:Entry");
   if (shutdown_initiated_) {
@@ -1262,12 +1452,17 @@ Status DBImpl::SetOptions(
   Status s;
   Status persist_options_status;
   SuperVersionContext sv_context(/* create_superversion */ true);
+  bool delete_persistence_changed = false;
   {
     auto db_options = GetDBOptions();
     InstrumentedMutexLock l(&mutex_);
+    const uint64_t old_delete_persistence_seconds =
+        cfd->GetLatestMutableCFOptions()->max_delete_persistence_seconds;
     s = cfd->SetOptions(db_options, options_map);
     if (s.ok()) {
       new_options = *cfd->GetLatestMutableCFOptions();
+      delete_persistence_changed = new_options.max_delete_persistence_seconds !=
+                                   old_delete_persistence_seconds;
       // Append new version to recompute compaction score.
       VersionEdit dummy_edit;
       s = versions_->LogAndApply(cfd, new_options, read_options, write_options,
@@ -1283,6 +1478,12 @@ Status DBImpl::SetOptions(
     }
   }
   sv_context.Clean();
+  if (s.ok() && delete_persistence_changed) {
+    // oldest_tombstone_time is derived from the seqno-to-time mapping, so
+    // start (or stop) recording it along with the option.
+    s = RegisterRecordSeqnoTimeWorker(read_options, write_options,
+                                      /* is_new_db */ false);
+  }
 
   ROCKS_LOG_INFO(
       immutable_db_options_.info_log,
@@ -3459,7 +3660,8 @@ Status DBImpl::WrapUpCreateColumnFamilies(
   bool register_worker = false;
   for (auto* opts_ptr : cf_options) {
     if (opts_ptr->preserve_internal_time_seconds > 0 ||
-        opts_ptr->preclude_last_level_data_seconds > 0) {
+        opts_ptr->preclude_last_level_data_seconds > 0 ||
+        opts_ptr->max_delete_persistence_seconds > 0) {
       register_worker = true;
       break;
     }
@@ -3729,7 +3931,8 @@ Status DBImpl::DropColumnFamilyImpl(ColumnFamilyHandle* column_family) {
   }
 
   if (cfd->ioptions()->preserve_internal_time_seconds > 0 ||
-      cfd->ioptions()->preclude_last_level_data_seconds > 0) {
+      cfd->ioptions()->preclude_last_level_data_seconds > 0 ||
+      cfd->GetLatestMutableCFOptions()->max_delete_persistence_seconds > 0) {
     s = RegisterRecordSeqnoTimeWorker(read_options, write_options,
                                       /* is_new_db */ false);
   }
@@ -6691,6 +6894,28 @@ Status DBImpl::GetCreationTimeOfOldestFile(uint64_t* creation_time) {
   }
 }
 
+void DBImpl::ScheduleDeletePersistenceCompactions() {
+  InstrumentedMutexLock l(&mutex_);
+  for (auto* cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped()) {
+      continue;
+    }
+    const MutableCFOptions& mutable_cf_options =
+        *cfd->GetLatestMutableCFOptions();
+    if (mutable_cf_options.max_delete_persistence_seconds == 0) {
+      continue;
+    }
+    VersionStorageInfo* vstorage = cfd->current()->storage_info();
+    vstorage->ComputeFilesMarkedForDeletePersistence(
+        *cfd->ioptions(), mutable_cf_options.max_delete_persistence_seconds,
+        mutable_cf_options.max_bytes_for_level_multiplier);
+    if (!vstorage->FilesMarkedForDeletePersistence().empty()) {
+      SchedulePendingCompaction(cfd);
+      MaybeScheduleFlushOrCompaction();
+    }
+  }
+}
+
 void DBImpl::RecordSeqnoToTimeMapping(uint64_t populate_historical_seconds) {
   // TECHNICALITY: Sample last sequence number *before* time, as prescribed
   // for SeqnoToTimeMapping. We don't know how long it has been since the last
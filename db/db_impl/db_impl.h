@@ -24,6 +24,7 @@
 #include "db/column_family.h"
 #include "db/compaction/compaction_iterator.h"
 #include "db/compaction/compaction_job.h"
+#include "db/compaction/compaction_memory_limiter.h"
 #include "db/error_handler.h"
 #include "db/event_helpers.h"
 #include "db/external_sst_file_ingestion_job.h"
@@ -1234,6 +1235,9 @@ class DBImpl : public DB {
 
   const PeriodicTaskScheduler& TEST_GetPeriodicTaskScheduler() const;
 
+  // Waits for the block cache warm-up started by DB::Open to finish
+  void TEST_WaitForBlockCacheWarmup();
+
   static Status TEST_ValidateOptions(const DBOptions& db_options) {
     return ValidateOptions(db_options);
   }
@@ -1249,12 +1253,29 @@ class DBImpl : public DB {
   // flush LOG out of application buffer
   void FlushInfoLog();
 
+  // See DBOptions::block_cache_warmup. Starts persisting the block cache hot
+  // set periodically and on close, and loads the hot set of the previous run
+  // into the block cache in the background.
+  Status StartBlockCacheWarmup();
+
+  // write the block cache hot set of the live SST files to the DB directory
+  void PersistBlockCacheHotSet();
+
+  // body of block_cache_warmup_thread_
+  void WarmUpBlockCacheFromHotSet();
+
   // record current sequence number to time mapping. If
   // populate_historical_seconds > 0 then pre-populate all the
   // sequence numbers from [1, last] to map to [now minus
   // populate_historical_seconds, now].
   void RecordSeqnoToTimeMapping(uint64_t populate_historical_seconds);
 
+  // Tombstones pass their max_delete_persistence_seconds deadlines with time,
+  // not with new Versions, so re-mark the files due in each column family and
+  // schedule compactions for them. Run along with RecordSeqnoToTimeMapping(),
+  // which is periodic whenever a deadline is set.
+  void ScheduleDeletePersistenceCompactions();
+
   // Everytime DB's seqno to time mapping changed (which already hold the db
   // mutex), we install a new SuperVersion in each column family with a shared
   // copy of the new mapping while holding the db mutex.
@@ -2247,6 +2268,13 @@ class DBImpl : public DB {
                                const std::vector<CompactionInputFiles>& inputs,
                                bool* sfm_bookkeeping, LogBuffer* log_buffer);
 
+  // Reserves memory for compaction `c` from `compaction_memory_limiter_`,
+  // first lowering its subcompactions and then `*readahead_size` if it does
+  // not fit. Returns false if it does not fit even then, unless `force`.
+  bool ReserveCompactionMemory(Compaction* c, bool force,
+                               std::unique_ptr<CompactionMemoryToken>* token,
+                               size_t* readahead_size, LogBuffer* log_buffer);
+
   // Request compaction tasks token from compaction thread limiter.
   // It always succeeds if force = true or limiter is disable.
   bool RequestCompactionToken(ColumnFamilyData* cfd, bool force,
@@ -2781,6 +2809,9 @@ class DBImpl : public DB {
   // stores the number of flushes are currently running
   int num_running_flushes_;
 
+  // See DBOptions::compaction_memory_limit
+  CompactionMemoryLimiter compaction_memory_limiter_;
+
   // number of background obsolete file purge jobs, submitted to the HIGH pool
   int bg_purge_scheduled_;
 
@@ -2882,6 +2913,14 @@ class DBImpl : public DB {
   // is set a little later during the shutdown after scheduling memtable
   // flushes
   std::atomic<bool> shutdown_initiated_;
+  // Set if the block cache hot set is to be persisted on close. See
+  // DBOptions::block_cache_warmup.
+  bool persist_block_cache_hot_set_ = false;
+  // Serializes PersistBlockCacheHotSet() of the periodic task and of Close(),
+  // which share the temporary file
+  InstrumentedMutex block_cache_hot_set_mutex_;
+  // Loads the previous block cache hot set into the block cache
+  port::Thread block_cache_warmup_thread_;
   // Flag to indicate whether sst_file_manager object was allocated in
   // DB::Open() or passed to us
   bool own_sfm_;
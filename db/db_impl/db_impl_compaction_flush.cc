@@ -61,6 +61,64 @@ bool DBImpl::EnoughRoomForCompaction(
   return enough_room;
 }
 
+bool DBImpl::ReserveCompactionMemory(
+    Compaction* c, bool force, std::unique_ptr<CompactionMemoryToken>* token,
+    size_t* readahead_size, LogBuffer* log_buffer) {
+  assert(*token == nullptr);
+  const size_t file_buffer_size =
+      static_cast<size_t>(mutable_db_options_.writable_file_max_buffer_size);
+  // Each input holds a readahead buffer per asynchronous read, and the one
+  // being read from
+  const size_t readahead_buffers =
+      immutable_db_options_.compaction_async_readahead_depth + 1;
+  uint32_t num_subcompactions = c->max_subcompactions();
+  size_t readahead = *readahead_size;
+  uint64_t bytes;
+  for (;;) {
+    bytes = CompactionMemoryLimiter::EstimateCompactionMemory(
+        *c, num_subcompactions, readahead * readahead_buffers,
+        file_buffer_size);
+    *token = compaction_memory_limiter_.GetToken(
+        bytes, CompactionMemoryLimiter::Admission::kIfFits);
+    if (*token != nullptr) {
+      break;
+    }
+    if (num_subcompactions > 1) {
+      num_subcompactions /= 2;
+    } else if (readahead > CompactionMemoryLimiter::kMinReadaheadSize) {
+      readahead = CompactionMemoryLimiter::kMinReadaheadSize;
+    } else {
+      *token = compaction_memory_limiter_.GetToken(
+          bytes, force ? CompactionMemoryLimiter::Admission::kAlways
+                       : CompactionMemoryLimiter::Admission::kIfFitsOrIdle);
+      break;
+    }
+  }
+  if (*token == nullptr) {
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] Deferred compaction estimated to use %" PRIu64
+                     " bytes, with %" PRIu64 " of %" PRIu64
+                     " bytes of compaction memory in use",
+                     c->column_family_data()->GetName().c_str(), bytes,
+                     compaction_memory_limiter_.GetUsage(),
+                     compaction_memory_limiter_.GetLimit());
+    return false;
+  }
+  if (num_subcompactions < c->max_subcompactions() ||
+      readahead < *readahead_size) {
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] Shrunk compaction to %" PRIu32
+                     " subcompactions and %" ROCKSDB_PRIszt
+                     " bytes of readahead to fit in compaction memory",
+                     c->column_family_data()->GetName().c_str(),
+                     num_subcompactions, readahead);
+    c->set_max_subcompactions(num_subcompactions);
+    *readahead_size = readahead;
+    TEST_SYNC_POINT_CALLBACK("DBImpl::ReserveCompactionMemory:Shrunk", c);
+  }
+  return true;
+}
+
 bool DBImpl::RequestCompactionToken(ColumnFamilyData* cfd, bool force,
                                     std::unique_ptr<TaskLimiterToken>* token,
                                     LogBuffer* log_buffer) {
@@ -281,6 +339,16 @@ Status DBImpl::FlushMemTableToOutputFile(
                      flush_reason);
 
   bool switched_to_mempurge = false;
+  // Flushes are never deferred, but count against compaction_memory_limit
+  std::unique_ptr<CompactionMemoryToken> memory_token;
+  if (s.ok()) {
+    memory_token = compaction_memory_limiter_.GetToken(
+        CompactionMemoryLimiter::EstimateFlushMemory(
+            flush_job.GetMemTables(),
+            static_cast<size_t>(
+                mutable_db_options_.writable_file_max_buffer_size)),
+        CompactionMemoryLimiter::Admission::kAlways);
+  }
   // Within flush_job.Run, rocksdb may call event listener to notify
   // file creation and deletion.
   //
@@ -374,6 +442,11 @@ Status DBImpl::FlushMemTableToOutputFile(
       // exists. Otherwise, some tests may fail.  Ignore the error in the
       // interim.
       sfm->OnAddFile(file_path).PermitUncheckedError();
+      for (const FileMetaData& meta : flush_job.GetPartitionFileMetas()) {
+        sfm->OnAddFile(MakeTableFileName(cfd->ioptions()->cf_paths[0].path,
+                                         meta.fd.GetNumber()))
+            .PermitUncheckedError();
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error =
             Status::SpaceLimit("Max allowed space was reached");
@@ -570,6 +643,20 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
     }
   }
 
+  // Flushes are never deferred, but count against compaction_memory_limit
+  std::unique_ptr<CompactionMemoryToken> memory_token;
+  if (s.ok()) {
+    uint64_t bytes = 0;
+    for (int i = 0; i != num_cfs; ++i) {
+      bytes += CompactionMemoryLimiter::EstimateFlushMemory(
+          jobs[i]->GetMemTables(),
+          static_cast<size_t>(
+              mutable_db_options_.writable_file_max_buffer_size));
+    }
+    memory_token = compaction_memory_limiter_.GetToken(
+        bytes, CompactionMemoryLimiter::Admission::kAlways);
+  }
+
   if (s.ok()) {
     assert(switched_to_mempurge.size() ==
            static_cast<long unsigned int>(num_cfs));
@@ -650,6 +737,7 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         auto& mems = jobs[i]->GetMemTables();
         cfds[i]->imm()->RollbackMemtableFlush(
             mems, /*rollback_succeeding_memtables=*/false);
+        jobs[i]->ReleaseL0KeyFilterSlot();
       }
     }
   }
@@ -747,6 +835,7 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         auto& mems = jobs[i]->GetMemTables();
         cfds[i]->imm()->RollbackMemtableFlush(
             mems, /*rollback_succeeding_memtables=*/false);
+        jobs[i]->ReleaseL0KeyFilterSlot();
       }
     }
   }
@@ -839,6 +928,12 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         // exists. Otherwise, some tests may fail.  Ignore the error in the
         // interim.
         sfm->OnAddFile(file_path).PermitUncheckedError();
+        for (const FileMetaData& meta : jobs[i]->GetPartitionFileMetas()) {
+          sfm->OnAddFile(
+                 MakeTableFileName(cfds[i]->ioptions()->cf_paths[0].path,
+                                   meta.fd.GetNumber()))
+              .PermitUncheckedError();
+        }
         if (sfm->IsMaxAllowedSpaceReached() &&
             error_handler_.GetBGError().ok()) {
           Status new_bg_error =
@@ -3580,6 +3675,8 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   TEST_SYNC_POINT("DBImpl::BackgroundCompaction:InProgress");
 
   std::unique_ptr<TaskLimiterToken> task_token;
+  std::unique_ptr<CompactionMemoryToken> memory_token;
+  FileOptions compaction_file_options = file_options_for_compaction_;
 
   bool sfm_reserved_compact_space = false;
   if (is_manual) {
@@ -3871,6 +3968,28 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     assert(c == nullptr);
     env_->Schedule(&DBImpl::BGWorkBottomCompaction, ca, Env::Priority::BOTTOM,
                    this, &DBImpl::UnscheduleCompactionCallback);
+  } else if (!ReserveCompactionMemory(
+                 c.get(), /*force=*/is_manual || is_prepicked, &memory_token,
+                 &compaction_file_options.compaction_readahead_size,
+                 log_buffer)) {
+    // Stay in the compaction queue until running jobs release memory, like
+    // compactions throttled by the compaction thread limiter
+    TEST_SYNC_POINT("DBImpl::BackgroundCompaction:DeferredForMemory");
+    auto cfd = c->column_family_data();
+    c->ReleaseCompactionFiles(status);
+    cfd->current()->storage_info()->ComputeCompactionScore(
+        *(c->immutable_options()), *(c->mutable_cf_options()));
+    if (!cfd->queued_for_compaction()) {
+      AddToCompactionQueue(cfd);
+      ++unscheduled_compactions_;
+    }
+    auto sfm = static_cast<SstFileManagerImpl*>(
+        immutable_db_options_.sst_file_manager.get());
+    if (sfm && sfm_reserved_compact_space) {
+      sfm->OnCompactionCompletion(c.get());
+    }
+    c.reset();
+    status = Status::Busy();
   } else {
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:BeforeCompaction",
                              c->column_family_data());
@@ -3887,7 +4006,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
 
     CompactionJob compaction_job(
         job_context->job_id, c.get(), immutable_db_options_,
-        mutable_db_options_, file_options_for_compaction_, versions_.get(),
+        mutable_db_options_, compaction_file_options, versions_.get(),
         &shutting_down_, log_buffer, directories_.GetDbDir(),
         GetDataDir(c->column_family_data(), c->output_path_id()),
         GetDataDir(c->column_family_data(), 0), stats_, &mutex_,
@@ -3963,7 +4082,7 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
   }
 
   if (status.ok() || status.IsCompactionTooLarge() ||
-      status.IsManualCompactionPaused()) {
+      status.IsManualCompactionPaused() || status.IsBusy()) {
     // Done
   } else if (status.IsColumnFamilyDropped() || status.IsShutdownInProgress()) {
     // Ignore compaction errors found during shutting down
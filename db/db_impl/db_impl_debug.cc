@@ -304,6 +304,12 @@ const PeriodicTaskScheduler& DBImpl::TEST_GetPeriodicTaskScheduler() const {
   return periodic_task_scheduler_;
 }
 
+void DBImpl::TEST_WaitForBlockCacheWarmup() {
+  if (block_cache_warmup_thread_.joinable()) {
+    block_cache_warmup_thread_.join();
+  }
+}
+
 SeqnoToTimeMapping DBImpl::TEST_GetSeqnoToTimeMapping() const {
   InstrumentedMutexLock l(&mutex_);
   return seqno_to_time_mapping_;
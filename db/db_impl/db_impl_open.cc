@@ -2329,6 +2329,9 @@ Status DBImpl::Open(const DBOptions& db_options, const std::string& dbname,
     s = impl->RegisterRecordSeqnoTimeWorker(read_options, write_options,
                                             recovery_ctx.is_new_db_);
   }
+  if (s.ok()) {
+    s = impl->StartBlockCacheWarmup();
+  }
   impl->options_mutex_.Unlock();
   if (!s.ok()) {
     for (auto* h : *handles) {
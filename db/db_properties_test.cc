@@ -356,6 +356,111 @@ TEST_F(DBPropertiesTest, ValidateSampleNumber) {
   ASSERT_EQ("50", num);
 }
 
+TEST_F(DBPropertiesTest, CompactionHeat) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.compaction_pri = kReadHotOverlappingRatio;
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_OK(Put(Key(i), "value"));
+  }
+  ASSERT_OK(Flush());
+  // One in 1024 file reads is sampled
+  for (int i = 0; i < 20000; i++) {
+    ASSERT_EQ("value", Get(Key(i % 100)));
+  }
+
+  std::string heat;
+  ASSERT_TRUE(db_->GetProperty(DB::Properties::kCompactionHeat, &heat));
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_EQ(files.size(), 1);
+  ASSERT_GT(files[0].num_reads_sampled, 0);
+
+  // The line of L0 is the third one
+  std::vector<std::string> lines = StringSplit(heat, '\n');
+  ASSERT_GT(lines.size(), 3);
+  int level = -1;
+  int num_files = 0;
+  double size_mb = 0;
+  uint64_t reads = 0;
+  ASSERT_EQ(4, sscanf(lines[2].c_str(), "%d %d %lf %" SCNu64, &level,
+                      &num_files, &size_mb, &reads));
+  ASSERT_EQ(0, level);
+  ASSERT_EQ(1, num_files);
+  ASSERT_EQ(files[0].num_reads_sampled, reads);
+}
+
+TEST_F(DBPropertiesTest, CompactionStageStats) {
+  class CompactionStatsListener : public EventListener {
+   public:
+    void OnCompactionCompleted(DB* /*db*/,
+                               const CompactionJobInfo& ci) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_ = ci.stats;
+    }
+    CompactionJobStats GetStats() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return stats_;
+    }
+
+   private:
+    std::mutex mutex_;
+    CompactionJobStats stats_;
+  };
+
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.report_bg_io_stats = true;
+  options.compression = kNoCompression;
+  auto listener = std::make_shared<CompactionStatsListener>();
+  options.listeners.push_back(listener);
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  table_options.block_size = 1024;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  std::string stage_stats;
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kCompactionStageStats, &stage_stats));
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 0; i < 1000; i += 2) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'w')));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  CompactionJobStats stats = listener->GetStats();
+  ASSERT_GT(stats.file_read_nanos, 0);
+  ASSERT_GT(stats.block_compress_nanos, 0);
+  ASSERT_GT(stats.filter_build_nanos, 0);
+  ASSERT_GT(stats.index_build_nanos, 0);
+  ASSERT_GT(stats.file_write_nanos, 0);
+  // No merge operator or compaction filter
+  ASSERT_EQ(stats.merge_operator_nanos, 0);
+  ASSERT_EQ(stats.compaction_filter_nanos, 0);
+
+  // A line per level and one for the sum, in seconds
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kCompactionStageStats, &stage_stats));
+  std::vector<std::string> lines = StringSplit(stage_stats, '\n');
+  ASSERT_EQ(lines.size(), 2 + options.num_levels + 1);
+  char level[8];
+  double seconds[9];
+  ASSERT_EQ(10, sscanf(lines[2].c_str(),
+                       "%7s %lf %lf %lf %lf %lf %lf %lf %lf %lf", level,
+                       &seconds[0], &seconds[1], &seconds[2], &seconds[3],
+                       &seconds[4], &seconds[5], &seconds[6], &seconds[7],
+                       &seconds[8]));
+  ASSERT_EQ(std::string("L0"), level);
+  ASSERT_EQ(1, sscanf(lines.back().c_str(), "%7s", level));
+  ASSERT_EQ(std::string("Sum"), level);
+}
+
 TEST_F(DBPropertiesTest, AggregatedTableProperties) {
   for (int kTableCount = 40; kTableCount <= 100; kTableCount += 30) {
     const int kDeletionsPerTable = 0;
@@ -2139,10 +2244,14 @@ TEST_F(DBPropertiesTest, GetMapPropertyBlockCacheEntryStats) {
                 values.end());
     ASSERT_TRUE(values.find(BlockCacheEntryStatsMapKeys::UsedPercent(role)) !=
                 values.end());
+    ASSERT_TRUE(values.find(BlockCacheEntryStatsMapKeys::AdmittedCount(
+                    role)) != values.end());
+    ASSERT_TRUE(values.find(BlockCacheEntryStatsMapKeys::RejectedCount(
+                    role)) != values.end());
   }
 
   // There should be no extra values in the map.
-  ASSERT_EQ(3 * kNumCacheEntryRoles + 4, values.size());
+  ASSERT_EQ(5 * kNumCacheEntryRoles + 4, values.size());
 }
 
 TEST_F(DBPropertiesTest, WriteStallStatsSanityCheck) {
@@ -3825,6 +3825,259 @@ TEST_F(DBRangeDelTest, RowCache) {
   // and should not turn db into read-only mdoe.
   ASSERT_OK(Put(Key(5), "foo"));
 }
+
+namespace {
+class RangeDeletedInputsListener : public EventListener {
+ public:
+  void OnCompactionCompleted(DB* /*db*/, const CompactionJobInfo& ci) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_range_deleted_input_files += ci.stats.num_range_deleted_input_files;
+    range_deleted_input_bytes += ci.stats.range_deleted_input_bytes;
+  }
+
+  std::mutex mutex_;
+  size_t num_range_deleted_input_files = 0;
+  uint64_t range_deleted_input_bytes = 0;
+};
+}  // anonymous namespace
+
+TEST_F(DBRangeDelTest, CompactionDropsRangeDeletedInputsWithoutReading) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 4 << 10;
+  auto listener = std::make_shared<RangeDeletedInputsListener>();
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  // Non-overlapping files, moved down as they are
+  Random rnd(301);
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    if (i % 40 == 39) {
+      ASSERT_OK(Flush());
+    }
+  }
+  MoveFilesToLevel(2);
+  const int num_l2_files = NumTableFilesAtLevel(2);
+  ASSERT_GT(num_l2_files, 2);
+
+  // Deletes all but the first and last few keys, which keeps the files at
+  // both ends partially live. The key outside the L2 range prevents a
+  // trivial move.
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(5), Key(195)));
+  ASSERT_OK(Put(Key(300), "val"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+
+  ASSERT_OK(dbfull()->TEST_CompactRange(1, nullptr, nullptr));
+
+  ASSERT_EQ(NumTableFilesAtLevel(1), 0);
+  {
+    std::lock_guard<std::mutex> lock(listener->mutex_);
+    ASSERT_EQ(listener->num_range_deleted_input_files,
+              static_cast<size_t>(num_l2_files - 2));
+    ASSERT_GT(listener->range_deleted_input_bytes, 0);
+  }
+  for (int i = 0; i < 200; ++i) {
+    bool live = i < 5 || i >= 195;
+    ASSERT_EQ(Get(Key(i)) != "NOT_FOUND", live) << i;
+    // The deleted data is gone, whether dropped with its file or by the
+    // compaction iterator.
+    std::string value;
+    ReadOptions read_opts;
+    read_opts.ignore_range_deletions = true;
+    Status s = db_->Get(read_opts, Key(i), &value);
+    ASSERT_EQ(s.ok(), live) << i;
+  }
+}
+
+TEST_F(DBRangeDelTest, CompactionKeepsRangeDeletedInputsForSnapshot) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.target_file_size_base = 4 << 10;
+  auto listener = std::make_shared<RangeDeletedInputsListener>();
+  options.listeners.push_back(listener);
+  DestroyAndReopen(options);
+
+  // Non-overlapping files, moved down as they are
+  Random rnd(301);
+  for (int i = 0; i < 200; ++i) {
+    ASSERT_OK(Put(Key(i), rnd.RandomString(100)));
+    if (i % 40 == 39) {
+      ASSERT_OK(Flush());
+    }
+  }
+  MoveFilesToLevel(2);
+  ASSERT_GT(NumTableFilesAtLevel(2), 2);
+
+  // The snapshot still sees the data under the tombstone.
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(200)));
+  ASSERT_OK(Put(Key(300), "val"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_OK(dbfull()->TEST_CompactRange(1, nullptr, nullptr));
+  {
+    std::lock_guard<std::mutex> lock(listener->mutex_);
+    ASSERT_EQ(listener->num_range_deleted_input_files, 0);
+  }
+
+  ReadOptions read_opts;
+  read_opts.snapshot = snapshot;
+  for (int i = 0; i < 200; ++i) {
+    std::string value;
+    ASSERT_OK(db_->Get(read_opts, Key(i), &value));
+    ASSERT_EQ(Get(Key(i)), "NOT_FOUND");
+  }
+  db_->ReleaseSnapshot(snapshot);
+}
+
+TEST_F(DBRangeDelTest, RangeTombstoneIndexMatchesIterator) {
+  // Point lookups answered through the Version's range tombstone index must
+  // agree with iterators, which always read each file's tombstones.
+  Options options = CurrentOptions();
+  options.range_tombstone_index_min_tombstones = 1;
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  options.disable_auto_compactions = true;
+  options.num_levels = 4;
+  // Small files so that compaction truncates tombstones at file boundaries.
+  options.target_file_size_base = 2 << 10;
+  DestroyAndReopen(options);
+
+  Random rnd(301);
+  const int kNumKeys = 200;
+  std::vector<const Snapshot*> snapshots;
+  for (int round = 0; round < 13; ++round) {
+    for (int i = 0; i < 60; ++i) {
+      int k = rnd.Uniform(kNumKeys);
+      if (rnd.OneIn(3)) {
+        ASSERT_OK(db_->Merge(WriteOptions(), Key(k), rnd.RandomString(8)));
+      } else {
+        ASSERT_OK(Put(Key(k), rnd.RandomString(100)));
+      }
+    }
+    for (int i = 0; i < 4; ++i) {
+      int begin = rnd.Uniform(kNumKeys);
+      ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                                 Key(begin),
+                                 Key(begin + 1 + rnd.Uniform(20))));
+    }
+    if (round % 3 == 0) {
+      snapshots.push_back(db_->GetSnapshot());
+    }
+    ASSERT_OK(Flush());
+    if (round % 4 == 3) {
+      MoveFilesToLevel(3 - round / 4);
+    }
+  }
+  ASSERT_GT(NumTableFilesAtLevel(0), 0);
+  ASSERT_GT(NumTableFilesAtLevel(1), 0);
+  ASSERT_GT(NumTableFilesAtLevel(3), 1);
+
+  snapshots.push_back(nullptr);
+  for (const Snapshot* snapshot : snapshots) {
+    ReadOptions read_opts;
+    read_opts.snapshot = snapshot;
+    std::map<std::string, std::string> expected;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_opts));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      expected[iter->key().ToString()] = iter->value().ToString();
+    }
+    ASSERT_OK(iter->status());
+
+    std::vector<std::string> key_strs;
+    for (int k = 0; k < kNumKeys + 20; ++k) {
+      key_strs.push_back(Key(k));
+      std::string value;
+      Status s = db_->Get(read_opts, Key(k), &value);
+      auto it = expected.find(Key(k));
+      if (it == expected.end()) {
+        ASSERT_TRUE(s.IsNotFound()) << Key(k);
+      } else {
+        ASSERT_OK(s);
+        ASSERT_EQ(value, it->second) << Key(k);
+      }
+    }
+    std::vector<Slice> keys(key_strs.begin(), key_strs.end());
+    std::vector<PinnableSlice> values(keys.size());
+    std::vector<Status> statuses(keys.size());
+    db_->MultiGet(read_opts, db_->DefaultColumnFamily(), keys.size(),
+                  keys.data(), values.data(), statuses.data());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      auto it = expected.find(key_strs[i]);
+      if (it == expected.end()) {
+        ASSERT_TRUE(statuses[i].IsNotFound()) << key_strs[i];
+      } else {
+        ASSERT_OK(statuses[i]);
+        ASSERT_EQ(values[i], it->second) << key_strs[i];
+      }
+    }
+  }
+  for (const Snapshot* snapshot : snapshots) {
+    if (snapshot != nullptr) {
+      db_->ReleaseSnapshot(snapshot);
+    }
+  }
+}
+
+TEST_F(DBRangeDelTest, RangeTombstoneIndexAppliesAtTombstoneLevel) {
+  Options options = CurrentOptions();
+  options.range_tombstone_index_min_tombstones = 1;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put(Key(1), "old"));
+  ASSERT_OK(Put(Key(2), "old"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(0), Key(10)));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  // Newer than the tombstone, in a level above it.
+  ASSERT_OK(Put(Key(2), "new"));
+  ASSERT_OK(Flush());
+
+  ASSERT_EQ(Get(Key(1)), "NOT_FOUND");
+  ASSERT_EQ(Get(Key(2)), "new");
+  ASSERT_EQ(Get(Key(3)), "NOT_FOUND");
+  ASSERT_EQ(MultiGet({Key(1), Key(2), Key(3)}),
+            std::vector<std::string>({"NOT_FOUND", "new", "NOT_FOUND"}));
+
+  // The index is immutable, but every new version builds its own.
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(),
+                             Key(2), Key(3)));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(Get(Key(2)), "NOT_FOUND");
+}
+
+TEST_F(DBRangeDelTest, RangeTombstoneIndexAppliesAtTombstoneL0File) {
+  Options options = CurrentOptions();
+  options.range_tombstone_index_min_tombstones = 1;
+  options.disable_auto_compactions = true;
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("a", "old"));
+  ASSERT_OK(Put("z", "old"));
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "zz"));
+  ASSERT_OK(Flush());
+  // Newer than the tombstone, in an L0 file searched after a newer one
+  // without the key
+  ASSERT_OK(Put("k", "new"));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("a", "new"));
+  ASSERT_OK(Put("z", "new"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(NumTableFilesAtLevel(0), 3);
+
+  ASSERT_EQ(Get("k"), "new");
+  ASSERT_EQ(Get("b"), "NOT_FOUND");
+  ASSERT_EQ(MultiGet({"a", "b", "k"}),
+            std::vector<std::string>({"new", "NOT_FOUND", "new"}));
+}
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
@@ -5,9 +5,11 @@
 
 #include "rocksdb/experimental.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +17,8 @@
 #include "db/db_impl/db_impl.h"
 #include "db/version_util.h"
 #include "logging/logging.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
 #include "util/atomic.h"
 
 namespace ROCKSDB_NAMESPACE::experimental {
@@ -372,6 +376,12 @@ enum BuiltinSstQueryFilters : char {
   // and filtered independently because it might be a special case that is
   // not representative of the minimum in a spread of values.
   kBytewiseMinMaxFilter = 0x10,
+
+  // A filter of the whole keys of a file for range queries, storing the
+  // shortest prefix of each key that distinguishes it from the other keys,
+  // plus some more bytes of the key, as the keys of a (prefix-compressed)
+  // meta block.
+  kWholeKeyRangeFilter = 0x11,
 };
 
 class SstQueryFilterBuilder {
@@ -639,6 +649,193 @@ class BytewiseMinMaxSstQueryFilterConfig : public SstQueryFilterConfigImpl {
   static constexpr char kEmptySeenFlag = 0x1;
 };
 
+class WholeKeyRangeSstQueryFilterConfig : public SstQueryFilterConfigImpl {
+ public:
+  WholeKeyRangeSstQueryFilterConfig(
+      uint32_t suffix_bytes,
+      const KeySegmentsExtractor::KeyCategorySet& categories,
+      size_t max_prefixes)
+      : SstQueryFilterConfigImpl(SelectWholeKey{}, categories),
+        suffix_bytes_(suffix_bytes),
+        max_prefixes_(std::max(max_prefixes, size_t{1})) {}
+
+  std::unique_ptr<SstQueryFilterBuilder> NewBuilder(
+      bool sanity_checks) const override {
+    auto b = std::make_unique<MyBuilder>(*this, sanity_checks);
+    if (categories_ != KeySegmentsExtractor::KeyCategorySet::All()) {
+      return std::make_unique<CategoryScopeFilterWrapperBuilder>(categories_,
+                                                                 std::move(b));
+    } else {
+      return b;
+    }
+  }
+
+  static bool RangeMayMatch(const Slice& filter, const Slice& lower_bound_incl,
+                            const Slice& upper_bound_excl) {
+    assert(!filter.empty() && filter[0] == kWholeKeyRangeFilter);
+    BlockContents contents(Slice(filter.data() + 1, filter.size() - 1));
+    Block block(std::move(contents));
+    std::unique_ptr<MetaBlockIter> iter(block.NewMetaIterator());
+    // A key in range has its stored prefix either in range too, or before
+    // the lower bound as a prefix of it. Such a prefix is the last one
+    // before the lower bound, as stored prefixes of other keys cannot
+    // extend it.
+    iter->Seek(lower_bound_incl);
+    if (iter->Valid()) {
+      if (iter->key().compare(upper_bound_excl) < 0) {
+        return true;
+      }
+      iter->Prev();
+    } else if (iter->status().ok()) {
+      iter->SeekToLast();
+    }
+    if (!iter->status().ok()) {
+      // Corrupt
+      return true;
+    }
+    return iter->Valid() && lower_bound_incl.starts_with(iter->key());
+  }
+
+ protected:
+  struct MyBuilder : public SstQueryFilterBuilder {
+    MyBuilder(const WholeKeyRangeSstQueryFilterConfig& _parent,
+              bool _sanity_checks)
+        : parent(_parent), sanity_checks(_sanity_checks) {}
+
+    void Add(const Slice& key, const KeySegmentsExtractor::Result& /*extracted*/,
+             const Slice* /*prev_key*/,
+             const KeySegmentsExtractor::Result* /*prev_extracted*/) override {
+      assert(encoded.empty());
+      if (!status.ok()) {
+        return;
+      }
+      if (has_last_key) {
+        int compare = key.compare(last_key);
+        if (compare == 0) {
+          // Another entry of the same key
+          return;
+        }
+        if (compare < 0) {
+          if (sanity_checks) {
+            status = Status::Corruption(
+                "Ordering invariant violated from 0x" +
+                Slice(last_key).ToString(/*hex=*/true) + " to 0x" +
+                key.ToString(/*hex=*/true));
+          }
+          return;
+        }
+        // The last key is distinguished from both its neighbors now
+        size_t shared = Slice(last_key).difference_offset(key);
+        AddLastKeyPrefix(std::max(last_key_shared, shared));
+        last_key_shared = shared;
+      }
+      last_key.assign(key.data(), key.size());
+      has_last_key = true;
+    }
+
+    Status GetStatus() const override { return status; }
+
+    size_t GetEncodedLength() const override {
+      if (!has_last_key) {
+        // Not an interesting filter -> 0 to indicate no filter
+        return 0;
+      }
+      return 1 + Encoded().size();
+    }
+
+    void Finish(std::string& append_to) override {
+      assert(status.ok());
+      if (!has_last_key) {
+        // Nothing to do
+        return;
+      }
+      append_to.push_back(kWholeKeyRangeFilter);
+      append_to.append(Encoded());
+    }
+
+    // Adds the prefix of the last key distinguishing it from keys sharing
+    // `shared` bytes with it
+    void AddLastKeyPrefix(size_t shared) const {
+      size_t len = std::min({last_key.size(), max_prefix_len,
+                             shared + 1 + parent.suffix_bytes_});
+      AddPrefix(Slice(last_key.data(), len));
+      if (prefixes.size() >= 2 * parent.max_prefixes_) {
+        ShortenPrefixes();
+      }
+    }
+
+    // Appends a prefix of keys after those of the stored prefixes, keeping
+    // the stored prefixes sorted and none of them a prefix of another
+    void AddPrefix(const Slice& prefix) const {
+      if (!prefixes.empty() && prefix.starts_with(prefixes.back())) {
+        // Already covered
+        return;
+      }
+      while (!prefixes.empty() && Slice(prefixes.back()).starts_with(prefix)) {
+        prefixes.pop_back();
+      }
+      prefixes.emplace_back(prefix.data(), prefix.size());
+    }
+
+    // Truncates the stored prefixes to the longest length leaving at most
+    // max_prefixes_ of them. Two adjacent prefixes become one when truncated
+    // to no more than the bytes they share, so the length is the
+    // max_prefixes_-th smallest number of bytes shared by adjacent prefixes.
+    void ShortenPrefixes() const {
+      std::vector<size_t> shared(prefixes.size() - 1);
+      for (size_t i = 1; i < prefixes.size(); ++i) {
+        shared[i - 1] = Slice(prefixes[i - 1]).difference_offset(prefixes[i]);
+      }
+      auto nth = shared.begin() + (parent.max_prefixes_ - 1);
+      std::nth_element(shared.begin(), nth, shared.end());
+      max_prefix_len = *nth;
+      std::vector<std::string> old_prefixes;
+      old_prefixes.swap(prefixes);
+      for (const auto& prefix : old_prefixes) {
+        AddPrefix(
+            Slice(prefix.data(), std::min(prefix.size(), max_prefix_len)));
+      }
+      assert(prefixes.size() <= parent.max_prefixes_);
+    }
+
+    const std::string& Encoded() const {
+      if (encoded.empty()) {
+        AddLastKeyPrefix(last_key_shared);
+        if (prefixes.size() > parent.max_prefixes_) {
+          ShortenPrefixes();
+        }
+        BlockBuilder block_builder(kRestartInterval);
+        for (const auto& prefix : prefixes) {
+          block_builder.Add(prefix, Slice());
+        }
+        encoded = block_builder.Finish().ToString();
+      }
+      return encoded;
+    }
+
+    static constexpr int kRestartInterval = 16;
+
+    const WholeKeyRangeSstQueryFilterConfig& parent;
+    const bool sanity_checks;
+    // The prefixes before the last key, and all of them once encoded. Sorted
+    // and bounded by 2 * max_prefixes_ while building.
+    mutable std::vector<std::string> prefixes;
+    // Length of the stored prefixes, reduced to bound their number
+    mutable size_t max_prefix_len = std::numeric_limits<size_t>::max();
+    mutable std::string encoded;
+    std::string last_key;
+    // Bytes the last key shares with the key before it
+    size_t last_key_shared = 0;
+    bool has_last_key = false;
+
+    Status status;
+  };
+
+ private:
+  const uint32_t suffix_bytes_;
+  const size_t max_prefixes_;
+};
+
 const SstQueryFilterConfigs kEmptyNotFoundSQFC{};
 
 class SstQueryFilterConfigsManagerImpl : public SstQueryFilterConfigsManager {
@@ -1045,6 +1242,10 @@ class SstQueryFilterConfigsManagerImpl : public SstQueryFilterConfigsManager {
                 filter, lower_bound_incl, state->lb_extracted, upper_bound_excl,
                 state->ub_extracted);
             break;
+          case kWholeKeyRangeFilter:
+            may_match = WholeKeyRangeSstQueryFilterConfig::RangeMayMatch(
+                filter, lower_bound_incl, upper_bound_excl);
+            break;
           default:
             // TODO? Report problem
             {}
@@ -1199,6 +1400,13 @@ std::shared_ptr<SstQueryFilterConfig> MakeSharedBytewiseMinMaxSQFC(
                                                               categories);
 }
 
+std::shared_ptr<SstQueryFilterConfig> MakeSharedWholeKeyRangeSQFC(
+    uint32_t suffix_bytes, KeySegmentsExtractor::KeyCategorySet categories,
+    size_t max_prefixes) {
+  return std::make_shared<WholeKeyRangeSstQueryFilterConfig>(
+      suffix_bytes, categories, max_prefixes);
+}
+
 Status SstQueryFilterConfigsManager::MakeShared(
     const Data& data, std::shared_ptr<SstQueryFilterConfigsManager>* out) {
   auto obj = std::make_shared<SstQueryFilterConfigsManagerImpl>();
@@ -39,6 +39,8 @@ TEST_F(FileNameTest, Parse) {
       {"0.sst", 0, kTableFile, kAllMode},
       {"CURRENT", 0, kCurrentFile, kAllMode},
       {"LOCK", 0, kDBLockFile, kAllMode},
+      {"BLOCK_CACHE_HOT_SET", 0, kBlockCacheHotSetFile, kAllMode},
+      {"BLOCK_CACHE_HOT_SET.dbtmp", 0, kBlockCacheHotSetFile, kAllMode},
       {"MANIFEST-2", 2, kDescriptorFile, kAllMode},
       {"MANIFEST-7", 7, kDescriptorFile, kAllMode},
       {"METADB-2", 2, kMetaDatabase, kAllMode},
@@ -91,6 +93,8 @@ TEST_F(FileNameTest, Parse) {
                                  "LOCKx",
                                  "LO",
                                  "LOGx",
+                                 "BLOCK_CACHE_HOT_SETx",
+                                 "BLOCK_CACHE_HOT_SET.tmp",
                                  "18446744073709551616.log",
                                  "184467440737095516150.log",
                                  "100",
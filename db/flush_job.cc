@@ -11,12 +11,15 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <unordered_set>
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/clipping_iterator.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
+#include "db/l0_key_filter.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
 #include "db/memtable.h"
@@ -36,6 +39,7 @@
 #include "port/port.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
@@ -312,6 +316,7 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
   if (!s.ok()) {
     cfd_->imm()->RollbackMemtableFlush(
         mems_, /*rollback_succeeding_memtables=*/!db_options_.atomic_flush);
+    ReleaseL0KeyFilterSlot();
   } else if (write_manifest_) {
     assert(!db_options_.atomic_flush);
     if (!db_options_.atomic_flush &&
@@ -321,6 +326,7 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
         error_handler->IsBGWorkStopped()) {
       cfd_->imm()->RollbackMemtableFlush(
           mems_, /*rollback_succeeding_memtables=*/!db_options_.atomic_flush);
+      ReleaseL0KeyFilterSlot();
       s = error_handler->GetBGError();
       if (skipped_since_bg_error) {
         *skipped_since_bg_error = true;
@@ -338,6 +344,12 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
     }
   }
 
+  if (output_level_ > 0) {
+    // The file is installed or rolled back
+    cfd_->compaction_picker()->UnregisterPendingFlushOutput(
+        meta_.fd.GetNumber());
+  }
+
   if (s.ok() && file_meta != nullptr) {
     *file_meta = meta_;
   }
@@ -382,6 +394,11 @@ Status FlushJob::Run(LogsWithPrepTracker* prep_tracker, FileMetaData* file_meta,
            << (IOSTATS(cpu_write_nanos) - prev_cpu_write_nanos);
     stream << "file_cpu_read_nanos"
            << (IOSTATS(cpu_read_nanos) - prev_cpu_read_nanos);
+    stream << "file_read_nanos" << stage_stats_.file_read_nanos;
+    stream << "merge_operator_nanos" << stage_stats_.merge_operator_nanos;
+    stream << "block_compress_nanos" << stage_stats_.block_compress_nanos;
+    stream << "filter_build_nanos" << stage_stats_.filter_build_nanos;
+    stream << "index_build_nanos" << stage_stats_.index_build_nanos;
   }
 
   TEST_SYNC_POINT("FlushJob::End");
@@ -847,6 +864,133 @@ bool FlushJob::MemPurgeDecider(double threshold) {
           threshold);
 }
 
+void FlushJob::PickPartitionBoundaries(uint64_t total_data_size,
+                                       uint64_t total_num_entries,
+                                       std::vector<std::string>* boundaries) {
+  // Sampled keys per key range
+  constexpr uint64_t kSamplesPerPartition = 64;
+  // Keys looked at to move a boundary to a cut of the SstPartitioner
+  constexpr int kMaxPartitionerSteps = 256;
+
+  const ImmutableOptions& ioptions = *cfd_->ioptions();
+  const Comparator* ucmp = cfd_->user_comparator();
+  const uint64_t num_partitions = std::min(
+      static_cast<uint64_t>(std::max(ioptions.max_flush_partitions, 1)),
+      total_data_size /
+          std::max(mutable_cf_options_.target_file_size_base, uint64_t{1}));
+  if (num_partitions < 2 || total_num_entries == 0 ||
+      mutable_cf_options_.enable_blob_files || ucmp->timestamp_size() > 0 ||
+      !ioptions.memtable_factory->IsInstanceOf(
+          SkipListFactory::kClassName())) {
+    return;
+  }
+
+  // Sample each memtable in proportion to its entries
+  std::vector<std::string> samples;
+  for (MemTable* m : mems_) {
+    const uint64_t num_entries = m->num_entries();
+    if (num_entries == 0) {
+      continue;
+    }
+    const uint64_t target_sample_size =
+        std::min(num_entries,
+                 std::max(kSamplesPerPartition * num_partitions * num_entries /
+                              total_num_entries,
+                          uint64_t{1}));
+    std::unordered_set<const char*> entries;
+    m->UniqueRandomSample(target_sample_size, &entries);
+    for (const char* entry : entries) {
+      samples.push_back(
+          ExtractUserKey(GetLengthPrefixedSlice(entry)).ToString());
+    }
+  }
+  if (samples.empty()) {
+    return;
+  }
+  std::sort(samples.begin(), samples.end(),
+            [ucmp](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  for (uint64_t i = 1; i < num_partitions; ++i) {
+    const std::string& key = samples[i * samples.size() / num_partitions];
+    if (ucmp->Compare(key, boundaries->empty() ? samples.front()
+                                               : boundaries->back()) > 0) {
+      boundaries->push_back(key);
+    }
+  }
+
+  if (ioptions.sst_partitioner_factory == nullptr || boundaries->empty()) {
+    return;
+  }
+  // Move each boundary to the next key where the partitioner cuts, so that
+  // the files are split as compaction would split them
+  SstPartitioner::Context context;
+  context.is_full_compaction = false;
+  context.is_manual_compaction = false;
+  context.output_level = 0;
+  context.smallest_user_key = samples.front();
+  context.largest_user_key = samples.back();
+  std::unique_ptr<SstPartitioner> partitioner =
+      ioptions.sst_partitioner_factory->CreatePartitioner(context);
+  ReadOptions ro;
+  ro.total_order_seek = true;
+  ro.io_activity = Env::IOActivity::kFlush;
+  Arena arena;
+  std::vector<InternalIterator*> memtables;
+  for (MemTable* m : mems_) {
+    memtables.push_back(
+        m->NewIterator(ro, /*seqno_to_time_mapping=*/nullptr, &arena));
+  }
+  ScopedArenaPtr<InternalIterator> iter(
+      NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
+                         static_cast<int>(memtables.size()), &arena));
+  std::vector<std::string> cuts;
+  for (const std::string& boundary : *boundaries) {
+    if (!cuts.empty() && ucmp->Compare(boundary, cuts.back()) <= 0) {
+      continue;
+    }
+    InternalKey seek_key(boundary, kMaxSequenceNumber, kValueTypeForSeek);
+    iter->Seek(seek_key.Encode());
+    std::string prev_user_key;
+    bool has_prev = false;
+    for (int steps = 0; iter->Valid() && steps < kMaxPartitionerSteps;
+         iter->Next(), ++steps) {
+      const Slice user_key = ExtractUserKey(iter->key());
+      if (has_prev && ucmp->Compare(prev_user_key, user_key) != 0) {
+        const Slice prev(prev_user_key);
+        if (partitioner->ShouldPartition(PartitionerRequest(
+                prev, user_key, /*current_output_file_size=*/0)) ==
+            kRequired) {
+          cuts.push_back(user_key.ToString());
+          break;
+        }
+      }
+      prev_user_key.assign(user_key.data(), user_key.size());
+      has_prev = true;
+    }
+  }
+  boundaries->swap(cuts);
+}
+
+void FlushJob::ReleaseL0KeyFilterSlot() {
+  for (FileMetaData* meta : GetOutputFileMetas()) {
+    if (meta->l0_key_filter_slot >= 0) {
+      cfd_->l0_key_filter()->RemoveFile(meta->l0_key_filter_slot,
+                                        meta->fd.GetNumber());
+      meta->l0_key_filter_slot = -1;
+    }
+  }
+}
+
+autovector<FileMetaData*> FlushJob::GetOutputFileMetas() {
+  autovector<FileMetaData*> metas;
+  metas.push_back(&meta_);
+  for (FileMetaData& meta : partition_metas_) {
+    metas.push_back(&meta);
+  }
+  return metas;
+}
+
 Status FlushJob::WriteLevel0Table() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_FLUSH_WRITE_L0);
@@ -867,16 +1011,13 @@ Status FlushJob::WriteLevel0Table() {
     if (log_buffer_) {
       log_buffer_->FlushBufferToLog();
     }
-    // memtables and range_del_iters store internal iterators over each data
-    // memtable and its associated range deletion memtable, respectively, at
-    // corresponding indexes.
-    std::vector<InternalIterator*> memtables;
+    // range_del_iters store internal iterators over the range deletion
+    // memtable of each data memtable
     std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
         range_del_iters;
     ReadOptions ro;
     ro.total_order_seek = true;
     ro.io_activity = Env::IOActivity::kFlush;
-    Arena arena;
     uint64_t total_num_entries = 0, total_num_deletes = 0;
     uint64_t total_data_size = 0;
     size_t total_memory_usage = 0;
@@ -893,8 +1034,6 @@ Status FlushJob::WriteLevel0Table() {
           db_options_.info_log,
           "[%s] [JOB %d] Flushing memtable with next log file: %" PRIu64 "\n",
           cfd_->GetName().c_str(), job_context_->job_id, m->GetNextLogNumber());
-      memtables.push_back(
-          m->NewIterator(ro, /*seqno_to_time_mapping=*/nullptr, &arena));
       auto* range_del_iter = m->NewRangeTombstoneIterator(
           ro, kMaxSequenceNumber, true /* immutable_memtable */);
       if (range_del_iter != nullptr) {
@@ -921,9 +1060,6 @@ Status FlushJob::WriteLevel0Table() {
                          << GetFlushReasonString(flush_reason_);
 
     {
-      ScopedArenaPtr<InternalIterator> iter(
-          NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
-                             static_cast<int>(memtables.size()), &arena));
       ROCKS_LOG_INFO(db_options_.info_log,
                      "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": started",
                      cfd_->GetName().c_str(), job_context_->job_id,
@@ -955,45 +1091,156 @@ Status FlushJob::WriteLevel0Table() {
       meta_.oldest_ancester_time = oldest_ancester_time;
       meta_.file_creation_time = current_time;
 
-      uint64_t num_input_entries = 0;
-      uint64_t memtable_payload_bytes = 0;
-      uint64_t memtable_garbage_bytes = 0;
-      IOStatus io_s;
-
       const std::string* const full_history_ts_low =
           (full_history_ts_low_.empty()) ? nullptr : &full_history_ts_low_;
       ReadOptions read_options(Env::IOActivity::kFlush);
       read_options.rate_limiter_priority = io_priority;
       const WriteOptions write_options(io_priority, Env::IOActivity::kFlush);
-      TableBuilderOptions tboptions(
-          *cfd_->ioptions(), mutable_cf_options_, read_options, write_options,
-          cfd_->internal_comparator(), cfd_->internal_tbl_prop_coll_factories(),
-          output_compression_, mutable_cf_options_.compression_opts,
-          cfd_->GetID(), cfd_->GetName(), 0 /* level */,
-          false /* is_bottommost */, TableFileCreationReason::kFlush,
-          oldest_key_time, current_time, db_id_, db_session_id_,
-          0 /* target_file_size */, meta_.fd.GetNumber(),
-          preclude_last_level_min_seqno_ == kMaxSequenceNumber
-              ? preclude_last_level_min_seqno_
-              : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
+      std::vector<uint64_t> level_bytes;
+      const VersionStorageInfo* vstorage = base_->storage_info();
+      for (int level = 0; level < vstorage->num_levels(); ++level) {
+        level_bytes.push_back(vstorage->NumLevelBytes(level));
+      }
       const SequenceNumber job_snapshot_seq =
           job_context_->GetJobSnapshotSequence();
+      L0KeyFilter* const l0_key_filter = cfd_->l0_key_filter();
+
+      // The key ranges to build files for in parallel, with
+      // max_flush_partitions. The first file is meta_.
+      std::vector<std::string> boundaries;
+      if (range_del_iters.empty()) {
+        PickPartitionBoundaries(total_data_size, total_num_entries,
+                                &boundaries);
+      }
+      partition_metas_.resize(boundaries.size());
+      for (FileMetaData& meta : partition_metas_) {
+        meta.fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+        meta.epoch_number = meta_.epoch_number;
+        meta.temperature = meta_.temperature;
+        meta.oldest_ancester_time = meta_.oldest_ancester_time;
+        meta.file_creation_time = meta_.file_creation_time;
+      }
+      std::vector<Partition> partitions(boundaries.size() + 1);
+      for (size_t i = 0; i < partitions.size(); ++i) {
+        partitions[i].meta = i == 0 ? &meta_ : &partition_metas_[i - 1];
+        if (i > 0) {
+          partitions[i].start = InternalKey(boundaries[i - 1],
+                                            kMaxSequenceNumber,
+                                            kValueTypeForSeek)
+                                    .Encode()
+                                    .ToString();
+        }
+        if (i < boundaries.size()) {
+          partitions[i].end =
+              InternalKey(boundaries[i], kMaxSequenceNumber, kValueTypeForSeek)
+                  .Encode()
+                  .ToString();
+        }
+      }
+      partitions[0].range_del_iters = std::move(range_del_iters);
+      if (partitions.size() > 1) {
+        ROCKS_LOG_INFO(db_options_.info_log,
+                       "[%s] [JOB %d] Level-0 flush split into %" ROCKSDB_PRIszt
+                       " files built in parallel",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       partitions.size());
+      }
+
+      auto build_partition = [&](Partition* p) {
+        Arena arena;
+        std::vector<InternalIterator*> memtables;
+        for (MemTable* m : mems_) {
+          memtables.push_back(
+              m->NewIterator(ro, /*seqno_to_time_mapping=*/nullptr, &arena));
+        }
+        ScopedArenaPtr<InternalIterator> merging_iter(
+            NewMergingIterator(&cfd_->internal_comparator(), memtables.data(),
+                               static_cast<int>(memtables.size()), &arena));
+        InternalIterator* iter = merging_iter.get();
+        const Slice start(p->start);
+        const Slice end(p->end);
+        std::unique_ptr<ClippingIterator> clipping_iter;
+        if (!p->start.empty() || !p->end.empty()) {
+          clipping_iter = std::make_unique<ClippingIterator>(
+              iter, p->start.empty() ? nullptr : &start,
+              p->end.empty() ? nullptr : &end, &cfd_->internal_comparator());
+          iter = clipping_iter.get();
+        }
 
-      s = BuildTable(
-          dbname_, versions_, db_options_, tboptions, file_options_,
-          cfd_->table_cache(), iter.get(), std::move(range_del_iters), &meta_,
-          &blob_file_additions, existing_snapshots_, earliest_snapshot_,
-          earliest_write_conflict_snapshot_, job_snapshot_seq,
-          snapshot_checker_, mutable_cf_options_.paranoid_file_checks,
-          cfd_->internal_stats(), &io_s, io_tracer_,
-          BlobFileCreationReason::kFlush, seqno_to_time_mapping_.get(),
-          event_logger_, job_context_->job_id, &table_properties_, write_hint,
-          full_history_ts_low, blob_callback_, base_, &num_input_entries,
-          &memtable_payload_bytes, &memtable_garbage_bytes);
+        TableBuilderOptions tboptions(
+            *cfd_->ioptions(), mutable_cf_options_, read_options,
+            write_options, cfd_->internal_comparator(),
+            cfd_->internal_tbl_prop_coll_factories(), output_compression_,
+            mutable_cf_options_.compression_opts, cfd_->GetID(),
+            cfd_->GetName(), 0 /* level */, false /* is_bottommost */,
+            TableFileCreationReason::kFlush, oldest_key_time, current_time,
+            db_id_, db_session_id_, 0 /* target_file_size */,
+            p->meta->fd.GetNumber(),
+            preclude_last_level_min_seqno_ == kMaxSequenceNumber
+                ? preclude_last_level_min_seqno_
+                : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
+        tboptions.level_bytes = level_bytes;
+
+        InternalStats::CompactionStageStats prev_stage_stats;
+        if (measure_io_stats_) {
+          prev_stage_stats =
+              InternalStats::CompactionStageStats::FromThreadCounters();
+        }
+        // Only a flush that is not split can write blob files
+        p->s = BuildTable(
+            dbname_, versions_, db_options_, tboptions, file_options_,
+            cfd_->table_cache(), iter, std::move(p->range_del_iters), p->meta,
+            &blob_file_additions, existing_snapshots_, earliest_snapshot_,
+            earliest_write_conflict_snapshot_, job_snapshot_seq,
+            snapshot_checker_, mutable_cf_options_.paranoid_file_checks,
+            cfd_->internal_stats(), &p->io_s, io_tracer_,
+            BlobFileCreationReason::kFlush, seqno_to_time_mapping_.get(),
+            event_logger_, job_context_->job_id, &p->table_properties,
+            write_hint, full_history_ts_low, blob_callback_, base_,
+            &p->num_input_entries, &p->memtable_payload_bytes,
+            &p->memtable_garbage_bytes,
+            l0_key_filter != nullptr ? &p->l0_key_hashes : nullptr);
+        if (measure_io_stats_) {
+          p->stage_stats =
+              InternalStats::CompactionStageStats::FromThreadCounters();
+          p->stage_stats.Subtract(prev_stage_stats);
+        }
+      };
+      std::vector<port::Thread> threads;
+      threads.reserve(partitions.size() - 1);
+      for (size_t i = 1; i < partitions.size(); ++i) {
+        threads.emplace_back([&, i]() {
+          if (measure_io_stats_) {
+            SetPerfLevel(PerfLevel::kEnableTime);
+          }
+          build_partition(&partitions[i]);
+          RecordFlushIOStats();
+        });
+      }
+      build_partition(&partitions[0]);
+      for (port::Thread& thread : threads) {
+        thread.join();
+      }
+
+      uint64_t num_input_entries = 0;
+      uint64_t memtable_payload_bytes = 0;
+      uint64_t memtable_garbage_bytes = 0;
+      for (Partition& p : partitions) {
+        if (!p.s.ok() && s.ok()) {
+          s = p.s;
+        }
+        // TODO: Cleanup io_status in BuildTable and table builders
+        assert(!p.s.ok() || p.io_s.ok());
+        p.io_s.PermitUncheckedError();
+        num_input_entries += p.num_input_entries;
+        memtable_payload_bytes += p.memtable_payload_bytes;
+        memtable_garbage_bytes += p.memtable_garbage_bytes;
+        if (measure_io_stats_) {
+          stage_stats_.Add(p.stage_stats);
+        }
+      }
+      table_properties_ = partitions[0].table_properties;
       TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:s", &s);
-      // TODO: Cleanup io_status in BuildTable and table builders
-      assert(!s.ok() || io_s.ok());
-      io_s.PermitUncheckedError();
       if (num_input_entries != total_num_entries && s.ok()) {
         std::string msg = "Expected " + std::to_string(total_num_entries) +
                           " entries in memtables, but read " +
@@ -1005,28 +1252,38 @@ Status FlushJob::WriteLevel0Table() {
           s = Status::Corruption(msg);
         }
       }
-      if (tboptions.reason == TableFileCreationReason::kFlush) {
-        TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
-        RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
-                   memtable_payload_bytes);
-        RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
-                   memtable_garbage_bytes);
+      // A file with range tombstones can delete keys it does not hold, so
+      // lookups must not skip it
+      for (Partition& p : partitions) {
+        if (s.ok() && l0_key_filter != nullptr &&
+            p.meta->fd.GetFileSize() > 0 &&
+            p.table_properties.num_range_deletions == 0) {
+          p.meta->l0_key_filter_slot =
+              l0_key_filter->AddFile(p.meta->fd.GetNumber(), p.l0_key_hashes);
+        }
       }
+      TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
+      RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
+                 memtable_payload_bytes);
+      RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
+                 memtable_garbage_bytes);
       LogFlush(db_options_.info_log);
     }
-    ROCKS_LOG_BUFFER(log_buffer_,
-                     "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
-                     " bytes %s"
-                     " %s"
-                     " %s",
-                     cfd_->GetName().c_str(), job_context_->job_id,
-                     meta_.fd.GetNumber(), meta_.fd.GetFileSize(),
-                     s.ToString().c_str(),
-                     s.ok() && meta_.fd.GetFileSize() == 0
-                         ? "It's an empty SST file from a successful flush so "
-                           "won't be kept in the DB"
-                         : "",
-                     meta_.marked_for_compaction ? " (needs compaction)" : "");
+    for (const FileMetaData* meta : GetOutputFileMetas()) {
+      ROCKS_LOG_BUFFER(
+          log_buffer_,
+          "[%s] [JOB %d] Level-0 flush table #%" PRIu64 ": %" PRIu64
+          " bytes %s"
+          " %s"
+          " %s",
+          cfd_->GetName().c_str(), job_context_->job_id, meta->fd.GetNumber(),
+          meta->fd.GetFileSize(), s.ToString().c_str(),
+          s.ok() && meta->fd.GetFileSize() == 0
+              ? "It's an empty SST file from a successful flush so "
+                "won't be kept in the DB"
+              : "",
+          meta->marked_for_compaction ? " (needs compaction)" : "");
+    }
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->FsyncWithDirOptions(
@@ -1040,25 +1297,46 @@ Status FlushJob::WriteLevel0Table() {
 
   // Note that if file_size is zero, the file has been deleted and
   // should not be added to the manifest.
-  const bool has_output = meta_.fd.GetFileSize() > 0;
+  autovector<FileMetaData*> outputs;
+  for (FileMetaData* meta : GetOutputFileMetas()) {
+    if (meta->fd.GetFileSize() > 0) {
+      outputs.push_back(meta);
+    }
+  }
+  const bool has_output = !outputs.empty();
 
   if (s.ok() && has_output) {
     TEST_SYNC_POINT("DBImpl::FlushJob:SSTFileCreated");
-    // if we have more than 1 background thread, then we cannot
-    // insert files directly into higher levels because some other
-    // threads could be concurrently producing compacted files for
-    // that key range.
-    // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
-                   meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
-                   meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
-                   meta_.marked_for_compaction, meta_.temperature,
-                   meta_.oldest_blob_file_number, meta_.oldest_ancester_time,
-                   meta_.file_creation_time, meta_.epoch_number,
-                   meta_.file_checksum, meta_.file_checksum_func_name,
-                   meta_.unique_id, meta_.compensated_range_deletion_size,
-                   meta_.tail_size, meta_.user_defined_timestamps_persisted);
+    // Add files to L0, unless they fit deeper without overlap
+    const Slice smallest = outputs.front()->smallest.user_key();
+    const Slice largest = outputs.back()->largest.user_key();
+    output_level_ = PickOutputLevel(smallest, largest);
+    if (output_level_ > 0) {
+      // The L0 key filter only covers L0 files
+      ReleaseL0KeyFilterSlot();
+      cfd_->compaction_picker()->RegisterPendingFlushOutput(
+          meta_.fd.GetNumber(), output_level_, smallest, largest);
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] [JOB %d] Flush table #%" PRIu64 " to level %d",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       meta_.fd.GetNumber(), output_level_);
+    }
+    for (const FileMetaData* meta : outputs) {
+      edit_->AddFile(output_level_, meta->fd.GetNumber(), meta->fd.GetPathId(),
+                     meta->fd.GetFileSize(), meta->smallest, meta->largest,
+                     meta->fd.smallest_seqno, meta->fd.largest_seqno,
+                     meta->marked_for_compaction, meta->temperature,
+                     meta->oldest_blob_file_number, meta->oldest_ancester_time,
+                     meta->file_creation_time, meta->epoch_number,
+                     meta->file_checksum, meta->file_checksum_func_name,
+                     meta->unique_id, meta->compensated_range_deletion_size,
+                     meta->tail_size, meta->user_defined_timestamps_persisted);
+      edit_->GetMutableNewFiles().back().second.l0_key_filter_slot =
+          meta->l0_key_filter_slot;
+    }
     edit_->SetBlobFileAdditions(std::move(blob_file_additions));
+  } else {
+    ReleaseL0KeyFilterSlot();
   }
   // Piggyback FlushJobInfo on the first first flushed memtable.
   mems_[0]->SetFlushJobInfo(GetFlushJobInfo());
@@ -1069,6 +1347,7 @@ Status FlushJob::WriteLevel0Table() {
   const uint64_t cpu_micros = clock_->CPUMicros() - start_cpu_micros;
   stats.micros = micros;
   stats.cpu_micros = cpu_micros;
+  stats.stage_stats = stage_stats_;
 
   ROCKS_LOG_INFO(db_options_.info_log,
                  "[%s] [JOB %d] Flush lasted %" PRIu64
@@ -1076,9 +1355,9 @@ Status FlushJob::WriteLevel0Table() {
                  cfd_->GetName().c_str(), job_context_->job_id, micros,
                  cpu_micros);
 
-  if (has_output) {
-    stats.bytes_written = meta_.fd.GetFileSize();
-    stats.num_output_files = 1;
+  for (const FileMetaData* meta : outputs) {
+    stats.bytes_written += meta->fd.GetFileSize();
+    stats.num_output_files++;
   }
 
   const auto& blobs = edit_->GetBlobFileAdditions();
@@ -1098,6 +1377,44 @@ Status FlushJob::WriteLevel0Table() {
   return s;
 }
 
+int FlushJob::PickOutputLevel(const Slice& smallest, const Slice& largest) {
+  db_mutex_->AssertHeld();
+  const ImmutableOptions& ioptions = *cfd_->ioptions();
+  if (!ioptions.flush_to_lowest_nonoverlapping_level ||
+      ioptions.compaction_style != kCompactionStyleLevel ||
+      db_options_.atomic_flush || !write_manifest_) {
+    return 0;
+  }
+  // The memtables of other flushes are in no version yet, so the output
+  // cannot be checked against them, and whichever flush commits first
+  // installs the others' files too
+  if (!cfd_->imm()->IsOnlyFlushRunning(mems_)) {
+    return 0;
+  }
+
+  VersionStorageInfo* vstorage = cfd_->current()->storage_info();
+  int max_level = vstorage->num_levels() - 1;
+  if (db_options_.allow_ingest_behind ||
+      ioptions.preclude_last_level_data_seconds > 0) {
+    // The last level is kept for ingested or older data
+    --max_level;
+  }
+  int output_level = 0;
+  for (int level = 0; level <= max_level; ++level) {
+    if (vstorage->OverlapInLevel(level, &smallest, &largest) ||
+        cfd_->RangeOverlapWithCompaction(smallest, largest, level)) {
+      break;
+    }
+    output_level = level;
+  }
+  // With level_compaction_dynamic_level_bytes, the levels above the base
+  // level are kept empty
+  if (output_level < vstorage->base_level()) {
+    return 0;
+  }
+  return output_level;
+}
+
 Env::IOPriority FlushJob::GetRateLimiterPriority() {
   if (versions_ && versions_->GetColumnFamilySet() &&
       versions_->GetColumnFamilySet()->write_controller()) {
@@ -25,6 +25,7 @@
 #include "db/log_writer.h"
 #include "db/logs_with_prep_tracker.h"
 #include "db/memtable_list.h"
+#include "db/range_tombstone_fragmenter.h"
 #include "db/seqno_to_time_mapping.h"
 #include "db/snapshot_impl.h"
 #include "db/version_edit.h"
@@ -97,6 +98,16 @@ class FlushJob {
     return &committed_flush_jobs_info_;
   }
 
+  // The output files of a flush split by max_flush_partitions besides the
+  // first one, which Run() returns
+  const std::vector<FileMetaData>& GetPartitionFileMetas() const {
+    return partition_metas_;
+  }
+
+  // Frees the output files' slots in the L0 key filter when the flush result
+  // is not installed, as after RollbackMemtableFlush()
+  void ReleaseL0KeyFilterSlot();
+
  private:
   friend class FlushJobTest_GetRateLimiterPriorityForWrite_Test;
 
@@ -104,6 +115,36 @@ class FlushJob {
   void ReportFlushInputSize(const autovector<MemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Returns the level to add the output files, from `smallest` to `largest`
+  // user key, to, which is 0 unless flush_to_lowest_nonoverlapping_level
+  // allows a deeper one. Requires db_mutex held.
+  int PickOutputLevel(const Slice& smallest, const Slice& largest);
+  // Returns meta_ and partition_metas_
+  autovector<FileMetaData*> GetOutputFileMetas();
+
+  // The output file of one key range of the flush, see max_flush_partitions
+  struct Partition {
+    FileMetaData* meta = nullptr;
+    // Internal keys bounding the range, empty if unbounded
+    std::string start;
+    std::string end;
+    std::vector<std::unique_ptr<FragmentedRangeTombstoneIterator>>
+        range_del_iters;
+    TableProperties table_properties;
+    std::vector<uint64_t> l0_key_hashes;
+    uint64_t num_input_entries = 0;
+    uint64_t memtable_payload_bytes = 0;
+    uint64_t memtable_garbage_bytes = 0;
+    IOStatus io_s;
+    Status s;
+    InternalStats::CompactionStageStats stage_stats;
+  };
+  // Sets `boundaries` to the user keys that split the flush into key ranges
+  // of about target_file_size_base, or leaves it empty if the flush is not
+  // split
+  void PickPartitionBoundaries(uint64_t total_data_size,
+                               uint64_t total_num_entries,
+                               std::vector<std::string>* boundaries);
 
   // Memtable Garbage Collection algorithm: a MemPurge takes the list
   // of immutable memtables and filters out (or "purge") the outdated bytes
@@ -181,6 +222,9 @@ class FlushJob {
   EventLogger* event_logger_;
   TableProperties table_properties_;
   bool measure_io_stats_;
+  // Time spent in the stages of writing the output file, measured only with
+  // measure_io_stats_
+  InternalStats::CompactionStageStats stage_stats_;
   // True if this flush job should call fsync on the output directory. False
   // otherwise.
   // Usually sync_output_directory_ is true. A flush job needs to call sync on
@@ -208,6 +252,11 @@ class FlushJob {
   autovector<MemTable*> mems_;
   VersionEdit* edit_;
   Version* base_;
+  // The output files after meta_ of a flush split by max_flush_partitions
+  std::vector<FileMetaData> partition_metas_;
+  // The level the output files are added to. When not 0, the file is
+  // registered with the compaction picker until the flush is installed.
+  int output_level_ = 0;
   bool pick_memtable_called;
   Env::Priority thread_pri_;
 
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstddef>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -25,9 +26,12 @@
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
 #include "db/write_stall_stats.h"
+#include "monitoring/iostats_context_imp.h"
+#include "monitoring/perf_context_imp.h"
 #include "port/port.h"
 #include "rocksdb/system_clock.h"
 #include "rocksdb/table.h"
+#include "rocksdb/utilities/miss_ratio_curve_cache.h"
 #include "table/block_based/cachable_entry.h"
 #include "util/hash_containers.h"
 #include "util/string_util.h"
@@ -88,6 +92,7 @@ namespace {
 const double kMB = 1048576.0;
 const double kGB = kMB * 1024;
 const double kMicrosInSec = 1000000.0;
+const double kNanosInSec = 1000000000.0;
 
 void PrintLevelStatsHeader(char* buf, size_t len, const std::string& cf_name,
                            const std::string& group_by) {
@@ -301,6 +306,7 @@ static const std::string aggregated_table_properties =
 static const std::string aggregated_table_properties_at_level =
     aggregated_table_properties + "-at-level";
 static const std::string num_running_compactions = "num-running-compactions";
+static const std::string compaction_memory_usage = "compaction-memory-usage";
 static const std::string num_running_flushes = "num-running-flushes";
 static const std::string actual_delayed_write_rate =
     "actual-delayed-write-rate";
@@ -309,6 +315,10 @@ static const std::string estimate_oldest_key_time = "estimate-oldest-key-time";
 static const std::string block_cache_capacity = "block-cache-capacity";
 static const std::string block_cache_usage = "block-cache-usage";
 static const std::string block_cache_pinned_usage = "block-cache-pinned-usage";
+static const std::string block_cache_miss_ratio_curve =
+    "block-cache-miss-ratio-curve";
+static const std::string compaction_heat = "compaction-heat";
+static const std::string compaction_stage_stats = "compaction-stage-stats";
 static const std::string options_statistics = "options-statistics";
 static const std::string num_blob_files = "num-blob-files";
 static const std::string blob_stats = "blob-stats";
@@ -337,6 +347,10 @@ const std::string DB::Properties::kDBWriteStallStats =
     rocksdb_prefix + db_write_stall_stats;
 const std::string DB::Properties::kDBStats = rocksdb_prefix + dbstats;
 const std::string DB::Properties::kLevelStats = rocksdb_prefix + levelstats;
+const std::string DB::Properties::kCompactionHeat =
+    rocksdb_prefix + compaction_heat;
+const std::string DB::Properties::kCompactionStageStats =
+    rocksdb_prefix + compaction_stage_stats;
 const std::string DB::Properties::kBlockCacheEntryStats =
     rocksdb_prefix + block_cache_entry_stats;
 const std::string DB::Properties::kFastBlockCacheEntryStats =
@@ -351,6 +365,8 @@ const std::string DB::Properties::kCompactionPending =
     rocksdb_prefix + compaction_pending;
 const std::string DB::Properties::kNumRunningCompactions =
     rocksdb_prefix + num_running_compactions;
+const std::string DB::Properties::kCompactionMemoryUsage =
+    rocksdb_prefix + compaction_memory_usage;
 const std::string DB::Properties::kNumRunningFlushes =
     rocksdb_prefix + num_running_flushes;
 const std::string DB::Properties::kBackgroundErrors =
@@ -416,6 +432,8 @@ const std::string DB::Properties::kBlockCacheUsage =
     rocksdb_prefix + block_cache_usage;
 const std::string DB::Properties::kBlockCachePinnedUsage =
     rocksdb_prefix + block_cache_pinned_usage;
+const std::string DB::Properties::kBlockCacheMissRatioCurve =
+    rocksdb_prefix + block_cache_miss_ratio_curve;
 const std::string DB::Properties::kOptionsStatistics =
     rocksdb_prefix + options_statistics;
 const std::string DB::Properties::kLiveSstFilesSizeAtTemperature =
@@ -450,6 +468,12 @@ const UnorderedMap<std::string, DBPropertyInfo>
           nullptr, nullptr}},
         {DB::Properties::kLevelStats,
          {false, &InternalStats::HandleLevelStats, nullptr, nullptr, nullptr}},
+        {DB::Properties::kCompactionHeat,
+         {false, &InternalStats::HandleCompactionHeat, nullptr, nullptr,
+          nullptr}},
+        {DB::Properties::kCompactionStageStats,
+         {false, &InternalStats::HandleCompactionStageStats, nullptr, nullptr,
+          nullptr}},
         {DB::Properties::kStats,
          {false, &InternalStats::HandleStats, nullptr, nullptr, nullptr}},
         {DB::Properties::kCFStats,
@@ -580,6 +604,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kNumRunningCompactions,
          {false, nullptr, &InternalStats::HandleNumRunningCompactions, nullptr,
           nullptr}},
+        {DB::Properties::kCompactionMemoryUsage,
+         {false, nullptr, &InternalStats::HandleCompactionMemoryUsage, nullptr,
+          nullptr}},
         {DB::Properties::kActualDelayedWriteRate,
          {false, nullptr, &InternalStats::HandleActualDelayedWriteRate, nullptr,
           nullptr}},
@@ -598,6 +625,9 @@ const UnorderedMap<std::string, DBPropertyInfo>
         {DB::Properties::kBlockCachePinnedUsage,
          {false, nullptr, &InternalStats::HandleBlockCachePinnedUsage, nullptr,
           nullptr}},
+        {DB::Properties::kBlockCacheMissRatioCurve,
+         {true, &InternalStats::HandleBlockCacheMissRatioCurve, nullptr,
+          &InternalStats::HandleBlockCacheMissRatioCurveMap, nullptr}},
         {DB::Properties::kOptionsStatistics,
          {true, nullptr, nullptr, nullptr,
           &DBImpl::GetPropertyHandleOptionsStatistics}},
@@ -626,6 +656,21 @@ const UnorderedMap<std::string, DBPropertyInfo>
           nullptr}},
 };
 
+InternalStats::CompactionStageStats
+InternalStats::CompactionStageStats::FromThreadCounters() {
+  CompactionStageStats stats;
+  stats.file_read_nanos = IOSTATS(read_nanos);
+  stats.block_decompress_nanos = get_perf_context()->block_decompress_time;
+  stats.merge_operator_nanos = get_perf_context()->merge_operator_time_nanos;
+  stats.block_compress_nanos = get_perf_context()->block_compress_time;
+  stats.filter_build_nanos = get_perf_context()->filter_build_time;
+  stats.index_build_nanos = get_perf_context()->index_build_time;
+  stats.file_write_nanos = IOSTATS(write_nanos);
+  stats.file_sync_nanos = IOSTATS(fsync_nanos) + IOSTATS(range_sync_nanos) +
+                          IOSTATS(prepare_write_nanos);
+  return stats;
+}
+
 InternalStats::InternalStats(int num_levels, SystemClock* clock,
                              ColumnFamilyData* cfd)
     : db_stats_{},
@@ -690,6 +735,9 @@ InternalStats::CacheEntryRoleStats::GetEntryCallback() {
         static_cast<size_t>(helper ? helper->role : CacheEntryRole::kMisc);
     entry_counts[role_idx]++;
     total_charges[role_idx] += charge;
+    if (helper) {
+      owner_charges[helper->owner_id] += charge;
+    }
   };
 }
 
@@ -707,6 +755,10 @@ void InternalStats::CacheEntryRoleStats::BeginCollection(
   table_size = cache->GetTableAddressCount();
   occupancy = cache->GetOccupancyCount();
   hash_seed = cache->GetHashSeed();
+  for (size_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    cache->GetAdmissionCounts(static_cast<CacheEntryRole>(i),
+                              &admitted_counts[i], &rejected_counts[i]);
+  }
 }
 
 void InternalStats::CacheEntryRoleStats::EndCollection(
@@ -747,6 +799,33 @@ std::string InternalStats::CacheEntryRoleStats::ToString(
     }
   }
   str << "\n";
+  bool has_admission_counts = false;
+  for (size_t i = 0; i < kNumCacheEntryRoles; ++i) {
+    if (admitted_counts[i] > 0 || rejected_counts[i] > 0) {
+      if (!has_admission_counts) {
+        str << "Block cache admission stats(admitted,rejected):";
+        has_admission_counts = true;
+      }
+      str << " " << kCacheEntryRoleToCamelString[i] << "("
+          << admitted_counts[i] << "," << rejected_counts[i] << ")";
+    }
+  }
+  if (has_admission_counts) {
+    str << "\n";
+  }
+  bool has_owner_charges = false;
+  for (size_t i = 1; i < owner_charges.size(); ++i) {
+    if (owner_charges[i] > 0) {
+      if (!has_owner_charges) {
+        str << "Block cache owner usage:";
+        has_owner_charges = true;
+      }
+      str << " " << i << "(" << BytesToHumanString(owner_charges[i]) << ")";
+    }
+  }
+  if (has_owner_charges) {
+    str << "\n";
+  }
   return str.str();
 }
 
@@ -769,6 +848,16 @@ void InternalStats::CacheEntryRoleStats::ToMap(
         std::to_string(total_charges[i]);
     v[BlockCacheEntryStatsMapKeys::UsedPercent(role)] =
         std::to_string(100.0 * total_charges[i] / cache_capacity);
+    v[BlockCacheEntryStatsMapKeys::AdmittedCount(role)] =
+        std::to_string(admitted_counts[i]);
+    v[BlockCacheEntryStatsMapKeys::RejectedCount(role)] =
+        std::to_string(rejected_counts[i]);
+  }
+  for (size_t i = 1; i < owner_charges.size(); ++i) {
+    if (owner_charges[i] > 0) {
+      v[BlockCacheEntryStatsMapKeys::OwnerUsedBytes(
+          static_cast<CacheOwnerId>(i))] = std::to_string(owner_charges[i]);
+    }
   }
 }
 
@@ -1046,6 +1135,79 @@ bool InternalStats::HandleLevelStats(std::string* value, Slice /*suffix*/) {
   return true;
 }
 
+bool InternalStats::HandleCompactionHeat(std::string* value,
+                                         Slice /*suffix*/) {
+  char buf[1000];
+  const auto* vstorage = cfd_->current()->storage_info();
+  snprintf(buf, sizeof(buf),
+           "Level Files Size(MB) SampledReads Reads/MB  HotFile HotReads "
+           "Write(MB)\n"
+           "----------------------------------------------------------------"
+           "---------\n");
+  value->append(buf);
+
+  for (int level = 0; level < number_levels_; level++) {
+    uint64_t reads = 0;
+    uint64_t hot_file = 0;
+    uint64_t hot_reads = 0;
+    for (const auto* file : vstorage->LevelFiles(level)) {
+      const uint64_t file_reads =
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      reads += file_reads;
+      if (file_reads > hot_reads) {
+        hot_file = file->fd.GetNumber();
+        hot_reads = file_reads;
+      }
+    }
+    const double size_mb = vstorage->NumLevelBytes(level) / kMB;
+    const CompactionStats& stats = comp_stats_[level];
+    snprintf(buf, sizeof(buf),
+             "%3d %8d %8.0f %12" PRIu64 " %8.1f %8" PRIu64 " %8" PRIu64
+             " %9.0f\n",
+             level, vstorage->NumLevelFiles(level), size_mb, reads,
+             size_mb > 0 ? reads / size_mb : 0.0, hot_file, hot_reads,
+             (stats.bytes_written + stats.bytes_written_blob) / kMB);
+    value->append(buf);
+  }
+  return true;
+}
+
+bool InternalStats::HandleCompactionStageStats(std::string* value,
+                                               Slice /*suffix*/) {
+  char buf[1000];
+  snprintf(buf, sizeof(buf),
+           "Level  Read(s) Decomp(s) MergeOp(s) Filter(s) Comp(s) "
+           "FilterBuild(s) IndexBuild(s) Write(s) Sync(s)\n"
+           "----------------------------------------------------------------"
+           "-----------------------------\n");
+  value->append(buf);
+
+  CompactionStageStats sum;
+  for (int level = 0; level <= number_levels_; level++) {
+    const bool is_sum = level == number_levels_;
+    const CompactionStageStats& stats =
+        is_sum ? sum : comp_stats_[level].stage_stats;
+    if (!is_sum) {
+      sum.Add(stats);
+    }
+    snprintf(buf, sizeof(buf),
+             "%5s %8.3f %9.3f %10.3f %9.3f %7.3f %14.3f %13.3f %8.3f "
+             "%7.3f\n",
+             is_sum ? "Sum" : ("L" + std::to_string(level)).c_str(),
+             stats.file_read_nanos / kNanosInSec,
+             stats.block_decompress_nanos / kNanosInSec,
+             stats.merge_operator_nanos / kNanosInSec,
+             stats.compaction_filter_nanos / kNanosInSec,
+             stats.block_compress_nanos / kNanosInSec,
+             stats.filter_build_nanos / kNanosInSec,
+             stats.index_build_nanos / kNanosInSec,
+             stats.file_write_nanos / kNanosInSec,
+             stats.file_sync_nanos / kNanosInSec);
+    value->append(buf);
+  }
+  return true;
+}
+
 bool InternalStats::HandleStats(std::string* value, Slice suffix) {
   if (!HandleCFStats(value, suffix)) {
     return false;
@@ -1265,6 +1427,12 @@ bool InternalStats::HandleNumRunningCompactions(uint64_t* value, DBImpl* db,
   return true;
 }
 
+bool InternalStats::HandleCompactionMemoryUsage(uint64_t* value, DBImpl* db,
+                                                Version* /*version*/) {
+  *value = db->compaction_memory_limiter_.GetUsage();
+  return true;
+}
+
 bool InternalStats::HandleBackgroundErrors(uint64_t* value, DBImpl* /*db*/,
                                            Version* /*version*/) {
   // Accumulated number of  errors in background flushes or compactions.
@@ -1530,6 +1698,66 @@ bool InternalStats::HandleBlockCachePinnedUsage(uint64_t* value, DBImpl* /*db*/,
   return false;
 }
 
+bool InternalStats::GetBlockCacheMissRatioCurve(
+    std::vector<size_t>* capacities, std::vector<double>* miss_ratios,
+    uint64_t* num_sampled_lookups) {
+  Cache* block_cache = GetBlockCacheForStats();
+  if (block_cache == nullptr ||
+      strcmp(block_cache->Name(), MissRatioCurveCache::kClassName()) != 0) {
+    return false;
+  }
+  auto* mrc_cache = static_cast<MissRatioCurveCache*>(block_cache);
+  const size_t capacity = mrc_cache->GetCapacity();
+  capacities->clear();
+  for (int shift = -3; shift <= 3; ++shift) {
+    size_t c = shift < 0 ? capacity >> -shift : capacity << shift;
+    if (c > 0 && (capacities->empty() || c > capacities->back())) {
+      capacities->push_back(c);
+    }
+  }
+  *num_sampled_lookups = mrc_cache->GetNumSampledLookups();
+  mrc_cache->GetMissRatioCurve(*capacities, miss_ratios);
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheMissRatioCurve(std::string* value,
+                                                   Slice /*suffix*/) {
+  std::vector<size_t> capacities;
+  std::vector<double> miss_ratios;
+  uint64_t num_sampled_lookups;
+  if (!GetBlockCacheMissRatioCurve(&capacities, &miss_ratios,
+                                   &num_sampled_lookups)) {
+    return false;
+  }
+  std::ostringstream str;
+  str << "Block cache miss ratio curve (" << num_sampled_lookups
+      << " sampled lookups)\n";
+  for (size_t i = 0; i < capacities.size(); ++i) {
+    str << "  capacity " << BytesToHumanString(capacities[i])
+        << ": miss ratio " << miss_ratios[i] << "\n";
+  }
+  *value = str.str();
+  return true;
+}
+
+bool InternalStats::HandleBlockCacheMissRatioCurveMap(
+    std::map<std::string, std::string>* values, Slice /*suffix*/) {
+  std::vector<size_t> capacities;
+  std::vector<double> miss_ratios;
+  uint64_t num_sampled_lookups;
+  if (!GetBlockCacheMissRatioCurve(&capacities, &miss_ratios,
+                                   &num_sampled_lookups)) {
+    return false;
+  }
+  values->clear();
+  (*values)["sampled_lookups"] = std::to_string(num_sampled_lookups);
+  for (size_t i = 0; i < capacities.size(); ++i) {
+    (*values)["capacity." + std::to_string(capacities[i])] =
+        std::to_string(miss_ratios[i]);
+  }
+  return true;
+}
+
 void InternalStats::DumpDBMapStats(
     std::map<std::string, std::string>* db_stats) {
   for (int i = 0; i < static_cast<int>(kIntStatsNumMax); ++i) {
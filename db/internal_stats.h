@@ -16,7 +16,9 @@
 #include <vector>
 
 #include "cache/cache_entry_roles.h"
+#include "cache/cache_owner.h"
 #include "db/version_set.h"
+#include "rocksdb/compaction_job_stats.h"
 #include "rocksdb/system_clock.h"
 #include "util/hash_containers.h"
 
@@ -170,6 +172,64 @@ class InternalStats {
     }
   };
 
+  // Time spent in the stages of compactions and flushes, in nanoseconds.
+  // Only measured with `report_bg_io_stats`, from the perf and IO stats
+  // contexts of the threads running them.
+  struct CompactionStageStats {
+    uint64_t file_read_nanos = 0;
+    uint64_t block_decompress_nanos = 0;
+    uint64_t merge_operator_nanos = 0;
+    uint64_t compaction_filter_nanos = 0;
+    uint64_t block_compress_nanos = 0;
+    uint64_t filter_build_nanos = 0;
+    uint64_t index_build_nanos = 0;
+    uint64_t file_write_nanos = 0;
+    // fsync, range sync and prepare write
+    uint64_t file_sync_nanos = 0;
+
+    // Returns the counters of the calling thread, except the compaction
+    // filter time, which is not kept there
+    static CompactionStageStats FromThreadCounters();
+
+    void Add(const CompactionStageStats& stats) {
+      this->file_read_nanos += stats.file_read_nanos;
+      this->block_decompress_nanos += stats.block_decompress_nanos;
+      this->merge_operator_nanos += stats.merge_operator_nanos;
+      this->compaction_filter_nanos += stats.compaction_filter_nanos;
+      this->block_compress_nanos += stats.block_compress_nanos;
+      this->filter_build_nanos += stats.filter_build_nanos;
+      this->index_build_nanos += stats.index_build_nanos;
+      this->file_write_nanos += stats.file_write_nanos;
+      this->file_sync_nanos += stats.file_sync_nanos;
+    }
+
+    void Add(const CompactionJobStats& stats) {
+      this->file_read_nanos += stats.file_read_nanos;
+      this->block_decompress_nanos += stats.block_decompress_nanos;
+      this->merge_operator_nanos += stats.merge_operator_nanos;
+      this->compaction_filter_nanos += stats.compaction_filter_nanos;
+      this->block_compress_nanos += stats.block_compress_nanos;
+      this->filter_build_nanos += stats.filter_build_nanos;
+      this->index_build_nanos += stats.index_build_nanos;
+      this->file_write_nanos += stats.file_write_nanos;
+      this->file_sync_nanos += stats.file_fsync_nanos +
+                               stats.file_range_sync_nanos +
+                               stats.file_prepare_write_nanos;
+    }
+
+    void Subtract(const CompactionStageStats& stats) {
+      this->file_read_nanos -= stats.file_read_nanos;
+      this->block_decompress_nanos -= stats.block_decompress_nanos;
+      this->merge_operator_nanos -= stats.merge_operator_nanos;
+      this->compaction_filter_nanos -= stats.compaction_filter_nanos;
+      this->block_compress_nanos -= stats.block_compress_nanos;
+      this->filter_build_nanos -= stats.filter_build_nanos;
+      this->index_build_nanos -= stats.index_build_nanos;
+      this->file_write_nanos -= stats.file_write_nanos;
+      this->file_sync_nanos -= stats.file_sync_nanos;
+    }
+  };
+
   // Per level compaction stats.  comp_stats_[level] stores the stats for
   // compactions that produced data for the specified "level".
   struct CompactionStats {
@@ -223,6 +283,8 @@ class InternalStats {
     // Number of compactions done per CompactionReason
     int counts[static_cast<int>(CompactionReason::kNumOfReasons)]{};
 
+    CompactionStageStats stage_stats;
+
     explicit CompactionStats()
         : micros(0),
           cpu_micros(0),
@@ -292,7 +354,8 @@ class InternalStats {
           num_input_records(c.num_input_records),
           num_dropped_records(c.num_dropped_records),
           num_output_records(c.num_output_records),
-          count(c.count) {
+          count(c.count),
+          stage_stats(c.stage_stats) {
       int num_of_reasons = static_cast<int>(CompactionReason::kNumOfReasons);
       for (int i = 0; i < num_of_reasons; i++) {
         counts[i] = c.counts[i];
@@ -317,6 +380,7 @@ class InternalStats {
       num_dropped_records = c.num_dropped_records;
       num_output_records = c.num_output_records;
       count = c.count;
+      stage_stats = c.stage_stats;
 
       int num_of_reasons = static_cast<int>(CompactionReason::kNumOfReasons);
       for (int i = 0; i < num_of_reasons; i++) {
@@ -342,6 +406,7 @@ class InternalStats {
       this->num_dropped_records = 0;
       this->num_output_records = 0;
       this->count = 0;
+      this->stage_stats = CompactionStageStats();
       int num_of_reasons = static_cast<int>(CompactionReason::kNumOfReasons);
       for (int i = 0; i < num_of_reasons; i++) {
         counts[i] = 0;
@@ -367,6 +432,7 @@ class InternalStats {
       this->num_dropped_records += c.num_dropped_records;
       this->num_output_records += c.num_output_records;
       this->count += c.count;
+      this->stage_stats.Add(c.stage_stats);
       int num_of_reasons = static_cast<int>(CompactionReason::kNumOfReasons);
       for (int i = 0; i < num_of_reasons; i++) {
         counts[i] += c.counts[i];
@@ -401,6 +467,7 @@ class InternalStats {
       this->num_dropped_records -= c.num_dropped_records;
       this->num_output_records -= c.num_output_records;
       this->count -= c.count;
+      this->stage_stats.Subtract(c.stage_stats);
       int num_of_reasons = static_cast<int>(CompactionReason::kNumOfReasons);
       for (int i = 0; i < num_of_reasons; i++) {
         counts[i] -= c.counts[i];
@@ -474,6 +541,10 @@ class InternalStats {
     std::string cache_id;
     std::array<uint64_t, kNumCacheEntryRoles> total_charges;
     std::array<size_t, kNumCacheEntryRoles> entry_counts;
+    std::array<uint64_t, kNumCacheEntryRoles> admitted_counts;
+    std::array<uint64_t, kNumCacheEntryRoles> rejected_counts;
+    // Indexed by CacheOwnerId, see NewCacheOwnerView()
+    std::array<uint64_t, CacheOwnerPartitions::kNumOwners> owner_charges;
     uint32_t collection_count = 0;
     uint32_t copies_of_last_collection = 0;
     uint64_t last_start_time_micros_ = 0;
@@ -760,6 +831,8 @@ class InternalStats {
   bool HandleNumFilesAtLevel(std::string* value, Slice suffix);
   bool HandleCompressionRatioAtLevelPrefix(std::string* value, Slice suffix);
   bool HandleLevelStats(std::string* value, Slice suffix);
+  bool HandleCompactionHeat(std::string* value, Slice suffix);
+  bool HandleCompactionStageStats(std::string* value, Slice suffix);
   bool HandleStats(std::string* value, Slice suffix);
   bool HandleCFMapStats(std::map<std::string, std::string>* compaction_stats,
                         Slice suffix);
@@ -793,6 +866,8 @@ class InternalStats {
   bool HandleCompactionPending(uint64_t* value, DBImpl* db, Version* version);
   bool HandleNumRunningCompactions(uint64_t* value, DBImpl* db,
                                    Version* version);
+  bool HandleCompactionMemoryUsage(uint64_t* value, DBImpl* db,
+                                   Version* version);
   bool HandleBackgroundErrors(uint64_t* value, DBImpl* db, Version* version);
   bool HandleCurSizeActiveMemTable(uint64_t* value, DBImpl* db,
                                    Version* version);
@@ -848,6 +923,12 @@ class InternalStats {
   bool HandleFastBlockCacheEntryStats(std::string* value, Slice suffix);
   bool HandleFastBlockCacheEntryStatsMap(
       std::map<std::string, std::string>* values, Slice suffix);
+  bool GetBlockCacheMissRatioCurve(std::vector<size_t>* capacities,
+                                   std::vector<double>* miss_ratios,
+                                   uint64_t* num_sampled_lookups);
+  bool HandleBlockCacheMissRatioCurve(std::string* value, Slice suffix);
+  bool HandleBlockCacheMissRatioCurveMap(
+      std::map<std::string, std::string>* values, Slice suffix);
   bool HandleLiveSstFilesSizeAtTemperature(std::string* value, Slice suffix);
   bool HandleNumBlobFiles(uint64_t* value, DBImpl* db, Version* version);
   bool HandleBlobStats(std::string* value, Slice suffix);
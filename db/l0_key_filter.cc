@@ -0,0 +1,117 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/l0_key_filter.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr size_t kMinWords = 1024;
+// 128 MiB. Files with more keys than this is sized for get more false
+// positives instead of a larger table.
+constexpr size_t kMaxWords = size_t{1} << 24;
+}  // namespace
+
+L0KeyFilter::Table::Table(size_t num_words)
+    : mask(num_words - 1), words(new std::atomic<uint64_t>[num_words]) {
+  assert((num_words & mask) == 0);
+  for (size_t i = 0; i < num_words; ++i) {
+    words[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+L0KeyFilter::L0KeyFilter(double bits_per_key) : bits_per_key_(bits_per_key) {
+  tables_.emplace_back(new Table(kMinWords));
+  table_.store(tables_.back().get(), std::memory_order_release);
+}
+
+L0KeyFilter::~L0KeyFilter() = default;
+
+uint64_t L0KeyFilter::HashKey(const Slice& user_key_without_ts) {
+  return GetSliceHash64(user_key_without_ts);
+}
+
+void L0KeyFilter::Grow(size_t num_words) {
+  const Table* old_table = tables_.back().get();
+  assert(num_words > old_table->mask + 1);
+  auto* table = new Table(num_words);
+  // Each word maps to the old one with the same low bits
+  for (size_t i = 0; i < num_words; ++i) {
+    table->words[i].store(
+        old_table->words[i & old_table->mask].load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+  }
+  tables_.emplace_back(table);
+  table_.store(table, std::memory_order_release);
+}
+
+int L0KeyFilter::AddFile(uint64_t file_number,
+                         const std::vector<uint64_t>& key_hashes) {
+  assert(file_number != 0);
+  MutexLock l(&mutex_);
+  int slot = -1;
+  for (int i = 0; i < kMaxFiles; ++i) {
+    if (owners_[i] == 0) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    return -1;
+  }
+  owners_[slot] = file_number;
+
+  // Each word holds one bit of the file's column
+  const size_t wanted_words = static_cast<size_t>(
+      std::min(bits_per_key_ * static_cast<double>(key_hashes.size()),
+               static_cast<double>(kMaxWords)));
+  Table* table = tables_.back().get();
+  if (wanted_words > table->mask + 1) {
+    Grow(size_t{1} << (FloorLog2(wanted_words - 1) + 1));
+    table = tables_.back().get();
+  }
+
+  const uint64_t bit = uint64_t{1} << slot;
+  if (stale_slots_ & bit) {
+    for (size_t i = 0; i <= table->mask; ++i) {
+      table->words[i].fetch_and(~bit, std::memory_order_relaxed);
+    }
+    stale_slots_ &= ~bit;
+  }
+  for (uint64_t h : key_hashes) {
+    table->words[Probe1(h) & table->mask].fetch_or(bit,
+                                                   std::memory_order_relaxed);
+    table->words[Probe2(h) & table->mask].fetch_or(bit,
+                                                   std::memory_order_relaxed);
+  }
+  return slot;
+}
+
+void L0KeyFilter::RemoveFile(int slot, uint64_t file_number) {
+  assert(slot >= 0 && slot < kMaxFiles);
+  MutexLock l(&mutex_);
+  if (owners_[slot] == file_number) {
+    owners_[slot] = 0;
+    stale_slots_ |= uint64_t{1} << slot;
+  }
+}
+
+size_t L0KeyFilter::ApproximateMemoryUsage() const {
+  MutexLock l(&mutex_);
+  size_t usage = sizeof(*this);
+  for (const auto& table : tables_) {
+    usage += sizeof(Table) + (table->mask + 1) * sizeof(uint64_t);
+  }
+  return usage;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
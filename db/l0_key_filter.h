@@ -0,0 +1,100 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A Bloom filter over the user keys of up to kMaxFiles L0 files of a column
+// family, answering with one probe which of the files may contain a key (see
+// `l0_key_filter_bits_per_key`).
+//
+// Without it, a point lookup checks the key range and then the filter of
+// every L0 file in turn, which is a cache miss or more per file when L0
+// grows. The filter is bit-sliced: bit i of every word belongs to the file
+// in slot i, so each of the two probes for a key loads one word, and ANDing
+// them gives the candidate files at once.
+//
+// Files are added by flush before their Version is installed, and their
+// slots freed once no Version references them. A freed slot is cleared when
+// it is reused. The table doubles when a file has more keys than it is
+// sized for; a doubled table copies each old word to both of its new
+// positions, so no key is lost. Old tables are kept until destruction
+// because lock-free readers may still be probing them.
+class L0KeyFilter {
+ public:
+  static constexpr int kMaxFiles = 64;
+
+  explicit L0KeyFilter(double bits_per_key);
+  ~L0KeyFilter();
+
+  // No copying allowed
+  L0KeyFilter(const L0KeyFilter&) = delete;
+  L0KeyFilter& operator=(const L0KeyFilter&) = delete;
+
+  // Hash of a user key, without timestamp, as added and probed
+  static uint64_t HashKey(const Slice& user_key_without_ts);
+
+  // Adds the keys of the file with the given number and returns its slot, or
+  // -1 if all slots are in use. Thread-safe.
+  int AddFile(uint64_t file_number, const std::vector<uint64_t>& key_hashes);
+
+  // Frees `slot` if it still belongs to `file_number`. Thread-safe.
+  void RemoveFile(int slot, uint64_t file_number);
+
+  // Returns a mask with bit i set if the file in slot i may contain the key
+  // with the given hash. Lock-free.
+  uint64_t MayContain(uint64_t key_hash) const {
+    const Table* table = table_.load(std::memory_order_acquire);
+    return table->words[Probe1(key_hash) & table->mask].load(
+               std::memory_order_relaxed) &
+           table->words[Probe2(key_hash) & table->mask].load(
+               std::memory_order_relaxed);
+  }
+
+  size_t ApproximateMemoryUsage() const;
+
+ private:
+  struct Table {
+    explicit Table(size_t num_words);
+
+    const size_t mask;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+  };
+
+  static uint32_t Probe1(uint64_t key_hash) {
+    return static_cast<uint32_t>(key_hash);
+  }
+  static uint32_t Probe2(uint64_t key_hash) {
+    return static_cast<uint32_t>(key_hash >> 32);
+  }
+
+  // Replaces the table with one of at least `num_words` words. Requires
+  // mutex_ held.
+  void Grow(size_t num_words);
+
+  const double bits_per_key_;
+
+  std::atomic<Table*> table_;
+
+  mutable port::Mutex mutex_;
+  // The current table, last, and the ones replaced by it
+  std::vector<std::unique_ptr<Table>> tables_;
+  // File number by slot, 0 if the slot is free
+  std::array<uint64_t, kMaxFiles> owners_{};
+  // Slots freed since their column was last cleared
+  uint64_t stale_slots_ = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
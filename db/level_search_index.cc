@@ -0,0 +1,124 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/level_search_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "db/dbformat.h"
+#include "db/version_edit.h"
+#include "port/port.h"
+#include "rocksdb/comparator.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Number of prefixes per cache line. Prefetching slot k * kPrefixesPerLine
+// brings in all the descendants of node k that are three levels below it.
+constexpr size_t kPrefixesPerLine = CACHE_LINE_SIZE / sizeof(uint64_t);
+
+uint64_t BigEndianPrefix(const Slice& key) {
+  uint64_t result = 0;
+  size_t n = std::min(key.size(), sizeof(uint64_t));
+  for (size_t i = 0; i < n; ++i) {
+    result |= uint64_t{static_cast<unsigned char>(key[i])}
+              << (8 * (sizeof(uint64_t) - 1 - i));
+  }
+  return result;
+}
+
+// Lays out sorted[] into eytzinger[] (1-based) by an in-order walk of the
+// implicit tree rooted at node k. Returns the next unconsumed sorted index.
+size_t FillEytzinger(const uint64_t* sorted, size_t n, size_t i, size_t k,
+                     uint64_t* eytzinger, uint32_t* ranks) {
+  if (k <= n) {
+    i = FillEytzinger(sorted, n, i, 2 * k, eytzinger, ranks);
+    eytzinger[k] = sorted[i];
+    ranks[k] = static_cast<uint32_t>(i);
+    ++i;
+    i = FillEytzinger(sorted, n, i, 2 * k + 1, eytzinger, ranks);
+  }
+  return i;
+}
+}  // namespace
+
+bool LevelSearchIndex::IsSupported(const Comparator* ucmp) {
+  return ucmp != nullptr && ucmp->timestamp_size() == 0 &&
+         (ucmp == BytewiseComparator() || ucmp == ReverseBytewiseComparator());
+}
+
+const LevelSearchIndex* LevelSearchIndex::Create(
+    const Comparator* ucmp, const LevelFilesBrief& file_level, Arena* arena) {
+  assert(arena);
+  if (!IsSupported(ucmp) || file_level.num_files == 0 ||
+      file_level.num_files >= std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  const size_t n = file_level.num_files;
+  const bool reverse = ucmp == ReverseBytewiseComparator();
+
+  // Cache-line align the prefix array so that each prefetch covers exactly
+  // one group of descendants.
+  char* mem = arena->AllocateAligned((n + 1) * sizeof(uint64_t) +
+                                     CACHE_LINE_SIZE);
+  uint64_t* prefixes = reinterpret_cast<uint64_t*>(
+      (reinterpret_cast<uintptr_t>(mem) + CACHE_LINE_SIZE - 1) &
+      ~(uintptr_t{CACHE_LINE_SIZE} - 1));
+  uint32_t* ranks = reinterpret_cast<uint32_t*>(
+      arena->AllocateAligned((n + 1) * sizeof(uint32_t)));
+
+  std::unique_ptr<uint64_t[]> sorted(new uint64_t[n]);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t p =
+        BigEndianPrefix(ExtractUserKey(file_level.files[i].largest_key));
+    sorted[i] = reverse ? ~p : p;
+    assert(i == 0 || sorted[i - 1] <= sorted[i]);
+  }
+  prefixes[0] = 0;
+  ranks[0] = 0;
+  size_t filled = FillEytzinger(sorted.get(), n, 0, 1, prefixes, ranks);
+  assert(filled == n);
+  (void)filled;
+
+  char* obj = arena->AllocateAligned(sizeof(LevelSearchIndex));
+  return new (obj) LevelSearchIndex(n, reverse, prefixes, ranks);
+}
+
+uint64_t LevelSearchIndex::KeyPrefix(const Slice& user_key) const {
+  uint64_t p = BigEndianPrefix(user_key);
+  return reverse_ ? ~p : p;
+}
+
+template <bool kStrict>
+uint32_t LevelSearchIndex::Search(uint64_t prefix) const {
+  size_t k = 1;
+  while (k <= num_files_) {
+    PREFETCH(prefixes_ + k * kPrefixesPerLine, 0 /* rw */, 1 /* locality */);
+    bool go_right = kStrict ? prefixes_[k] <= prefix : prefixes_[k] < prefix;
+    k = 2 * k + (go_right ? 1 : 0);
+  }
+  // Undo the trailing right turns (plus the final left turn) to recover the
+  // last node where the search went left, which is the answer.
+  k >>= CountTrailingZeroBits(~k) + 1;
+  return k == 0 ? static_cast<uint32_t>(num_files_) : ranks_[k];
+}
+
+void LevelSearchIndex::Narrow(const Slice& user_key, uint32_t* left,
+                              uint32_t* right) const {
+  assert(left != nullptr && right != nullptr);
+  const uint64_t prefix = KeyPrefix(user_key);
+  // Files with a smaller prefix end strictly before user_key, and files with
+  // a larger prefix end strictly after it.
+  *left = Search</*kStrict=*/false>(prefix);
+  *right = *left == num_files_ ? *left : Search</*kStrict=*/true>(prefix);
+  assert(*left <= *right);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
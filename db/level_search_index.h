@@ -0,0 +1,86 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "memory/arena.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Comparator;
+struct LevelFilesBrief;
+
+// A compact, cache-friendly search structure over the files of one sorted
+// level (level > 0), built once per Version for levels with many files.
+//
+// Binary searching LevelFilesBrief touches a different FdWithKeyRange (and
+// the key bytes it points to) on every step, so a lookup on a level with tens
+// of thousands of files takes a dozen or more dependent cache misses before
+// any table is read. Instead, this index keeps the first 8 bytes of every
+// file's largest user key as a fixed-width integer in Eytzinger (BFS) order,
+// so the top levels of the implicit search tree share a few cache lines and
+// deeper nodes can be prefetched several steps ahead.
+//
+// Fixed-width prefixes are only order-preserving for bytewise-style
+// comparators, so the index is only built for BytewiseComparator() and
+// ReverseBytewiseComparator() without user-defined timestamps. Because
+// distinct keys can share a prefix, the index only narrows the candidate
+// range; the final decision among files whose prefix equals the lookup key's
+// prefix still uses full internal key comparisons.
+class LevelSearchIndex {
+ public:
+  // Returns true if an index can be built for keys ordered by `ucmp`.
+  static bool IsSupported(const Comparator* ucmp);
+
+  // Builds an index over the files of `file_level`, with all memory
+  // allocated from `arena`. Returns nullptr if the comparator is not
+  // supported. `file_level` must be sorted and non-overlapping.
+  static const LevelSearchIndex* Create(const Comparator* ucmp,
+                                        const LevelFilesBrief& file_level,
+                                        Arena* arena);
+
+  // Narrows the search for the first file whose largest key is >= a lookup
+  // key with user key `user_key`. On return, every file before *left is known
+  // to end before `user_key`, and every file at or after *right is known to
+  // end after it, so the answer is in [*left, *right] (where *right means
+  // "the first file past the narrowed range").
+  void Narrow(const Slice& user_key, uint32_t* left, uint32_t* right) const;
+
+  size_t num_files() const { return num_files_; }
+
+  // Approximate memory used by the index, for testing and accounting.
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + (num_files_ + 1) * (sizeof(uint64_t) +
+                                               sizeof(uint32_t));
+  }
+
+ private:
+  LevelSearchIndex(size_t num_files, bool reverse, uint64_t* prefixes,
+                   uint32_t* ranks)
+      : num_files_(num_files),
+        reverse_(reverse),
+        prefixes_(prefixes),
+        ranks_(ranks) {}
+
+  uint64_t KeyPrefix(const Slice& user_key) const;
+
+  // Returns the sorted position of the first prefix that is >= `prefix`
+  // (kStrict == false) or > `prefix` (kStrict == true).
+  template <bool kStrict>
+  uint32_t Search(uint64_t prefix) const;
+
+  size_t num_files_;
+  bool reverse_;
+  // 1-based array of num_files_ key prefixes in Eytzinger order. Slot 0 is
+  // unused so that the children of node k are 2k and 2k+1.
+  uint64_t* prefixes_;
+  // Maps an Eytzinger slot back to the file's position in the level.
+  uint32_t* ranks_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
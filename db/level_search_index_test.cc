@@ -0,0 +1,159 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/level_search_index.h"
+
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "db/version_edit.h"
+#include "db/version_set.h"
+#include "port/stack_trace.h"
+#include "rocksdb/comparator.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class LevelSearchIndexTest : public testing::Test {
+ public:
+  ~LevelSearchIndexTest() override {
+    for (auto* f : files_) {
+      delete f;
+    }
+  }
+
+  // Adds a file covering [smallest, largest]. Files must be added in the
+  // comparator's order.
+  void AddFile(const std::string& smallest, const std::string& largest) {
+    auto* f = new FileMetaData();
+    f->smallest = InternalKey(smallest, 100, kTypeValue);
+    f->largest = InternalKey(largest, 100, kTypeValue);
+    files_.push_back(f);
+  }
+
+  void Build(const Comparator* ucmp) {
+    ucmp_ = ucmp;
+    DoGenerateLevelFilesBrief(&plain_, files_, &arena_);
+    DoGenerateLevelFilesBrief(&indexed_, files_, &arena_);
+    indexed_.search_index = LevelSearchIndex::Create(ucmp, indexed_, &arena_);
+    ASSERT_NE(indexed_.search_index, nullptr);
+    ASSERT_EQ(indexed_.search_index->num_files(), files_.size());
+  }
+
+  // Checks that the index never changes the result of FindFile().
+  void CheckKey(const std::string& user_key, SequenceNumber seq) {
+    InternalKeyComparator icmp(ucmp_);
+    InternalKey ikey(user_key, seq, kValueTypeForSeek);
+    int expected = FindFile(icmp, plain_, ikey.Encode());
+    int actual = FindFile(icmp, indexed_, ikey.Encode());
+    ASSERT_EQ(expected, actual) << "key: " << Slice(user_key).ToString(true)
+                                << " seq: " << seq;
+  }
+
+  const Comparator* ucmp_ = nullptr;
+  std::vector<FileMetaData*> files_;
+  Arena arena_;
+  LevelFilesBrief plain_;
+  LevelFilesBrief indexed_;
+};
+
+TEST_F(LevelSearchIndexTest, Supported) {
+  ASSERT_TRUE(LevelSearchIndex::IsSupported(BytewiseComparator()));
+  ASSERT_TRUE(LevelSearchIndex::IsSupported(ReverseBytewiseComparator()));
+  ASSERT_FALSE(LevelSearchIndex::IsSupported(test::Uint64Comparator()));
+  ASSERT_FALSE(
+      LevelSearchIndex::IsSupported(BytewiseComparatorWithU64Ts()));
+
+  AddFile("a", "b");
+  Arena arena;
+  LevelFilesBrief brief;
+  DoGenerateLevelFilesBrief(&brief, files_, &arena);
+  ASSERT_EQ(LevelSearchIndex::Create(test::Uint64Comparator(), brief, &arena),
+            nullptr);
+}
+
+TEST_F(LevelSearchIndexTest, SharedPrefixes) {
+  // Many files whose largest keys share the same 8-byte prefix, so the
+  // index can only narrow the search to that group.
+  AddFile("a", "b");
+  for (int i = 0; i < 50; ++i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "prefix00%04d", 2 * i);
+    std::string smallest = buf;
+    snprintf(buf, sizeof(buf), "prefix00%04d", 2 * i + 1);
+    AddFile(smallest, buf);
+  }
+  AddFile("prefix01", "prefix02");
+  AddFile("z", "zz");
+  Build(BytewiseComparator());
+
+  for (const char* k : {"", "a", "b", "c", "prefix", "prefix00",
+                        "prefix000000", "prefix000049", "prefix000050",
+                        "prefix000099", "prefix0001", "prefix01", "prefix015",
+                        "prefix02", "prefix03", "y", "z", "zz", "zzz"}) {
+    CheckKey(k, kMaxSequenceNumber);
+    CheckKey(k, 100);
+    CheckKey(k, 0);
+  }
+}
+
+TEST_F(LevelSearchIndexTest, RandomBytewise) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(rnd.RandomBinaryString(1 + rnd.Uniform(12)));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  for (size_t i = 0; i + 1 < keys.size(); i += 2) {
+    AddFile(keys[i], keys[i + 1]);
+  }
+  Build(BytewiseComparator());
+
+  for (const auto& k : keys) {
+    CheckKey(k, kMaxSequenceNumber);
+    CheckKey(k, 50);
+  }
+  for (int i = 0; i < 2000; ++i) {
+    CheckKey(rnd.RandomBinaryString(rnd.Uniform(12)), kMaxSequenceNumber);
+  }
+}
+
+TEST_F(LevelSearchIndexTest, RandomReverseBytewise) {
+  Random rnd(302);
+  const Comparator* ucmp = ReverseBytewiseComparator();
+  std::vector<std::string> keys;
+  for (int i = 0; i < 2000; ++i) {
+    keys.push_back(rnd.RandomBinaryString(1 + rnd.Uniform(12)));
+  }
+  std::sort(keys.begin(), keys.end(),
+            [&](const std::string& a, const std::string& b) {
+              return ucmp->Compare(a, b) < 0;
+            });
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  for (size_t i = 0; i + 1 < keys.size(); i += 2) {
+    AddFile(keys[i], keys[i + 1]);
+  }
+  Build(ucmp);
+
+  for (const auto& k : keys) {
+    CheckKey(k, kMaxSequenceNumber);
+    CheckKey(k, 50);
+  }
+  for (int i = 0; i < 2000; ++i) {
+    CheckKey(rnd.RandomBinaryString(rnd.Uniform(12)), kMaxSequenceNumber);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -389,6 +389,12 @@ bool MemTableList::IsFlushPendingOrRunning() const {
   return IsFlushPending();
 }
 
+bool MemTableList::IsOnlyFlushRunning(
+    const autovector<MemTable*>& mems) const {
+  assert(current_->memlist_.size() - num_flush_not_started_ >= mems.size());
+  return current_->memlist_.size() - num_flush_not_started_ == mems.size();
+}
+
 // Returns the memtables that need to be flushed.
 void MemTableList::PickMemtablesToFlush(uint64_t max_memtable_id,
                                         autovector<MemTable*>* ret,
@@ -265,6 +265,10 @@ class MemTableList {
   // flushing.
   bool IsFlushPendingOrRunning() const;
 
+  // Returns true if `mems`, which are being flushed, are the only memtables
+  // being flushed or waiting for their flush to be installed.
+  bool IsOnlyFlushRunning(const autovector<MemTable*>& mems) const;
+
   // Returns the earliest memtables that needs to be flushed. The returned
   // memtables are guaranteed to be in the ascending order of created time.
   void PickMemtablesToFlush(uint64_t max_memtable_id,
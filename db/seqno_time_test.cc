@@ -269,6 +269,56 @@ TEST_F(SeqnoTimeTest, TemperatureBasicLevel) {
   Close();
 }
 
+TEST_F(SeqnoTimeTest, DeletePersistenceWithoutFlush) {
+  const uint64_t kDeadline = 10000;
+  Options options = CurrentOptions();
+  options.env = mock_env_.get();
+  options.max_open_files = -1;
+  options.level_compaction_dynamic_level_bytes = true;
+  options.max_delete_persistence_seconds = kDeadline;
+  DestroyAndReopen(options);
+
+  int delete_persistence_compactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* compaction = static_cast<Compaction*>(arg);
+        if (compaction->compaction_reason() ==
+            CompactionReason::kDeletePersistence) {
+          delete_persistence_compactions++;
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "value"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_OK(Delete(Key(5)));
+  ASSERT_OK(Flush());
+
+  // No more writes or flushes: the deadline is re-evaluated by the periodic
+  // seqno to time recording.
+  dbfull()->TEST_WaitForPeriodicTaskRun([&] {
+    mock_clock_->MockSleepForSeconds(static_cast<int>(kDeadline / 2));
+  });
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("1,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(0, delete_persistence_compactions);
+
+  dbfull()->TEST_WaitForPeriodicTaskRun([&] {
+    mock_clock_->MockSleepForSeconds(static_cast<int>(kDeadline / 2 + 1));
+  });
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("0,0,0,0,0,0,1", FilesPerLevel());
+  ASSERT_EQ(1, delete_persistence_compactions);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  Close();
+}
+
 enum class SeqnoTimeTestType : char {
   kTrackInternalTimeSeconds = 0,
   kPrecludeLastLevel = 1,
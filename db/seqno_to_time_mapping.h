@@ -235,6 +235,16 @@ class SeqnoToTimeMapping {
   // If the internal list is empty
   bool Empty() const { return pairs_.empty(); }
 
+  // Return the oldest known time, or kUnknownTimeBeforeAll if empty. Every
+  // sequence number for which GetProximalTimeBeforeSeqno() returns
+  // kUnknownTimeBeforeAll was written no later than this time.
+  // Because this is a const operation depending on sortedness, the structure
+  // must be in enforced state as a precondition.
+  uint64_t GetOldestTime() const {
+    assert(enforced_);
+    return pairs_.empty() ? kUnknownTimeBeforeAll : pairs_.front().time;
+  }
+
   // return the string for user message
   // Note: Not efficient, okay for print
   std::string ToHumanString() const;
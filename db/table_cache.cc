@@ -436,7 +436,7 @@ Status TableCache::Get(
     uint8_t block_protection_bytes_per_key,
     const std::shared_ptr<const SliceTransform>& prefix_extractor,
     HistogramImpl* file_read_hist, bool skip_filters, int level,
-    size_t max_file_size_for_l0_meta_pin) {
+    size_t max_file_size_for_l0_meta_pin, bool skip_range_deletions) {
   auto& fd = file_meta.fd;
   std::string* row_cache_entry = nullptr;
   bool done = false;
@@ -473,7 +473,7 @@ Status TableCache::Get(
     SequenceNumber* max_covering_tombstone_seq =
         get_context->max_covering_tombstone_seq();
     if (s.ok() && max_covering_tombstone_seq != nullptr &&
-        !options.ignore_range_deletions) {
+        !options.ignore_range_deletions && !skip_range_deletions) {
       std::unique_ptr<FragmentedRangeTombstoneIterator> range_del_iter(
           t->NewRangeTombstoneIterator(options));
       if (range_del_iter != nullptr) {
@@ -547,7 +547,7 @@ Status TableCache::MultiGetFilter(
     const std::shared_ptr<const SliceTransform>& prefix_extractor,
     HistogramImpl* file_read_hist, int level,
     MultiGetContext::Range* mget_range, TypedHandle** table_handle,
-    uint8_t block_protection_bytes_per_key) {
+    uint8_t block_protection_bytes_per_key, bool skip_range_deletions) {
   auto& fd = file_meta.fd;
   IterKey row_cache_key;
   std::string row_cache_entry_buffer;
@@ -580,7 +580,7 @@ Status TableCache::MultiGetFilter(
   if (s.ok()) {
     s = t->MultiGetFilter(options, prefix_extractor.get(), mget_range);
   }
-  if (s.ok() && !options.ignore_range_deletions) {
+  if (s.ok() && !options.ignore_range_deletions && !skip_range_deletions) {
     // Update the range tombstone sequence numbers for the keys here
     // as TableCache::MultiGet may or may not be called, and even if it
     // is, it may be called with fewer keys in the rangedue to filtering.
@@ -646,6 +646,53 @@ Status TableCache::ApproximateKeyAnchors(
   return s;
 }
 
+Status TableCache::WarmUpBlockCache(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+    const std::vector<uint64_t>& block_offsets,
+    const std::function<bool(uint64_t)>& before_read) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle,
+                  block_protection_bytes_per_key);
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->WarmUpBlockCache(ro, block_offsets, before_read);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
+Status TableCache::ReadRawDataBlock(
+    const ReadOptions& ro, const InternalKeyComparator& internal_comparator,
+    const FileMetaData& file_meta, uint8_t block_protection_bytes_per_key,
+    const Slice& key, RawDataBlock* block) {
+  Status s;
+  TableReader* t = file_meta.fd.table_reader;
+  TypedHandle* handle = nullptr;
+  if (t == nullptr) {
+    s = FindTable(ro, file_options_, internal_comparator, file_meta, &handle,
+                  block_protection_bytes_per_key);
+    if (s.ok()) {
+      t = cache_.Value(handle);
+    }
+  }
+  if (s.ok() && t != nullptr) {
+    s = t->ReadRawDataBlock(ro, key, block);
+  }
+  if (handle != nullptr) {
+    cache_.Release(handle);
+  }
+  return s;
+}
+
 size_t TableCache::GetMemoryUsageByTableReader(
     const FileOptions& file_options, const ReadOptions& read_options,
     const InternalKeyComparator& internal_comparator,
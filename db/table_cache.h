@@ -112,6 +112,8 @@ class TableCache {
   //                       recorded
   // @param skip_filters Disables loading/accessing the filter block
   // @param level The level this table is at, -1 for "not set / don't know"
+  // @param skip_range_deletions Do not apply the file's range tombstones,
+  //                             because the caller already did
   Status Get(
       const ReadOptions& options,
       const InternalKeyComparator& internal_comparator,
@@ -119,7 +121,8 @@ class TableCache {
       uint8_t block_protection_bytes_per_key,
       const std::shared_ptr<const SliceTransform>& prefix_extractor = nullptr,
       HistogramImpl* file_read_hist = nullptr, bool skip_filters = false,
-      int level = -1, size_t max_file_size_for_l0_meta_pin = 0);
+      int level = -1, size_t max_file_size_for_l0_meta_pin = 0,
+      bool skip_range_deletions = false);
 
   // Return the range delete tombstone iterator of the file specified by
   // `file_meta`.
@@ -141,7 +144,8 @@ class TableCache {
       const std::shared_ptr<const SliceTransform>& prefix_extractor,
       HistogramImpl* file_read_hist, int level,
       MultiGetContext::Range* mget_range, TypedHandle** table_handle,
-      uint8_t block_protection_bytes_per_key);
+      uint8_t block_protection_bytes_per_key,
+      bool skip_range_deletions = false);
 
   // If a seek to internal key "k" in specified file finds an entry,
   // call get_context->SaveValue() repeatedly until
@@ -209,6 +213,23 @@ class TableCache {
                                uint8_t block_protection_bytes_per_key,
                                std::vector<TableReader::Anchor>& anchors);
 
+  // Loads data blocks of the file into the block cache. See
+  // TableReader::WarmUpBlockCache().
+  Status WarmUpBlockCache(const ReadOptions& ro,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileMetaData& file_meta,
+                          uint8_t block_protection_bytes_per_key,
+                          const std::vector<uint64_t>& block_offsets,
+                          const std::function<bool(uint64_t)>& before_read);
+
+  // Reads a data block of the file as stored. See
+  // TableReader::ReadRawDataBlock().
+  Status ReadRawDataBlock(const ReadOptions& ro,
+                          const InternalKeyComparator& internal_comparator,
+                          const FileMetaData& file_meta,
+                          uint8_t block_protection_bytes_per_key,
+                          const Slice& key, RawDataBlock* block);
+
   // Return total memory usage of the table reader of the file.
   // 0 if table reader of the file is not loaded.
   size_t GetMemoryUsageByTableReader(
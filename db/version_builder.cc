@@ -27,6 +27,7 @@
 #include "db/blob/blob_file_meta.h"
 #include "db/dbformat.h"
 #include "db/internal_stats.h"
+#include "db/l0_key_filter.h"
 #include "db/table_cache.h"
 #include "db/version_edit.h"
 #include "db/version_edit_handler.h"
@@ -428,6 +429,11 @@ class VersionBuilder::Rep {
   void UnrefFile(FileMetaData* f) {
     f->refs--;
     if (f->refs <= 0) {
+      if (f->l0_key_filter_slot >= 0) {
+        // Added by a flush whose Version was never installed
+        cfd_->l0_key_filter()->RemoveFile(f->l0_key_filter_slot,
+                                          f->fd.GetNumber());
+      }
       if (f->table_reader_handle) {
         assert(table_cache_ != nullptr);
         // NOTE: have to release in raw cache interface to avoid using a
@@ -965,6 +971,11 @@ class VersionBuilder::Rep {
 
     FileMetaData* const f = new FileMetaData(meta);
     f->refs = 1;
+    if (level != 0) {
+      // A file moved out of L0 keeps its slot only in the L0 copy, which
+      // frees it
+      f->l0_key_filter_slot = -1;
+    }
 
     if (file_metadata_cache_res_mgr_) {
       Status s = file_metadata_cache_res_mgr_->UpdateCacheReservation(
@@ -104,6 +104,7 @@ enum NewFileCustomTag : uint32_t {
 };
 
 class VersionSet;
+class LevelSearchIndex;
 
 constexpr uint64_t kFileNumberMask = 0x3FFFFFFFFFFFFFFF;
 constexpr uint64_t kUnknownOldestAncesterTime = 0;
@@ -258,6 +259,10 @@ struct FileMetaData {
   // false, it's explicitly written to Manifest.
   bool user_defined_timestamps_persisted = true;
 
+  // Slot of this L0 file in the column family's L0KeyFilter, or -1 if the
+  // filter does not cover it. In memory only.
+  int l0_key_filter_slot = -1;
+
   FileMetaData() = default;
 
   FileMetaData(uint64_t file, uint32_t file_path_id, uint64_t file_size,
@@ -333,6 +338,17 @@ struct FileMetaData {
     return kUnknownFileCreationTime;
   }
 
+  // Time no later than the write of the oldest tombstone in the file, from
+  // the table properties if the table reader is pinned. 0 means no
+  // tombstones or not available.
+  uint64_t TryGetOldestTombstoneTime() const {
+    if (fd.table_reader != nullptr &&
+        fd.table_reader->GetTableProperties() != nullptr) {
+      return fd.table_reader->GetTableProperties()->oldest_tombstone_time;
+    }
+    return 0;
+  }
+
   // WARNING: manual update to this function is needed
   // whenever a new string property is added to FileMetaData
   // to reduce approximation error.
@@ -377,9 +393,14 @@ struct FdWithKeyRange {
 struct LevelFilesBrief {
   size_t num_files;
   FdWithKeyRange* files;
+  // Optional accelerated search structure over `files`. Only set for sorted
+  // levels of a Version when enabled by
+  // `level_search_index_min_files`.
+  const LevelSearchIndex* search_index;
   LevelFilesBrief() {
     num_files = 0;
     files = nullptr;
+    search_index = nullptr;
   }
 };
 
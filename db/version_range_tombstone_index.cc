@@ -0,0 +1,153 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/version_range_tombstone_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include "db/range_tombstone_fragmenter.h"
+#include "rocksdb/comparator.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+int VersionRangeTombstoneIndex::Builder::CompareBound(const Bound& a,
+                                                      const Bound& b) const {
+  int cmp = ucmp_->Compare(a.key, b.key);
+  if (cmp != 0) {
+    return cmp;
+  }
+  return static_cast<int>(a.after) - static_cast<int>(b.after);
+}
+
+void VersionRangeTombstoneIndex::Builder::AddFile(
+    int level, uint64_t file_number, const Slice& smallest,
+    const Slice& largest, FragmentedRangeTombstoneIterator* iter) {
+  // Point lookups search a file for user keys in [smallest, largest]. In
+  // sorted levels, a largest key that is a range tombstone sentinel means
+  // the file's tombstones were truncated before that user key, and lookups
+  // for it go to the next file instead.
+  Bound lower{ExtractUserKey(smallest).ToString(), false};
+  bool largest_is_sentinel =
+      ExtractInternalKeyFooter(largest) ==
+      PackSequenceAndType(kMaxSequenceNumber, kTypeRangeDeletion);
+  Bound upper{ExtractUserKey(largest).ToString(),
+              level == 0 || !largest_is_sentinel};
+
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    Tombstone t{Bound{iter->start_key().ToString(), false},
+                Bound{iter->end_key().ToString(), false}, iter->seq(), level,
+                file_number};
+    if (CompareBound(t.start, lower) < 0) {
+      t.start = lower;
+    }
+    if (CompareBound(t.end, upper) > 0) {
+      t.end = upper;
+    }
+    if (CompareBound(t.start, t.end) < 0) {
+      tombstones_.push_back(std::move(t));
+    }
+  }
+}
+
+std::unique_ptr<VersionRangeTombstoneIndex>
+VersionRangeTombstoneIndex::Builder::Finish() {
+  if (tombstones_.empty()) {
+    return nullptr;
+  }
+
+  // Sweep over the sorted start and end bounds of all tombstones, emitting a
+  // fragment at every distinct bound with the tombstones active after it.
+  struct Event {
+    const Bound* bound;
+    size_t tombstone;
+    bool start;
+  };
+  std::vector<Event> events;
+  events.reserve(tombstones_.size() * 2);
+  for (size_t i = 0; i < tombstones_.size(); ++i) {
+    events.push_back({&tombstones_[i].start, i, true});
+    events.push_back({&tombstones_[i].end, i, false});
+  }
+  std::sort(events.begin(), events.end(),
+            [this](const Event& a, const Event& b) {
+              return CompareBound(*a.bound, *b.bound) < 0;
+            });
+
+  std::unique_ptr<VersionRangeTombstoneIndex> index(
+      new VersionRangeTombstoneIndex(ucmp_));
+  using ActiveTombstone = std::tuple<SequenceNumber, int, uint64_t>;
+  std::multiset<ActiveTombstone, std::greater<ActiveTombstone>> active;
+  for (size_t i = 0; i < events.size();) {
+    const Bound& bound = *events[i].bound;
+    for (; i < events.size() && CompareBound(*events[i].bound, bound) == 0;
+         ++i) {
+      const Tombstone& t = tombstones_[events[i].tombstone];
+      if (events[i].start) {
+        active.emplace(t.seq, t.level, t.file_number);
+      } else {
+        active.erase(
+            active.find(ActiveTombstone(t.seq, t.level, t.file_number)));
+      }
+    }
+    if (active.empty() && (index->fragments_.empty() ||
+                           index->fragments_.back().seq_begin ==
+                               index->fragments_.back().seq_end)) {
+      // Consecutive empty fragments are redundant.
+      continue;
+    }
+    Fragment f;
+    f.key_offset = static_cast<uint32_t>(index->keys_.size());
+    f.key_size = static_cast<uint32_t>(bound.key.size());
+    f.after = bound.after;
+    f.seq_begin = static_cast<uint32_t>(index->seqs_.size());
+    for (const auto& s : active) {
+      index->seqs_.push_back(
+          {std::get<0>(s), std::get<1>(s), std::get<2>(s)});
+    }
+    f.seq_end = static_cast<uint32_t>(index->seqs_.size());
+    index->keys_.append(bound.key);
+    index->fragments_.push_back(f);
+  }
+  assert(active.empty());
+  tombstones_.clear();
+  return index;
+}
+
+SequenceNumber VersionRangeTombstoneIndex::MaxCoveringTombstoneSeqnum(
+    const Slice& user_key, SequenceNumber upper_bound, int* level,
+    uint64_t* file_number) const {
+  // Find the last fragment starting at or before `user_key`, i.e. the first
+  // fragment starting after it, minus one.
+  auto it = std::upper_bound(
+      fragments_.begin(), fragments_.end(), user_key,
+      [this](const Slice& key, const Fragment& f) {
+        int cmp = ucmp_->Compare(key, FragmentKey(f));
+        return cmp < 0 || (cmp == 0 && f.after);
+      });
+  if (it == fragments_.begin()) {
+    return 0;
+  }
+  --it;
+  const FileSeq* begin = seqs_.data() + it->seq_begin;
+  const FileSeq* end = seqs_.data() + it->seq_end;
+  // Sequence numbers are in decreasing order, so the first one visible at
+  // `upper_bound` is the answer. Without a snapshot that is the first one.
+  const FileSeq* found = std::lower_bound(
+      begin, end, upper_bound, [](const FileSeq& s, SequenceNumber bound) {
+        return s.seq > bound;
+      });
+  if (found == end) {
+    return 0;
+  }
+  *level = found->level;
+  *file_number = found->file_number;
+  return found->seq;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,133 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Comparator;
+class FragmentedRangeTombstoneIterator;
+
+// An immutable interval index over the range tombstones of every file in a
+// Version, built lazily on the first point lookup that needs it (see
+// `range_tombstone_index_min_tombstones`).
+//
+// Without it, a point lookup creates a FragmentedRangeTombstoneIterator and
+// binary searches the tombstones of every file it visits. The index merges
+// all files' tombstones, clipped to the user key range each file answers
+// lookups for, into a single sorted array of non-overlapping fragments. Each
+// fragment keeps the sequence numbers (and files) of the tombstones covering
+// it in decreasing order, so the newest visible covering tombstone for a key
+// is one binary search plus, usually, one comparison.
+//
+// Tombstones always have larger sequence numbers than the keys they cover in
+// files searched after theirs, so the newest covering tombstone also comes
+// from the first covering file a lookup searches. Lookups report that file
+// and its level so that readers only apply the tombstone once they reach it,
+// exactly as if they had read it from the file. Within L0, newer files are
+// searched first whatever their level, hence the file and not only the level.
+class VersionRangeTombstoneIndex {
+ public:
+  class Builder {
+   public:
+    explicit Builder(const Comparator* ucmp) : ucmp_(ucmp) {}
+
+    // Adds the tombstones of file `file_number` at `level` with the given
+    // smallest and largest internal keys. Only the part of each tombstone
+    // within the user key range that point lookups search in this file is
+    // indexed.
+    void AddFile(int level, uint64_t file_number, const Slice& smallest,
+                 const Slice& largest, FragmentedRangeTombstoneIterator* iter);
+
+    size_t NumTombstones() const { return tombstones_.size(); }
+
+    // Returns nullptr if no tombstones were added.
+    std::unique_ptr<VersionRangeTombstoneIndex> Finish();
+
+   private:
+    // A position between user keys: just before `key` (after == false) or
+    // just after it (after == true).
+    struct Bound {
+      std::string key;
+      bool after;
+    };
+    struct Tombstone {
+      Bound start;
+      Bound end;
+      SequenceNumber seq;
+      int level;
+      uint64_t file_number;
+    };
+
+    int CompareBound(const Bound& a, const Bound& b) const;
+
+    const Comparator* ucmp_;
+    std::vector<Tombstone> tombstones_;
+  };
+
+  // Returns the sequence number of the newest tombstone covering `user_key`
+  // that is visible at `upper_bound`, or 0 if there is none. If non-zero,
+  // `*level` and `*file_number` are set to those of the file holding the
+  // tombstone.
+  SequenceNumber MaxCoveringTombstoneSeqnum(const Slice& user_key,
+                                            SequenceNumber upper_bound,
+                                            int* level,
+                                            uint64_t* file_number) const;
+
+  // Whether a lookup that reached the file `hit_file_number` at `hit_level`
+  // has searched the file at `level` and `file_number` holding a tombstone
+  static bool ReachedTombstoneFile(int hit_level, uint64_t hit_file_number,
+                                   int level, uint64_t file_number) {
+    return hit_level > level || hit_file_number == file_number;
+  }
+
+  size_t NumFragments() const { return fragments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + keys_.capacity() +
+           fragments_.capacity() * sizeof(Fragment) +
+           seqs_.capacity() * sizeof(FileSeq);
+  }
+
+ private:
+  // A fragment covers the user keys from its start bound up to the start
+  // bound of the next fragment. Fragments with no tombstones are kept to
+  // mark the end of the previous fragment.
+  struct Fragment {
+    uint32_t key_offset;
+    uint32_t key_size;
+    bool after;
+    // Range of `seqs_` with the tombstones covering this fragment, newest
+    // first.
+    uint32_t seq_begin;
+    uint32_t seq_end;
+  };
+  struct FileSeq {
+    SequenceNumber seq;
+    int level;
+    uint64_t file_number;
+  };
+
+  explicit VersionRangeTombstoneIndex(const Comparator* ucmp) : ucmp_(ucmp) {}
+
+  Slice FragmentKey(const Fragment& f) const {
+    return Slice(keys_.data() + f.key_offset, f.key_size);
+  }
+
+  const Comparator* ucmp_;
+  std::string keys_;
+  std::vector<Fragment> fragments_;
+  std::vector<FileSeq> seqs_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -29,6 +29,8 @@
 #include "db/compaction/file_pri.h"
 #include "db/dbformat.h"
 #include "db/internal_stats.h"
+#include "db/l0_key_filter.h"
+#include "db/level_search_index.h"
 #include "db/log_reader.h"
 #include "db/log_writer.h"
 #include "db/memtable.h"
@@ -99,6 +101,26 @@ namespace {
 int FindFileInRange(const InternalKeyComparator& icmp,
                     const LevelFilesBrief& file_level, const Slice& key,
                     uint32_t left, uint32_t right) {
+  // For small ranges (e.g. narrow FileIndexer hints) a plain binary search
+  // is already cheap.
+  constexpr uint32_t kMinRangeForSearchIndex = 16;
+  if (file_level.search_index != nullptr &&
+      right - left >= kMinRangeForSearchIndex) {
+    // Let the cache-friendly prefix index cut the range down before
+    // comparing full keys. The answer over the whole level lies in
+    // [index_left, index_right], so clamping that to [left, right] gives the
+    // answer within the requested range.
+    assert(file_level.search_index->num_files() == file_level.num_files);
+    uint32_t index_left = 0;
+    uint32_t index_right = 0;
+    file_level.search_index->Narrow(ExtractUserKey(key), &index_left,
+                                    &index_right);
+    left = std::min(std::max(index_left, left), right);
+    right = std::min(std::max(index_right, left), right);
+    if (left == right) {
+      return static_cast<int>(left);
+    }
+  }
   auto cmp = [&](const FdWithKeyRange& f, const Slice& k) -> bool {
     return icmp.InternalKeyComparator::Compare(f.largest_key, k) < 0;
   };
@@ -146,7 +168,8 @@ class FilePicker {
   FilePicker(const Slice& user_key, const Slice& ikey,
              autovector<LevelFilesBrief>* file_levels, unsigned int num_levels,
              FileIndexer* file_indexer, const Comparator* user_comparator,
-             const InternalKeyComparator* internal_comparator)
+             const InternalKeyComparator* internal_comparator,
+             uint64_t l0_key_filter_mask = ~uint64_t{0})
       : num_levels_(num_levels),
         curr_level_(static_cast<unsigned int>(-1)),
         returned_file_level_(static_cast<unsigned int>(-1)),
@@ -160,7 +183,8 @@ class FilePicker {
         ikey_(ikey),
         file_indexer_(file_indexer),
         user_comparator_(user_comparator),
-        internal_comparator_(internal_comparator) {
+        internal_comparator_(internal_comparator),
+        l0_key_filter_mask_(l0_key_filter_mask) {
     // Setup member variables to search first level.
     search_ended_ = !PrepareNextLevel();
     if (!search_ended_) {
@@ -181,6 +205,14 @@ class FilePicker {
       while (curr_index_in_curr_level_ < curr_file_level_->num_files) {
         // Loops over all files in current level.
         FdWithKeyRange* f = &curr_file_level_->files[curr_index_in_curr_level_];
+        if (curr_level_ == 0) {
+          const int slot = f->file_metadata->l0_key_filter_slot;
+          if (slot >= 0 && (l0_key_filter_mask_ & (uint64_t{1} << slot)) == 0) {
+            // The L0 key filter rules out this file
+            ++curr_index_in_curr_level_;
+            continue;
+          }
+        }
         hit_file_level_ = curr_level_;
         is_hit_file_last_in_level_ =
             curr_index_in_curr_level_ == curr_file_level_->num_files - 1;
@@ -271,6 +303,9 @@ class FilePicker {
   FileIndexer* file_indexer_;
   const Comparator* user_comparator_;
   const InternalKeyComparator* internal_comparator_;
+  // Bit i clear if the L0 file in slot i of the L0 key filter does not
+  // contain the key
+  uint64_t l0_key_filter_mask_;
 
   // Setup local variables to search next level.
   // Returns false if there are no more levels to search.
@@ -857,6 +892,10 @@ Version::~Version() {
       f->refs--;
       if (f->refs <= 0) {
         assert(cfd_ != nullptr);
+        if (f->l0_key_filter_slot >= 0) {
+          cfd_->l0_key_filter()->RemoveFile(f->l0_key_filter_slot,
+                                            f->fd.GetNumber());
+        }
         // When not in the process of closing the DB, we'll have a superversion
         // to get current mutable options from
         auto* sv = cfd_->GetSuperVersion();
@@ -885,6 +924,7 @@ void DoGenerateLevelFilesBrief(LevelFilesBrief* file_level,
 
   size_t num = files.size();
   file_level->num_files = num;
+  file_level->search_index = nullptr;
   char* mem = arena->AllocateAligned(num * sizeof(FdWithKeyRange));
   file_level->files = new (mem) FdWithKeyRange[num];
 
@@ -2423,10 +2463,37 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
     pinned_iters_mgr->StartPinning();
   }
 
+  // With the range tombstone index, the newest covering tombstone is known
+  // upfront. It is only applied once the search reaches the tombstone's
+  // file, as if it had been read from there, so that newer entries in the
+  // files searched before it are still found.
+  const VersionRangeTombstoneIndex* range_tombstone_index =
+      GetRangeTombstoneIndex(read_options);
+  SequenceNumber indexed_tombstone_seq = 0;
+  int indexed_tombstone_level = 0;
+  uint64_t indexed_tombstone_file_number = 0;
+  if (range_tombstone_index != nullptr) {
+    indexed_tombstone_seq = range_tombstone_index->MaxCoveringTombstoneSeqnum(
+        user_key,
+        read_options.snapshot != nullptr
+            ? read_options.snapshot->GetSequenceNumber()
+            : kMaxSequenceNumber,
+        &indexed_tombstone_level, &indexed_tombstone_file_number);
+  }
+
+  uint64_t l0_key_filter_mask = ~uint64_t{0};
+  const L0KeyFilter* l0_key_filter =
+      cfd_ != nullptr ? cfd_->l0_key_filter() : nullptr;
+  if (l0_key_filter != nullptr && storage_info_.NumLevelFiles(0) > 0) {
+    l0_key_filter_mask = l0_key_filter->MayContain(
+        L0KeyFilter::HashKey(StripTimestampFromUserKey(
+            user_key, user_comparator()->timestamp_size())));
+  }
+
   FilePicker fp(user_key, ikey, &storage_info_.level_files_brief_,
                 storage_info_.num_non_empty_levels_,
                 &storage_info_.file_indexer_, user_comparator(),
-                internal_comparator());
+                internal_comparator(), l0_key_filter_mask);
   FdWithKeyRange* f = fp.GetNextFile();
 
   while (f != nullptr) {
@@ -2435,6 +2502,12 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       // stop here.
       break;
     }
+    if (indexed_tombstone_seq > *max_covering_tombstone_seq &&
+        VersionRangeTombstoneIndex::ReachedTombstoneFile(
+            static_cast<int>(fp.GetHitFileLevel()), f->fd.GetNumber(),
+            indexed_tombstone_level, indexed_tombstone_file_number)) {
+      *max_covering_tombstone_seq = indexed_tombstone_seq;
+    }
     if (get_context.sample()) {
       sample_file_read_inc(f->file_metadata);
     }
@@ -2450,7 +2523,8 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
         cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
         IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
                         fp.IsHitFileLastInLevel()),
-        fp.GetHitFileLevel(), max_file_size_for_l0_meta_pin_);
+        fp.GetHitFileLevel(), max_file_size_for_l0_meta_pin_,
+        /*skip_range_deletions=*/range_tombstone_index != nullptr);
     // TODO: examine the behavior for corrupted key
     if (timer_enabled) {
       PERF_COUNTER_BY_LEVEL_ADD(get_from_table_nanos, timer.ElapsedNanos(),
@@ -2617,6 +2691,23 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
     iter->get_context = &(get_ctx[get_ctx_index]);
   }
 
+  // See Version::Get(). MultiGetFromSST() applies the indexed tombstones.
+  const VersionRangeTombstoneIndex* range_tombstone_index =
+      GetRangeTombstoneIndex(read_options);
+  const bool range_tombstones_indexed = range_tombstone_index != nullptr;
+  if (range_tombstones_indexed) {
+    const SequenceNumber read_seq =
+        read_options.snapshot != nullptr
+            ? read_options.snapshot->GetSequenceNumber()
+            : kMaxSequenceNumber;
+    for (auto iter = range->begin(); iter != range->end(); ++iter) {
+      iter->indexed_tombstone_seq =
+          range_tombstone_index->MaxCoveringTombstoneSeqnum(
+              iter->ukey_with_ts, read_seq, &iter->indexed_tombstone_level,
+              &iter->indexed_tombstone_file_number);
+    }
+  }
+
   Status s;
   // blob_file => [[blob_idx, it], ...]
   std::unordered_map<uint64_t, BlobReadContexts> blob_ctxs;
@@ -2624,7 +2715,8 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
 #if USE_COROUTINES
   if (read_options.async_io && read_options.optimize_multiget_for_io &&
       using_coroutines() && use_async_io_) {
-    s = MultiGetAsync(read_options, range, &blob_ctxs);
+    s = MultiGetAsync(read_options, range, &blob_ctxs,
+                      range_tombstones_indexed);
   } else
 #endif  // USE_COROUTINES
   {
@@ -2658,7 +2750,8 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
           // Call MultiGetFromSST for looking up a single file
           s = MultiGetFromSST(read_options, fp.CurrentFileRange(),
                               fp.GetHitFileLevel(), skip_filters,
-                              /*skip_range_deletions=*/false, f, blob_ctxs,
+                              /*skip_range_deletions=*/range_tombstones_indexed,
+                              f, blob_ctxs,
                               /*table_handle=*/nullptr, num_filter_read,
                               num_index_read, num_sst_read);
           if (fp.GetHitFileLevel() == 0) {
@@ -2677,14 +2770,15 @@ void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
           bool skip_filters =
               IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
                               fp.IsHitFileLastInLevel());
-          bool skip_range_deletions = false;
+          bool skip_range_deletions = range_tombstones_indexed;
           if (!skip_filters) {
             Status status = table_cache_->MultiGetFilter(
                 read_options, *internal_comparator(), *f->file_metadata,
                 mutable_cf_options_.prefix_extractor,
                 cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
                 fp.GetHitFileLevel(), &file_range, &table_handle,
-                mutable_cf_options_.block_protection_bytes_per_key);
+                mutable_cf_options_.block_protection_bytes_per_key,
+                range_tombstones_indexed);
             skip_range_deletions = true;
             if (status.ok()) {
               skip_filters = true;
@@ -2841,7 +2935,8 @@ Status Version::ProcessBatch(
     autovector<FilePickerMultiGet, 4>& batches, std::deque<size_t>& waiting,
     std::deque<size_t>& to_process, unsigned int& num_tasks_queued,
     std::unordered_map<int, std::tuple<uint64_t, uint64_t, uint64_t>>&
-        mget_stats) {
+        mget_stats,
+    bool range_tombstones_indexed) {
   FilePickerMultiGet& fp = *batch;
   MultiGetRange range = fp.GetRange();
   // Initialize a new empty range. Any keys that are not in this level will
@@ -2864,14 +2959,15 @@ Status Version::ProcessBatch(
     TableCache::TypedHandle* table_handle = nullptr;
     bool skip_filters = IsFilterSkipped(static_cast<int>(fp.GetHitFileLevel()),
                                         fp.IsHitFileLastInLevel());
-    bool skip_range_deletions = false;
+    bool skip_range_deletions = range_tombstones_indexed;
     if (!skip_filters) {
       Status status = table_cache_->MultiGetFilter(
           read_options, *internal_comparator(), *f->file_metadata,
           mutable_cf_options_.prefix_extractor,
           cfd_->internal_stats()->GetFileReadHist(fp.GetHitFileLevel()),
           fp.GetHitFileLevel(), &file_range, &table_handle,
-          mutable_cf_options_.block_protection_bytes_per_key);
+          mutable_cf_options_.block_protection_bytes_per_key,
+          range_tombstones_indexed);
       if (status.ok()) {
         skip_filters = true;
         skip_range_deletions = true;
@@ -2946,7 +3042,8 @@ Status Version::ProcessBatch(
 
 Status Version::MultiGetAsync(
     const ReadOptions& options, MultiGetRange* range,
-    std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs) {
+    std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs,
+    bool range_tombstones_indexed) {
   autovector<FilePickerMultiGet, 4> batches;
   std::deque<size_t> waiting;
   std::deque<size_t> to_process;
@@ -2982,7 +3079,8 @@ Status Version::MultiGetAsync(
       // Look through one level. This may split the batch and enqueue it to
       // to_process
       s = ProcessBatch(options, batch, mget_tasks, blob_ctxs, batches, waiting,
-                       to_process, num_tasks_queued, mget_stats);
+                       to_process, num_tasks_queued, mget_stats,
+                       range_tombstones_indexed);
       // If ProcessBatch didn't enqueue any coroutine tasks, it means all
       // keys were filtered out. So put the batch back in to_process to
       // lookup in the next level
@@ -3073,11 +3171,18 @@ bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
          level == storage_info_.num_non_empty_levels() - 1;
 }
 
-void VersionStorageInfo::GenerateLevelFilesBrief() {
+void VersionStorageInfo::GenerateLevelFilesBrief(
+    uint64_t search_index_min_files) {
   level_files_brief_.resize(num_non_empty_levels_);
   for (int level = 0; level < num_non_empty_levels_; level++) {
-    DoGenerateLevelFilesBrief(&level_files_brief_[level], files_[level],
-                              &arena_);
+    auto& file_level = level_files_brief_[level];
+    DoGenerateLevelFilesBrief(&file_level, files_[level], &arena_);
+    // L0 files may overlap, so only sorted levels can use the index.
+    if (level > 0 && search_index_min_files > 0 &&
+        file_level.num_files >= search_index_min_files) {
+      file_level.search_index =
+          LevelSearchIndex::Create(user_comparator_, file_level, &arena_);
+    }
   }
 }
 
@@ -3089,7 +3194,7 @@ void VersionStorageInfo::PrepareForVersionAppend(
   CalculateBaseBytes(immutable_options, mutable_cf_options);
   UpdateFilesByCompactionPri(immutable_options, mutable_cf_options);
   GenerateFileIndexer();
-  GenerateLevelFilesBrief();
+  GenerateLevelFilesBrief(immutable_options.level_search_index_min_files);
   GenerateLevel0NonOverlapping();
   GenerateBottommostFiles();
   GenerateFileLocationIndex();
@@ -3218,6 +3323,60 @@ void Version::UpdateAccumulatedStats(const ReadOptions& read_options) {
   }
 }
 
+const VersionRangeTombstoneIndex* Version::GetRangeTombstoneIndex(
+    const ReadOptions& read_options) {
+  if (cfd_ == nullptr ||
+      cfd_->ioptions()->range_tombstone_index_min_tombstones == 0 ||
+      read_options.ignore_range_deletions ||
+      user_comparator()->timestamp_size() > 0) {
+    return nullptr;
+  }
+  if (!range_tombstone_index_built_.load(std::memory_order_acquire)) {
+    if (read_options.read_tier == kBlockCacheTier) {
+      // Building may need to open table files.
+      return nullptr;
+    }
+    std::call_once(range_tombstone_index_once_, [this]() {
+      BuildRangeTombstoneIndex();
+      range_tombstone_index_built_.store(true, std::memory_order_release);
+    });
+  }
+  return range_tombstone_index_.get();
+}
+
+void Version::BuildRangeTombstoneIndex() {
+  // Index all tombstones regardless of visibility; lookups filter by their
+  // own snapshot.
+  const ReadOptions read_options;
+  VersionRangeTombstoneIndex::Builder builder(user_comparator());
+  for (int level = 0; level < storage_info_.num_non_empty_levels(); ++level) {
+    for (const auto* file_meta : storage_info_.LevelFiles(level)) {
+      std::unique_ptr<FragmentedRangeTombstoneIterator> iter;
+      Status s = table_cache_->GetRangeTombstoneIterator(
+          read_options, *internal_comparator(), *file_meta,
+          mutable_cf_options_.block_protection_bytes_per_key, &iter);
+      if (!s.ok()) {
+        // Lookups in this version search each file's tombstones instead.
+        ROCKS_LOG_WARN(info_log_,
+                       "[%s] Not building range tombstone index for version "
+                       "%" PRIu64 ": %s",
+                       cfd_->GetName().c_str(), version_number_,
+                       s.ToString().c_str());
+        return;
+      }
+      if (iter != nullptr) {
+        builder.AddFile(level, file_meta->fd.GetNumber(),
+                        file_meta->smallest.Encode(),
+                        file_meta->largest.Encode(), iter.get());
+      }
+    }
+  }
+  if (builder.NumTombstones() >=
+      cfd_->ioptions()->range_tombstone_index_min_tombstones) {
+    range_tombstone_index_ = builder.Finish();
+  }
+}
+
 void VersionStorageInfo::ComputeCompensatedSizes() {
   static const int kDeletionWeightOnCompaction = 2;
   uint64_t average_value_size = GetAverageValueSize();
@@ -3624,6 +3783,9 @@ void VersionStorageInfo::ComputeCompactionScore(
   ComputeFilesMarkedForPeriodicCompaction(
       immutable_options, mutable_cf_options.periodic_compaction_seconds,
       max_output_level);
+  ComputeFilesMarkedForDeletePersistence(
+      immutable_options, mutable_cf_options.max_delete_persistence_seconds,
+      mutable_cf_options.max_bytes_for_level_multiplier);
   ComputeFilesMarkedForForcedBlobGC(
       mutable_cf_options.blob_garbage_collection_age_cutoff,
       mutable_cf_options.blob_garbage_collection_force_threshold,
@@ -3750,6 +3912,75 @@ void VersionStorageInfo::ComputeFilesMarkedForPeriodicCompaction(
   }
 }
 
+void VersionStorageInfo::ComputeFilesMarkedForDeletePersistence(
+    const ImmutableOptions& ioptions,
+    const uint64_t max_delete_persistence_seconds,
+    double level_multiplier) {
+  files_marked_for_delete_persistence_.clear();
+  if (max_delete_persistence_seconds == 0 ||
+      compaction_style_ != CompactionStyle::kCompactionStyleLevel) {
+    return;
+  }
+
+  int64_t temp_current_time;
+  auto status = ioptions.clock->GetCurrentTime(&temp_current_time);
+  if (!status.ok()) {
+    return;
+  }
+  const uint64_t current_time = static_cast<uint64_t>(temp_current_time);
+
+  // A tombstone is persisted once it is compacted into the last level with
+  // data. Without data below L0, there is nothing to push tombstones into.
+  int last_level = 0;
+  for (int level = num_levels() - 1; level > 0; level--) {
+    if (!files_[level].empty()) {
+      last_level = level;
+      break;
+    }
+  }
+  if (last_level == 0) {
+    return;
+  }
+
+  // The levels a tombstone leaves on its way down are L0 and base level to
+  // last level - 1. Leaving the k-th of them has a budget proportional to
+  // multiplier^k, so the deadline of a level is the running sum of the
+  // budgets, scaled for the last one to be max_delete_persistence_seconds.
+  const double multiplier = std::max(level_multiplier, 1.0);
+  std::vector<double> deadlines(last_level, 0.0);
+  double budget = 1.0;
+  double total = 0.0;
+  for (int level = 0; level < last_level; level++) {
+    if (level > 0 && level < base_level_) {
+      continue;
+    }
+    total += budget;
+    deadlines[level] = total;
+    budget *= multiplier;
+  }
+
+  for (int level = 0; level < last_level; level++) {
+    if (level > 0 && level < base_level_) {
+      continue;
+    }
+    const uint64_t deadline = static_cast<uint64_t>(
+        deadlines[level] / total *
+        static_cast<double>(max_delete_persistence_seconds));
+    if (deadline > current_time) {
+      continue;
+    }
+    for (FileMetaData* f : files_[level]) {
+      if (!f->being_compacted) {
+        const uint64_t oldest_tombstone_time = f->TryGetOldestTombstoneTime();
+        if (oldest_tombstone_time > 0 &&
+            oldest_tombstone_time < current_time - deadline) {
+          files_marked_for_delete_persistence_.emplace_back(level, f);
+        }
+      }
+    }
+  }
+}
+
 void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
     double blob_garbage_collection_age_cutoff,
     double blob_garbage_collection_force_threshold,
@@ -3952,15 +4183,32 @@ void VersionStorageInfo::UpdateNumNonEmptyLevels() {
 }
 
 namespace {
-// Sort `temp` based on ratio of overlapping size over file size
+// Sort `temp` based on ratio of overlapping size over file size. If
+// `read_hot_first`, the ratio is divided by one plus the file's sampled reads
+// per byte relative to the level.
 void SortFileByOverlappingRatio(
     const InternalKeyComparator& icmp, const std::vector<FileMetaData*>& files,
     const std::vector<FileMetaData*>& next_level_files, SystemClock* clock,
-    int level, int num_non_empty_levels, uint64_t ttl,
+    int level, int num_non_empty_levels, uint64_t ttl, bool read_hot_first,
     std::vector<Fsize>* temp) {
   std::unordered_map<uint64_t, uint64_t> file_to_order;
   auto next_level_it = next_level_files.begin();
 
+  double level_reads_per_byte = 0;
+  if (read_hot_first) {
+    uint64_t level_reads = 0;
+    uint64_t level_bytes = 0;
+    for (auto* file : files) {
+      level_reads +=
+          file->stats.num_reads_sampled.load(std::memory_order_relaxed);
+      level_bytes += file->compensated_file_size;
+    }
+    if (level_bytes > 0) {
+      level_reads_per_byte = static_cast<double>(level_reads) /
+                             static_cast<double>(level_bytes);
+    }
+  }
+
   int64_t curr_time;
   Status status = clock->GetCurrentTime(&curr_time);
   if (!status.ok()) {
@@ -3993,9 +4241,17 @@ void SortFileByOverlappingRatio(
     uint64_t ttl_boost_score = (ttl > 0) ? ttl_booster.GetBoostScore(file) : 1;
     assert(ttl_boost_score > 0);
     assert(file->compensated_file_size != 0);
-    file_to_order[file->fd.GetNumber()] = overlapping_bytes * 1024U /
-                                          file->compensated_file_size /
-                                          ttl_boost_score;
+    uint64_t order = overlapping_bytes * 1024U / file->compensated_file_size /
+                     ttl_boost_score;
+    if (level_reads_per_byte > 0) {
+      const double reads_per_byte =
+          static_cast<double>(
+              file->stats.num_reads_sampled.load(std::memory_order_relaxed)) /
+          static_cast<double>(file->compensated_file_size);
+      order = static_cast<uint64_t>(static_cast<double>(order) /
+                                    (1 + reads_per_byte / level_reads_per_byte));
+    }
+    file_to_order[file->fd.GetNumber()] = order;
   }
 
   size_t num_to_sort = temp->size() > VersionStorageInfo::kNumberFilesToSort
@@ -4126,9 +4382,11 @@ void VersionStorageInfo::UpdateFilesByCompactionPri(
                   });
         break;
       case kMinOverlappingRatio:
-        SortFileByOverlappingRatio(*internal_comparator_, files_[level],
-                                   files_[level + 1], ioptions.clock, level,
-                                   num_non_empty_levels_, options.ttl, &temp);
+      case kReadHotOverlappingRatio:
+        SortFileByOverlappingRatio(
+            *internal_comparator_, files_[level], files_[level + 1],
+            ioptions.clock, level, num_non_empty_levels_, options.ttl,
+            ioptions.compaction_pri == kReadHotOverlappingRatio, &temp);
         break;
       case kRoundRobin:
         SortFileByRoundRobin(*internal_comparator_, &compact_cursor_,
@@ -24,6 +24,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
@@ -46,6 +47,7 @@
 #include "db/table_cache.h"
 #include "db/version_builder.h"
 #include "db/version_edit.h"
+#include "db/version_range_tombstone_index.h"
 #include "db/write_controller.h"
 #include "env/file_system_tracer.h"
 #if USE_COROUTINES
@@ -221,6 +223,13 @@ class VersionStorageInfo {
       const ImmutableOptions& ioptions,
       const uint64_t periodic_compaction_seconds, int last_level);
 
+  // This computes files_marked_for_delete_persistence_ and is called by
+  // ComputeCompactionScore() or, on the current version as time passes, by
+  // DBImpl::ScheduleDeletePersistenceCompactions(). REQUIRES: DB mutex held
+  void ComputeFilesMarkedForDeletePersistence(
+      const ImmutableOptions& ioptions,
+      const uint64_t max_delete_persistence_seconds, double level_multiplier);
+
   // This computes bottommost_files_marked_for_compaction_ and is called by
   // ComputeCompactionScore() or UpdateOldestSnapshot().
   //
@@ -494,6 +503,15 @@ class VersionStorageInfo {
     return files_marked_for_periodic_compaction_;
   }
 
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  // Used by Leveled Compaction only.
+  const autovector<std::pair<int, FileMetaData*>>&
+  FilesMarkedForDeletePersistence() const {
+    assert(finalized_);
+    return files_marked_for_delete_persistence_;
+  }
+
   void TEST_AddFileMarkedForPeriodicCompaction(int level, FileMetaData* f) {
     files_marked_for_periodic_compaction_.emplace_back(level, f);
   }
@@ -638,7 +656,7 @@ class VersionStorageInfo {
     file_indexer_.UpdateIndex(&arena_, num_non_empty_levels_, files_);
   }
 
-  void GenerateLevelFilesBrief();
+  void GenerateLevelFilesBrief(uint64_t search_index_min_files);
   void GenerateLevel0NonOverlapping();
   void GenerateBottommostFiles();
   void GenerateFileLocationIndex();
@@ -712,6 +730,11 @@ class VersionStorageInfo {
   autovector<std::pair<int, FileMetaData*>>
       files_marked_for_periodic_compaction_;
 
+  // Files whose oldest tombstone is past the deadline of their level (see
+  // `max_delete_persistence_seconds`)
+  autovector<std::pair<int, FileMetaData*>>
+      files_marked_for_delete_persistence_;
+
   // These files are considered bottommost because none of their keys can exist
   // at lower levels. They are not necessarily all in the same level. The marked
   // ones are eligible for compaction because they contain duplicate key
@@ -1078,6 +1101,13 @@ class Version {
   // This accumulated stats will be used in compaction.
   void UpdateAccumulatedStats(const ReadOptions& read_options);
 
+  // Returns the index over the range tombstones of all files of this
+  // version, building it on first use, or nullptr if point lookups with
+  // `read_options` should search the range tombstones of each file instead.
+  const VersionRangeTombstoneIndex* GetRangeTombstoneIndex(
+      const ReadOptions& read_options);
+  void BuildRangeTombstoneIndex();
+
   DECLARE_SYNC_AND_ASYNC(
       /* ret_type */ Status, /* func_name */ MultiGetFromSST,
       const ReadOptions& read_options, MultiGetRange file_range,
@@ -1092,7 +1122,8 @@ class Version {
   // within and across levels
   Status MultiGetAsync(
       const ReadOptions& options, MultiGetRange* range,
-      std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs);
+      std::unordered_map<uint64_t, BlobReadContexts>* blob_ctxs,
+      bool range_tombstones_indexed);
 
   // A helper function to lookup a batch of keys in a single level. It will
   // queue coroutine tasks to mget_tasks. It may also split the input batch
@@ -1105,7 +1136,8 @@ class Version {
       autovector<FilePickerMultiGet, 4>& batches, std::deque<size_t>& waiting,
       std::deque<size_t>& to_process, unsigned int& num_tasks_queued,
       std::unordered_map<int, std::tuple<uint64_t, uint64_t, uint64_t>>&
-          mget_stats);
+          mget_stats,
+      bool range_tombstones_indexed);
 #endif
 
   ColumnFamilyData* cfd_;  // ColumnFamilyData to which this Version belongs
@@ -1131,6 +1163,12 @@ class Version {
   std::shared_ptr<IOTracer> io_tracer_;
   bool use_async_io_;
 
+  // See `range_tombstone_index_min_tombstones`. Built at most once, and
+  // immutable after `range_tombstone_index_built_` is set.
+  std::once_flag range_tombstone_index_once_;
+  std::atomic<bool> range_tombstone_index_built_{false};
+  std::unique_ptr<VersionRangeTombstoneIndex> range_tombstone_index_;
+
   Version(ColumnFamilyData* cfd, VersionSet* vset, const FileOptions& file_opt,
           MutableCFOptions mutable_cf_options,
           const std::shared_ptr<IOTracer>& io_tracer,
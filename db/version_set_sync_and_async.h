@@ -21,6 +21,17 @@ DEFINE_SYNC_AND_ASYNC(Status, Version::MultiGetFromSST)
   bool timer_enabled = GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
                        get_perf_context()->per_level_perf_context_enabled;
 
+  // Apply the tombstones found in the range tombstone index once the lookup
+  // reaches their file. See Version::Get().
+  for (auto iter = file_range.begin(); iter != file_range.end(); ++iter) {
+    if (iter->indexed_tombstone_seq > iter->max_covering_tombstone_seq &&
+        VersionRangeTombstoneIndex::ReachedTombstoneFile(
+            hit_file_level, f->fd.GetNumber(), iter->indexed_tombstone_level,
+            iter->indexed_tombstone_file_number)) {
+      iter->max_covering_tombstone_seq = iter->indexed_tombstone_seq;
+    }
+  }
+
   Status s;
   StopWatchNano timer(clock_, timer_enabled /* auto_start */);
   s = CO_AWAIT(table_cache_->MultiGet)(
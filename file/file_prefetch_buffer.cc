@@ -738,8 +738,13 @@ bool FilePrefetchBuffer::TryReadFromCacheUntracked(
       assert(reader != nullptr);
       assert(max_readahead_size_ >= readahead_size_);
 
-      if (for_compaction) {
+      if (for_compaction && num_buffers_ == 1) {
         s = Prefetch(opts, reader, offset, std::max(n, readahead_size_));
+      } else if (for_compaction) {
+        // Compaction reads sequentially, so every buffer is filled with a
+        // full readahead, and the ones after the first asynchronously
+        s = PrefetchInternal(opts, reader, offset, n, readahead_size_,
+                             copy_to_overlap_buffer);
       } else {
         if (implicit_auto_readahead_) {
           if (!IsEligibleForPrefetch(offset, n)) {
@@ -31,6 +31,7 @@ static const std::string kRocksDbTFileExt = "sst";
 static const std::string kLevelDbTFileExt = "ldb";
 static const std::string kRocksDBBlobFileExt = "blob";
 static const std::string kArchivalDirName = "archive";
+static const std::string kBlockCacheHotSetFileName = "BLOCK_CACHE_HOT_SET";
 
 // Given a path, flatten the path name by replacing all chars not in
 // {[0-9,a-z,A-Z,-,_,.]} with _. And append '_LOG\0' at the end.
@@ -253,6 +254,14 @@ std::string IdentityFileName(const std::string& dbname) {
   return dbname + "/IDENTITY";
 }
 
+std::string BlockCacheHotSetFileName(const std::string& dbname) {
+  return dbname + "/" + kBlockCacheHotSetFileName;
+}
+
+std::string TempBlockCacheHotSetFileName(const std::string& dbname) {
+  return BlockCacheHotSetFileName(dbname) + "." + kTempFileNameSuffix;
+}
+
 // Owned filenames have the form:
 //    dbname/IDENTITY
 //    dbname/CURRENT
@@ -264,6 +273,8 @@ std::string IdentityFileName(const std::string& dbname) {
 //    dbname/METADB-[0-9]+
 //    dbname/OPTIONS-[0-9]+
 //    dbname/OPTIONS-[0-9]+.dbtmp
+//    dbname/BLOCK_CACHE_HOT_SET
+//    dbname/BLOCK_CACHE_HOT_SET.dbtmp
 //    Disregards / at the beginning
 bool ParseFileName(const std::string& fname, uint64_t* number, FileType* type,
                    WalFileType* log_type) {
@@ -286,6 +297,15 @@ bool ParseFileName(const std::string& fname, uint64_t* number,
   } else if (rest == "LOCK") {
     *number = 0;
     *type = kDBLockFile;
+  } else if (rest.starts_with(kBlockCacheHotSetFileName)) {
+    // The temporary file too, which is not tracked in pending outputs like
+    // other temporary files
+    rest.remove_prefix(kBlockCacheHotSetFileName.size());
+    if (!rest.empty() && rest != "." + kTempFileNameSuffix) {
+      return false;
+    }
+    *number = 0;
+    *type = kBlockCacheHotSetFile;
   } else if (info_log_name_prefix.size() > 0 &&
              rest.starts_with(info_log_name_prefix)) {
     rest.remove_prefix(info_log_name_prefix.size());
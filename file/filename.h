@@ -144,6 +144,14 @@ std::string MetaDatabaseName(const std::string& dbname, uint64_t number);
 // either from a backup-image or empty
 std::string IdentityFileName(const std::string& dbname);
 
+// Return the name of the file persisting the block cache hot set of the db
+// (see DBOptions::block_cache_warmup)
+std::string BlockCacheHotSetFileName(const std::string& dbname);
+
+// Return the name of the temporary file the block cache hot set is written to
+// before it replaces the previous one
+std::string TempBlockCacheHotSetFileName(const std::string& dbname);
+
 // If filename is a rocksdb file, store the type of the file in *type.
 // The number encoded in the filename is stored in *number.  If the
 // filename was successfully parsed, returns true.  Else return false.
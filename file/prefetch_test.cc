@@ -2864,6 +2864,124 @@ TEST_P(PrefetchTest, TraceReadAsyncWithCallbackWrapper) {
 }
 #endif  // GFLAGS
 
+// Serves asynchronous reads synchronously, like the default
+// FSRandomAccessFile::ReadAsync(), so that they do not need io_uring
+class SyncReadAsyncRandomAccessFile : public FSRandomAccessFileOwnerWrapper {
+ public:
+  explicit SyncReadAsyncRandomAccessFile(
+      std::unique_ptr<FSRandomAccessFile>& file)
+      : FSRandomAccessFileOwnerWrapper(std::move(file)) {}
+
+  IOStatus ReadAsync(FSReadRequest& req, const IOOptions& opts,
+                     std::function<void(FSReadRequest&, void*)> cb,
+                     void* cb_arg, void** io_handle, IOHandleDeleter* del_fn,
+                     IODebugContext* dbg) override {
+    return FSRandomAccessFile::ReadAsync(req, opts, cb, cb_arg, io_handle,
+                                         del_fn, dbg);
+  }
+};
+
+class SyncReadAsyncFS : public FileSystemWrapper {
+ public:
+  SyncReadAsyncFS(const std::shared_ptr<FileSystem>& wrapped,
+                  bool support_async_io)
+      : FileSystemWrapper(wrapped), support_async_io_(support_async_io) {}
+
+  static const char* kClassName() { return "SyncReadAsyncFS"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& opts,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    std::unique_ptr<FSRandomAccessFile> file;
+    IOStatus s = target()->NewRandomAccessFile(fname, opts, &file, dbg);
+    if (s.ok()) {
+      result->reset(new SyncReadAsyncRandomAccessFile(file));
+    }
+    return s;
+  }
+
+  void SupportedOps(int64_t& supported_ops) override {
+    target()->SupportedOps(supported_ops);
+    if (support_async_io_) {
+      supported_ops |= (1 << FSSupportedOps::kAsyncIO);
+    } else {
+      supported_ops &= ~(1 << FSSupportedOps::kAsyncIO);
+    }
+  }
+
+ private:
+  const bool support_async_io_;
+};
+
+// This test verifies that compaction reads its input files with
+// asynchronous readahead if compaction_async_readahead_depth is set and the
+// file system supports asynchronous reads.
+TEST_P(PrefetchTest, CompactionAsyncReadahead) {
+  // First param is if the file system supports asynchronous reads
+  const bool support_async_io = std::get<0>(GetParam());
+  // Second param is if directIO is enabled or not
+  const bool use_direct_io = std::get<1>(GetParam());
+  std::shared_ptr<SyncReadAsyncFS> fs =
+      std::make_shared<SyncReadAsyncFS>(env_->GetFileSystem(),
+                                        support_async_io);
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  Options options;
+  SetGenericOptions(env.get(), use_direct_io, options);
+  options.write_buffer_size = 4 << 20;
+  options.compaction_readahead_size = 8 * 1024;
+  options.compaction_async_readahead_depth = 2;
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  int read_async_count = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "FilePrefetchBuffer::ReadAsync",
+      [&](void* /*arg*/) { read_async_count++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  Status s = TryReopen(options);
+  if (use_direct_io && (s.IsNotSupported() || s.IsInvalidArgument())) {
+    // If direct IO is not supported, skip the test
+    SyncPoint::GetInstance()->DisableProcessing();
+    SyncPoint::GetInstance()->ClearAllCallBacks();
+    return;
+  } else {
+    ASSERT_OK(s);
+  }
+
+  const int kNumKeys = 2000;
+  Random rnd(309);
+  std::vector<std::string> values(kNumKeys);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < kNumKeys; ++j) {
+      values[j] = rnd.RandomString(100);
+      ASSERT_OK(Put(BuildKey(j), values[j]));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  read_async_count = 0;
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  if (support_async_io) {
+    ASSERT_GT(read_async_count, 0);
+  } else {
+    ASSERT_EQ(read_async_count, 0);
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  for (int j = 0; j < kNumKeys; ++j) {
+    ASSERT_EQ(values[j], Get(BuildKey(j)));
+  }
+  Close();
+}
+
 class FilePrefetchBufferTest : public testing::Test {
  public:
   void SetUp() override {
@@ -147,6 +147,9 @@ class Cache {
     // primary cache without removal from the secondary cache can be prevented
     // from attempting re-insertion into secondary cache (for efficiency).
     const CacheItemHelper* without_secondary_compat;
+    // EXPERIMENTAL: The owner the entry is attributed to for per-owner
+    // capacity limits. See NewCacheOwnerView().
+    CacheOwnerId owner_id = kUnownedCacheEntry;
 
     CacheItemHelper() : CacheItemHelper(CacheEntryRole::kMisc) {}
 
@@ -429,6 +432,34 @@ class Cache {
   // See ShardedCacheOptions::hash_seed
   virtual uint32_t GetHashSeed() const { return 0; }
 
+  // See ShardedCacheOptions::frequency_admission. Returns the number of
+  // insertions of entries with `role` that would have evicted an entry and
+  // were admitted or rejected by the admission policy. Both are zero if the
+  // cache has no admission policy.
+  virtual void GetAdmissionCounts(CacheEntryRole /*role*/, uint64_t* admitted,
+                                  uint64_t* rejected) const {
+    *admitted = 0;
+    *rejected = 0;
+  }
+
+  // EXPERIMENTAL: Limits the total charge of entries attributed to `owner`
+  // (see NewCacheOwnerView()). The owner's usage never exceeds `hard_limit`:
+  // insertions that would exceed it are treated as if the entry was inserted
+  // and evicted immediately. Once the cache is full, the owner's usage does
+  // not grow beyond `soft_limit` and its entries are evicted first while over
+  // it, so that the owner does not evict the entries of others. SIZE_MAX
+  // means no limit. Returns NotSupported if the cache does not support
+  // owners.
+  virtual Status SetOwnerCapacityLimits(CacheOwnerId /*owner*/,
+                                        size_t /*soft_limit*/,
+                                        size_t /*hard_limit*/) {
+    return Status::NotSupported();
+  }
+
+  // EXPERIMENTAL: Returns the total charge of entries attributed to `owner`,
+  // or 0 if the cache does not support owners.
+  virtual size_t GetOwnerUsage(CacheOwnerId /*owner*/) const { return 0; }
+
   // EXPERIMENTAL
   // The following APIs are experimental and might change in the future.
 
@@ -648,6 +679,20 @@ class CacheWrapper : public Cache {
 
   uint32_t GetHashSeed() const override { return target_->GetHashSeed(); }
 
+  void GetAdmissionCounts(CacheEntryRole role, uint64_t* admitted,
+                          uint64_t* rejected) const override {
+    target_->GetAdmissionCounts(role, admitted, rejected);
+  }
+
+  Status SetOwnerCapacityLimits(CacheOwnerId owner, size_t soft_limit,
+                                size_t hard_limit) override {
+    return target_->SetOwnerCapacityLimits(owner, soft_limit, hard_limit);
+  }
+
+  size_t GetOwnerUsage(CacheOwnerId owner) const override {
+    return target_->GetOwnerUsage(owner);
+  }
+
   void ReportProblems(const std::shared_ptr<Logger>& info_log) const override {
     target_->ReportProblems(info_log);
   }
@@ -59,6 +59,15 @@ enum CompactionPri : char {
   // level. The file picking process will cycle through all the files in a
   // round-robin manner.
   kRoundRobin = 0x4,
+  // Like kMinOverlappingRatio, with the ratio of each file divided by one
+  // plus the file's sampled reads per byte relative to its level. Files of
+  // read-hot key ranges are compacted first, reducing the files point
+  // lookups search where reads happen, while files of ranges that are only
+  // written wait, which gathers more of their updates per compaction. Read
+  // heat comes from the reads sampled for every file (see
+  // `LiveFileMetaData::num_reads_sampled`) and is shown by DB property
+  // "rocksdb.compaction-heat".
+  kReadHotOverlappingRatio = 0x5,
 };
 
 struct FileTemperatureAge {
@@ -791,6 +800,30 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   uint64_t periodic_compaction_seconds = 0xfffffffffffffffe;
 
+  // EXPERIMENTAL
+  // Upper bound on the time a deletion takes to be persisted, that is, for
+  // its point or range tombstone to reach the last level with data, where
+  // compaction drops the deleted data along with it. Leveled compaction
+  // picks files whose oldest tombstone has been in the tree longer than the
+  // deadline of their level. The deadlines grow with the level by
+  // `max_bytes_for_level_multiplier` and the last one is this value, so
+  // that the extra compactions are spread over the levels as in FADE
+  // ("Lethe: A Tunable Delete-Aware LSM Engine", SIGMOD 2020).
+  //
+  // The age of a tombstone is measured from a time no later than its
+  // write, from the sequence number to time mapping, which is recorded
+  // while this option is set (as with `preserve_internal_time_seconds`).
+  // For tombstones written before the recording started, the age is
+  // measured from its start. Only files whose table reader is open are
+  // considered (see `max_open_files`).
+  //
+  // unit: seconds. 0 means no deadline.
+  //
+  // Default: 0
+  //
+  // Dynamically changeable through SetOptions() API
+  uint64_t max_delete_persistence_seconds = 0;
+
   // If this option is set then 1 in N blocks are compressed
   // using a fast (lz4) and slow (zstd) compression algorithm.
   // The compressibility is reported as stats and the stored
@@ -1085,6 +1118,91 @@ struct AdvancedColumnFamilyOptions {
   // additional key comparison during memtable lookup.
   bool paranoid_memory_checks = false;
 
+  // For each sorted level (L1 and below) with at least this many files, build
+  // an in-memory, cache-friendly search index over the files' key ranges when
+  // a new Version is installed. Point lookups (Get, MultiGet) and iterator
+  // seeks use it to locate the candidate file with far fewer cache misses
+  // than a binary search over the file metadata, which helps on levels with
+  // tens of thousands of files. The index costs about 12 bytes per indexed
+  // file. It is only built for BytewiseComparator() and
+  // ReverseBytewiseComparator() without user-defined timestamps; other
+  // comparators silently fall back to binary search.
+  //
+  // Default: 0 (disabled)
+  // Not dynamically changeable, change it requires db restart.
+  uint64_t level_search_index_min_files = 0;
+
+  // If the files of a Version hold at least this many range tombstones in
+  // total, point lookups (Get, MultiGet) build, on first use, an in-memory
+  // interval index over the tombstones of all files and answer "newest
+  // tombstone covering this key" with a single binary search, instead of
+  // searching the tombstones of every file they visit. The index is
+  // immutable and shared by all reads of the Version; a new Version builds
+  // its own. It costs roughly the size of the tombstones' keys plus 16 bytes
+  // per overlapping tombstone fragment. Reads with user-defined timestamps
+  // and iterators do not use it.
+  //
+  // Default: 0 (disabled)
+  // Not dynamically changeable, change it requires db restart.
+  uint64_t range_tombstone_index_min_tombstones = 0;
+
+  // If positive, flush adds the keys of each new L0 file to an in-memory
+  // Bloom filter shared by up to 64 L0 files of the column family, using
+  // about this many bits per key. Get probes it once to find the L0 files
+  // that may contain the key and skips the others without checking their
+  // key range or their own filter, which saves a cache miss or more per L0
+  // file when L0 holds many overlapping files. Files written by flush only
+  // are covered, except files with range tombstones; files from recovery,
+  // ingestion, compaction into L0, or beyond the 64th are searched as
+  // before. MultiGet and iterators do not use it.
+  //
+  // Default: 0 (disabled)
+  // Not dynamically changeable, change it requires db restart.
+  double l0_key_filter_bits_per_key = 0;
+
+  // If true, compaction writes a data block of its input files unchanged
+  // into its output when the output keys would fill a block with exactly the
+  // same contents, as for key ranges the compaction does not merge or change.
+  // This saves compressing the block again, at the cost of reading the
+  // candidate blocks once more as stored. Compactions still read every key.
+  // Only used with the block-based table format, without a compaction filter,
+  // blob files, user-defined timestamps, or compression dictionaries. See
+  // the "rocksdb.number.data.blocks.copied" ticker.
+  //
+  // Default: false
+  // Not dynamically changeable, change it requires db restart.
+  bool compaction_copy_data_blocks = false;
+
+  // If true, with kCompactionStyleLevel, flush writes its output file to the
+  // deepest level where it overlaps no file in that level or above, and no
+  // output of a running compaction to those levels, instead of to L0. This
+  // skips the compactions that would otherwise move mostly sequential or
+  // disjoint writes down level by level. Levels above the base level of
+  // level_compaction_dynamic_level_bytes are not used, nor the last level with
+  // allow_ingest_behind or preclude_last_level_data_seconds. A flush goes to
+  // L0 as before when another flush of the column family is running, with
+  // atomic_flush, or when MemPurge replaces it. The file is still built with
+  // the options of L0, like its compression.
+  //
+  // Default: false
+  // Not dynamically changeable, change it requires db restart.
+  bool flush_to_lowest_nonoverlapping_level = false;
+
+  // If greater than 1, a flush of at least twice target_file_size_base of
+  // memtable data splits its key range into up to this many parts, of about
+  // target_file_size_base each, and builds a file for each part in a thread
+  // of its own. The files are installed together. Part boundaries are picked
+  // from a sample of memtable keys; with an sst_partitioner_factory, each is
+  // moved to the next key where the partitioner cuts, if one is found within
+  // a few hundred keys. Parallel compression (CompressionOptions::
+  // parallel_threads) applies to each file. Flushes with range deletions,
+  // blob files, user-defined timestamps, or a memtable other than the skip
+  // list are not split.
+  //
+  // Default: 1
+  // Not dynamically changeable, change it requires db restart.
+  int max_flush_partitions = 1;
+
   // Create ColumnFamilyOptions with default values for all fields
   AdvancedColumnFamilyOptions();
   // Create ColumnFamilyOptions from Options
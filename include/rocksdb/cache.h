@@ -24,7 +24,9 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
+class Status;
 
 // These definitions begin source compatibility for a future change in which
 // a specific class for block cache is split away from general caches, so that
@@ -95,6 +97,13 @@ const std::string& GetCacheEntryRoleName(CacheEntryRole);
 // A fast bit set for CacheEntryRoles
 using CacheEntryRoleSet = SmallEnumSet<CacheEntryRole, CacheEntryRole::kMisc>;
 
+// EXPERIMENTAL: Identifies the owner, such as a tenant or column family, that
+// entries of a shared cache are attributed to, for per-owner capacity limits
+// and usage reporting. See NewCacheOwnerView().
+using CacheOwnerId = uint8_t;
+// Entries not attributed to any owner
+constexpr CacheOwnerId kUnownedCacheEntry = 0;
+
 // For use with `GetMapProperty()` for property
 // `DB::Properties::kBlockCacheEntryStats`. On success, the map will
 // be populated with all keys that can be obtained from these functions.
@@ -107,6 +116,11 @@ struct BlockCacheEntryStatsMapKeys {
   static std::string EntryCount(CacheEntryRole);
   static std::string UsedBytes(CacheEntryRole);
   static std::string UsedPercent(CacheEntryRole);
+  // See ShardedCacheOptions::frequency_admission
+  static std::string AdmittedCount(CacheEntryRole);
+  static std::string RejectedCount(CacheEntryRole);
+  // See NewCacheOwnerView()
+  static std::string OwnerUsedBytes(CacheOwnerId);
 };
 
 extern const bool kDefaultToAdaptiveMutex;
@@ -160,6 +174,21 @@ struct ShardedCacheOptions {
   // this option must be kept as default empty.
   std::shared_ptr<SecondaryCache> secondary_cache;
 
+  // EXPERIMENTAL: If true, each cache shard keeps an approximate count of
+  // recent lookups per key (a TinyLFU count-min sketch with periodically
+  // halved counters, about 2 bytes per entry the shard can hold) and, when an
+  // insertion would evict an entry, rejects the insertion if its key was
+  // looked up less often than the evicted entry. This keeps one-off reads,
+  // such as long scans, from displacing frequently used entries. A rejected
+  // insertion behaves as if the entry was inserted and evicted immediately:
+  // if a handle is requested, it refers to an entry not visible to lookups.
+  // Supported by LRUCache and HyperClockCache. Has no effect when
+  // strict_capacity_limit is set. The number of insertions admitted and
+  // rejected per CacheEntryRole is available from
+  // Cache::GetAdmissionCounts() and the block cache entry stats DB
+  // properties.
+  bool frequency_admission = false;
+
   // See hash_seed comments below
   static constexpr int32_t kQuasiRandomHashSeed = -1;
   static constexpr int32_t kHostHashSeed = -2;
@@ -371,6 +400,53 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// EXPERIMENTAL
+// How LocalFlashSecondaryCache picks the segment to reclaim when it is full
+enum class LocalFlashReclamationPolicy : uint8_t {
+  // Reclaim the oldest segment
+  kFIFO,
+  // Like kFIFO, but a segment with entries looked up since it was last
+  // considered gets a second chance, so frequently used data survives longer
+  // at the cost of reclaiming segments out of order.
+  kClock,
+};
+
+// EXPERIMENTAL
+// Options for a SecondaryCache on local flash, typically used as the
+// `nvm_sec_cache` tier of a TieredCache below the DRAM tiers. Entries are
+// appended to an in-memory segment which, once full, is written to a file of
+// its own through `fs`, so the device only sees large sequential writes.
+// Space is reclaimed a whole segment at a time. An in-memory hash index maps
+// each key to its location. Lookups with wait=false read through
+// FSRandomAccessFile::ReadAsync, so the FileSystem's async I/O support (e.g.
+// io_uring) allows several lookups to be in flight at once.
+//
+// The cache contents do not survive the process: files found in `path` that
+// were left behind by a previous instance are deleted on creation.
+struct LocalFlashSecondaryCacheOptions {
+  // Directory for the segment files. Created if missing. Required.
+  std::string path;
+
+  // FileSystem for the segment files. nullptr means FileSystem::Default().
+  std::shared_ptr<FileSystem> fs;
+
+  // Total size of the segment files. Rounded down to whole segments, at least
+  // one.
+  size_t capacity = 0;
+
+  // Size of a segment, and of the in-memory buffer of the segment being
+  // filled. Entries larger than this are not cached.
+  size_t segment_size = 16 << 20;
+
+  LocalFlashReclamationPolicy reclamation_policy =
+      LocalFlashReclamationPolicy::kClock;
+};
+
+// EXPERIMENTAL
+// Creates a local flash SecondaryCache, see LocalFlashSecondaryCacheOptions.
+Status NewLocalFlashSecondaryCache(const LocalFlashSecondaryCacheOptions& opts,
+                                   std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
@@ -576,4 +652,17 @@ Status UpdateTieredCache(
     const std::shared_ptr<Cache>& cache, int64_t total_capacity = -1,
     double compressed_secondary_ratio = std::numeric_limits<double>::max(),
     TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyMax);
+
+// EXPERIMENTAL
+// Returns a Cache that forwards to `cache` and attributes every entry it
+// inserts to `owner` (other than kUnownedCacheEntry). For example, column
+// families of different tenants can each set a view of one shared block cache
+// as BlockBasedTableOptions::block_cache. LRUCache and HyperClockCache (also
+// as the primary cache of a tiered cache) then track the usage of each owner
+// and enforce the limits set with Cache::SetOwnerCapacityLimits(), which
+// bounds how much one owner can evict of the others' entries while keeping
+// the benefits of sharing one cache. Per-owner usage is also reported in the
+// `rocksdb.block-cache-entry-stats` DB property.
+std::shared_ptr<Cache> NewCacheOwnerView(std::shared_ptr<Cache> cache,
+                                         CacheOwnerId owner);
 }  // namespace ROCKSDB_NAMESPACE
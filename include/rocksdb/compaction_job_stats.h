@@ -35,6 +35,12 @@ struct CompactionJobStats {
   size_t num_input_files;
   // the number of compaction input files at the output level (table files)
   size_t num_input_files_at_output_level;
+  // the number of compaction input files (included in num_input_files) that
+  // were deleted without being read, because range tombstones in other input
+  // files delete all of their keys
+  size_t num_range_deleted_input_files;
+  // the total size of those files
+  uint64_t range_deleted_input_bytes;
 
   // the number of compaction output records.
   uint64_t num_output_records;
@@ -94,6 +100,29 @@ struct CompactionJobStats {
   // Time spent on preparing file write (fallocate, etc)
   uint64_t file_prepare_write_nanos;
 
+  // Time spent on reading input files.
+  uint64_t file_read_nanos;
+
+  // Time spent on decompressing input blocks.
+  uint64_t block_decompress_nanos;
+
+  // Time spent in the merge operator.
+  uint64_t merge_operator_nanos;
+
+  // Time spent in the compaction filter.
+  uint64_t compaction_filter_nanos;
+
+  // Time spent on compressing output blocks. Blocks compressed by parallel
+  // compression threads (see `CompressionOptions::parallel_threads`) are not
+  // counted.
+  uint64_t block_compress_nanos;
+
+  // Time spent on building filters, most of which is when they are finished.
+  uint64_t filter_build_nanos;
+
+  // Time spent on adding index entries and finishing indexes.
+  uint64_t index_build_nanos;
+
   // 0-terminated strings storing the first 8 bytes of the smallest and
   // largest key in the output.
   static const size_t kMaxPrefixLength = 8;
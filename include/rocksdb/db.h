@@ -1109,6 +1109,21 @@ class DB {
     //      of files per level and total size of each level (MB).
     static const std::string kLevelStats;
 
+    //  "rocksdb.compaction-heat" - returns multi-line string with the read
+    //      and write heat of each level: the reads sampled from its files, in
+    //      total and per MB, the file with the most sampled reads, and the
+    //      bytes flushed or compacted into the level (MB). See
+    //      `kReadHotOverlappingRatio`.
+    static const std::string kCompactionHeat;
+
+    //  "rocksdb.compaction-stage-stats" - returns multi-line string with the
+    //      seconds compactions and flushes into each level spent on reading
+    //      input files, decompressing, in the merge operator and compaction
+    //      filter, compressing, building filters and indexes, and writing
+    //      and syncing output files. Only measured with
+    //      `report_bg_io_stats`. See `CompactionJobStats`.
+    static const std::string kCompactionStageStats;
+
     //  "rocksdb.block-cache-entry-stats" - returns a multi-line string or
     //      map with statistics on block cache usage. See
     //      `BlockCacheEntryStatsMapKeys` for structured representation of keys
@@ -1143,6 +1158,11 @@ class DB {
     //      running compactions.
     static const std::string kNumRunningCompactions;
 
+    //  "rocksdb.compaction-memory-usage" - returns the memory, in bytes,
+    //      that running compactions and flushes are estimated to use (see
+    //      DBOptions::compaction_memory_limit).
+    static const std::string kCompactionMemoryUsage;
+
     //  "rocksdb.background-errors" - returns accumulated number of background
     //      errors.
     static const std::string kBackgroundErrors;
@@ -1295,6 +1315,14 @@ class DB {
     //      entries being pinned.
     static const std::string kBlockCachePinnedUsage;
 
+    //  "rocksdb.block-cache-miss-ratio-curve" - returns a multi-line string
+    //      or map with the estimated miss ratios of the block cache lookups so
+    //      far at 1/8 to 8 times the block cache capacity. Only available if
+    //      the block cache is a MissRatioCurveCache. In the map form, keys
+    //      are "sampled_lookups" and capacities in bytes prefixed by
+    //      "capacity.".
+    static const std::string kBlockCacheMissRatioCurve;
+
     // "rocksdb.options-statistics" - returns multi-line string
     //      of options.statistics
     static const std::string kOptionsStatistics;
@@ -1384,6 +1412,7 @@ class DB {
   //  "rocksdb.base-level"
   //  "rocksdb.estimate-pending-compaction-bytes"
   //  "rocksdb.num-running-compactions"
+  //  "rocksdb.compaction-memory-usage"
   //  "rocksdb.num-running-flushes"
   //  "rocksdb.actual-delayed-write-rate"
   //  "rocksdb.is-write-stopped"
@@ -336,6 +336,28 @@ std::shared_ptr<SstQueryFilterConfig> MakeSharedBytewiseMinMaxSQFC(
     FilterInput select, KeySegmentsExtractor::KeyCategorySet categories =
                             KeySegmentsExtractor::KeyCategorySet::All());
 
+// A filtering scheme for range queries over whole user keys, for ranges
+// that fall between the keys of a file rather than outside of its key range.
+// For each key, it stores the shortest prefix distinguishing the key from
+// the other keys of the file, plus up to `suffix_bytes` more bytes of the key
+// (like SuRF-Real, Zhang et al. SIGMOD'18, but in a prefix-compressed block
+// rather than a succinct trie). A range is filtered out if no stored prefix
+// can begin a key in it, with no false negatives. More suffix bytes make
+// false positives rarer at the cost of a larger filter.
+//
+// At most `max_prefixes` prefixes are stored per file. For files with more
+// keys, all prefixes are truncated to a common length short enough that
+// each covers several keys, bounding the filter size (and the memory to
+// build it) at the cost of more false positives.
+//
+// The filter is also limited to the specified categories, as with
+// MakeSharedBytewiseMinMaxSQFC.
+std::shared_ptr<SstQueryFilterConfig> MakeSharedWholeKeyRangeSQFC(
+    uint32_t suffix_bytes = 1,
+    KeySegmentsExtractor::KeyCategorySet categories =
+        KeySegmentsExtractor::KeyCategorySet::All(),
+    size_t max_prefixes = 1024);
+
 // TODO: more kinds of filters, eventually including Bloom/ribbon filters
 // and replacing the old filter configuration APIs
 
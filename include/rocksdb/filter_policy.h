@@ -79,6 +79,10 @@ struct FilterBuildingContext {
 
   // Reason for creating the file with the filter
   TableFileCreationReason reason = TableFileCreationReason::kMisc;
+
+  // Bytes of data in each level of the LSM tree at table creation, indexed
+  // by level, or empty if unknown. Does not include the table being built.
+  std::vector<uint64_t> level_bytes;
 };
 
 // Determines what kind of filter (if any) to generate in SST files, and under
@@ -209,4 +213,43 @@ const FilterPolicy* NewBloomFilterPolicy(
 FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                     int bloom_before_level = 0);
 
+// EXPERIMENTAL
+// Return a new filter policy that uses a binary fuse filter, a static
+// filter that is about as fast to query as a Bloom filter (three memory
+// accesses per query) and close to Ribbon filters in space. Entries are 8-
+// or 16-bit fingerprints, whichever is the smallest with a false positive
+// rate no higher than a Bloom filter of bloom_equivalent_bits_per_key, for
+// about 9 or 18 bits per key (more for small filters). For example, 10
+// bits per key gives a 0.4% FP rate at about 9 bits per key. Building
+// costs somewhat more CPU than Ribbon, and about 40 bytes of temporary
+// memory per key, which is charged to the block cache like Ribbon banding.
+// Very small or very large filters are Bloom filters instead.
+//
+// Binary fuse filters are only readable by RocksDB versions that support
+// them. Older versions reading the data will behave as if no filter was
+// used.
+FilterPolicy* NewBinaryFuseFilterPolicy(double bloom_equivalent_bits_per_key);
+
+// EXPERIMENTAL
+// Return a new filter policy that spends an average of
+// bloom_equivalent_bits_per_key bits per key (as in NewBloomFilterPolicy)
+// across the levels of the LSM tree, but gives more bits per key to smaller
+// levels and fewer to larger ones. Under kCompactionStyleLevel, the false
+// positive rate of each level is chosen proportional to its size
+// ("Monkey", Dayan et al. SIGMOD'17), which minimizes the sum of false
+// positive rates over the levels, i.e. the expected number of unnecessary
+// data block reads of a point lookup of a missing key, for the same total
+// filter memory. The level sizes are those at table creation time, with L0
+// treated as one level, so filters are rebalanced as compaction rewrites
+// files. The largest levels get no filter when the budget is too small for
+// them, and an empty level is treated like the smallest non-empty one.
+//
+// Without level information (other compaction styles, SstFileWriter, etc.)
+// the average bits per key is used. Filters are Bloom filters, or Ribbon
+// filters with the same false positive rate except for flushes when
+// use_ribbon is true (see NewRibbonFilterPolicy). They are readable by all
+// built-in filter policies.
+FilterPolicy* NewLevelOptimizedFilterPolicy(
+    double bloom_equivalent_bits_per_key, bool use_ribbon = false);
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -157,6 +157,9 @@ enum class CompactionReason : int {
   // [InternalOnly] DBImpl::ReFitLevel treated as a compaction,
   // Used only for internal conflict checking with other compactions
   kRefitLevel,
+  // Compaction pushing tombstones down so that they reach the last level
+  // within `max_delete_persistence_seconds`
+  kDeletePersistence,
   // total number of compaction reasons, new reasons must be added above this.
   kNumOfReasons,
 };
@@ -61,7 +61,7 @@ class FileSystem;
 struct Options;
 struct DbPath;
 
-using FileTypeSet = SmallEnumSet<FileType, FileType::kBlobFile>;
+using FileTypeSet = SmallEnumSet<FileType, FileType::kBlockCacheHotSetFile>;
 
 struct ColumnFamilyOptions : public AdvancedColumnFamilyOptions {
   // The function recovers options to a previous version. Only 4.6 or later
@@ -1590,6 +1590,49 @@ struct DBOptions {
   // `kUnknown`, this overrides any temperature set by OptimizeForLogWrite
   // functions.
   Temperature wal_write_temperature = Temperature::kUnknown;
+
+  // If true, the DB keeps a list of the data blocks in the block caches of
+  // its block-based tables (the "hot set") in the file BLOCK_CACHE_HOT_SET of
+  // the DB directory. The list is rewritten on a clean close and every
+  // `block_cache_hot_set_persist_period_sec` seconds. On DB::Open, the blocks
+  // of the list that are still live are loaded back into the block cache in
+  // the background, ordered by file and offset, at most
+  // `block_cache_warmup_bytes_per_sec` bytes per second. This shortens the
+  // time to regain the block cache hit rate after a restart. Only files with
+  // a unique id in their table properties are covered.
+  // Default: false
+  bool block_cache_warmup = false;
+
+  // See `block_cache_warmup`. 0 only persists the hot set on close.
+  // Default: 600 (10 minutes)
+  uint64_t block_cache_hot_set_persist_period_sec = 600;
+
+  // See `block_cache_warmup`. 0 means no limit.
+  // Default: 64MB/s
+  uint64_t block_cache_warmup_bytes_per_sec = 64 << 20;
+
+  // If non-zero, the memory that running compactions and flushes are
+  // estimated to use, for input readahead, output file buffers, and filter
+  // and index builders, is kept within this many bytes. A compaction that
+  // does not fit first runs with fewer subcompactions and less readahead,
+  // and if it still does not fit, waits until running jobs finish. Flushes
+  // and manual compactions are never deferred, and a compaction larger than
+  // the limit runs when no other job is running. The memory reserved is
+  // reported by DB property "rocksdb.compaction-memory-usage".
+  // Default: 0 (no limit)
+  uint64_t compaction_memory_limit = 0;
+
+  // If non-zero, compactions read each input file through this many
+  // asynchronous reads of `compaction_readahead_size` bytes submitted ahead
+  // of the one being consumed, instead of one synchronous readahead at a
+  // time, so that the storage device is kept busy while the compaction
+  // merges. This needs a FileSystem that supports asynchronous reads (see
+  // FSSupportedOps::kAsyncIO, e.g. the POSIX one with io_uring), and is
+  // ignored otherwise, or when `compaction_readahead_size` is 0, or when
+  // `rate_limiter` limits reads, as asynchronous reads are not rate limited.
+  // Each input file then holds up to (1 + this) readahead buffers.
+  // Default: 0
+  size_t compaction_async_readahead_depth = 0;
   // End EXPERIMENTAL
 };
 
@@ -101,6 +101,12 @@ struct PerfContextBase {
 
   uint64_t block_checksum_time;    // total nanos spent on block checksum
   uint64_t block_decompress_time;  // total nanos spent on block decompression
+  // Table building, not counted in parallel compression threads
+  uint64_t block_compress_time;  // total nanos spent on block compression
+  // total nanos spent on finishing filters, where most of their building is
+  uint64_t filter_build_time;
+  // total nanos spent on adding index entries and finishing indexes
+  uint64_t index_build_time;
 
   uint64_t get_read_bytes;       // bytes for vals returned by Get
   uint64_t multiget_read_bytes;  // bytes for vals returned by MultiGet
@@ -534,6 +534,10 @@ enum Tickers : uint32_t {
   FILE_READ_CORRUPTION_RETRY_COUNT,
   FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
 
+  // Number of data blocks compaction copied from its input files as they
+  // were, without building and compressing them again
+  NUMBER_DATA_BLOCKS_COPIED,
+
   TICKER_ENUM_MAX
 };
 
@@ -667,6 +671,11 @@ enum Histograms : uint32_t {
   // system's prefetch) from the end of SST table during block based table open
   TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
 
+  // Estimated reuse distance, in bytes, of the block cache lookups sampled by
+  // a MissRatioCurveCache: the smallest LRU cache capacity that would have
+  // served the lookup. Does not include first lookups of keys.
+  BLOCK_CACHE_SAMPLED_REUSE_DISTANCE,
+
   HISTOGRAM_ENUM_MAX
 };
 
@@ -232,6 +232,18 @@ struct BlockBasedTableOptions {
     // Makes the index significantly bigger (2x or more), especially when keys
     // are long.
     kBinarySearchWithFirstKey = 0x03,
+
+    // Like kBinarySearch, but the index also stores a small learned model:
+    // error-bounded piecewise-linear segments mapping the first 8 bytes of
+    // each block's separator key, read as a big-endian number, to the
+    // position of that block in the index. Seeks predict the position and
+    // only binary search a few entries around it, which needs far fewer
+    // probes than a full binary search for numeric keys such as timestamps
+    // or IDs. The model is only built for BytewiseComparator() and
+    // ReverseBytewiseComparator() without user-defined timestamps, and only
+    // when its error is small compared to the index size; otherwise the
+    // table behaves exactly like kBinarySearch.
+    kLearnedIndex = 0x04,
   };
 
   IndexType index_type = kBinarySearch;
@@ -244,6 +256,18 @@ struct BlockBasedTableOptions {
 
   DataBlockIndexType data_block_index_type = kDataBlockBinarySearch;
 
+  // If true, each new table file also stores a minimal perfect hash over its
+  // user keys, next to the regular index. It maps a key straight to the data
+  // block and restart interval holding the key's newest entry, with a 16-bit
+  // fingerprint that rejects most keys not in the file. Point lookups (Get)
+  // then skip the index block search and the binary search within the data
+  // block, and most lookups of absent keys read no data block. Costs about 6
+  // bytes per distinct key in the file, held in memory by the table reader.
+  //
+  // Ignored with kTwoLevelIndexSearch and with user-defined timestamps. Files
+  // are readable with any setting of this option.
+  bool perfect_hash_index = false;
+
   // Option hash_index_allow_collision is now deleted.
   // It will behave as if hash_index_allow_collision=true.
 
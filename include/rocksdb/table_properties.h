@@ -44,6 +44,8 @@ struct TablePropertiesNames {
   static const std::string kIndexSize;
   static const std::string kIndexPartitions;
   static const std::string kTopLevelIndexSize;
+  static const std::string kLearnedIndexSize;
+  static const std::string kLearnedIndexMaxError;
   static const std::string kIndexKeyIsUserKey;
   static const std::string kIndexValueIsDeltaEncoded;
   static const std::string kFilterSize;
@@ -69,6 +71,7 @@ struct TablePropertiesNames {
   static const std::string kCreationTime;
   static const std::string kOldestKeyTime;
   static const std::string kFileCreationTime;
+  static const std::string kOldestTombstoneTime;
   static const std::string kSlowCompressionEstimatedDataSize;
   static const std::string kFastCompressionEstimatedDataSize;
   static const std::string kSequenceNumberTimeMapping;
@@ -219,6 +222,12 @@ struct TableProperties {
   uint64_t index_partitions = 0;
   // Size of the top-level index if kTwoLevelIndexSearch is used
   uint64_t top_level_index_size = 0;
+  // Size of the learned index model if kLearnedIndex is used and the keys
+  // could be modeled; 0 means readers binary search the index block.
+  uint64_t learned_index_size = 0;
+  // Maximum distance, in index entries, between the learned model's
+  // prediction and the actual position of any index entry.
+  uint64_t learned_index_max_error = 0;
   // Whether the index key is user key. Otherwise it includes 8 byte of sequence
   // number added by internal key format.
   uint64_t index_key_is_user_key = 0;
@@ -270,6 +279,10 @@ struct TableProperties {
   uint64_t oldest_key_time = 0;
   // Actual SST file creation time. 0 means unknown.
   uint64_t file_creation_time = 0;
+  // Time of the write of the oldest point or range tombstone in the file,
+  // from the sequence number to time mapping (see
+  // `max_delete_persistence_seconds`). 0 means no tombstones or unknown.
+  uint64_t oldest_tombstone_time = 0;
   // Estimated size of data blocks if compressed using a relatively slower
   // compression algorithm (see `ColumnFamilyOptions::sample_for_compression`).
   // 0 means unknown.
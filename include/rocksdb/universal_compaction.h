@@ -99,6 +99,22 @@ class CompactionOptionsUniversal {
   // Default: kCompactionStopStyleTotalSize
   CompactionStopStyle stop_style;
 
+  // EXPERIMENTAL
+  // If at least 2, universal compaction follows lazy leveling ("Dostoevsky",
+  // Dayan and Idreos, SIGMOD'18) instead of size ratios and size
+  // amplification: sorted runs other than the last one are tiered, with up
+  // to this many runs of similar size per tier, and the last sorted run is
+  // leveled. Tier k holds runs of about factor^k times the size of a flushed
+  // file.
+  // Once a tier has this many runs, they are merged into one run of the next
+  // tier, or into the last sorted run if the merged run would be as large
+  // as the tier of the last run. Writes are rewritten about once per tier
+  // and `factor` times into the last run, while there are at most about
+  // `factor` runs per tier to read, each checked by its filters first.
+  // Periodic and deletion-triggered compactions are picked as usual.
+  // Default: 0 (disabled)
+  unsigned int lazy_leveling_tiering_factor;
+
   // Option to optimize the universal multi level compaction by enabling
   // trivial move for non overlapping files.
   // Default: false
@@ -120,6 +136,7 @@ class CompactionOptionsUniversal {
         compression_size_percent(-1),
         max_read_amp(-1),
         stop_style(kCompactionStopStyleTotalSize),
+        lazy_leveling_tiering_factor(0),
         allow_trivial_move(false),
         incremental(false) {}
 };
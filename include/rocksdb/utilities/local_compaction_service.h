@@ -0,0 +1,104 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct LocalCompactionServiceOptions {
+  // The program and arguments that start a worker process. The job
+  // directory is passed as one more, last argument, and the program is
+  // expected to call RunLocalCompactionWorker() on it, and to exit with code
+  // 0 if that returns OK and another code otherwise. Required.
+  std::vector<std::string> worker_command;
+
+  // Directory holding one subdirectory per job, with its input, output files
+  // and result. It must be on the same file system as the DB, so that output
+  // files can be renamed into it, and must not be shared with anything else:
+  // its contents, like jobs left by a process that crashed, are removed when
+  // the service is created. Required.
+  std::string work_dir;
+
+  // Maximum number of worker processes running at once. Further jobs wait
+  // for one to exit.
+  int max_workers = 4;
+
+  // Number of times a job is run before it is given up and compacted in the
+  // DB process instead. A run fails if the worker crashes, is killed, times
+  // out, or exits without a result. A compaction that fails in the worker
+  // (e.g. on corruption) is not retried, and fails in the DB.
+  int max_attempts = 2;
+
+  // If non-zero, a worker running longer than this is killed, and the run
+  // counts as failed.
+  uint64_t timeout_seconds = 0;
+};
+
+class LocalCompactionService;
+
+// EXPERIMENTAL
+// Returns a CompactionService, for DBOptions::compaction_service, that runs
+// compactions in worker processes on the same host, for example to limit
+// their CPU usage with a cgroup of their own, or to keep their memory and
+// cache usage out of the DB process.
+//
+// Jobs are exchanged through `work_dir`: Schedule() writes the compaction
+// input and DB name to a job directory, and Wait() starts a worker on it and
+// waits for the worker to rename its result into place. Workers run
+// DB::OpenAndCompact(), which opens the DB as a secondary and writes the
+// output files to the job directory, from where the DB renames them in.
+// nullptr is returned if a required option is not set, or if the platform
+// is not POSIX.
+std::shared_ptr<LocalCompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& opts);
+
+// An abstract base class (public interface) to the implementation
+class LocalCompactionService : public CompactionService {
+ public:
+  static const char* kClassName() { return "LocalCompactionService"; }
+  const char* Name() const override { return kClassName(); }
+
+  // Asks the running workers to stop, and makes their jobs, and the jobs
+  // waited for afterwards, fall back to compacting in the DB process, which
+  // gives up quickly when the DB is closing. Call it before closing the DB,
+  // so that the close does not wait for workers to finish.
+  virtual void CancelAwaitingJobs() = 0;
+
+  // Undoes CancelAwaitingJobs() for the jobs waited for afterwards
+  virtual void Resume() = 0;
+
+  // Number of worker runs that failed, and of jobs that fell back to
+  // compacting in the DB process
+  virtual uint64_t GetNumFailedRuns() const = 0;
+  virtual uint64_t GetNumLocalFallbacks() const = 0;
+};
+
+// Runs the compaction job in `job_dir`, written by a LocalCompactionService,
+// and writes its result there. This is the body of a worker process. OK is
+// returned if a result was written, even for a failed compaction, whose
+// status is in the result.
+//
+// Like for DB::OpenAndCompact(), the options that cannot be serialized with
+// the job input come from `override_options`. Its table_factory,
+// merge_operator, prefix_extractor, compaction_filter_factory and
+// sst_partitioner_factory, if not set, are created from their serialized
+// form in the job input instead, which works for the built-in ones.
+// `canceled`, if not nullptr, can be set to stop the compaction, for example
+// from a SIGTERM handler: the service sends SIGTERM to cancel a worker.
+Status RunLocalCompactionWorker(
+    const std::string& job_dir,
+    const CompactionServiceOptionsOverride& override_options,
+    std::atomic<bool>* canceled = nullptr);
+
+}  // namespace ROCKSDB_NAMESPACE
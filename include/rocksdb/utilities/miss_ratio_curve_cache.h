@@ -0,0 +1,68 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rocksdb/advanced_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct MissRatioCurveCacheOptions {
+  // Fraction of the keys looked up whose reuse distances are tracked. Higher
+  // rates give more accurate curves for smaller key sets, at a higher CPU and
+  // memory cost. Keys are sampled by hash, so all lookups of a sampled key
+  // are tracked.
+  double sampling_rate = 0.001;
+
+  // When more keys than this have been sampled, the sampling rate is halved
+  // and the keys that no longer qualify are dropped. This bounds the memory
+  // used, at about 64 bytes per sampled key.
+  size_t max_sampled_keys = 64 * 1024;
+};
+
+class MissRatioCurveCache;
+
+// EXPERIMENTAL
+// Returns a Cache wrapping `cache` that estimates, for all capacities at
+// once, the miss ratio an LRU cache of that capacity would have had on the
+// lookups so far. It uses a ghost cache of sampled keys without values
+// ("SHARDS", Waldspurger et al. FAST'15): for the lookups of sampled keys,
+// it measures the bytes of distinct sampled keys accessed since the
+// previous lookup of the key, and scales that by the sampling rate.
+// Lookups of other keys cost one hash computation.
+//
+// If used as BlockBasedTableOptions::block_cache, the curve can be read with
+// DB property "rocksdb.block-cache-miss-ratio-curve", and sampled reuse
+// distances are recorded in the BLOCK_CACHE_SAMPLED_REUSE_DISTANCE histogram
+// of the Statistics passed to lookups.
+std::shared_ptr<MissRatioCurveCache> NewMissRatioCurveCache(
+    std::shared_ptr<Cache> cache, const MissRatioCurveCacheOptions& opts = {});
+
+// An abstract base class (public interface) to the implementation
+class MissRatioCurveCache : public CacheWrapper {
+ public:
+  using CacheWrapper::CacheWrapper;
+
+  static const char* kClassName() { return "MissRatioCurveCache"; }
+  const char* Name() const override { return kClassName(); }
+
+  // Sets (*miss_ratios)[i] to the estimated miss ratio, between 0 and 1, of
+  // an LRU cache of capacity capacities[i] for the lookups so far. A ratio
+  // is 0 if no lookups were sampled yet.
+  virtual void GetMissRatioCurve(const std::vector<size_t>& capacities,
+                                 std::vector<double>* miss_ratios) const = 0;
+
+  // Number of lookups the curve is based on
+  virtual uint64_t GetNumSampledLookups() const = 0;
+
+  // Forgets the lookups so far, but not the sampled keys
+  virtual void ResetMissRatioCurve() = 0;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
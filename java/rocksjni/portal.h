@@ -4761,6 +4761,8 @@ class CompactionPriorityJni {
         return 0x3;
       case ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin:
         return 0x4;
+      case ROCKSDB_NAMESPACE::CompactionPri::kReadHotOverlappingRatio:
+        return 0x5;
       default:
         return 0x0;  // undefined
     }
@@ -4781,6 +4783,8 @@ class CompactionPriorityJni {
         return ROCKSDB_NAMESPACE::CompactionPri::kMinOverlappingRatio;
       case 0x4:
         return ROCKSDB_NAMESPACE::CompactionPri::kRoundRobin;
+      case 0x5:
+        return ROCKSDB_NAMESPACE::CompactionPri::kReadHotOverlappingRatio;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionPri::kByCompensatedSize;
@@ -5273,6 +5277,8 @@ class TickerTypeJni {
         return -0x56;
       case ROCKSDB_NAMESPACE::Tickers::FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT:
         return -0x57;
+      case ROCKSDB_NAMESPACE::Tickers::NUMBER_DATA_BLOCKS_COPIED:
+        return -0x58;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -5735,6 +5741,8 @@ class TickerTypeJni {
       case -0x57:
         return ROCKSDB_NAMESPACE::Tickers::
             FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT;
+      case -0x58:
+        return ROCKSDB_NAMESPACE::Tickers::NUMBER_DATA_BLOCKS_COPIED;
       case -0x54:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -5889,9 +5897,11 @@ class HistogramTypeJni {
         return 0x3C;
       case ROCKSDB_NAMESPACE::Histograms::TABLE_OPEN_PREFETCH_TAIL_READ_BYTES:
         return 0x3D;
-      case ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX:
-        // 0x3D for backwards compatibility on current minor version.
+      case ROCKSDB_NAMESPACE::Histograms::BLOCK_CACHE_SAMPLED_REUSE_DISTANCE:
         return 0x3E;
+      case ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX:
+        // 0x3F for backwards compatibility on current minor version.
+        return 0x3F;
       default:
         // undefined/default
         return 0x0;
@@ -6034,6 +6044,9 @@ class HistogramTypeJni {
         return ROCKSDB_NAMESPACE::Histograms::
             TABLE_OPEN_PREFETCH_TAIL_READ_BYTES;
       case 0x3E:
+        return ROCKSDB_NAMESPACE::Histograms::
+            BLOCK_CACHE_SAMPLED_REUSE_DISTANCE;
+      case 0x3F:
         // 0x1F for backwards compatibility on current minor version.
         return ROCKSDB_NAMESPACE::Histograms::HISTOGRAM_ENUM_MAX;
 
@@ -7461,6 +7474,8 @@ class CompactionReasonJni {
         return 0x12;
       case ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel:
         return 0x13;
+      case ROCKSDB_NAMESPACE::CompactionReason::kDeletePersistence:
+        return 0x14;
       default:
         return 0x7F;  // undefined
     }
@@ -7511,6 +7526,8 @@ class CompactionReasonJni {
         return ROCKSDB_NAMESPACE::CompactionReason::kRoundRobinTtl;
       case 0x13:
         return ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel;
+      case 0x14:
+        return ROCKSDB_NAMESPACE::CompactionReason::kDeletePersistence;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionReason::kUnknown;
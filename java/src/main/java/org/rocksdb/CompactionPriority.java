@@ -41,7 +41,14 @@ public enum CompactionPriority {
    * level. The file picking process will cycle through all the files in a
    * round-robin manner.
    */
-  RoundRobin((byte)0x4);
+  RoundRobin((byte)0x4),
+
+  /**
+   * Like {@link #MinOverlappingRatio}, with the ratio of each file divided by
+   * one plus the file's sampled reads per byte relative to its level, so that
+   * files of read-hot key ranges are compacted first.
+   */
+  ReadHotOverlappingRatio((byte)0x5);
 
 
   private final byte value;
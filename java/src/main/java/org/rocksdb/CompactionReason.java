@@ -104,7 +104,13 @@ public enum CompactionReason {
   /**
    * Compaction by calling DBImpl::ReFitLevel
    */
-  kRefitLevel((byte) 0x13);
+  kRefitLevel((byte) 0x13),
+
+  /**
+   * Compaction pushing tombstones down so that they reach the last level
+   * within max_delete_persistence_seconds
+   */
+  kDeletePersistence((byte) 0x14);
 
   private final byte value;
 
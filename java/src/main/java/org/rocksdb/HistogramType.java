@@ -210,8 +210,14 @@ public enum HistogramType {
    */
   TABLE_OPEN_PREFETCH_TAIL_READ_BYTES((byte) 0x3D),
 
-  // 0x3E for backwards compatibility on current minor version.
-  HISTOGRAM_ENUM_MAX((byte) 0x3E);
+  /**
+   * Estimated reuse distance, in bytes, of the block cache lookups sampled
+   * by a MissRatioCurveCache.
+   */
+  BLOCK_CACHE_SAMPLED_REUSE_DISTANCE((byte) 0x3E),
+
+  // 0x3F for backwards compatibility on current minor version.
+  HISTOGRAM_ENUM_MAX((byte) 0x3F);
 
   private final byte value;
 
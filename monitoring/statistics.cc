@@ -270,6 +270,7 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.file.read.corruption.retry.count"},
     {FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
      "rocksdb.file.read.corruption.retry.success.count"},
+    {NUMBER_DATA_BLOCKS_COPIED, "rocksdb.number.data.blocks.copied"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -340,6 +341,8 @@ const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
     {ASYNC_PREFETCH_ABORT_MICROS, "rocksdb.async.prefetch.abort.micros"},
     {TABLE_OPEN_PREFETCH_TAIL_READ_BYTES,
      "rocksdb.table.open.prefetch.tail.read.bytes"},
+    {BLOCK_CACHE_SAMPLED_REUSE_DISTANCE,
+     "rocksdb.block.cache.sampled.reuse.distance"},
 };
 
 std::shared_ptr<Statistics> CreateDBStatistics() {
@@ -254,6 +254,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"allow_trivial_move",
          {offsetof(class CompactionOptionsUniversal, allow_trivial_move),
           OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"lazy_leveling_tiering_factor",
+         {offsetof(class CompactionOptionsUniversal,
+                   lazy_leveling_tiering_factor),
+          OptionType::kUInt, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}}};
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -446,6 +451,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, periodic_compaction_seconds),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"max_delete_persistence_seconds",
+         {offsetof(struct MutableCFOptions, max_delete_persistence_seconds),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"bottommost_temperature",
          {0, OptionType::kTemperature, OptionVerificationType::kDeprecated,
           OptionTypeFlags::kMutable}},
@@ -830,6 +839,32 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableCFOptions, persist_user_defined_timestamps),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kCompareLoose}},
+        {"level_search_index_min_files",
+         {offsetof(struct ImmutableCFOptions, level_search_index_min_files),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"range_tombstone_index_min_tombstones",
+         {offsetof(struct ImmutableCFOptions,
+                   range_tombstone_index_min_tombstones),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"l0_key_filter_bits_per_key",
+         {offsetof(struct ImmutableCFOptions, l0_key_filter_bits_per_key),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_copy_data_blocks",
+         {offsetof(struct ImmutableCFOptions, compaction_copy_data_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"flush_to_lowest_nonoverlapping_level",
+         {offsetof(struct ImmutableCFOptions,
+                   flush_to_lowest_nonoverlapping_level),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_flush_partitions",
+         {offsetof(struct ImmutableCFOptions, max_flush_partitions),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kCFOptionsName = "ColumnFamilyOptions";
@@ -974,7 +1009,15 @@ ImmutableCFOptions::ImmutableCFOptions(const ColumnFamilyOptions& cf_options)
       sst_partitioner_factory(cf_options.sst_partitioner_factory),
       blob_cache(cf_options.blob_cache),
       persist_user_defined_timestamps(
-          cf_options.persist_user_defined_timestamps) {}
+          cf_options.persist_user_defined_timestamps),
+      level_search_index_min_files(cf_options.level_search_index_min_files),
+      range_tombstone_index_min_tombstones(
+          cf_options.range_tombstone_index_min_tombstones),
+      l0_key_filter_bits_per_key(cf_options.l0_key_filter_bits_per_key),
+      compaction_copy_data_blocks(cf_options.compaction_copy_data_blocks),
+      flush_to_lowest_nonoverlapping_level(
+          cf_options.flush_to_lowest_nonoverlapping_level),
+      max_flush_partitions(cf_options.max_flush_partitions) {}
 
 ImmutableOptions::ImmutableOptions() : ImmutableOptions(Options()) {}
 
@@ -1108,6 +1151,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  ttl);
   ROCKS_LOG_INFO(log, "              periodic_compaction_seconds: %" PRIu64,
                  periodic_compaction_seconds);
+  ROCKS_LOG_INFO(log, "           max_delete_persistence_seconds: %" PRIu64,
+                 max_delete_persistence_seconds);
   ROCKS_LOG_INFO(log, "                   paranoid_memory_checks: %d",
                  paranoid_memory_checks);
   std::string result;
@@ -1161,6 +1206,9 @@ void MutableCFOptions::Dump(Logger* log) const {
       static_cast<int>(compaction_options_universal.allow_trivial_move));
   ROCKS_LOG_INFO(log, "compaction_options_universal.incremental        : %d",
                  static_cast<int>(compaction_options_universal.incremental));
+  ROCKS_LOG_INFO(
+      log, "compaction_options_universal.lazy_leveling_tiering_factor : %u",
+      compaction_options_universal.lazy_leveling_tiering_factor);
 
   // FIFO Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_fifo.max_table_files_size : %" PRIu64,
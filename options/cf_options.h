@@ -88,6 +88,18 @@ struct ImmutableCFOptions {
   std::shared_ptr<Cache> blob_cache;
 
   bool persist_user_defined_timestamps;
+
+  uint64_t level_search_index_min_files;
+
+  uint64_t range_tombstone_index_min_tombstones;
+
+  double l0_key_filter_bits_per_key;
+
+  bool compaction_copy_data_blocks;
+
+  bool flush_to_lowest_nonoverlapping_level;
+
+  int max_flush_partitions;
 };
 
 struct ImmutableOptions : public ImmutableDBOptions, public ImmutableCFOptions {
@@ -139,6 +151,7 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(options.max_bytes_for_level_multiplier),
         ttl(options.ttl),
         periodic_compaction_seconds(options.periodic_compaction_seconds),
+        max_delete_persistence_seconds(options.max_delete_persistence_seconds),
         max_bytes_for_level_multiplier_additional(
             options.max_bytes_for_level_multiplier_additional),
         compaction_options_fifo(options.compaction_options_fifo),
@@ -204,6 +217,7 @@ struct MutableCFOptions {
         max_bytes_for_level_multiplier(0),
         ttl(0),
         periodic_compaction_seconds(0),
+        max_delete_persistence_seconds(0),
         compaction_options_fifo(),
         enable_blob_files(false),
         min_blob_size(0),
@@ -290,6 +304,7 @@ struct MutableCFOptions {
   double max_bytes_for_level_multiplier;
   uint64_t ttl;
   uint64_t periodic_compaction_seconds;
+  uint64_t max_delete_persistence_seconds;
   std::vector<int> max_bytes_for_level_multiplier_additional;
   CompactionOptionsFIFO compaction_options_fifo;
   CompactionOptionsUniversal compaction_options_universal;
@@ -2017,6 +2017,10 @@ TEST_F(LoadCustomizableTest, LoadFilterPolicyTest) {
       BloomFilterPolicy::kNickName(),
       kAutoRibbon,
       RibbonFilterPolicy::kNickName(),
+      BinaryFuseFilterPolicy::kClassName(),
+      BinaryFuseFilterPolicy::kNickName(),
+      LevelOptimizedFilterPolicy::kClassName(),
+      LevelOptimizedFilterPolicy::kNickName(),
   });
   ASSERT_OK(TestExpectedBuiltins<const FilterPolicy>(
       "Mock", expected, &result, &failures, [](const std::string& name) {
@@ -2039,6 +2043,14 @@ TEST_F(LoadCustomizableTest, LoadFilterPolicyTest) {
                                            kAutoRibbon + ":1.234:56", &result));
   ASSERT_NE(result.get(), nullptr);
   ASSERT_TRUE(result->IsInstanceOf(kAutoRibbon));
+  ASSERT_OK(FilterPolicy::CreateFromString(
+      config_options_,
+      std::string(LevelOptimizedFilterPolicy::kClassName()) + ":1.234:true",
+      &result));
+  ASSERT_NE(result.get(), nullptr);
+  ASSERT_EQ(result->GetId(),
+            std::string(LevelOptimizedFilterPolicy::kClassName()) +
+                ":1.234:true");
 
   if (RegisterTests("Test")) {
     ExpectCreateShared<FilterPolicy>(MockFilterPolicy::kClassName(), &result);
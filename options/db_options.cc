@@ -584,6 +584,28 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct ImmutableDBOptions, wal_write_temperature),
           OptionType::kTemperature, OptionVerificationType::kNormal,
           OptionTypeFlags::kNone}},
+        {"block_cache_warmup",
+         {offsetof(struct ImmutableDBOptions, block_cache_warmup),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_hot_set_persist_period_sec",
+         {offsetof(struct ImmutableDBOptions,
+                   block_cache_hot_set_persist_period_sec),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"block_cache_warmup_bytes_per_sec",
+         {offsetof(struct ImmutableDBOptions, block_cache_warmup_bytes_per_sec),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_memory_limit",
+         {offsetof(struct ImmutableDBOptions, compaction_memory_limit),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"compaction_async_readahead_depth",
+         {offsetof(struct ImmutableDBOptions,
+                   compaction_async_readahead_depth),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
 };
 
 const std::string OptionsHelper::kDBOptionsName = "DBOptions";
@@ -788,7 +810,15 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       follower_catchup_retry_count(options.follower_catchup_retry_count),
       follower_catchup_retry_wait_ms(options.follower_catchup_retry_wait_ms),
       metadata_write_temperature(options.metadata_write_temperature),
-      wal_write_temperature(options.wal_write_temperature) {
+      wal_write_temperature(options.wal_write_temperature),
+      block_cache_warmup(options.block_cache_warmup),
+      block_cache_hot_set_persist_period_sec(
+          options.block_cache_hot_set_persist_period_sec),
+      block_cache_warmup_bytes_per_sec(
+          options.block_cache_warmup_bytes_per_sec),
+      compaction_memory_limit(options.compaction_memory_limit),
+      compaction_async_readahead_depth(
+          options.compaction_async_readahead_depth) {
   fs = env->GetFileSystem();
   clock = env->GetSystemClock().get();
   logger = info_log.get();
@@ -970,6 +1000,21 @@ void ImmutableDBOptions::Dump(Logger* log) const {
                    temperature_to_string[metadata_write_temperature].c_str());
   ROCKS_LOG_HEADER(log, "            Options.wal_write_temperature: %s",
                    temperature_to_string[wal_write_temperature].c_str());
+  ROCKS_LOG_HEADER(log, "            Options.block_cache_warmup: %d",
+                   block_cache_warmup);
+  ROCKS_LOG_HEADER(
+      log, "            Options.block_cache_hot_set_persist_period_sec: %" PRIu64,
+      block_cache_hot_set_persist_period_sec);
+  ROCKS_LOG_HEADER(
+      log, "            Options.block_cache_warmup_bytes_per_sec: %" PRIu64,
+      block_cache_warmup_bytes_per_sec);
+  ROCKS_LOG_HEADER(log,
+                   "            Options.compaction_memory_limit: %" PRIu64,
+                   compaction_memory_limit);
+  ROCKS_LOG_HEADER(log,
+                   "            Options.compaction_async_readahead_depth: "
+                   "%" ROCKSDB_PRIszt,
+                   compaction_async_readahead_depth);
 }
 
 bool ImmutableDBOptions::IsWalDirSameAsDBPath() const {
@@ -105,6 +105,11 @@ struct ImmutableDBOptions {
   uint64_t follower_catchup_retry_wait_ms;
   Temperature metadata_write_temperature;
   Temperature wal_write_temperature;
+  bool block_cache_warmup;
+  uint64_t block_cache_hot_set_persist_period_sec;
+  uint64_t block_cache_warmup_bytes_per_sec;
+  uint64_t compaction_memory_limit;
+  size_t compaction_async_readahead_depth;
 
   // Beginning convenience/helper objects that are not part of the base
   // DBOptions
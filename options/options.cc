@@ -92,6 +92,7 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       report_bg_io_stats(options.report_bg_io_stats),
       ttl(options.ttl),
       periodic_compaction_seconds(options.periodic_compaction_seconds),
+      max_delete_persistence_seconds(options.max_delete_persistence_seconds),
       sample_for_compression(options.sample_for_compression),
       last_level_temperature(options.last_level_temperature),
       default_write_temperature(options.default_write_temperature),
@@ -112,7 +113,15 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
       prepopulate_blob_cache(options.prepopulate_blob_cache),
-      persist_user_defined_timestamps(options.persist_user_defined_timestamps) {
+      persist_user_defined_timestamps(options.persist_user_defined_timestamps),
+      level_search_index_min_files(options.level_search_index_min_files),
+      range_tombstone_index_min_tombstones(
+          options.range_tombstone_index_min_tombstones),
+      l0_key_filter_bits_per_key(options.l0_key_filter_bits_per_key),
+      compaction_copy_data_blocks(options.compaction_copy_data_blocks),
+      flush_to_lowest_nonoverlapping_level(
+          options.flush_to_lowest_nonoverlapping_level),
+      max_flush_partitions(options.max_flush_partitions) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
       static_cast<unsigned int>(num_levels)) {
@@ -363,6 +372,11 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "Options.compaction_options_universal.max_read_amp: %d",
                      compaction_options_universal.max_read_amp);
+    ROCKS_LOG_HEADER(
+        log,
+        "Options.compaction_options_universal.lazy_leveling_tiering_factor: "
+        "%u",
+        compaction_options_universal.lazy_leveling_tiering_factor);
     ROCKS_LOG_HEADER(
         log, "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
         compaction_options_fifo.max_table_files_size);
@@ -407,6 +421,21 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "               Options.optimize_filters_for_hits: %d",
                      optimize_filters_for_hits);
+    ROCKS_LOG_HEADER(
+        log, "            Options.level_search_index_min_files: %" PRIu64,
+        level_search_index_min_files);
+    ROCKS_LOG_HEADER(
+        log, "    Options.range_tombstone_index_min_tombstones: %" PRIu64,
+        range_tombstone_index_min_tombstones);
+    ROCKS_LOG_HEADER(log, "              Options.l0_key_filter_bits_per_key: %f",
+                     l0_key_filter_bits_per_key);
+    ROCKS_LOG_HEADER(log, "             Options.compaction_copy_data_blocks: %d",
+                     compaction_copy_data_blocks);
+    ROCKS_LOG_HEADER(log,
+                     "    Options.flush_to_lowest_nonoverlapping_level: %d",
+                     flush_to_lowest_nonoverlapping_level);
+    ROCKS_LOG_HEADER(log, "                    Options.max_flush_partitions: %d",
+                     max_flush_partitions);
     ROCKS_LOG_HEADER(log, "               Options.paranoid_file_checks: %d",
                      paranoid_file_checks);
     ROCKS_LOG_HEADER(log, "               Options.force_consistency_checks: %d",
@@ -418,6 +447,9 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "         Options.periodic_compaction_seconds: %" PRIu64,
                      periodic_compaction_seconds);
+    ROCKS_LOG_HEADER(log,
+                     "      Options.max_delete_persistence_seconds: %" PRIu64,
+                     max_delete_persistence_seconds);
     const auto& it_temp = temperature_to_string.find(default_temperature);
     std::string str_default_temperature;
     if (it_temp == temperature_to_string.end()) {
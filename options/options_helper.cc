@@ -189,6 +189,15 @@ DBOptions BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.metadata_write_temperature =
       immutable_db_options.metadata_write_temperature;
   options.wal_write_temperature = immutable_db_options.wal_write_temperature;
+  options.block_cache_warmup = immutable_db_options.block_cache_warmup;
+  options.block_cache_hot_set_persist_period_sec =
+      immutable_db_options.block_cache_hot_set_persist_period_sec;
+  options.block_cache_warmup_bytes_per_sec =
+      immutable_db_options.block_cache_warmup_bytes_per_sec;
+  options.compaction_memory_limit =
+      immutable_db_options.compaction_memory_limit;
+  options.compaction_async_readahead_depth =
+      immutable_db_options.compaction_async_readahead_depth;
   return options;
 }
 
@@ -245,6 +254,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.max_bytes_for_level_multiplier;
   cf_opts->ttl = moptions.ttl;
   cf_opts->periodic_compaction_seconds = moptions.periodic_compaction_seconds;
+  cf_opts->max_delete_persistence_seconds =
+      moptions.max_delete_persistence_seconds;
 
   cf_opts->max_bytes_for_level_multiplier_additional.clear();
   for (auto value : moptions.max_bytes_for_level_multiplier_additional) {
@@ -325,6 +336,14 @@ void UpdateColumnFamilyOptions(const ImmutableCFOptions& ioptions,
       ioptions.preserve_internal_time_seconds;
   cf_opts->persist_user_defined_timestamps =
       ioptions.persist_user_defined_timestamps;
+  cf_opts->level_search_index_min_files = ioptions.level_search_index_min_files;
+  cf_opts->range_tombstone_index_min_tombstones =
+      ioptions.range_tombstone_index_min_tombstones;
+  cf_opts->l0_key_filter_bits_per_key = ioptions.l0_key_filter_bits_per_key;
+  cf_opts->compaction_copy_data_blocks = ioptions.compaction_copy_data_blocks;
+  cf_opts->flush_to_lowest_nonoverlapping_level =
+      ioptions.flush_to_lowest_nonoverlapping_level;
+  cf_opts->max_flush_partitions = ioptions.max_flush_partitions;
   cf_opts->default_temperature = ioptions.default_temperature;
 
   // TODO(yhchiang): find some way to handle the following derived options
@@ -343,7 +362,8 @@ std::map<CompactionPri, std::string> OptionsHelper::compaction_pri_to_string = {
     {kOldestLargestSeqFirst, "kOldestLargestSeqFirst"},
     {kOldestSmallestSeqFirst, "kOldestSmallestSeqFirst"},
     {kMinOverlappingRatio, "kMinOverlappingRatio"},
-    {kRoundRobin, "kRoundRobin"}};
+    {kRoundRobin, "kRoundRobin"},
+    {kReadHotOverlappingRatio, "kReadHotOverlappingRatio"}};
 
 std::map<CompactionStopStyle, std::string>
     OptionsHelper::compaction_stop_style_to_string = {
@@ -815,7 +835,8 @@ std::unordered_map<std::string, CompactionPri>
         {"kOldestLargestSeqFirst", kOldestLargestSeqFirst},
         {"kOldestSmallestSeqFirst", kOldestSmallestSeqFirst},
         {"kMinOverlappingRatio", kMinOverlappingRatio},
-        {"kRoundRobin", kRoundRobin}};
+        {"kRoundRobin", kRoundRobin},
+        {"kReadHotOverlappingRatio", kReadHotOverlappingRatio}};
 
 std::unordered_map<std::string, CompactionStopStyle>
     OptionsHelper::compaction_stop_style_string_map = {
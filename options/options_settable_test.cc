@@ -181,6 +181,7 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "pin_top_level_index_and_filter=1;"
       "index_type=kHashSearch;"
       "data_block_index_type=kDataBlockBinaryAndHash;"
+      "perfect_hash_index=true;"
       "index_shortening=kNoShortening;"
       "checksum=kxxHash;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;"
@@ -371,7 +372,12 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "follower_catchup_retry_count=456;"
                              "follower_catchup_retry_wait_ms=789;"
                              "metadata_write_temperature=kCold;"
-                             "wal_write_temperature=kHot;",
+                             "wal_write_temperature=kHot;"
+                             "block_cache_warmup=true;"
+                             "block_cache_hot_set_persist_period_sec=123;"
+                             "block_cache_warmup_bytes_per_sec=456;"
+                             "compaction_memory_limit=789;"
+                             "compaction_async_readahead_depth=3;",
                              new_options));
 
   ASSERT_EQ(unset_bytes_base, NumUnsetBytes(new_options_ptr, sizeof(DBOptions),
@@ -546,6 +552,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "report_bg_io_stats=true;"
       "ttl=60;"
       "periodic_compaction_seconds=3600;"
+      "max_delete_persistence_seconds=86400;"
       "sample_for_compression=0;"
       "enable_blob_files=true;"
       "min_blob_size=256;"
@@ -573,7 +580,13 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "memtable_max_range_deletions=999999;"
       "bottommost_file_compaction_delay=7200;"
       "uncache_aggressiveness=1234;"
-      "paranoid_memory_checks=1;",
+      "paranoid_memory_checks=1;"
+      "level_search_index_min_files=4096;"
+      "range_tombstone_index_min_tombstones=1000;"
+      "l0_key_filter_bits_per_key=10;"
+      "compaction_copy_data_blocks=true;"
+      "flush_to_lowest_nonoverlapping_level=true;"
+      "max_flush_partitions=4;",
       new_options));
 
   ASSERT_NE(new_options->blob_cache.get(), nullptr);
@@ -4,9 +4,12 @@ LIB_SOURCES =                                                   \
   cache/cache_entry_roles.cc                                    \
   cache/cache_key.cc                                            \
   cache/cache_helpers.cc                                        \
+  cache/cache_owner.cc                                          \
   cache/cache_reservation_manager.cc                            \
   cache/charged_cache.cc                                        \
   cache/clock_cache.cc                                          \
+  cache/frequency_admission.cc                                  \
+  cache/local_flash_secondary_cache.cc                          \
   cache/lru_cache.cc                                            \
   cache/compressed_secondary_cache.cc                           \
   cache/secondary_cache.cc                                      \
@@ -29,13 +32,16 @@ LIB_SOURCES =                                                   \
   db/blob/blob_log_writer.cc                                    \
   db/blob/blob_source.cc                                        \
   db/blob/prefetch_buffer_collection.cc                         \
+  db/block_cache_hot_set.cc                                     \
   db/builder.cc                                                 \
   db/c.cc                                                       \
   db/coalescing_iterator.cc                                     \
   db/column_family.cc                                           \
   db/compaction/compaction.cc                                   \
+  db/compaction/compaction_block_copier.cc                      \
   db/compaction/compaction_iterator.cc                          \
   db/compaction/compaction_job.cc                               \
+  db/compaction/compaction_memory_limiter.cc                    \
   db/compaction/compaction_picker.cc                            \
   db/compaction/compaction_picker_fifo.cc                       \
   db/compaction/compaction_picker_level.cc                      \
@@ -71,6 +77,8 @@ LIB_SOURCES =                                                   \
   db/forward_iterator.cc                                        \
   db/import_column_family_job.cc                                \
   db/internal_stats.cc                                          \
+  db/l0_key_filter.cc                                           \
+  db/level_search_index.cc                                      \
   db/logs_with_prep_tracker.cc                                  \
   db/log_reader.cc                                              \
   db/log_writer.cc                                              \
@@ -93,6 +101,7 @@ LIB_SOURCES =                                                   \
   db/version_builder.cc                                         \
   db/version_edit.cc                                            \
   db/version_edit_handler.cc                                    \
+  db/version_range_tombstone_index.cc                           \
   db/version_set.cc                                             \
   db/wal_edit.cc                                                \
   db/wal_manager.cc                                             \
@@ -193,10 +202,13 @@ LIB_SOURCES =                                                   \
   table/block_based/hash_index_reader.cc                        \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
+  table/block_based/learned_index.cc                            \
+  table/block_based/learned_index_reader.cc                     \
   table/block_based/parsed_full_filter_block.cc                 \
   table/block_based/partitioned_filter_block.cc                 \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
+  table/block_based/perfect_hash_index.cc                       \
   table/block_based/reader_common.cc                            \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
@@ -276,6 +288,7 @@ LIB_SOURCES =                                                   \
   utilities/checkpoint/checkpoint_impl.cc                       \
   utilities/compaction_filters.cc                               \
   utilities/compaction_filters/remove_emptyvalue_compactionfilter.cc    \
+  utilities/compaction_service/local_compaction_service.cc      \
   utilities/convenience/info_log_finder.cc                      \
   utilities/counted_fs.cc                                       \
   utilities/debug.cc                                            \
@@ -303,6 +316,7 @@ LIB_SOURCES =                                                   \
   utilities/persistent_cache/persistent_cache_tier.cc           \
   utilities/persistent_cache/volatile_tier_impl.cc              \
   utilities/simulator_cache/cache_simulator.cc                  \
+  utilities/simulator_cache/miss_ratio_curve_cache.cc           \
   utilities/simulator_cache/sim_cache.cc                        \
   utilities/table_properties_collectors/compact_for_tiering_collector.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector.cc \
@@ -444,6 +458,7 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_test.cc                                                   \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
+  cache/local_flash_secondary_cache_test.cc                             \
   cache/lru_cache_test.cc                                               \
   cache/tiered_secondary_cache_test.cc					\
   db/blob/blob_counting_iterator_test.cc                                \
@@ -519,6 +534,7 @@ TEST_MAIN_SOURCES =                                                     \
   db/file_indexer_test.cc                                               \
   db/filename_test.cc                                                   \
   db/flush_job_test.cc                                                  \
+  db/level_search_index_test.cc                                         \
   db/listener_test.cc                                                   \
   db/log_test.cc                                                        \
   db/manual_compaction_test.cc                                          \
@@ -574,7 +590,9 @@ TEST_MAIN_SOURCES =                                                     \
   table/block_based/block_test.cc                                       \
   table/block_based/disc_bit_block_index_test.cc                        \
   table/block_based/full_filter_block_test.cc                           \
+  table/block_based/learned_index_test.cc                               \
   table/block_based/partitioned_filter_block_test.cc                    \
+  table/block_based/perfect_hash_index_test.cc                          \
   table/cleanable_test.cc                                               \
   table/cuckoo/cuckoo_table_builder_test.cc                             \
   table/cuckoo/cuckoo_table_reader_test.cc                              \
@@ -621,6 +639,7 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/cassandra/cassandra_row_merge_test.cc                       \
   utilities/cassandra/cassandra_serialize_test.cc                       \
   utilities/checkpoint/checkpoint_test.cc                               \
+  utilities/compaction_service/local_compaction_service_test.cc         \
   utilities/env_timed_test.cc                                           \
   utilities/memory/memory_test.cc                                       \
   utilities/merge_operators/string_append/stringappend_test.cc          \
@@ -630,6 +649,7 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/persistent_cache/hash_table_test.cc                         \
   utilities/persistent_cache/persistent_cache_test.cc                   \
   utilities/simulator_cache/cache_simulator_test.cc                     \
+  utilities/simulator_cache/miss_ratio_curve_cache_test.cc              \
   utilities/simulator_cache/sim_cache_test.cc                           \
   utilities/table_properties_collectors/compact_for_tiering_collector_test.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector_test.cc  \
@@ -322,6 +322,25 @@ void DataBlockIter::SeekImpl(const Slice& target) {
   FindKeyAfterBinarySeek(seek_key, index, skip_linear_scan);
 }
 
+void DataBlockIter::SeekFromRestartImpl(const Slice& target,
+                                        uint32_t restart_index) {
+  PERF_TIMER_GUARD(block_seek_nanos);
+  if (data_ == nullptr) {  // Not init yet
+    return;
+  }
+  if (restart_index >= num_restarts_ || restarts_ == 0) {
+    CorruptionError("restart point out of range");
+    return;
+  }
+  SeekToRestartPoint(restart_index);
+  cur_entry_idx_ =
+      static_cast<int32_t>(restart_index * block_restart_interval_) - 1;
+  NextImpl();
+  while (Valid() && CompareCurrentKey(target) < 0) {
+    NextImpl();
+  }
+}
+
 void MetaBlockIter::SeekImpl(const Slice& target) {
   Slice seek_key = target;
   PERF_TIMER_GUARD(block_seek_nanos);
@@ -371,6 +390,8 @@ void IndexBlockIter::SeekImpl(const Slice& target) {
     // restart interval must be one when hash search is enabled so the binary
     // search simply lands at the right place.
     skip_linear_scan = true;
+  } else if (learned_index_) {
+    ok = LearnedSeek(seek_key, &index, &skip_linear_scan);
   } else if (value_delta_encoded_) {
     ok = BinaryOrDiscBitSeek<DecodeKeyV4>(seek_key, &index, &skip_linear_scan);
   } else {
@@ -758,7 +779,19 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
     // key accesses.
     return false;
   }
+  return BinarySeekInRange<DecodeKeyFunc>(target, -1, num_restarts_ - 1, index,
+                                          skip_linear_scan);
+}
 
+// Same as `BinarySeek()` but only searches restart keys in (`left`, `right`].
+// The caller must guarantee the loop invariants below for the initial bounds.
+template <class TValue>
+template <typename DecodeKeyFunc>
+bool BlockIter<TValue>::BinarySeekInRange(const Slice& target, int64_t left,
+                                          int64_t right, uint32_t* index,
+                                          bool* skip_linear_scan) {
+  assert(restarts_ != 0);
+  assert(-1 <= left && left <= right && right < num_restarts_);
   *skip_linear_scan = false;
   // Loop invariants:
   // - Restart key at index `left` is less than or equal to the target key. The
@@ -766,7 +799,6 @@ bool BlockIter<TValue>::BinarySeek(const Slice& target, uint32_t* index,
   //   keys.
   // - Any restart keys after index `right` are strictly greater than the target
   //   key.
-  int64_t left = -1, right = num_restarts_ - 1;
   while (left != right) {
     // The `mid` is computed by rounding up so it lands in (`left`, `right`].
     int64_t mid = left + (right - left + 1) / 2;
@@ -826,6 +858,56 @@ int IndexBlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   return CompareCurrentKey(target);
 }
 
+// Uses the learned model to bound the binary search over the restart array to
+// the few restart points around the predicted position. The bounds are
+// verified against the restart keys just outside the predicted range, so a
+// misprediction only widens the search and never changes the result of
+// `BinarySeek()`.
+bool IndexBlockIter::LearnedSeek(const Slice& target, uint32_t* index,
+                                 bool* skip_linear_scan) {
+  assert(learned_index_ != nullptr);
+  uint32_t first = 0;
+  uint32_t last = 0;
+  if (restarts_ == 0 ||
+      !learned_index_->PredictRestartRange(
+          raw_key_.IsUserKey() ? target : ExtractUserKey(target),
+          num_restarts_, &first, &last)) {
+    return value_delta_encoded_
+               ? BinarySeek<DecodeKeyV4>(target, index, skip_linear_scan)
+               : BinarySeek<DecodeKey>(target, index, skip_linear_scan);
+  }
+
+  int64_t left = -1;
+  int64_t right = num_restarts_ - 1;
+  if (first > 0) {
+    int cmp = CompareBlockKey(first, target);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp <= 0) {
+      left = first;
+    } else {
+      right = first - 1;
+    }
+  }
+  if (right == num_restarts_ - 1 && last + 1 < num_restarts_) {
+    int cmp = CompareBlockKey(last + 1, target);
+    if (!status_.ok()) {
+      return false;
+    }
+    if (cmp > 0) {
+      right = last;
+    } else {
+      left = last + 1;
+    }
+  }
+  return value_delta_encoded_
+             ? BinarySeekInRange<DecodeKeyV4>(target, left, right, index,
+                                              skip_linear_scan)
+             : BinarySeekInRange<DecodeKey>(target, left, right, index,
+                                            skip_linear_scan);
+}
+
 // Binary search in block_ids to find the first block
 // with a key >= target
 bool IndexBlockIter::BinaryBlockIndexSeek(const Slice& target,
@@ -1193,7 +1275,7 @@ IndexBlockIter* Block::NewIndexIterator(
     IndexBlockIter* iter, Statistics* /*stats*/, bool total_order_seek,
     bool have_first_key, bool key_includes_seq, bool value_is_full,
     bool block_contents_pinned, bool user_defined_timestamps_persisted,
-    BlockPrefixIndex* prefix_index) {
+    BlockPrefixIndex* prefix_index, const LearnedIndexModel* learned_index) {
   IndexBlockIter* ret_iter;
   if (iter != nullptr) {
     ret_iter = iter;
@@ -1215,7 +1297,8 @@ IndexBlockIter* Block::NewIndexIterator(
         raw_ucmp, data_, restart_offset_, num_restarts_, global_seqno,
         prefix_index_ptr, have_first_key, key_includes_seq, value_is_full,
         block_contents_pinned, user_defined_timestamps_persisted,
-        protection_bytes_per_key_, kv_checksum_, block_restart_interval_);
+        protection_bytes_per_key_, kv_checksum_, block_restart_interval_,
+        learned_index);
   }
 
   return ret_iter;
@@ -23,6 +23,7 @@
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "table/block_based/block_prefix_index.h"
+#include "table/block_based/learned_index.h"
 #include "table/block_based/disc_bit_block_index.h"
 #include "table/format.h"
 #include "table/internal_iterator.h"
@@ -227,6 +228,9 @@ class Block {
   // If `prefix_index` is not nullptr this block will do hash lookup for the key
   // prefix. If total_order_seek is true, prefix_index_ is ignored.
   //
+  // If `learned_index` is not nullptr, Seek() uses it to bound the binary
+  // search over the restart points.
+  //
   // `have_first_key` controls whether IndexValue will contain
   // first_internal_key. It affects data serialization format, so the same value
   // have_first_key must be used when writing and reading index.
@@ -239,7 +243,8 @@ class Block {
       bool have_first_key, bool key_includes_seq, bool value_is_full,
       bool block_contents_pinned = false,
       bool user_defined_timestamps_persisted = true,
-      BlockPrefixIndex* prefix_index = nullptr);
+      BlockPrefixIndex* prefix_index = nullptr,
+      const LearnedIndexModel* learned_index = nullptr);
 
   // Report an approximation of how much memory has been used.
   size_t ApproximateMemoryUsage() const;
@@ -678,6 +683,11 @@ class BlockIter : public InternalIteratorBase<TValue> {
   inline bool BinarySeek(const Slice& target, uint32_t* index,
                          bool* is_index_key_result);
 
+  template <typename DecodeKeyFunc>
+  inline bool BinarySeekInRange(const Slice& target, int64_t left,
+                                int64_t right, uint32_t* index,
+                                bool* is_index_key_result);
+
   template <typename DecodeKeyFunc>
   inline bool DiscBitSeek(const Slice& target, uint32_t* index,
                           bool* is_index_key_result);
@@ -749,6 +759,16 @@ class DataBlockIter final : public BlockIter<Slice> {
     return true;
   }
 
+  // Positions the iterator at the first key >= `target`, scanning linearly
+  // from restart point `restart_index`. The caller must know that no key
+  // before that restart point is >= `target`, e.g. from the perfect hash
+  // index, which records the restart interval holding the first entry of
+  // each user key.
+  void SeekForGetFromRestart(const Slice& target, uint32_t restart_index) {
+    SeekFromRestartImpl(target, restart_index);
+    UpdateKey();
+  }
+
   void Invalidate(const Status& s) override {
     BlockIter::Invalidate(s);
     // Clear prev entries cache.
@@ -797,6 +817,7 @@ class DataBlockIter final : public BlockIter<Slice> {
   int32_t prev_entries_idx_ = -1;
 
   bool SeekForGetImpl(const Slice& target);
+  void SeekFromRestartImpl(const Slice& target, uint32_t restart_index);
 };
 
 // Iterator over MetaBlocks.  MetaBlocks are similar to Data Blocks and
@@ -842,7 +863,8 @@ class MetaBlockIter final : public BlockIter<Slice> {
 
 class IndexBlockIter final : public BlockIter<IndexValue> {
  public:
-  IndexBlockIter() : BlockIter(), prefix_index_(nullptr) {}
+  IndexBlockIter()
+      : BlockIter(), prefix_index_(nullptr), learned_index_(nullptr) {}
 
   // key_includes_seq, default true, means that the keys are in internal key
   // format.
@@ -855,7 +877,8 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                   bool value_is_full, bool block_contents_pinned,
                   bool user_defined_timestamps_persisted,
                   uint8_t protection_bytes_per_key, const char* kv_checksum,
-                  uint32_t block_restart_interval) {
+                  uint32_t block_restart_interval,
+                  const LearnedIndexModel* learned_index = nullptr) {
     InitializeBase(raw_ucmp, data, restarts, num_restarts,
                    kDisableGlobalSequenceNumber, block_contents_pinned,
                    user_defined_timestamps_persisted,
@@ -864,6 +887,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
                    kv_checksum, block_restart_interval);
     raw_key_.SetIsUserKey(!key_includes_seq);
     prefix_index_ = prefix_index;
+    learned_index_ = learned_index;
     value_delta_encoded_ = !value_is_full;
     have_first_key_ = have_first_key;
     if (have_first_key_ && global_seqno != kDisableGlobalSequenceNumber) {
@@ -933,6 +957,7 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool value_delta_encoded_;
   bool have_first_key_;  // value includes first_internal_key
   BlockPrefixIndex* prefix_index_;
+  const LearnedIndexModel* learned_index_;
   // Whether the value is delta encoded. In that case the value is assumed to be
   // BlockHandle. The first value in each restart interval is the full encoded
   // BlockHandle; the restart of encoded size part of the BlockHandle. The
@@ -970,6 +995,10 @@ class IndexBlockIter final : public BlockIter<IndexValue> {
   bool BinaryBlockIndexSeek(const Slice& target, uint32_t* block_ids,
                             uint32_t left, uint32_t right, uint32_t* index,
                             bool* prefix_may_exist);
+  // Same result as a total order BinarySeek(), using `learned_index_` to
+  // narrow the restart points that are searched.
+  bool LearnedSeek(const Slice& target, uint32_t* index,
+                   bool* skip_linear_scan);
   inline int CompareBlockKey(uint32_t block_index, const Slice& target);
 
   inline bool ParseNextIndexKey();
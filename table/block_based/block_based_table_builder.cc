@@ -29,6 +29,7 @@
 #include "index_builder.h"
 #include "logging/logging.h"
 #include "memory/memory_allocator_impl.h"
+#include "monitoring/perf_context_imp.h"
 #include "rocksdb/cache.h"
 #include "rocksdb/comparator.h"
 #include "rocksdb/env.h"
@@ -303,10 +304,20 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<IndexBuilder> index_builder;
   std::string index_separator_scratch;
   PartitionedIndexBuilder* p_index_builder_ = nullptr;
+  LearnedIndexBuilder* l_index_builder_ = nullptr;
 
   std::string last_ikey;  // Internal key or empty (unset)
   const Slice* first_key_in_next_block = nullptr;
   CompressionType compression_type;
+  // Offered data block of another table, until a data block starts with its
+  // first key
+  std::unique_ptr<RawDataBlock> raw_block_offer;
+  // The offered block the current data block started like. It is written
+  // instead of the current data block if their contents match.
+  std::unique_ptr<RawDataBlock> raw_block_to_copy;
+  uint64_t num_raw_data_blocks_copied = 0;
+  // Smallest sequence number of the point and range tombstones added
+  SequenceNumber smallest_tombstone_seqno = kMaxSequenceNumber;
   uint64_t sample_for_compression;
   std::atomic<uint64_t> compressible_input_data_bytes;
   std::atomic<uint64_t> uncompressible_input_data_bytes;
@@ -552,6 +563,18 @@ struct BlockBasedTableBuilder::Rep {
           table_options.index_type, &internal_comparator,
           &this->internal_prefix_transform, use_delta_encoding_for_index_values,
           table_options, ts_sz, persist_user_defined_timestamps));
+      if (table_options.index_type == BlockBasedTableOptions::kLearnedIndex) {
+        l_index_builder_ =
+            static_cast<LearnedIndexBuilder*>(index_builder.get());
+      }
+      // The point lookup index keys on user keys, which would not match
+      // lookups with a different timestamp.
+      if (table_options.perfect_hash_index && ts_sz == 0) {
+        index_builder.reset(new PointLookupIndexBuilder(
+            &internal_comparator, std::move(index_builder),
+            table_options.block_restart_interval, ts_sz,
+            persist_user_defined_timestamps));
+      }
     }
     if (ioptions.optimize_filters_for_hits && tbo.is_bottommost) {
       // Apply optimize_filters_for_hits setting here when applicable by
@@ -577,6 +600,7 @@ struct BlockBasedTableBuilder::Rep {
         filter_context.num_levels = ioptions.num_levels;
         filter_context.level_at_creation = tbo.level_at_creation;
         filter_context.is_bottommost = tbo.is_bottommost;
+        filter_context.level_bytes = tbo.level_bytes;
         assert(filter_context.level_at_creation < filter_context.num_levels);
       }
 
@@ -1023,6 +1047,14 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
 #endif  // !NDEBUG
 
     auto should_flush = r->flush_block_policy->Update(ikey, value);
+    if (!r->data_block.empty() &&
+        ((r->raw_block_to_copy != nullptr &&
+          r->last_ikey == r->raw_block_to_copy->last_key) ||
+         (r->raw_block_offer != nullptr &&
+          ikey == Slice(r->raw_block_offer->first_key)))) {
+      // Align the data block with the offered one
+      should_flush = true;
+    }
     if (should_flush) {
       assert(!r->data_block.empty());
       r->first_key_in_next_block = &ikey;
@@ -1060,6 +1092,7 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
         if (r->IsParallelCompressionEnabled()) {
           r->pc_rep->curr_block_keys->Clear();
         } else {
+          PERF_TIMER_GUARD(index_build_time);
           r->index_builder->AddIndexEntry(r->last_ikey, &ikey,
                                           r->pending_handle,
                                           &r->index_separator_scratch);
@@ -1067,6 +1100,14 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
       }
     }
 
+    if (r->raw_block_offer != nullptr) {
+      if (r->data_block.empty() &&
+          ikey == Slice(r->raw_block_offer->first_key)) {
+        r->raw_block_to_copy = std::move(r->raw_block_offer);
+      }
+      r->raw_block_offer.reset();
+    }
+
     // Note: PartitionedFilterBlockBuilder requires key being added to filter
     // builder after being added to index builder.
     if (r->state == Rep::State::kUnbuffered) {
@@ -1131,9 +1172,13 @@ void BlockBasedTableBuilder::Add(const Slice& ikey, const Slice& value) {
   if (value_type == kTypeDeletion || value_type == kTypeSingleDeletion ||
       value_type == kTypeDeletionWithTimestamp) {
     r->props.num_deletions++;
+    r->smallest_tombstone_seqno =
+        std::min(r->smallest_tombstone_seqno, GetInternalKeySeqno(ikey));
   } else if (value_type == kTypeRangeDeletion) {
     r->props.num_deletions++;
     r->props.num_range_deletions++;
+    r->smallest_tombstone_seqno =
+        std::min(r->smallest_tombstone_seqno, GetInternalKeySeqno(ikey));
   } else if (value_type == kTypeMerge) {
     r->props.num_merge_operands++;
   }
@@ -1187,6 +1232,22 @@ void BlockBasedTableBuilder::WriteBlock(const Slice& uncompressed_block_data,
   CompressionType type;
   Status compress_status;
   bool is_data_block = block_type == BlockType::kData;
+  if (is_data_block && r->raw_block_to_copy != nullptr) {
+    std::unique_ptr<RawDataBlock> raw_block = std::move(r->raw_block_to_copy);
+    if (uncompressed_block_data == Slice(raw_block->uncompressed)) {
+      NotifyCollectTableCollectorsOnBlockAdd(r->table_properties_collectors,
+                                             uncompressed_block_data.size(),
+                                             /*block_compressed_bytes_fast=*/0,
+                                             /*block_compressed_bytes_slow=*/0);
+      WriteMaybeCompressedBlock(raw_block->raw, raw_block->compression_type,
+                                handle, block_type, &uncompressed_block_data);
+      r->props.data_size = r->get_offset();
+      ++r->props.num_data_blocks;
+      ++r->num_raw_data_blocks_copied;
+      RecordTick(r->ioptions.stats, NUMBER_DATA_BLOCKS_COPIED);
+      return;
+    }
+  }
   CompressAndVerifyBlock(uncompressed_block_data, is_data_block,
                          *(r->compression_ctxs[0]), r->verify_ctxs[0].get(),
                          &(r->compressed_output), &(block_contents), &type,
@@ -1235,6 +1296,7 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
   }
 
   if (is_status_ok && uncompressed_block_data.size() < kCompressionSizeLimit) {
+    PERF_TIMER_GUARD(block_compress_time);
     StopWatchNano timer(
         r->ioptions.clock,
         ShouldReportDetailedTime(r->ioptions.env, r->ioptions.stats));
@@ -1611,8 +1673,11 @@ void BlockBasedTableBuilder::WriteFilterBlock(
       // subtypes.
       std::unique_ptr<const char[]> filter_owner;
       Slice filter_content;
-      s = rep_->filter_builder->Finish(filter_block_handle, &filter_content,
-                                       &filter_owner);
+      {
+        PERF_TIMER_GUARD(filter_build_time);
+        s = rep_->filter_builder->Finish(filter_block_handle, &filter_content,
+                                         &filter_owner);
+      }
 
       assert(s.ok() || s.IsIncomplete() || s.IsCorruption());
       if (s.IsCorruption()) {
@@ -1647,7 +1712,11 @@ void BlockBasedTableBuilder::WriteIndexBlock(
     return;
   }
   IndexBuilder::IndexBlocks index_blocks;
-  auto index_builder_status = rep_->index_builder->Finish(&index_blocks);
+  Status index_builder_status;
+  {
+    PERF_TIMER_GUARD(index_build_time);
+    index_builder_status = rep_->index_builder->Finish(&index_blocks);
+  }
   if (index_builder_status.IsIncomplete()) {
     // We we have more than one index partition then meta_blocks are not
     // supported for the index. Currently meta_blocks are used only by
@@ -1680,8 +1749,11 @@ void BlockBasedTableBuilder::WriteIndexBlock(
   if (index_builder_status.IsIncomplete()) {
     bool index_building_finished = false;
     while (ok() && !index_building_finished) {
-      Status s =
-          rep_->index_builder->Finish(&index_blocks, *index_block_handle);
+      Status s;
+      {
+        PERF_TIMER_GUARD(index_build_time);
+        s = rep_->index_builder->Finish(&index_blocks, *index_block_handle);
+      }
       if (s.ok()) {
         index_building_finished = true;
       } else if (s.IsIncomplete()) {
@@ -1753,6 +1825,13 @@ void BlockBasedTableBuilder::WritePropertiesBlock(
       rep_->props.top_level_index_size =
           rep_->p_index_builder_->TopLevelIndexSize(rep_->offset);
     }
+    if (rep_->table_options.index_type ==
+        BlockBasedTableOptions::kLearnedIndex) {
+      assert(rep_->l_index_builder_ != nullptr);
+      rep_->props.learned_index_size = rep_->l_index_builder_->ModelSize();
+      rep_->props.learned_index_max_error =
+          rep_->l_index_builder_->ModelMaxError();
+    }
     rep_->props.index_key_is_user_key =
         !rep_->index_builder->seperator_is_key_plus_seq();
     rep_->props.index_value_is_delta_encoded =
@@ -2063,6 +2142,7 @@ Status BlockBasedTableBuilder::Finish() {
     // To make sure properties block is able to keep the accurate size of index
     // block, we will finish writing all index entries first.
     if (ok() && !empty_data_block) {
+      PERF_TIMER_GUARD(index_build_time);
       r->index_builder->AddIndexEntry(
           r->last_ikey, nullptr /* no next data block */, r->pending_handle,
           &r->index_separator_scratch);
@@ -2118,6 +2198,29 @@ void BlockBasedTableBuilder::Abandon() {
 #endif  // ROCKSDB_ASSERT_STATUS_CHECKED
 }
 
+bool BlockBasedTableBuilder::OfferRawDataBlock(
+    std::unique_ptr<RawDataBlock>&& block) {
+  Rep* r = rep_;
+  // Data blocks to compress with a dictionary or in parallel are not written
+  // in Add() order, and blocks compressed differently than configured are
+  // compressed again. Blocks left uncompressed, e.g. for a poor compression
+  // ratio, are copied as well.
+  if (r->state != Rep::State::kUnbuffered || r->compression_dict != nullptr ||
+      r->IsParallelCompressionEnabled() ||
+      (block->compression_type != r->compression_type &&
+       block->compression_type != kNoCompression) ||
+      block->compress_format_version !=
+          GetCompressFormatForVersion(r->table_options.format_version)) {
+    return false;
+  }
+  r->raw_block_offer = std::move(block);
+  return true;
+}
+
+uint64_t BlockBasedTableBuilder::NumRawDataBlocksCopied() const {
+  return rep_->num_raw_data_blocks_copied;
+}
+
 uint64_t BlockBasedTableBuilder::NumEntries() const {
   return rep_->props.num_entries;
 }
@@ -2173,6 +2276,21 @@ void BlockBasedTableBuilder::SetSeqnoTimeTableProperties(
   assert(rep_->props.seqno_to_time_mapping.empty());
   relevant_mapping.EncodeTo(rep_->props.seqno_to_time_mapping);
   rep_->props.creation_time = oldest_ancestor_time;
+  if (rep_->smallest_tombstone_seqno != kMaxSequenceNumber) {
+    // A time no later than the tombstone write, so its deadline is never
+    // missed because of the approximation. The oldest ancestor time is not
+    // used: compaction refreshes it to the age of the oldest data, so it
+    // would make fresh tombstones look overdue.
+    uint64_t time = relevant_mapping.GetProximalTimeBeforeSeqno(
+        rep_->smallest_tombstone_seqno);
+    if (time == kUnknownTimeBeforeAll) {
+      // The tombstone predates the mapping: it was written before recording
+      // started (the deadline then runs from when it did), or its entries
+      // were pruned, which only happens once it is older than the deadline.
+      time = relevant_mapping.GetOldestTime();
+    }
+    rep_->props.oldest_tombstone_time = time;
+  }
 }
 
 const std::string BlockBasedTable::kObsoleteFilterBlockPrefix = "filter.";
@@ -82,6 +82,10 @@ class BlockBasedTableBuilder : public TableBuilder {
 
   bool IsEmpty() const override;
 
+  bool OfferRawDataBlock(std::unique_ptr<RawDataBlock>&& block) override;
+
+  uint64_t NumRawDataBlocksCopied() const override;
+
   // Size of the file generated so far.  If invoked after a successful
   // Finish() call, returns the size of the final generated file.
   uint64_t FileSize() const override;
@@ -181,7 +181,8 @@ static std::unordered_map<std::string, BlockBasedTableOptions::IndexType>
         {"kTwoLevelIndexSearch",
          BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch},
         {"kBinarySearchWithFirstKey",
-         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey}};
+         BlockBasedTableOptions::IndexType::kBinarySearchWithFirstKey},
+        {"kLearnedIndex", BlockBasedTableOptions::IndexType::kLearnedIndex}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::DataBlockIndexType>
@@ -260,6 +261,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          OptionTypeInfo::Enum<BlockBasedTableOptions::DataBlockIndexType>(
              offsetof(struct BlockBasedTableOptions, data_block_index_type),
              &block_base_table_data_block_index_type_string_map)},
+        {"perfect_hash_index",
+         {offsetof(struct BlockBasedTableOptions, perfect_hash_index),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
         {"index_shortening",
          OptionTypeInfo::Enum<BlockBasedTableOptions::IndexShorteningMode>(
              offsetof(struct BlockBasedTableOptions, index_shortening),
@@ -755,6 +760,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  data_block_index_type: %d\n",
            table_options_.data_block_index_type);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  perfect_hash_index: %d\n",
+           table_options_.perfect_hash_index);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_shortening: %d\n",
            static_cast<int>(table_options_.index_shortening));
   ret.append(buffer);
@@ -965,6 +973,8 @@ const std::string BlockBasedTablePropertyNames::kDecoupledPartitionedFilters =
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
+const std::string kLearnedIndexModelBlock = "rocksdb.learnedindex.model";
+const std::string kPerfectHashIndexBlock = "rocksdb.perfecthashindex";
 const std::string kPropTrue = "1";
 const std::string kPropFalse = "0";
 
@@ -56,6 +56,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/hash_index_reader.h"
+#include "table/block_based/learned_index_reader.h"
 #include "table/block_based/partitioned_filter_block.h"
 #include "table/block_based/partitioned_index_reader.h"
 #include "table/block_fetcher.h"
@@ -67,6 +68,7 @@
 #include "table/persistent_cache_helper.h"
 #include "table/persistent_cache_options.h"
 #include "table/sst_file_writer_collectors.h"
+#include "table/table_builder.h"
 #include "table/two_level_iterator.h"
 #include "test_util/sync_point.h"
 #include "util/coding.h"
@@ -614,6 +616,17 @@ CacheKey BlockBasedTable::GetCacheKey(const OffsetableCacheKey& base_cache_key,
   return base_cache_key.WithOffset(handle.offset() >> 2);
 }
 
+bool BlockBasedTable::GetBlockOffset(const OffsetableCacheKey& base_cache_key,
+                                     const Slice& cache_key,
+                                     uint64_t* block_offset) {
+  uint64_t offset;
+  if (!base_cache_key.GetOffset(cache_key, &offset)) {
+    return false;
+  }
+  *block_offset = offset << 2;
+  return true;
+}
+
 Status BlockBasedTable::Open(
     const ReadOptions& read_options, const ImmutableOptions& ioptions,
     const EnvOptions& env_options, const BlockBasedTableOptions& table_options,
@@ -847,6 +860,11 @@ Status BlockBasedTable::Open(
   if (!s.ok()) {
     return s;
   }
+  s = new_table->ReadPerfectHashIndex(ro, prefetch_buffer.get(),
+                                      metaindex_iter.get());
+  if (!s.ok()) {
+    return s;
+  }
   rep->verify_checksum_set_on_open = ro.verify_checksums;
   s = new_table->PrefetchIndexAndFilterBlocks(
       ro, prefetch_buffer.get(), metaindex_iter.get(), new_table.get(),
@@ -1104,6 +1122,37 @@ Status BlockBasedTable::ReadRangeDelBlock(
   return s;
 }
 
+Status BlockBasedTable::ReadPerfectHashIndex(
+    const ReadOptions& read_options, FilePrefetchBuffer* prefetch_buffer,
+    InternalIterator* meta_iter) {
+  BlockHandle handle;
+  Status s = FindOptionalMetaBlock(meta_iter, kPerfectHashIndexBlock, &handle);
+  if (!s.ok() || handle.IsNull()) {
+    // Like other optional index metadata, a missing or unreadable perfect
+    // hash index only means falling back to the regular index.
+    IGNORE_STATUS_IF_ERROR(s);
+    return Status::OK();
+  }
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), prefetch_buffer, rep_->footer, read_options, handle,
+      &contents, rep_->ioptions, true /* decompress */,
+      true /*maybe_compressed*/, BlockType::kIndex,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options,
+      GetMemoryAllocator(rep_->table_options));
+  s = block_fetcher.ReadBlockContents();
+  if (!s.ok()) {
+    return s;
+  }
+  s = PerfectHashIndex::Create(contents.data, &rep_->perfect_hash_index);
+  if (!s.ok()) {
+    ROCKS_LOG_WARN(rep_->ioptions.logger,
+                   "Ignoring perfect hash index of file %s: %s",
+                   rep_->file->file_name().c_str(), s.ToString().c_str());
+  }
+  return Status::OK();
+}
+
 Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
     InternalIterator* meta_iter, BlockBasedTable* new_table, bool prefetch_all,
@@ -1337,6 +1386,9 @@ size_t BlockBasedTable::ApproximateMemoryUsage() const {
   if (rep_->uncompression_dict_reader) {
     usage += rep_->uncompression_dict_reader->ApproximateMemoryUsage();
   }
+  if (rep_->perfect_hash_index) {
+    usage += rep_->perfect_hash_index->ApproximateMemoryUsage();
+  }
   if (rep_->table_properties) {
     usage += rep_->table_properties->ApproximateMemoryUsage();
   }
@@ -2313,6 +2365,18 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
       FullFilterKeyMayMatch(filter, key, prefix_extractor, get_context,
                             &lookup_context, read_options);
   TEST_SYNC_POINT("BlockBasedTable::Get:AfterFilterMatch");
+  bool matched = false;  // if such user key matched a key in SST
+  // Data block already searched through the perfect hash index, if any.
+  BlockHandle searched_block = BlockHandle::NullBlockHandle();
+  if (may_match && rep_->perfect_hash_index != nullptr) {
+    if (GetWithPerfectHashIndex(read_options, key, get_context, tracing_get_id,
+                                &matched, &searched_block, &s)) {
+      if (matched && filter != nullptr) {
+        RecordFullFilterTruePositive();
+      }
+      return s;
+    }
+  }
   if (may_match) {
     IndexBlockIter iiter_on_stack;
     // if prefix_extractor found in block differs from options, disable
@@ -2331,10 +2395,13 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
 
     size_t ts_sz =
         rep_->internal_comparator.user_comparator()->timestamp_size();
-    bool matched = false;  // if such user key matched a key in SST
     bool done = false;
     for (iiter->Seek(key); iiter->Valid() && !done; iiter->Next()) {
       IndexValue v = iiter->value();
+      if (!searched_block.IsNull() &&
+          v.handle.offset() <= searched_block.offset()) {
+        continue;
+      }
 
       if (!v.first_internal_key.empty() && !skip_filters &&
           UserComparatorWrapper(rep_->internal_comparator.user_comparator())
@@ -2439,14 +2506,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
       }
     }
     if (matched && filter != nullptr) {
-      if (rep_->whole_key_filtering) {
-        RecordTick(rep_->ioptions.stats, BLOOM_FILTER_FULL_TRUE_POSITIVE);
-      } else {
-        RecordTick(rep_->ioptions.stats, BLOOM_FILTER_PREFIX_TRUE_POSITIVE);
-      }
-      // Includes prefix stats
-      PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1,
-                                rep_->level);
+      RecordFullFilterTruePositive();
     }
 
     if (s.ok() && !iiter->status().IsNotFound()) {
@@ -2457,6 +2517,94 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
   return s;
 }
 
+void BlockBasedTable::RecordFullFilterTruePositive() const {
+  if (rep_->whole_key_filtering) {
+    RecordTick(rep_->ioptions.stats, BLOOM_FILTER_FULL_TRUE_POSITIVE);
+  } else {
+    RecordTick(rep_->ioptions.stats, BLOOM_FILTER_PREFIX_TRUE_POSITIVE);
+  }
+  // Includes prefix stats
+  PERF_COUNTER_BY_LEVEL_ADD(bloom_filter_full_true_positive, 1, rep_->level);
+}
+
+bool BlockBasedTable::GetWithPerfectHashIndex(const ReadOptions& read_options,
+                                              const Slice& key,
+                                              GetContext* get_context,
+                                              uint64_t tracing_get_id,
+                                              bool* matched,
+                                              BlockHandle* searched_block,
+                                              Status* s) {
+  assert(rep_->perfect_hash_index != nullptr);
+  BlockHandle handle;
+  uint32_t restart_index = 0;
+  if (!rep_->perfect_hash_index->Lookup(ExtractUserKey(key), &handle,
+                                        &restart_index)) {
+    // The user key is not in this file.
+    return true;
+  }
+
+  BlockCacheLookupContext lookup_data_block_context{
+      TableReaderCaller::kUserGet, tracing_get_id,
+      /*get_from_user_specified_snapshot=*/read_options.snapshot != nullptr};
+  DataBlockIter biter;
+  Status tmp_status;
+  NewDataBlockIterator<DataBlockIter>(
+      read_options, handle, &biter, BlockType::kData, get_context,
+      &lookup_data_block_context, /*prefetch_buffer=*/nullptr,
+      /*for_compaction=*/false, /*async_read=*/false, tmp_status,
+      /*use_block_cache_for_lookup=*/true);
+  if (read_options.read_tier == kBlockCacheTier &&
+      biter.status().IsIncomplete()) {
+    // couldn't get block from block_cache
+    get_context->MarkKeyMayExist();
+    *s = biter.status();
+    return true;
+  }
+  if (!biter.status().ok()) {
+    *s = biter.status();
+    return true;
+  }
+
+  bool done = false;
+  bool does_referenced_key_exist = false;
+  uint64_t referenced_data_size = 0;
+  for (biter.SeekForGetFromRestart(key, restart_index); biter.Valid();
+       biter.Next()) {
+    ParsedInternalKey parsed_key;
+    *s = ParseInternalKey(biter.key(), &parsed_key, false /* log_err_key */);
+    if (!s->ok()) {
+      return true;
+    }
+    Status read_status;
+    bool ret = get_context->SaveValue(parsed_key, biter.value(), matched,
+                                      &read_status,
+                                      biter.IsValuePinned() ? &biter : nullptr);
+    if (!read_status.ok()) {
+      *s = read_status;
+      return true;
+    }
+    if (!ret) {
+      if (get_context->State() == GetContext::GetState::kFound) {
+        does_referenced_key_exist = true;
+        referenced_data_size = biter.key().size() + biter.value().size();
+      }
+      done = true;
+      break;
+    }
+  }
+  *s = biter.status();
+  if (block_cache_tracer_ && block_cache_tracer_->is_tracing_enabled()) {
+    FinishTraceRecord(lookup_data_block_context,
+                      lookup_data_block_context.block_key,
+                      does_referenced_key_exist ? biter.key() : key,
+                      does_referenced_key_exist, referenced_data_size);
+  }
+  // Reaching the end of the block undecided means later entries of the key
+  // are in the following blocks, which only the regular index can find.
+  *searched_block = handle;
+  return done || !s->ok();
+}
+
 Status BlockBasedTable::MultiGetFilter(const ReadOptions& read_options,
                                        const SliceTransform* prefix_extractor,
                                        MultiGetRange* mget_range) {
@@ -2548,6 +2696,140 @@ Status BlockBasedTable::Prefetch(const ReadOptions& read_options,
   return Status::OK();
 }
 
+Status BlockBasedTable::WarmUpBlockCache(
+    const ReadOptions& read_options, const std::vector<uint64_t>& block_offsets,
+    const std::function<bool(uint64_t)>& before_read) {
+  assert(std::is_sorted(block_offsets.begin(), block_offsets.end()));
+  Cache* const block_cache = rep_->table_options.block_cache.get();
+  if (block_cache == nullptr || block_offsets.empty()) {
+    return Status::OK();
+  }
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+  if (!iiter->status().ok()) {
+    return iiter->status();
+  }
+
+  // Both the index and the offsets are in file order. Offsets are compared
+  // without their two lower bits, as from GetBlockOffset().
+  auto offset_it = block_offsets.begin();
+  for (iiter->SeekToFirst(); iiter->Valid() && offset_it != block_offsets.end();
+       iiter->Next()) {
+    BlockHandle block_handle = iiter->value().handle;
+    const uint64_t key_offset = block_handle.offset() >> 2;
+    while (offset_it != block_offsets.end() && (*offset_it >> 2) < key_offset) {
+      ++offset_it;
+    }
+    if (offset_it == block_offsets.end() || (*offset_it >> 2) != key_offset) {
+      continue;
+    }
+    ++offset_it;
+
+    // Neither read nor charge `before_read` for blocks already cached, e.g.
+    // by user reads since the DB was opened
+    Cache::Handle* cache_handle = block_cache->Lookup(
+        GetCacheKey(rep_->base_cache_key, block_handle).AsSlice());
+    if (cache_handle != nullptr) {
+      block_cache->Release(cache_handle);
+      continue;
+    }
+    if (!before_read(BlockSizeWithTrailer(block_handle))) {
+      return Status::Incomplete("Block cache warm-up stopped");
+    }
+
+    // Load the block specified by the block_handle into the block cache
+    DataBlockIter biter;
+    Status tmp_status;
+    NewDataBlockIterator<DataBlockIter>(
+        read_options, block_handle, &biter, /*type=*/BlockType::kData,
+        /*get_context=*/nullptr, &lookup_context,
+        /*prefetch_buffer=*/nullptr, /*for_compaction=*/false,
+        /*async_read=*/false, tmp_status, /*use_block_cache_for_lookup=*/true);
+    if (!biter.status().ok()) {
+      return biter.status();
+    }
+  }
+  return iiter->status();
+}
+
+Status BlockBasedTable::ReadRawDataBlock(const ReadOptions& read_options,
+                                         const Slice& key,
+                                         RawDataBlock* block) {
+  // Keys as stored differ from the keys read with a global seqno or without
+  // persisted timestamps, and blocks compressed with this table's dictionary
+  // can only be read with it
+  if (rep_->global_seqno != kDisableGlobalSequenceNumber ||
+      !rep_->user_defined_timestamps_persisted ||
+      !rep_->compression_dict_handle.IsNull()) {
+    return Status::NotSupported("Data blocks cannot be copied");
+  }
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kCompaction};
+  IndexBlockIter iiter_on_stack;
+  auto iiter = NewIndexIterator(read_options, /*need_upper_bound_check=*/false,
+                                &iiter_on_stack, /*get_context=*/nullptr,
+                                &lookup_context);
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter_unique_ptr;
+  if (iiter != &iiter_on_stack) {
+    iiter_unique_ptr = std::unique_ptr<InternalIteratorBase<IndexValue>>(iiter);
+  }
+  iiter->Seek(key);
+  if (!iiter->Valid()) {
+    return iiter->status().ok() ? Status::NotFound() : iiter->status();
+  }
+  const BlockHandle handle = iiter->value().handle;
+
+  BlockContents contents;
+  BlockFetcher block_fetcher(
+      rep_->file.get(), /*prefetch_buffer=*/nullptr, rep_->footer,
+      read_options, handle, &contents, rep_->ioptions,
+      /*do_uncompress=*/false, /*maybe_compressed=*/true, BlockType::kData,
+      UncompressionDict::GetEmptyDict(), rep_->persistent_cache_options);
+  Status s = block_fetcher.ReadBlockContents();
+  if (!s.ok()) {
+    return s;
+  }
+  block->compression_type = block_fetcher.get_compression_type();
+  block->compress_format_version =
+      GetCompressFormatForVersion(rep_->footer.format_version());
+  block->raw.assign(contents.data.data(), contents.data.size());
+  if (block->compression_type != kNoCompression) {
+    UncompressionContext context(block->compression_type);
+    UncompressionInfo info(context, UncompressionDict::GetEmptyDict(),
+                           block->compression_type);
+    s = UncompressBlockData(info, block->raw.data(), block->raw.size(),
+                            &contents, rep_->footer.format_version(),
+                            rep_->ioptions);
+    if (!s.ok()) {
+      return s;
+    }
+  }
+  block->uncompressed.assign(contents.data.data(), contents.data.size());
+
+  Block data_block(std::move(contents));
+  std::unique_ptr<DataBlockIter> biter(data_block.NewDataIterator(
+      rep_->internal_comparator.user_comparator(), kDisableGlobalSequenceNumber,
+      /*iter=*/nullptr, /*stats=*/nullptr, /*block_contents_pinned=*/false,
+      rep_->user_defined_timestamps_persisted));
+  biter->SeekToFirst();
+  if (biter->Valid()) {
+    block->first_key.assign(biter->key().data(), biter->key().size());
+    biter->SeekToLast();
+  }
+  if (!biter->Valid()) {
+    return biter->status().ok() ? Status::Corruption("Empty data block")
+                                : biter->status();
+  }
+  block->last_key.assign(biter->key().data(), biter->key().size());
+  return Status::OK();
+}
+
 Status BlockBasedTable::VerifyChecksum(const ReadOptions& read_options,
                                        TableReaderCaller caller) {
   Status s;
@@ -2822,6 +3104,11 @@ Status BlockBasedTable::CreateIndexReader(
                                        index_reader);
       }
     }
+    case BlockBasedTableOptions::kLearnedIndex: {
+      return LearnedIndexReader::Create(this, ro, prefetch_buffer, meta_iter,
+                                        use_cache, prefetch, pin,
+                                        lookup_context, index_reader);
+    }
     default: {
       std::string error_message =
           "Unrecognized index type: " + std::to_string(rep_->index_type);
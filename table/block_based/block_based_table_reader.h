@@ -26,6 +26,7 @@
 #include "table/block_based/block_type.h"
 #include "table/block_based/cachable_entry.h"
 #include "table/block_based/filter_block.h"
+#include "table/block_based/perfect_hash_index.h"
 #include "table/block_based/uncompression_dict_reader.h"
 #include "table/format.h"
 #include "table/persistent_cache_options.h"
@@ -164,6 +165,13 @@ class BlockBasedTable : public TableReader {
   Status Prefetch(const ReadOptions& read_options, const Slice* begin,
                   const Slice* end) override;
 
+  Status WarmUpBlockCache(
+      const ReadOptions& read_options, const std::vector<uint64_t>& block_offsets,
+      const std::function<bool(uint64_t)>& before_read) override;
+
+  Status ReadRawDataBlock(const ReadOptions& read_options, const Slice& key,
+                          RawDataBlock* block) override;
+
   // Given a key, return an approximate byte offset in the file where
   // the data for that key begins (or would begin if the key were
   // present in the file). The returned value is in terms of file
@@ -261,6 +269,14 @@ class BlockBasedTable : public TableReader {
   static CacheKey GetCacheKey(const OffsetableCacheKey& base_cache_key,
                               const BlockHandle& handle);
 
+  // The inverse of GetCacheKey(): if `cache_key` is the key of a block of the
+  // file with `base_cache_key`, sets `*block_offset` and returns true. The
+  // cache key only keeps the offset without its two lower bits, so
+  // `*block_offset` is the block offset rounded down to a multiple of 4, which
+  // still identifies the block.
+  static bool GetBlockOffset(const OffsetableCacheKey& base_cache_key,
+                             const Slice& cache_key, uint64_t* block_offset);
+
   static void UpdateCacheInsertionMetrics(BlockType block_type,
                                           GetContext* get_context, size_t usage,
                                           bool redundant,
@@ -468,6 +484,17 @@ class BlockBasedTable : public TableReader {
                            BlockCacheLookupContext* lookup_context,
                            std::unique_ptr<IndexReader>* index_reader);
 
+  // Serves a point lookup from the perfect hash index. Returns false if the
+  // lookup must continue through the regular index with the data blocks
+  // after `*searched_block`, because the entries of the key continue past
+  // the end of the data block they start in.
+  bool GetWithPerfectHashIndex(const ReadOptions& read_options,
+                               const Slice& key, GetContext* get_context,
+                               uint64_t tracing_get_id, bool* matched,
+                               BlockHandle* searched_block, Status* s);
+
+  void RecordFullFilterTruePositive() const;
+
   bool FullFilterKeyMayMatch(FilterBlockReader* filter, const Slice& user_key,
                              const SliceTransform* prefix_extractor,
                              GetContext* get_context,
@@ -500,6 +527,9 @@ class BlockBasedTable : public TableReader {
                            InternalIterator* meta_iter,
                            const InternalKeyComparator& internal_comparator,
                            BlockCacheLookupContext* lookup_context);
+  Status ReadPerfectHashIndex(const ReadOptions& ro,
+                              FilePrefetchBuffer* prefetch_buffer,
+                              InternalIterator* meta_iter);
   Status PrefetchIndexAndFilterBlocks(
       const ReadOptions& ro, FilePrefetchBuffer* prefetch_buffer,
       InternalIterator* meta_iter, BlockBasedTable* new_table,
@@ -624,6 +654,9 @@ struct BlockBasedTable::Rep {
 
   std::shared_ptr<FragmentedRangeTombstoneList> fragmented_range_dels;
 
+  // Set if the file has a perfect hash point lookup index.
+  std::unique_ptr<PerfectHashIndex> perfect_hash_index;
+
   // Context for block cache CreateCallback
   BlockCreateContext create_context;
 
@@ -8,10 +8,34 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 #include "table/block_based/block_prefetcher.h"
 
+#include "file/file_util.h"
 #include "rocksdb/file_system.h"
+#include "rocksdb/rate_limiter.h"
 #include "table/block_based/block_based_table_reader.h"
 
 namespace ROCKSDB_NAMESPACE {
+namespace {
+// Number of asynchronous reads to keep in flight ahead of the compaction
+// reading `rep`'s file, or 0 to read it synchronously
+size_t CompactionAsyncReadaheadDepth(const BlockBasedTable::Rep* rep,
+                                     size_t compaction_readahead_size) {
+  const ImmutableOptions& ioptions = rep->ioptions;
+  if (ioptions.compaction_async_readahead_depth == 0 ||
+      compaction_readahead_size == 0) {
+    return 0;
+  }
+  // Asynchronous reads are not charged to the rate limiter
+  if (ioptions.rate_limiter != nullptr &&
+      ioptions.rate_limiter->IsRateLimited(RateLimiter::OpType::kRead)) {
+    return 0;
+  }
+  if (!CheckFSFeatureSupport(ioptions.fs.get(), FSSupportedOps::kAsyncIO)) {
+    return 0;
+  }
+  return ioptions.compaction_async_readahead_depth;
+}
+}  // namespace
+
 void BlockPrefetcher::PrefetchIfNeeded(
     const BlockBasedTable::Rep* rep, const BlockHandle& handle,
     const size_t readahead_size, bool is_for_compaction,
@@ -32,7 +56,13 @@ void BlockPrefetcher::PrefetchIfNeeded(
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
   if (is_for_compaction) {
-    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0) {
+    if (prefetch_buffer_ != nullptr) {
+      return;
+    }
+    const size_t async_depth =
+        CompactionAsyncReadaheadDepth(rep, compaction_readahead_size_);
+    if (async_depth == 0 && !rep->file->use_direct_io() &&
+        compaction_readahead_size_ > 0) {
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
@@ -58,6 +88,8 @@ void BlockPrefetcher::PrefetchIfNeeded(
     // implicit_auto_readahead is set.
     readahead_params.initial_readahead_size = compaction_readahead_size_;
     readahead_params.max_readahead_size = compaction_readahead_size_;
+    // The buffer being read from, and one per asynchronous read ahead of it
+    readahead_params.num_buffers = async_depth + 1;
     rep->CreateFilePrefetchBufferIfNotExists(readahead_params,
                                              &prefetch_buffer_,
                                              /*readaheadsize_cb=*/nullptr);
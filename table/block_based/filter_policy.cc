@@ -9,9 +9,11 @@
 
 #include "rocksdb/filter_policy.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <climits>
+#include <cmath>
 #include <cstring>
 #include <deque>
 #include <limits>
@@ -31,6 +33,7 @@
 #include "table/block_based/full_filter_block.h"
 #include "util/bloom_impl.h"
 #include "util/coding.h"
+#include "util/fastrange.h"
 #include "util/hash.h"
 #include "util/math.h"
 #include "util/ribbon_config.h"
@@ -609,6 +612,18 @@ class FastLocalBloomBitsReader : public BuiltinFilterBitsReader {
                                             len_bytes_, num_probes_, data_);
   }
 
+  void PrepareMayMatch(const Slice& key, PreparedQuery* query) override {
+    uint64_t h = GetSliceHash64(key);
+    FastLocalBloomImpl::PrepareHash(Lower32of64(h), len_bytes_, data_,
+                                    /*out*/ &query->offset);
+    query->hash = Upper32of64(h);
+  }
+
+  bool MayMatchPrepared(const PreparedQuery& query) override {
+    return FastLocalBloomImpl::HashMayMatchPrepared(
+        static_cast<uint32_t>(query.hash), num_probes_, data_ + query.offset);
+  }
+
  private:
   const char* data_;
   const int num_probes_;
@@ -1053,12 +1068,499 @@ class Standard128RibbonBitsReader : public BuiltinFilterBitsReader {
     return soln_.FilterQuery(h, hasher_);
   }
 
+  void PrepareMayMatch(const Slice& key, PreparedQuery* query) override {
+    ribbon::InterleavedPrepareQuery(GetSliceHash64(key), hasher_, soln_,
+                                    &query->hash, &query->offset,
+                                    &query->extra[0], &query->extra[1]);
+  }
+
+  bool MayMatchPrepared(const PreparedQuery& query) override {
+    return ribbon::InterleavedFilterQuery(query.hash, query.offset,
+                                          query.extra[0], query.extra[1],
+                                          hasher_, soln_);
+  }
+
  private:
   using TS = Standard128RibbonTypesAndSettings;
   ribbon::SerializableInterleavedSolution<TS> soln_;
   ribbon::StandardHasher<TS> hasher_;
 };
 
+// ################## Binary fuse filter implementation ################ //
+
+// A 3-wise binary fuse filter (Graf & Lemire, "Binary Fuse Filters: Fast
+// and Smaller Than Xor Filters", 2022) of 8- or 16-bit fingerprints. The
+// fingerprint of a key is the XOR of the entries at its three positions,
+// which are in three consecutive segments of the array, so a query costs
+// three memory accesses. Space is about 1.125 entries per key for large
+// filters (somewhat more for small ones), and building takes linear time,
+// by peeling the 3-hypergraph of keys.
+//
+// Metadata: -3 marker | seed | log2(segment length) |
+//           fingerprint bytes | reserved (0)
+static constexpr uint32_t kMaxBinaryFuseSegmentLengthBits = 18;
+
+// A bijective mixing of the key hash with a seed (from MurmurHash3 fmix64)
+inline uint64_t BinaryFuseSeededHash(uint64_t h, uint32_t seed) {
+  h += seed * uint64_t{0x9E3779B97F4A7C15};
+  h ^= h >> 33;
+  h *= uint64_t{0xff51afd7ed558ccd};
+  h ^= h >> 33;
+  h *= uint64_t{0xc4ceb9fe1a85ec53};
+  h ^= h >> 33;
+  return h;
+}
+
+inline uint32_t BinaryFuseFingerprint(uint64_t seeded_hash) {
+  return static_cast<uint32_t>(seeded_hash ^ (seeded_hash >> 32));
+}
+
+struct BinaryFuseLayout {
+  uint32_t segment_length_bits = 0;
+  // Number of segments the first position can be in, times segment length
+  uint32_t segment_count_length = 0;
+  // Number of entries, including the two extra segments
+  uint32_t array_length = 0;
+
+  static BinaryFuseLayout ForNumEntries(size_t num_entries) {
+    BinaryFuseLayout layout;
+    double n = static_cast<double>(std::max(num_entries, size_t{1}));
+    layout.segment_length_bits = std::min(
+        static_cast<uint32_t>(std::floor(std::log(n) / std::log(3.33) + 2.25)),
+        kMaxBinaryFuseSegmentLengthBits);
+    uint64_t segment_length = uint64_t{1} << layout.segment_length_bits;
+    double size_factor =
+        num_entries <= 1
+            ? 0.0
+            : std::max(1.125, 0.875 + 0.25 * std::log(1e6) / std::log(n));
+    auto capacity = static_cast<uint64_t>(std::round(n * size_factor));
+    uint64_t segment_count =
+        (capacity + segment_length - 1) / segment_length > 2
+            ? (capacity + segment_length - 1) / segment_length - 2
+            : 1;
+    layout.segment_count_length =
+        static_cast<uint32_t>(segment_count * segment_length);
+    layout.array_length =
+        static_cast<uint32_t>((segment_count + 2) * segment_length);
+    return layout;
+  }
+
+  // Returns false if not a valid layout
+  static bool FromMetadata(uint32_t array_length, uint32_t segment_length_bits,
+                           BinaryFuseLayout* layout) {
+    if (segment_length_bits > kMaxBinaryFuseSegmentLengthBits) {
+      return false;
+    }
+    uint32_t segment_length = uint32_t{1} << segment_length_bits;
+    if (array_length % segment_length != 0 ||
+        array_length / segment_length < 3) {
+      return false;
+    }
+    layout->segment_length_bits = segment_length_bits;
+    layout->segment_count_length = array_length - 2 * segment_length;
+    layout->array_length = array_length;
+    return true;
+  }
+
+  void GetPositions(uint64_t seeded_hash, uint32_t positions[3]) const {
+    uint32_t segment_length = uint32_t{1} << segment_length_bits;
+    uint32_t mask = segment_length - 1;
+    uint32_t h0 =
+        static_cast<uint32_t>(FastRange64(seeded_hash, segment_count_length));
+    positions[0] = h0;
+    positions[1] =
+        (h0 + segment_length) ^ (static_cast<uint32_t>(seeded_hash >> 18) & mask);
+    positions[2] =
+        (h0 + 2 * segment_length) ^ (static_cast<uint32_t>(seeded_hash) & mask);
+  }
+};
+
+inline uint32_t BinaryFuseLoad(const char* data, uint32_t fingerprint_bytes,
+                               uint32_t pos) {
+  return fingerprint_bytes == 1 ? static_cast<uint8_t>(data[pos])
+                                : DecodeFixed16(data + 2 * pos);
+}
+
+class BinaryFuseBitsBuilder : public XXPH3FilterBitsBuilder {
+ public:
+  // Filter sizes follow from the number of keys, so only the Bloom
+  // fallback rounds them for optimize_filters_for_memory.
+  explicit BinaryFuseBitsBuilder(
+      double desired_one_in_fp_rate, int bloom_millibits_per_key,
+      std::atomic<int64_t>* aggregate_rounding_balance,
+      std::shared_ptr<CacheReservationManager> cache_res_mgr,
+      bool detect_filter_construct_corruption, Logger* info_log)
+      : XXPH3FilterBitsBuilder(/*aggregate_rounding_balance=*/nullptr,
+                               cache_res_mgr,
+                               detect_filter_construct_corruption),
+        fingerprint_bytes_(desired_one_in_fp_rate > 256.0 ? 2 : 1),
+        info_log_(info_log),
+        bloom_fallback_(bloom_millibits_per_key, aggregate_rounding_balance,
+                        cache_res_mgr, detect_filter_construct_corruption) {}
+
+  // No Copy allowed
+  BinaryFuseBitsBuilder(const BinaryFuseBitsBuilder&) = delete;
+  void operator=(const BinaryFuseBitsBuilder&) = delete;
+
+  ~BinaryFuseBitsBuilder() override = default;
+
+  using FilterBitsBuilder::Finish;
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override {
+    return Finish(buf, nullptr);
+  }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf, Status* status) override {
+    if (hash_entries_info_.entries.size() == 0) {
+      if (status) {
+        *status = Status::OK();
+      }
+      return FinishAlwaysFalse(buf);
+    }
+    if (UseBloom(hash_entries_info_.entries.size())) {
+      return FallBackToBloom(buf, status);
+    }
+
+    TEST_SYNC_POINT_CALLBACK(
+        "XXPH3FilterBitsBuilder::Finish::"
+        "TamperHashEntries",
+        &hash_entries_info_.entries);
+
+    // Peeling needs distinct keys. Sorting also orders the keys by first
+    // position, for locality.
+    std::unique_ptr<CacheReservationManager::CacheReservationHandle>
+        construction_res_handle;
+    if (cache_res_mgr_) {
+      BinaryFuseLayout max_layout =
+          BinaryFuseLayout::ForNumEntries(hash_entries_info_.entries.size());
+      size_t bytes_construction =
+          hash_entries_info_.entries.size() * (2 * sizeof(uint64_t) + 4) +
+          size_t{max_layout.array_length} *
+              (sizeof(uint64_t) + 2 * sizeof(uint32_t));
+      Status s = cache_res_mgr_->MakeCacheReservation(bytes_construction,
+                                                      &construction_res_handle);
+      if (s.IsMemoryLimit()) {
+        ROCKS_LOG_WARN(info_log_,
+                       "Cache charging for binary fuse filter construction "
+                       "failed due to cache full");
+        return FallBackToBloom(buf, status);
+      }
+      s.PermitUncheckedError();
+    }
+    std::vector<uint64_t> hashes(hash_entries_info_.entries.begin(),
+                                 hash_entries_info_.entries.end());
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    const BinaryFuseLayout layout =
+        BinaryFuseLayout::ForNumEntries(hashes.size());
+    std::vector<uint32_t> counts;
+    std::vector<uint64_t> xors;
+    std::vector<uint32_t> alone;
+    std::vector<uint64_t> peeled_hashes;
+    std::vector<uint32_t> peeled_positions;
+    uint32_t start_seed = Lower32of64(hashes.front()) & 255;
+    uint32_t seed = start_seed;
+    bool success = false;
+    do {
+      success = Peel(hashes, layout, seed, &counts, &xors, &alone,
+                     &peeled_hashes, &peeled_positions);
+      if (!success) {
+        seed = (seed + 1) & 255;
+      }
+    } while (!success && seed != start_seed);
+    counts = {};
+    xors = {};
+    alone = {};
+    if (!success) {
+      ROCKS_LOG_WARN(info_log_,
+                     "Too many re-seeds (256) for binary fuse filter, %llu",
+                     static_cast<unsigned long long>(hashes.size()));
+      return FallBackToBloom(buf, status);
+    }
+
+    Status verify_hash_entries_checksum_status =
+        MaybeVerifyHashEntriesChecksum();
+    if (!verify_hash_entries_checksum_status.ok()) {
+      ROCKS_LOG_WARN(info_log_, "Verify hash entries checksum error: %s",
+                     verify_hash_entries_checksum_status.getState());
+      if (status) {
+        *status = verify_hash_entries_checksum_status;
+      }
+      return FinishAlwaysTrue(buf);
+    }
+
+    bool keep_entries_for_postverify = detect_filter_construct_corruption_;
+    if (!keep_entries_for_postverify) {
+      ResetEntries();
+    }
+
+    std::unique_ptr<char[]> mutable_buf;
+    std::unique_ptr<CacheReservationManager::CacheReservationHandle>
+        final_filter_cache_res_handle;
+    size_t len_with_metadata =
+        size_t{layout.array_length} * fingerprint_bytes_ + kMetadataLen;
+    len_with_metadata = AllocateMaybeRounding(len_with_metadata, hashes.size(),
+                                              &mutable_buf);
+    // Cache charging for mutable_buf
+    if (cache_res_mgr_) {
+      Status s = cache_res_mgr_->MakeCacheReservation(
+          len_with_metadata * sizeof(char), &final_filter_cache_res_handle);
+      s.PermitUncheckedError();
+    }
+
+    // Assign in reverse peeling order, so that each key's entry is set
+    // after the other two entries of the key
+    char* data = mutable_buf.get();
+    for (size_t i = peeled_hashes.size(); i > 0; --i) {
+      uint64_t seeded_hash = peeled_hashes[i - 1];
+      uint32_t pos = peeled_positions[i - 1];
+      uint32_t positions[3];
+      layout.GetPositions(seeded_hash, positions);
+      uint32_t fingerprint = BinaryFuseFingerprint(seeded_hash);
+      for (uint32_t other : positions) {
+        if (other != pos) {
+          fingerprint ^= BinaryFuseLoad(data, fingerprint_bytes_, other);
+        }
+      }
+      if (fingerprint_bytes_ == 1) {
+        data[pos] = static_cast<char>(fingerprint);
+      } else {
+        EncodeFixed16(data + 2 * pos, static_cast<uint16_t>(fingerprint));
+      }
+    }
+
+    // See BloomFilterPolicy::GetBloomBitsReader re: metadata
+    // -3 = Marker for binary fuse filter
+    mutable_buf[len_with_metadata - 5] = static_cast<char>(-3);
+    mutable_buf[len_with_metadata - 4] = static_cast<char>(seed);
+    mutable_buf[len_with_metadata - 3] =
+        static_cast<char>(layout.segment_length_bits);
+    mutable_buf[len_with_metadata - 2] = static_cast<char>(fingerprint_bytes_);
+    mutable_buf[len_with_metadata - 1] = 0;
+
+    auto TEST_arg_pair __attribute__((__unused__)) =
+        std::make_pair(&mutable_buf, len_with_metadata);
+    TEST_SYNC_POINT_CALLBACK("XXPH3FilterBitsBuilder::Finish::TamperFilter",
+                             &TEST_arg_pair);
+
+    Slice rv(mutable_buf.get(), len_with_metadata);
+    *buf = std::move(mutable_buf);
+    final_filter_cache_res_handles_.push_back(
+        std::move(final_filter_cache_res_handle));
+    if (status) {
+      *status = Status::OK();
+    }
+    return rv;
+  }
+
+  size_t CalculateSpace(size_t num_entries) override {
+    if (num_entries == 0) {
+      // See FinishAlwaysFalse
+      return 0;
+    }
+    if (UseBloom(num_entries)) {
+      return bloom_fallback_.CalculateSpace(num_entries);
+    }
+    return FuseSpace(num_entries);
+  }
+
+  size_t ApproximateNumEntries(size_t bytes) override {
+    // Largest number of entries that fits, by binary search
+    size_t lower = 0;
+    size_t upper = std::min(bytes * 8, size_t{kMaxBinaryFuseEntries});
+    while (lower < upper) {
+      size_t mid = upper - (upper - lower) / 2;
+      if (CalculateSpace(mid) <= bytes) {
+        lower = mid;
+      } else {
+        upper = mid - 1;
+      }
+    }
+    return lower;
+  }
+
+  double EstimatedFpRate(size_t num_entries,
+                         size_t len_with_metadata) override {
+    if (len_with_metadata <= kMetadataLen) {
+      return num_entries > 0 ? 1.0 : 0.0;
+    }
+    if (UseBloom(num_entries)) {
+      return bloom_fallback_.EstimatedFpRate(num_entries, len_with_metadata);
+    }
+    return std::pow(2.0, -8.0 * fingerprint_bytes_);
+  }
+
+  Status MaybePostVerify(const Slice& filter_content) override {
+    bool fall_back = (bloom_fallback_.EstimateEntriesAdded() > 0);
+    return fall_back ? bloom_fallback_.MaybePostVerify(filter_content)
+                     : XXPH3FilterBitsBuilder::MaybePostVerify(filter_content);
+  }
+
+ protected:
+  size_t RoundDownUsableSpace(size_t available_size) override {
+    // Not used without aggregate_rounding_balance_
+    return available_size;
+  }
+
+ private:
+  // Approximate limit keeping the filter size within 32 bits
+  static constexpr uint32_t kMaxBinaryFuseEntries = 950000000;
+
+  size_t FuseSpace(size_t num_entries) const {
+    return size_t{BinaryFuseLayout::ForNumEntries(num_entries).array_length} *
+               fingerprint_bytes_ +
+           kMetadataLen;
+  }
+
+  // Too many entries, or a Bloom filter would be smaller
+  bool UseBloom(size_t num_entries) {
+    if (num_entries > kMaxBinaryFuseEntries) {
+      return true;
+    }
+    return num_entries < 1024 &&
+           bloom_fallback_.CalculateSpace(num_entries) < FuseSpace(num_entries);
+  }
+
+  Slice FallBackToBloom(std::unique_ptr<const char[]>* buf, Status* status) {
+    SwapEntriesWith(&bloom_fallback_);
+    assert(hash_entries_info_.entries.empty());
+    return bloom_fallback_.Finish(buf, status);
+  }
+
+  // Peels the keys with the seed, repeatedly removing a key that is alone
+  // in one of its positions. Returns true if all keys were removed, with
+  // their seeded hashes and lone positions in removal order.
+  static bool Peel(const std::vector<uint64_t>& hashes,
+                   const BinaryFuseLayout& layout, uint32_t seed,
+                   std::vector<uint32_t>* counts, std::vector<uint64_t>* xors,
+                   std::vector<uint32_t>* alone,
+                   std::vector<uint64_t>* peeled_hashes,
+                   std::vector<uint32_t>* peeled_positions) {
+    counts->assign(layout.array_length, 0);
+    xors->assign(layout.array_length, 0);
+    alone->clear();
+    peeled_hashes->clear();
+    peeled_positions->clear();
+    uint32_t positions[3];
+    for (uint64_t h : hashes) {
+      uint64_t seeded_hash = BinaryFuseSeededHash(h, seed);
+      layout.GetPositions(seeded_hash, positions);
+      for (uint32_t pos : positions) {
+        ++(*counts)[pos];
+        (*xors)[pos] ^= seeded_hash;
+      }
+    }
+    for (uint32_t pos = 0; pos < layout.array_length; ++pos) {
+      if ((*counts)[pos] == 1) {
+        alone->push_back(pos);
+      }
+    }
+    while (!alone->empty()) {
+      uint32_t pos = alone->back();
+      alone->pop_back();
+      if ((*counts)[pos] != 1) {
+        continue;
+      }
+      uint64_t seeded_hash = (*xors)[pos];
+      peeled_hashes->push_back(seeded_hash);
+      peeled_positions->push_back(pos);
+      layout.GetPositions(seeded_hash, positions);
+      for (uint32_t other : positions) {
+        --(*counts)[other];
+        (*xors)[other] ^= seeded_hash;
+        if ((*counts)[other] == 1) {
+          alone->push_back(other);
+        }
+      }
+    }
+    return peeled_hashes->size() == hashes.size();
+  }
+
+  // 1 or 2, for a FP rate of 1/256 or 1/65536
+  const uint32_t fingerprint_bytes_;
+
+  // For warnings, or can be nullptr
+  Logger* info_log_;
+
+  // For falling back on Bloom filter for very small or very large filters,
+  // and in exceptional cases
+  FastLocalBloomBitsBuilder bloom_fallback_;
+};
+
+// for the linker, at least with DEBUG_LEVEL=2
+constexpr uint32_t BinaryFuseBitsBuilder::kMaxBinaryFuseEntries;
+
+class BinaryFuseBitsReader : public BuiltinFilterBitsReader {
+ public:
+  BinaryFuseBitsReader(const char* data, const BinaryFuseLayout& layout,
+                       uint32_t seed, uint32_t fingerprint_bytes)
+      : data_(data),
+        layout_(layout),
+        seed_(seed),
+        fingerprint_bytes_(fingerprint_bytes),
+        fingerprint_mask_(fingerprint_bytes == 1 ? 0xffU : 0xffffU) {}
+
+  // No Copy allowed
+  BinaryFuseBitsReader(const BinaryFuseBitsReader&) = delete;
+  void operator=(const BinaryFuseBitsReader&) = delete;
+
+  ~BinaryFuseBitsReader() override = default;
+
+  bool MayMatch(const Slice& key) override {
+    return HashMayMatch(GetSliceHash64(key));
+  }
+
+  void MayMatch(int num_keys, Slice** keys, bool* may_match) override {
+    std::array<PreparedQuery, MultiGetContext::MAX_BATCH_SIZE> prepared;
+    for (int i = 0; i < num_keys; ++i) {
+      PrepareMayMatch(*keys[i], &prepared[i]);
+    }
+    for (int i = 0; i < num_keys; ++i) {
+      may_match[i] = MayMatchPrepared(prepared[i]);
+    }
+  }
+
+  bool HashMayMatch(const uint64_t h) override {
+    PreparedQuery query;
+    PrepareHash(h, &query, /*prefetch=*/false);
+    return MayMatchPrepared(query);
+  }
+
+  void PrepareMayMatch(const Slice& key, PreparedQuery* query) override {
+    PrepareHash(GetSliceHash64(key), query, /*prefetch=*/true);
+  }
+
+  bool MayMatchPrepared(const PreparedQuery& query) override {
+    uint32_t x = BinaryFuseLoad(data_, fingerprint_bytes_, query.offset) ^
+                 BinaryFuseLoad(data_, fingerprint_bytes_, query.extra[0]) ^
+                 BinaryFuseLoad(data_, fingerprint_bytes_, query.extra[1]);
+    return x == static_cast<uint32_t>(query.hash);
+  }
+
+ private:
+  void PrepareHash(uint64_t h, PreparedQuery* query, bool prefetch) {
+    uint64_t seeded_hash = BinaryFuseSeededHash(h, seed_);
+    uint32_t positions[3];
+    layout_.GetPositions(seeded_hash, positions);
+    query->hash = BinaryFuseFingerprint(seeded_hash) & fingerprint_mask_;
+    query->offset = positions[0];
+    query->extra[0] = positions[1];
+    query->extra[1] = positions[2];
+    if (prefetch) {
+      for (uint32_t pos : positions) {
+        PREFETCH(data_ + pos * fingerprint_bytes_, 0 /* rw */, 1 /* locality */);
+      }
+    }
+  }
+
+  const char* data_;
+  const BinaryFuseLayout layout_;
+  const uint32_t seed_;
+  const uint32_t fingerprint_bytes_;
+  const uint32_t fingerprint_mask_;
+};
+
 // ##################### Legacy Bloom implementation ################### //
 
 using LegacyBloomImpl = LegacyLocalityBloomImpl</*ExtraRotates*/ false>;
@@ -1340,6 +1842,19 @@ class LegacyBloomBitsReader : public BuiltinFilterBitsReader {
 
   bool HashMayMatch(const uint64_t /* h */) override { return false; }
 
+  void PrepareMayMatch(const Slice& key, PreparedQuery* query) override {
+    query->hash = BloomHash(key);
+    LegacyBloomImpl::PrepareHashMayMatch(
+        static_cast<uint32_t>(query->hash), num_lines_, data_,
+        /*out*/ &query->offset, log2_cache_line_size_);
+  }
+
+  bool MayMatchPrepared(const PreparedQuery& query) override {
+    return LegacyBloomImpl::HashMayMatchPrepared(
+        static_cast<uint32_t>(query.hash), num_probes_, data_ + query.offset,
+        log2_cache_line_size_);
+  }
+
  private:
   const char* data_;
   const int num_probes_;
@@ -1566,6 +2081,33 @@ BloomLikeFilterPolicy::GetStandard128RibbonBuilderWithContext(
       context.info_log);
 }
 
+FilterBitsBuilder* BloomLikeFilterPolicy::GetBinaryFuseBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  bool offm = context.table_options.optimize_filters_for_memory;
+  const auto options_overrides_iter =
+      context.table_options.cache_usage_options.options_overrides.find(
+          CacheEntryRole::kFilterConstruction);
+  const auto filter_construction_charged =
+      options_overrides_iter !=
+              context.table_options.cache_usage_options.options_overrides.end()
+          ? options_overrides_iter->second.charged
+          : context.table_options.cache_usage_options.options.charged;
+
+  std::shared_ptr<CacheReservationManager> cache_res_mgr;
+  if (context.table_options.block_cache &&
+      filter_construction_charged ==
+          CacheEntryRoleOptions::Decision::kEnabled) {
+    cache_res_mgr = std::make_shared<
+        CacheReservationManagerImpl<CacheEntryRole::kFilterConstruction>>(
+        context.table_options.block_cache);
+  }
+  return new BinaryFuseBitsBuilder(
+      desired_one_in_fp_rate_, millibits_per_key_,
+      offm ? &aggregate_rounding_balance_ : nullptr, cache_res_mgr,
+      context.table_options.detect_filter_construct_corruption,
+      context.info_log);
+}
+
 std::string BloomLikeFilterPolicy::GetBitsPerKeySuffix() const {
   std::string rv = ":" + std::to_string(millibits_per_key_ / 1000);
   int frac = millibits_per_key_ % 1000;
@@ -1677,6 +2219,9 @@ BuiltinFilterBitsReader* BuiltinFilterPolicy::GetBuiltinFilterBitsReader(
       case -2:
         // Marker for Ribbon implementations
         return GetRibbonBitsReader(contents);
+      case -3:
+        // Marker for binary fuse filter
+        return GetBinaryFuseBitsReader(contents);
       default:
         // Reserved (treat as zero probes, always FP, for now)
         return new AlwaysTrueFilter();
@@ -1748,6 +2293,29 @@ BuiltinFilterBitsReader* BuiltinFilterPolicy::GetRibbonBitsReader(
                                          seed);
 }
 
+BuiltinFilterBitsReader* BuiltinFilterPolicy::GetBinaryFuseBitsReader(
+    const Slice& contents) {
+  uint32_t len_with_meta = static_cast<uint32_t>(contents.size());
+  uint32_t len = len_with_meta - kMetadataLen;
+
+  assert(len > 0);  // precondition
+
+  uint32_t seed = static_cast<uint8_t>(contents.data()[len + 1]);
+  uint32_t segment_length_bits = static_cast<uint8_t>(contents.data()[len + 2]);
+  uint32_t fingerprint_bytes = static_cast<uint8_t>(contents.data()[len + 3]);
+  uint32_t reserved = static_cast<uint8_t>(contents.data()[len + 4]);
+  BinaryFuseLayout layout;
+  if (reserved != 0 || (fingerprint_bytes != 1 && fingerprint_bytes != 2) ||
+      len % fingerprint_bytes != 0 ||
+      !BinaryFuseLayout::FromMetadata(len / fingerprint_bytes,
+                                      segment_length_bits, &layout)) {
+    // Corrupt or not supported. Return something safe:
+    return new AlwaysTrueFilter();
+  }
+  return new BinaryFuseBitsReader(contents.data(), layout, seed,
+                                  fingerprint_bytes);
+}
+
 // For newer Bloom filter implementations
 BuiltinFilterBitsReader* BuiltinFilterPolicy::GetBloomBitsReader(
     const Slice& contents) {
@@ -1887,6 +2455,121 @@ FilterPolicy* NewRibbonFilterPolicy(double bloom_equivalent_bits_per_key,
                                 bloom_before_level);
 }
 
+FilterBitsBuilder* BinaryFuseFilterPolicy::GetBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  if (GetMillibitsPerKey() == 0) {
+    // "No filter" special case
+    return nullptr;
+  }
+  return GetBinaryFuseBuilderWithContext(context);
+}
+
+const char* BinaryFuseFilterPolicy::kClassName() { return "binaryfusefilter"; }
+const char* BinaryFuseFilterPolicy::kNickName() {
+  return "rocksdb.BinaryFuseFilter";
+}
+
+FilterPolicy* NewBinaryFuseFilterPolicy(double bloom_equivalent_bits_per_key) {
+  return new BinaryFuseFilterPolicy(bloom_equivalent_bits_per_key);
+}
+
+LevelOptimizedFilterPolicy::LevelOptimizedFilterPolicy(
+    double bloom_equivalent_bits_per_key, bool use_ribbon)
+    : BloomLikeFilterPolicy(bloom_equivalent_bits_per_key),
+      use_ribbon_(use_ribbon) {}
+
+FilterBitsBuilder* LevelOptimizedFilterPolicy::GetBuilderWithContext(
+    const FilterBuildingContext& context) const {
+  double bits_per_key = GetMillibitsPerKey() / 1000.0;
+  if (context.compaction_style == kCompactionStyleLevel) {
+    bits_per_key = GetLevelBitsPerKey(bits_per_key, context.level_bytes,
+                                      context.level_at_creation);
+  }
+  return GetPolicyForBitsPerKey(bits_per_key)->GetBuilderWithContext(context);
+}
+
+double LevelOptimizedFilterPolicy::GetLevelBitsPerKey(
+    double bits_per_key, const std::vector<uint64_t>& level_bytes,
+    int level) {
+  if (bits_per_key <= 0 || level < 0 ||
+      static_cast<size_t>(level) >= level_bytes.size()) {
+    return bits_per_key;
+  }
+  std::vector<double> sizes;
+  double total = 0;
+  for (uint64_t bytes : level_bytes) {
+    if (bytes > 0) {
+      sizes.push_back(static_cast<double>(bytes));
+      total += static_cast<double>(bytes);
+    }
+  }
+  if (sizes.empty()) {
+    return bits_per_key;
+  }
+  std::sort(sizes.begin(), sizes.end(), std::greater<double>());
+  // An empty level is treated like the smallest one
+  const double size = level_bytes[level] > 0
+                          ? static_cast<double>(level_bytes[level])
+                          : sizes.back();
+
+  // A Bloom filter with b bits per key has FP rate p = exp(-b * ln(2)^2).
+  // With p_i = lambda * N_i for level i of N_i bytes, the budget
+  //   Sum over levels with p_i < 1: N_i * -ln(p_i) / ln(2)^2
+  //     = bits_per_key * Sum N_i
+  // gives ln(lambda). Levels with p_i >= 1, the largest ones, get no bits,
+  // and are left out until the largest level left has p_i < 1. The
+  // smallest level alone always does.
+  const double ln2_squared = std::log(2.0) * std::log(2.0);
+  const double budget = bits_per_key * total * ln2_squared;
+  double active = total;
+  double sum_n_ln_n = 0;
+  for (double n : sizes) {
+    sum_n_ln_n += n * std::log(n);
+  }
+  double ln_lambda = 0;
+  for (double largest : sizes) {
+    ln_lambda = -(budget + sum_n_ln_n) / active;
+    if (ln_lambda + std::log(largest) < 0) {
+      break;
+    }
+    active -= largest;
+    sum_n_ln_n -= largest * std::log(largest);
+  }
+  return std::max(-(ln_lambda + std::log(size)) / ln2_squared, 0.0);
+}
+
+const FilterPolicy* LevelOptimizedFilterPolicy::GetPolicyForBitsPerKey(
+    double bits_per_key) const {
+  int quarter_bits = static_cast<int>(bits_per_key * 4 + 0.5);
+  std::lock_guard<std::mutex> lock(policies_mutex_);
+  auto& policy = policies_[quarter_bits];
+  if (!policy) {
+    if (use_ribbon_) {
+      policy.reset(NewRibbonFilterPolicy(quarter_bits / 4.0));
+    } else {
+      policy.reset(NewBloomFilterPolicy(quarter_bits / 4.0));
+    }
+  }
+  return policy.get();
+}
+
+const char* LevelOptimizedFilterPolicy::kClassName() {
+  return "leveloptimizedfilter";
+}
+const char* LevelOptimizedFilterPolicy::kNickName() {
+  return "rocksdb.LevelOptimizedFilter";
+}
+
+std::string LevelOptimizedFilterPolicy::GetId() const {
+  return BloomLikeFilterPolicy::GetId() + (use_ribbon_ ? ":true" : ":false");
+}
+
+FilterPolicy* NewLevelOptimizedFilterPolicy(
+    double bloom_equivalent_bits_per_key, bool use_ribbon) {
+  return new LevelOptimizedFilterPolicy(bloom_equivalent_bits_per_key,
+                                        use_ribbon);
+}
+
 FilterBuildingContext::FilterBuildingContext(
     const BlockBasedTableOptions& _table_options)
     : table_options(_table_options) {}
@@ -1908,6 +2591,8 @@ std::shared_ptr<const FilterPolicy> BloomLikeFilterPolicy::Create(
     // For testing
     return std::make_shared<RibbonFilterPolicy>(bits_per_key,
                                                 /*bloom_before_level*/ 0);
+  } else if (name == BinaryFuseFilterPolicy::kClassName()) {
+    return std::make_shared<BinaryFuseFilterPolicy>(bits_per_key);
   } else {
     return nullptr;
   }
@@ -1989,6 +2674,39 @@ static int RegisterBuiltinFilterPolicies(ObjectLibrary& library,
         guard->reset(NewRibbonFilterPolicy(bits_per_key, bloom_before_level));
         return guard->get();
       });
+  library.AddFactory<const FilterPolicy>(
+      FilterPatternEntryWithBits(BinaryFuseFilterPolicy::kClassName())
+          .AnotherName(BinaryFuseFilterPolicy::kNickName()),
+      [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
+         std::string* /* errmsg */) {
+        guard->reset(
+            NewBuiltinFilterPolicyWithBits<BinaryFuseFilterPolicy>(uri));
+        return guard->get();
+      });
+  library.AddFactory<const FilterPolicy>(
+      FilterPatternEntryWithBits(LevelOptimizedFilterPolicy::kClassName())
+          .AnotherName(LevelOptimizedFilterPolicy::kNickName()),
+      [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
+         std::string* /* errmsg */) {
+        const std::vector<std::string> vals = StringSplit(uri, ':');
+        double bits_per_key = ParseDouble(vals[1]);
+        guard->reset(NewLevelOptimizedFilterPolicy(bits_per_key));
+        return guard->get();
+      });
+  for (bool use_ribbon : {false, true}) {
+    library.AddFactory<const FilterPolicy>(
+        FilterPatternEntryWithBits(LevelOptimizedFilterPolicy::kClassName())
+            .AnotherName(LevelOptimizedFilterPolicy::kNickName())
+            .AddSuffix(use_ribbon ? ":true" : ":false"),
+        [use_ribbon](const std::string& uri,
+                     std::unique_ptr<const FilterPolicy>* guard,
+                     std::string* /* errmsg */) {
+          const std::vector<std::string> vals = StringSplit(uri, ':');
+          double bits_per_key = ParseDouble(vals[1]);
+          guard->reset(NewLevelOptimizedFilterPolicy(bits_per_key, use_ribbon));
+          return guard->get();
+        });
+  }
   library.AddFactory<const FilterPolicy>(
       FilterPatternEntryWithBits(test::LegacyBloomFilterPolicy::kClassName()),
       [](const std::string& uri, std::unique_ptr<const FilterPolicy>* guard,
@@ -2063,6 +2781,7 @@ const std::vector<std::string>& BloomLikeFilterPolicy::GetAllFixedImpls() {
       test::LegacyBloomFilterPolicy::kClassName(),
       test::FastLocalBloomFilterPolicy::kClassName(),
       test::Standard128RibbonFilterPolicy::kClassName(),
+      BinaryFuseFilterPolicy::kClassName(),
   };
   return impls;
 }
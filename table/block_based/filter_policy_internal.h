@@ -9,12 +9,15 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "rocksdb/filter_policy.h"
 #include "rocksdb/table.h"
+#include "util/hash.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -133,6 +136,26 @@ class BuiltinFilterBitsReader : public FilterBitsReader {
  public:
   // Check if the hash of the entry match the bits in filter
   virtual bool HashMayMatch(const uint64_t /* h */) { return true; }
+
+  // A query split in two steps, so that a batch of queries spanning many
+  // filters (e.g. the partitions of a partitioned filter) can prefetch the
+  // filter memory of all keys before testing any of them. The fields are
+  // specific to the implementation.
+  struct PreparedQuery {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t extra[2];
+  };
+
+  // Hashes the key and prefetches the filter memory MayMatchPrepared reads
+  virtual void PrepareMayMatch(const Slice& key, PreparedQuery* query) {
+    query->hash = GetSliceHash64(key);
+  }
+
+  // Same result as MayMatch on the key passed to PrepareMayMatch
+  virtual bool MayMatchPrepared(const PreparedQuery& query) {
+    return HashMayMatch(query.hash);
+  }
 };
 
 // Base class for RocksDB built-in filter policies. This provides the
@@ -169,6 +192,10 @@ class BuiltinFilterPolicy : public FilterPolicy {
 
   // For Ribbon filter implementation(s)
   static BuiltinFilterBitsReader* GetRibbonBitsReader(const Slice& contents);
+
+  // For binary fuse filter implementation(s)
+  static BuiltinFilterBitsReader* GetBinaryFuseBitsReader(
+      const Slice& contents);
 };
 
 // A "read only" filter policy used for backward compatibility with old
@@ -225,6 +252,8 @@ class BloomLikeFilterPolicy : public BuiltinFilterPolicy {
       const FilterBuildingContext& context) const;
   FilterBitsBuilder* GetStandard128RibbonBuilderWithContext(
       const FilterBuildingContext& context) const;
+  FilterBitsBuilder* GetBinaryFuseBuilderWithContext(
+      const FilterBuildingContext& context) const;
 
   std::string GetBitsPerKeySuffix() const;
 
@@ -309,6 +338,61 @@ class RibbonFilterPolicy : public BloomLikeFilterPolicy {
   std::atomic<int> bloom_before_level_;
 };
 
+// For NewBinaryFuseFilterPolicy
+//
+// This is a user-facing policy that builds binary fuse filters, except for
+// very small or very large filters, which are Bloom filters.
+class BinaryFuseFilterPolicy : public BloomLikeFilterPolicy {
+ public:
+  explicit BinaryFuseFilterPolicy(double bloom_equivalent_bits_per_key)
+      : BloomLikeFilterPolicy(bloom_equivalent_bits_per_key) {}
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext&) const override;
+
+  static const char* kClassName();
+  const char* Name() const override { return kClassName(); }
+  static const char* kNickName();
+  const char* NickName() const override { return kNickName(); }
+};
+
+// For NewLevelOptimizedFilterPolicy
+//
+// A user-facing policy that builds each filter with a BloomFilterPolicy or
+// RibbonFilterPolicy of the bits per key chosen for the level at creation.
+class LevelOptimizedFilterPolicy : public BloomLikeFilterPolicy {
+ public:
+  LevelOptimizedFilterPolicy(double bloom_equivalent_bits_per_key,
+                             bool use_ribbon);
+
+  FilterBitsBuilder* GetBuilderWithContext(
+      const FilterBuildingContext&) const override;
+
+  static const char* kClassName();
+  const char* Name() const override { return kClassName(); }
+  static const char* kNickName();
+  const char* NickName() const override { return kNickName(); }
+  std::string GetId() const override;
+
+  // Bloom-equivalent bits per key for tables created in `level`, such that
+  // the false positive rate of each level is proportional to its size and
+  // bits_per_key are spent on average. Returns bits_per_key if the level is
+  // unknown.
+  static double GetLevelBitsPerKey(double bits_per_key,
+                                   const std::vector<uint64_t>& level_bytes,
+                                   int level);
+
+ private:
+  // The policy for building filters with the given bits per key, rounded to
+  // a quarter bit. The policies are kept for the lifetime of this one, as
+  // their builders might refer to them.
+  const FilterPolicy* GetPolicyForBitsPerKey(double bits_per_key) const;
+
+  const bool use_ribbon_;
+  mutable std::mutex policies_mutex_;
+  mutable std::map<int, std::unique_ptr<const FilterPolicy>> policies_;
+};
+
 // For testing only, but always constructable with internal names
 namespace test {
 
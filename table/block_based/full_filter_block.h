@@ -108,13 +108,6 @@ class FullFilterBlockReader
   void KeysMayMatch(MultiGetRange* range,
                     BlockCacheLookupContext* lookup_context,
                     const ReadOptions& read_options) override;
-  // Used in partitioned filter code
-  void KeysMayMatch2(MultiGetRange* range,
-                     const SliceTransform* /*prefix_extractor*/,
-                     BlockCacheLookupContext* lookup_context,
-                     const ReadOptions& read_options) {
-    KeysMayMatch(range, lookup_context, read_options);
-  }
 
   void PrefixesMayMatch(MultiGetRange* range,
                         const SliceTransform* prefix_extractor,
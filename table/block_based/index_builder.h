@@ -18,6 +18,8 @@
 #include "rocksdb/comparator.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "table/block_based/block_builder.h"
+#include "table/block_based/learned_index.h"
+#include "table/block_based/perfect_hash_index.h"
 #include "table/format.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -436,6 +438,127 @@ class HashIndexBuilder : public IndexBuilder {
   uint64_t current_restart_index_ = 0;
 };
 
+// LearnedIndexBuilder builds an ordinary binary-searchable index block plus a
+// metablock holding a piecewise-linear model from each separator key to its
+// position in the index block (see learned_index.h). When the comparator
+// does not order keys as numbers, or no model with a useful error bound
+// exists, the metablock is omitted and readers use plain binary search.
+class LearnedIndexBuilder : public IndexBuilder {
+ public:
+  LearnedIndexBuilder(const InternalKeyComparator* comparator,
+                      int index_block_restart_interval, int format_version,
+                      bool use_value_delta_encoding,
+                      BlockBasedTableOptions::IndexShorteningMode shortening_mode,
+                      size_t ts_sz, const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(comparator, index_block_restart_interval,
+                               format_version, use_value_delta_encoding,
+                               shortening_mode, /* include_first_key */ false,
+                               ts_sz, persist_user_defined_timestamps),
+        model_builder_(comparator->user_comparator(),
+                       static_cast<uint32_t>(index_block_restart_interval)) {}
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* first_key_in_next_block,
+                      const BlockHandle& block_handle,
+                      std::string* separator_scratch) override {
+    Slice separator = primary_index_builder_.AddIndexEntry(
+        last_key_in_current_block, first_key_in_next_block, block_handle,
+        separator_scratch);
+    model_builder_.AddSeparator(ExtractUserKey(separator));
+    return separator;
+  }
+
+  void OnKeyAdded(const Slice& key) override {
+    primary_index_builder_.OnKeyAdded(key);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_.Finish(index_blocks,
+                                             last_partition_block_handle);
+    if (s.ok() && model_builder_.Finish(&model_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kLearnedIndexModelBlock.c_str(), model_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_.IndexSize() + model_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_.seperator_is_key_plus_seq();
+  }
+
+  // Size of the model metablock, 0 if no model was built.
+  size_t ModelSize() const { return model_block_.size(); }
+
+  // Maximum prediction error of the model, in index entries.
+  uint32_t ModelMaxError() const { return model_builder_.MaxError(); }
+
+ private:
+  ShortenedIndexBuilder primary_index_builder_;
+  LearnedIndexModelBuilder model_builder_;
+  std::string model_block_;
+};
+
+// PointLookupIndexBuilder wraps the primary (non-partitioned) index builder
+// and additionally writes a PerfectHashIndex metablock over the user keys of
+// the file (BlockBasedTableOptions::perfect_hash_index).
+class PointLookupIndexBuilder : public IndexBuilder {
+ public:
+  PointLookupIndexBuilder(const InternalKeyComparator* comparator,
+                          std::unique_ptr<IndexBuilder>&& primary_index_builder,
+                          int block_restart_interval, size_t ts_sz,
+                          const bool persist_user_defined_timestamps)
+      : IndexBuilder(comparator, ts_sz, persist_user_defined_timestamps),
+        primary_index_builder_(std::move(primary_index_builder)),
+        hash_index_builder_(static_cast<uint32_t>(block_restart_interval)) {
+    assert(ts_sz == 0);
+  }
+
+  Slice AddIndexEntry(const Slice& last_key_in_current_block,
+                      const Slice* first_key_in_next_block,
+                      const BlockHandle& block_handle,
+                      std::string* separator_scratch) override {
+    hash_index_builder_.FinishBlock(block_handle);
+    return primary_index_builder_->AddIndexEntry(last_key_in_current_block,
+                                                 first_key_in_next_block,
+                                                 block_handle, separator_scratch);
+  }
+
+  void OnKeyAdded(const Slice& key) override {
+    hash_index_builder_.AddKey(ExtractUserKey(key));
+    primary_index_builder_->OnKeyAdded(key);
+  }
+
+  Status Finish(IndexBlocks* index_blocks,
+                const BlockHandle& last_partition_block_handle) override {
+    Status s = primary_index_builder_->Finish(index_blocks,
+                                              last_partition_block_handle);
+    if (s.ok() && hash_index_builder_.Finish(&hash_index_block_)) {
+      index_blocks->meta_blocks.insert(
+          {kPerfectHashIndexBlock.c_str(), hash_index_block_});
+    }
+    return s;
+  }
+
+  size_t IndexSize() const override {
+    return primary_index_builder_->IndexSize() + hash_index_block_.size();
+  }
+
+  bool seperator_is_key_plus_seq() override {
+    return primary_index_builder_->seperator_is_key_plus_seq();
+  }
+
+ private:
+  std::unique_ptr<IndexBuilder> primary_index_builder_;
+  PerfectHashIndexBuilder hash_index_builder_;
+  std::string hash_index_block_;
+};
+
 /**
  * IndexBuilder for two-level indexing. Internally it creates a new index for
  * each partition and Finish then in order when Finish is called on it
@@ -0,0 +1,232 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "rocksdb/comparator.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint8_t kLearnedIndexFormat = 1;
+constexpr uint8_t kReverseBytewiseFlag = 0x1;
+constexpr size_t kHeaderSize = 2 + 4 * sizeof(uint32_t);
+constexpr size_t kSegmentSize = sizeof(uint64_t) + sizeof(uint32_t) +
+                                sizeof(uint64_t);
+
+uint64_t KeyToNumber(const Slice& user_key, bool reverse) {
+  uint64_t result = 0;
+  size_t n = std::min(user_key.size(), sizeof(uint64_t));
+  for (size_t i = 0; i < n; ++i) {
+    result |= uint64_t{static_cast<unsigned char>(user_key[i])}
+              << (8 * (sizeof(uint64_t) - 1 - i));
+  }
+  return reverse ? ~result : result;
+}
+
+uint64_t DoubleToBits(double d) {
+  uint64_t bits;
+  static_assert(sizeof(bits) == sizeof(d), "double must be 64 bits");
+  memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+double BitsToDouble(uint64_t bits) {
+  double d;
+  memcpy(&d, &bits, sizeof(d));
+  return d;
+}
+
+double Predict(uint64_t first_key, uint32_t first_pos, double slope,
+               uint64_t key) {
+  if (key <= first_key) {
+    return first_pos;
+  }
+  return first_pos + slope * static_cast<double>(key - first_key);
+}
+}  // namespace
+
+LearnedIndexModelBuilder::LearnedIndexModelBuilder(const Comparator* ucmp,
+                                                   uint32_t restart_interval,
+                                                   uint32_t max_error)
+    : supported_(IsSupported(ucmp)),
+      reverse_(ucmp == ReverseBytewiseComparator()),
+      restart_interval_(std::max(restart_interval, uint32_t{1})),
+      max_error_(max_error) {}
+
+bool LearnedIndexModelBuilder::IsSupported(const Comparator* ucmp) {
+  return ucmp != nullptr && ucmp->timestamp_size() == 0 &&
+         (ucmp == BytewiseComparator() || ucmp == ReverseBytewiseComparator());
+}
+
+void LearnedIndexModelBuilder::AddSeparator(const Slice& user_key) {
+  if (supported_) {
+    keys_.push_back(KeyToNumber(user_key, reverse_));
+    assert(keys_.size() < 2 || keys_[keys_.size() - 2] <= keys_.back());
+  }
+}
+
+bool LearnedIndexModelBuilder::Finish(std::string* model_block) {
+  assert(model_block != nullptr);
+  model_block->clear();
+  const size_t n = keys_.size();
+  if (!supported_ || n == 0 || n >= std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  // Greedy "shrinking cone" fit: extend the current segment while some line
+  // through its first point stays within max_error_ of every point.
+  struct Fitted {
+    uint64_t first_key;
+    uint32_t first_pos;
+    double slope;
+  };
+  std::vector<Fitted> segments;
+  size_t i = 0;
+  while (i < n) {
+    const uint64_t x0 = keys_[i];
+    const double y0 = static_cast<double>(i);
+    double lo = 0.0;
+    double hi = std::numeric_limits<double>::infinity();
+    size_t j = i + 1;
+    for (; j < n; ++j) {
+      if (keys_[j] == x0) {
+        // Entries sharing the first key all predict y0; any excess error
+        // is accounted for below.
+        continue;
+      }
+      const double dx = static_cast<double>(keys_[j] - x0);
+      const double y = static_cast<double>(j);
+      const double new_lo = std::max(lo, (y - max_error_ - y0) / dx);
+      const double new_hi = std::min(hi, (y + max_error_ - y0) / dx);
+      if (new_lo > new_hi) {
+        break;
+      }
+      lo = new_lo;
+      hi = new_hi;
+    }
+    const double slope = std::isinf(hi) ? lo : (lo + hi) / 2;
+    segments.push_back({x0, static_cast<uint32_t>(i), slope});
+    i = j;
+  }
+
+  // Measure the real error, which can exceed max_error_ for long runs of
+  // entries sharing the same 8-byte prefix or due to rounding.
+  uint64_t max_error = 0;
+  size_t seg = 0;
+  for (size_t k = 0; k < n; ++k) {
+    while (seg + 1 < segments.size() && segments[seg + 1].first_key <= keys_[k]) {
+      ++seg;
+    }
+    const auto& s = segments[seg];
+    double pred = Predict(s.first_key, s.first_pos, s.slope, keys_[k]);
+    pred = std::min(std::max(pred, 0.0), static_cast<double>(n - 1));
+    const double err = std::fabs(std::round(pred) - static_cast<double>(k));
+    max_error = std::max(max_error, static_cast<uint64_t>(err));
+  }
+
+  // A model is only useful if the predicted window is much smaller than the
+  // whole index block (e.g. keys are not numbers, or share long prefixes).
+  if (2 * max_error + 3 >= n) {
+    return false;
+  }
+  actual_max_error_ = static_cast<uint32_t>(max_error);
+
+  model_block->push_back(static_cast<char>(kLearnedIndexFormat));
+  model_block->push_back(static_cast<char>(reverse_ ? kReverseBytewiseFlag : 0));
+  PutFixed32(model_block, static_cast<uint32_t>(n));
+  PutFixed32(model_block, restart_interval_);
+  PutFixed32(model_block, actual_max_error_);
+  PutFixed32(model_block, static_cast<uint32_t>(segments.size()));
+  for (const auto& s : segments) {
+    PutFixed64(model_block, s.first_key);
+    PutFixed32(model_block, s.first_pos);
+    PutFixed64(model_block, DoubleToBits(s.slope));
+  }
+  return true;
+}
+
+Status LearnedIndexModel::Create(const Slice& contents,
+                                 std::unique_ptr<LearnedIndexModel>* model) {
+  assert(model != nullptr);
+  if (contents.size() < kHeaderSize) {
+    return Status::Corruption("Learned index model block too small");
+  }
+  const char* p = contents.data();
+  if (static_cast<uint8_t>(p[0]) != kLearnedIndexFormat) {
+    return Status::NotSupported("Unknown learned index model format");
+  }
+  const uint8_t flags = static_cast<uint8_t>(p[1]);
+  if ((flags & ~kReverseBytewiseFlag) != 0) {
+    return Status::NotSupported("Unknown learned index model flags");
+  }
+  p += 2;
+  std::unique_ptr<LearnedIndexModel> result(new LearnedIndexModel());
+  result->reverse_ = (flags & kReverseBytewiseFlag) != 0;
+  result->num_entries_ = DecodeFixed32(p);
+  result->restart_interval_ = DecodeFixed32(p + 4);
+  result->max_error_ = DecodeFixed32(p + 8);
+  const uint32_t num_segments = DecodeFixed32(p + 12);
+  p += 16;
+  if (result->num_entries_ == 0 || result->restart_interval_ == 0 ||
+      num_segments == 0 || num_segments > result->num_entries_ ||
+      contents.size() != kHeaderSize + num_segments * kSegmentSize) {
+    return Status::Corruption("Bad learned index model block");
+  }
+  result->segments_.reserve(num_segments);
+  for (uint32_t i = 0; i < num_segments; ++i) {
+    Segment s;
+    s.first_key = DecodeFixed64(p);
+    s.first_pos = DecodeFixed32(p + 8);
+    s.slope = BitsToDouble(DecodeFixed64(p + 12));
+    p += kSegmentSize;
+    if (s.first_pos >= result->num_entries_ || !std::isfinite(s.slope) ||
+        s.slope < 0 ||
+        (i > 0 && (s.first_key <= result->segments_.back().first_key ||
+                   s.first_pos <= result->segments_.back().first_pos))) {
+      return Status::Corruption("Bad learned index model segment");
+    }
+    result->segments_.push_back(s);
+  }
+  *model = std::move(result);
+  return Status::OK();
+}
+
+bool LearnedIndexModel::PredictRestartRange(const Slice& user_key,
+                                            uint32_t num_restarts,
+                                            uint32_t* first_restart,
+                                            uint32_t* last_restart) const {
+  if (num_restarts == 0 ||
+      (num_entries_ - 1) / restart_interval_ + 1 != num_restarts) {
+    return false;
+  }
+  const uint64_t key = KeyToNumber(user_key, reverse_);
+  auto it = std::upper_bound(
+      segments_.begin(), segments_.end(), key,
+      [](uint64_t k, const Segment& s) { return k < s.first_key; });
+  const Segment& s = it == segments_.begin() ? segments_.front() : *(it - 1);
+  double pred = Predict(s.first_key, s.first_pos, s.slope, key);
+  pred = std::min(std::max(std::round(pred), 0.0),
+                  static_cast<double>(num_entries_ - 1));
+  const uint64_t pos = static_cast<uint64_t>(pred);
+  // One extra entry of slack on each side covers targets that fall between
+  // two separators.
+  const uint64_t slack = uint64_t{max_error_} + 1;
+  const uint64_t first = pos > slack ? pos - slack : 0;
+  const uint64_t last = std::min(pos + slack, uint64_t{num_entries_} - 1);
+  *first_restart = static_cast<uint32_t>(first / restart_interval_);
+  *last_restart = static_cast<uint32_t>(last / restart_interval_);
+  assert(*first_restart <= *last_restart && *last_restart < num_restarts);
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,113 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class Comparator;
+
+// A learned index for the index block of a block-based table
+// (BlockBasedTableOptions::kLearnedIndex).
+//
+// The index block itself is an ordinary binary-searchable index block. In
+// addition, the builder maps every index entry's separator key to a number
+// (the first 8 bytes of the user key, read big-endian, which is monotonic
+// under BytewiseComparator) and fits error-bounded piecewise-linear segments
+// from that number to the entry's position in the index block. On Seek, the
+// model predicts the position of the target and the index block iterator
+// only binary searches a window of a few restart points around the
+// prediction, verifying the window bounds and widening to a full search if
+// the prediction was off (e.g. for keys not seen by the builder).
+//
+// Model block format (all integers little-endian fixed width):
+//
+//   [format: 1 byte][flags: 1 byte]
+//   [num_entries: 4 bytes][restart_interval: 4 bytes][max_error: 4 bytes]
+//   [num_segments: 4 bytes]
+//   num_segments x [first_key: 8 bytes][first_pos: 4 bytes][slope: 8 bytes]
+//
+// `slope` holds the bits of an IEEE-754 double. `flags` bit 0 means keys are
+// ordered by ReverseBytewiseComparator() and numbers are complemented.
+class LearnedIndexModelBuilder {
+ public:
+  // `max_error` is the per-segment error bound used while fitting.
+  LearnedIndexModelBuilder(const Comparator* ucmp, uint32_t restart_interval,
+                           uint32_t max_error = kDefaultMaxError);
+
+  // Returns true if the keys ordered by `ucmp` can be modeled as numbers.
+  static bool IsSupported(const Comparator* ucmp);
+
+  // Adds the separator key (internal or user key) of the next index entry.
+  void AddSeparator(const Slice& user_key);
+
+  // Fits the model over all added entries. Returns false (and leaves
+  // `*model_block` empty) if no useful model exists, in which case readers
+  // fall back to binary search.
+  bool Finish(std::string* model_block);
+
+  size_t NumEntries() const { return keys_.size(); }
+  uint32_t MaxError() const { return actual_max_error_; }
+
+  static constexpr uint32_t kDefaultMaxError = 4;
+
+ private:
+  const bool supported_;
+  const bool reverse_;
+  const uint32_t restart_interval_;
+  const uint32_t max_error_;
+  std::vector<uint64_t> keys_;
+  uint32_t actual_max_error_ = 0;
+};
+
+class LearnedIndexModel {
+ public:
+  // Parses a model block. The returned model keeps no reference to
+  // `contents`.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<LearnedIndexModel>* model);
+
+  // Predicts the range of restart points [*first_restart, *last_restart]
+  // (inclusive) of an index block with `num_restarts` restart points that
+  // should contain the last restart key <= a target with user key
+  // `user_key`. Returns false if the model does not match the block, in which
+  // case the caller should binary search the whole block.
+  bool PredictRestartRange(const Slice& user_key, uint32_t num_restarts,
+                           uint32_t* first_restart,
+                           uint32_t* last_restart) const;
+
+  uint32_t NumEntries() const { return num_entries_; }
+  uint32_t MaxError() const { return max_error_; }
+  size_t NumSegments() const { return segments_.size(); }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + segments_.capacity() * sizeof(Segment);
+  }
+
+ private:
+  struct Segment {
+    uint64_t first_key;
+    uint32_t first_pos;
+    double slope;
+  };
+
+  LearnedIndexModel() = default;
+
+  bool reverse_ = false;
+  uint32_t num_entries_ = 0;
+  uint32_t restart_interval_ = 1;
+  uint32_t max_error_ = 0;
+  std::vector<Segment> segments_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,271 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/learned_index.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/dbformat.h"
+#include "port/stack_trace.h"
+#include "rocksdb/comparator.h"
+#include "table/block_based/block.h"
+#include "table/block_based/block_builder.h"
+#include "table/format.h"
+#include "test_util/testharness.h"
+#include "test_util/testutil.h"
+#include "util/random.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::string NumberKey(uint64_t n, const std::string& suffix = "") {
+  std::string key(sizeof(uint64_t), '\0');
+  for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+    key[i] = static_cast<char>(n >> (8 * (sizeof(uint64_t) - 1 - i)));
+  }
+  return key + suffix;
+}
+}  // namespace
+
+// Params: restart interval, whether index keys include sequence numbers,
+// whether index values are delta encoded.
+class LearnedIndexTest
+    : public testing::Test,
+      public testing::WithParamInterface<std::tuple<int, bool, bool>> {
+ public:
+  int RestartInterval() const { return std::get<0>(GetParam()); }
+  bool KeyIncludesSeq() const { return std::get<1>(GetParam()); }
+  bool ValueDeltaEncoded() const { return std::get<2>(GetParam()); }
+
+  // Builds an index block and a model over the given sorted user keys.
+  void Build(const std::vector<std::string>& user_keys) {
+    user_keys_ = user_keys;
+    BlockBuilder builder(RestartInterval(), true /* use_delta_encoding */,
+                         ValueDeltaEncoded(),
+                         BlockBasedTableOptions::kDataBlockBinarySearch,
+                         0 /* ts_sz */, true /* persist_udt */,
+                         !KeyIncludesSeq());
+    LearnedIndexModelBuilder model_builder(BytewiseComparator(),
+                                           RestartInterval());
+    BlockHandle last_handle;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < user_keys_.size(); ++i) {
+      const std::string& user_key = user_keys_[i];
+      InternalKey ikey(user_key, 100, kTypeValue);
+      BlockHandle handle(offset, 4000);
+      offset += 4000 + 5 /* block trailer */;
+      IndexValue entry(handle, Slice());
+      std::string encoded_entry;
+      std::string delta_encoded_entry;
+      entry.EncodeTo(&encoded_entry, false /* have_first_key */, nullptr);
+      if (ValueDeltaEncoded() && i > 0) {
+        entry.EncodeTo(&delta_encoded_entry, false, &last_handle);
+      }
+      last_handle = handle;
+      const Slice delta_encoded_entry_slice(delta_encoded_entry);
+      builder.Add(KeyIncludesSeq() ? ikey.Encode() : Slice(user_key),
+                  encoded_entry, &delta_encoded_entry_slice);
+      model_builder.AddSeparator(user_key);
+    }
+    block_data_ = builder.Finish().ToString();
+    BlockContents contents;
+    contents.data = block_data_;
+    block_.reset(new Block(std::move(contents)));
+
+    model_block_.clear();
+    model_.reset();
+    if (model_builder.Finish(&model_block_)) {
+      ASSERT_OK(LearnedIndexModel::Create(model_block_, &model_));
+      ASSERT_EQ(model_->MaxError(), model_builder.MaxError());
+      ASSERT_EQ(model_->NumEntries(), user_keys_.size());
+    }
+  }
+
+  IndexBlockIter* NewIterator(const LearnedIndexModel* model) {
+    return block_->NewIndexIterator(
+        BytewiseComparator(), kDisableGlobalSequenceNumber, nullptr, nullptr,
+        true /* total_order_seek */, false /* have_first_key */,
+        KeyIncludesSeq(), !ValueDeltaEncoded(),
+        false /* block_contents_pinned */,
+        true /* user_defined_timestamps_persisted */, nullptr /* prefix_index */,
+        model);
+  }
+
+  // Checks that seeking with the model gives the same result as without.
+  void CheckSeek(const std::string& user_key) {
+    std::unique_ptr<IndexBlockIter> plain(NewIterator(nullptr));
+    std::unique_ptr<IndexBlockIter> learned(NewIterator(model_.get()));
+    for (SequenceNumber seq : {kMaxSequenceNumber, SequenceNumber{100},
+                               SequenceNumber{0}}) {
+      InternalKey target(user_key, seq, kValueTypeForSeek);
+      plain->Seek(target.Encode());
+      learned->Seek(target.Encode());
+      ASSERT_OK(plain->status());
+      ASSERT_OK(learned->status());
+      ASSERT_EQ(plain->Valid(), learned->Valid())
+          << Slice(user_key).ToString(true);
+      if (plain->Valid()) {
+        ASSERT_EQ(plain->key(), learned->key())
+            << Slice(user_key).ToString(true);
+        ASSERT_EQ(plain->value().handle.offset(),
+                  learned->value().handle.offset());
+        // Iteration continues from the same position.
+        plain->Next();
+        learned->Next();
+        ASSERT_EQ(plain->Valid(), learned->Valid());
+        if (plain->Valid()) {
+          ASSERT_EQ(plain->key(), learned->key());
+        }
+      }
+    }
+  }
+
+  std::vector<std::string> user_keys_;
+  std::string block_data_;
+  std::unique_ptr<Block> block_;
+  std::string model_block_;
+  std::unique_ptr<LearnedIndexModel> model_;
+};
+
+TEST_P(LearnedIndexTest, UniformKeys) {
+  std::vector<std::string> keys;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    keys.push_back(NumberKey(1000000 + i * 1000));
+  }
+  Build(keys);
+  ASSERT_NE(model_, nullptr);
+  ASSERT_EQ(model_->NumSegments(), 1);
+  ASSERT_LE(model_->MaxError(), 1);
+
+  for (const auto& k : keys) {
+    CheckSeek(k);
+  }
+  CheckSeek("");
+  CheckSeek(NumberKey(0));
+  CheckSeek(NumberKey(1000000 + 500));
+  CheckSeek(NumberKey(1000000 + 999 * 1000 + 1));
+  CheckSeek(NumberKey(std::numeric_limits<uint64_t>::max()));
+}
+
+TEST_P(LearnedIndexTest, SkewedKeys) {
+  Random rnd(301);
+  std::vector<std::string> keys;
+  uint64_t n = 0;
+  for (int i = 0; i < 5000; ++i) {
+    // Mix of dense runs and large jumps, with variable-length suffixes.
+    n += rnd.OneIn(20) ? rnd.Next64() % (uint64_t{1} << 40) : 1 + rnd.Uniform(3);
+    keys.push_back(NumberKey(n, rnd.RandomString(rnd.Uniform(4))));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  Build(keys);
+  ASSERT_NE(model_, nullptr);
+  ASSERT_LT(model_->NumSegments(), keys.size() / 4);
+
+  for (const auto& k : keys) {
+    CheckSeek(k);
+  }
+  for (int i = 0; i < 5000; ++i) {
+    // Targets both inside and outside the modeled key range.
+    CheckSeek(NumberKey(rnd.Next64() % (n + 1000), rnd.RandomString(2)));
+    CheckSeek(rnd.RandomBinaryString(rnd.Uniform(10)));
+  }
+}
+
+TEST_P(LearnedIndexTest, NonNumericKeys) {
+  // Keys sharing a long common prefix cannot be told apart by the model.
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; ++i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "user_key_%06d", i);
+    keys.push_back(buf);
+  }
+  Build(keys);
+  ASSERT_EQ(model_, nullptr);
+  ASSERT_TRUE(model_block_.empty());
+}
+
+INSTANTIATE_TEST_CASE_P(LearnedIndexTest, LearnedIndexTest,
+                        ::testing::Combine(::testing::Values(1, 4, 16),
+                                           ::testing::Bool(),
+                                           ::testing::Bool()));
+
+TEST(LearnedIndexModelTest, Unsupported) {
+  ASSERT_TRUE(LearnedIndexModelBuilder::IsSupported(BytewiseComparator()));
+  ASSERT_TRUE(
+      LearnedIndexModelBuilder::IsSupported(ReverseBytewiseComparator()));
+  ASSERT_FALSE(LearnedIndexModelBuilder::IsSupported(test::Uint64Comparator()));
+  ASSERT_FALSE(
+      LearnedIndexModelBuilder::IsSupported(BytewiseComparatorWithU64Ts()));
+
+  LearnedIndexModelBuilder builder(test::Uint64Comparator(), 1);
+  for (uint64_t i = 0; i < 100; ++i) {
+    builder.AddSeparator(NumberKey(i));
+  }
+  std::string model_block;
+  ASSERT_FALSE(builder.Finish(&model_block));
+  ASSERT_TRUE(model_block.empty());
+}
+
+TEST(LearnedIndexModelTest, ReverseBytewise) {
+  LearnedIndexModelBuilder builder(ReverseBytewiseComparator(), 2);
+  for (uint64_t i = 0; i < 100; ++i) {
+    builder.AddSeparator(NumberKey((100 - i) * 7));
+  }
+  std::string model_block;
+  ASSERT_TRUE(builder.Finish(&model_block));
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_OK(LearnedIndexModel::Create(model_block, &model));
+  for (uint64_t i = 0; i < 100; ++i) {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    ASSERT_TRUE(
+        model->PredictRestartRange(NumberKey((100 - i) * 7), 50, &first, &last));
+    ASSERT_LE(first, i / 2);
+    ASSERT_GE(last, i / 2);
+  }
+}
+
+TEST(LearnedIndexModelTest, BadModelBlock) {
+  LearnedIndexModelBuilder builder(BytewiseComparator(), 1);
+  for (uint64_t i = 0; i < 100; ++i) {
+    builder.AddSeparator(NumberKey(i * i));
+  }
+  std::string model_block;
+  ASSERT_TRUE(builder.Finish(&model_block));
+
+  std::unique_ptr<LearnedIndexModel> model;
+  ASSERT_TRUE(
+      LearnedIndexModel::Create(Slice(model_block.data(), 5), &model)
+          .IsCorruption());
+  ASSERT_TRUE(LearnedIndexModel::Create(
+                  Slice(model_block.data(), model_block.size() - 1), &model)
+                  .IsCorruption());
+  std::string bad_format = model_block;
+  bad_format[0] = 2;
+  ASSERT_TRUE(LearnedIndexModel::Create(bad_format, &model).IsNotSupported());
+  ASSERT_EQ(model, nullptr);
+
+  ASSERT_OK(LearnedIndexModel::Create(model_block, &model));
+  uint32_t first = 0;
+  uint32_t last = 0;
+  // The model does not describe a block with a different number of restarts.
+  ASSERT_FALSE(model->PredictRestartRange(NumberKey(4), 99, &first, &last));
+  ASSERT_TRUE(model->PredictRestartRange(NumberKey(4), 100, &first, &last));
+  ASSERT_LE(first, 2);
+  ASSERT_GE(last, 2);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
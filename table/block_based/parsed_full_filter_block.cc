@@ -12,11 +12,21 @@ namespace ROCKSDB_NAMESPACE {
 
 ParsedFullFilterBlock::ParsedFullFilterBlock(const FilterPolicy* filter_policy,
                                              BlockContents&& contents)
-    : block_contents_(std::move(contents)),
-      filter_bits_reader_(
-          !block_contents_.data.empty()
-              ? filter_policy->GetFilterBitsReader(block_contents_.data)
-              : nullptr) {}
+    : block_contents_(std::move(contents)) {
+  if (block_contents_.data.empty()) {
+    return;
+  }
+  if (filter_policy->IsInstanceOf(BuiltinFilterPolicy::kClassName())) {
+    // Same reader as BuiltinFilterPolicy::GetFilterBitsReader, keeping its
+    // type for the two-step queries
+    builtin_filter_bits_reader_ =
+        BuiltinFilterPolicy::GetBuiltinFilterBitsReader(block_contents_.data);
+    filter_bits_reader_.reset(builtin_filter_bits_reader_);
+  } else {
+    filter_bits_reader_.reset(
+        filter_policy->GetFilterBitsReader(block_contents_.data));
+  }
+}
 
 ParsedFullFilterBlock::~ParsedFullFilterBlock() = default;
 
@@ -12,6 +12,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class BuiltinFilterBitsReader;
 class FilterBitsReader;
 class FilterPolicy;
 
@@ -26,6 +27,12 @@ class ParsedFullFilterBlock {
     return filter_bits_reader_.get();
   }
 
+  // Same as filter_bits_reader() for filters of built-in policies, which
+  // support BuiltinFilterBitsReader::PrepareMayMatch, nullptr otherwise
+  BuiltinFilterBitsReader* builtin_filter_bits_reader() const {
+    return builtin_filter_bits_reader_;
+  }
+
   // TODO: consider memory usage of the FilterBitsReader
   size_t ApproximateMemoryUsage() const {
     return block_contents_.ApproximateMemoryUsage();
@@ -42,6 +49,7 @@ class ParsedFullFilterBlock {
  private:
   BlockContents block_contents_;
   std::unique_ptr<FilterBitsReader> filter_bits_reader_;
+  BuiltinFilterBitsReader* builtin_filter_bits_reader_ = nullptr;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
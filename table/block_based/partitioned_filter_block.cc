@@ -5,6 +5,7 @@
 
 #include "table/block_based/partitioned_filter_block.h"
 
+#include <array>
 #include <utility>
 
 #include "block_cache.h"
@@ -17,6 +18,7 @@
 #include "rocksdb/filter_policy.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/filter_policy_internal.h"
 #include "util/coding.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -343,8 +345,8 @@ void PartitionedFilterBlockReader::KeysMayMatch(
     return;  // Any/all may match
   }
 
-  MayMatch(range, nullptr, lookup_context, read_options,
-           &FullFilterBlockReader::KeysMayMatch2);
+  MayMatch(range, /*prefix_extractor=*/nullptr, lookup_context,
+           read_options);
 }
 
 bool PartitionedFilterBlockReader::PrefixMayMatch(
@@ -360,8 +362,7 @@ void PartitionedFilterBlockReader::PrefixesMayMatch(
     MultiGetRange* range, const SliceTransform* prefix_extractor,
     BlockCacheLookupContext* lookup_context, const ReadOptions& read_options) {
   assert(prefix_extractor);
-  MayMatch(range, prefix_extractor, lookup_context, read_options,
-           &FullFilterBlockReader::PrefixesMayMatch);
+  MayMatch(range, prefix_extractor, lookup_context, read_options);
 }
 
 BlockHandle PartitionedFilterBlockReader::GetFilterPartitionHandle(
@@ -458,8 +459,8 @@ bool PartitionedFilterBlockReader::MayMatch(
 
 void PartitionedFilterBlockReader::MayMatch(
     MultiGetRange* range, const SliceTransform* prefix_extractor,
-    BlockCacheLookupContext* lookup_context, const ReadOptions& read_options,
-    FilterManyFunction filter_function) const {
+    BlockCacheLookupContext* lookup_context,
+    const ReadOptions& read_options) const {
   CachableEntry<Block_kFilterPartitionIndex> filter_block;
   Status s = GetOrReadFilterBlock(range->begin()->get_context, lookup_context,
                                   &filter_block, read_options);
@@ -472,58 +473,116 @@ void PartitionedFilterBlockReader::MayMatch(
     return;  // Any/all may match
   }
 
-  auto start_iter_same_handle = range->begin();
+  // Keys mapping to the same partition are adjacent in sorted order and
+  // share a block cache lookup. All partitions are pinned first, then all
+  // keys are hashed and their filter memory prefetched, and only then are
+  // they tested, so that the cache misses of keys in different partitions
+  // overlap.
+  struct Partition {
+    CachableEntry<ParsedFullFilterBlock> block;
+    // Range of the partition's keys in the arrays below
+    int start;
+    int end;
+  };
+  std::array<Partition, MultiGetContext::MAX_BATCH_SIZE> partitions;
+  int num_partitions = 0;
+  std::array<Slice, MultiGetContext::MAX_BATCH_SIZE> filter_keys;
+  std::array<Slice*, MultiGetContext::MAX_BATCH_SIZE> filter_key_ptrs;
+  std::array<BuiltinFilterBitsReader::PreparedQuery,
+             MultiGetContext::MAX_BATCH_SIZE>
+      queries;
+  std::array<bool, MultiGetContext::MAX_BATCH_SIZE> may_match = {{true}};
+  int num_keys = 0;
+
+  // Keys not in the prefix extractor domain, or in partitions that could
+  // not be read, may match without a query
+  MultiGetRange filter_range(*range, range->begin(), range->end());
   BlockHandle prev_filter_handle = BlockHandle::NullBlockHandle();
-
-  // For all keys mapping to same partition (must be adjacent in sorted order)
-  // share block cache lookup and use full filter multiget on the partition
-  // filter.
-  for (auto iter = start_iter_same_handle; iter != range->end(); ++iter) {
+  bool partition_ok = false;
+  for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
     // TODO: re-use one top-level index iterator
     BlockHandle this_filter_handle =
         GetFilterPartitionHandle(filter_block, iter->ikey);
-    if (!prev_filter_handle.IsNull() &&
-        this_filter_handle != prev_filter_handle) {
-      MultiGetRange subrange(*range, start_iter_same_handle, iter);
-      MayMatchPartition(&subrange, prefix_extractor, prev_filter_handle,
-                        lookup_context, read_options, filter_function);
-      range->AddSkipsFrom(subrange);
-      start_iter_same_handle = iter;
-    }
     if (UNLIKELY(this_filter_handle.size() == 0)) {  // key is out of range
       // Not reachable with current behavior of GetFilterPartitionHandle
       assert(false);
       range->SkipKey(iter);
+      filter_range.SkipKey(iter);
       prev_filter_handle = BlockHandle::NullBlockHandle();
-    } else {
+      continue;
+    }
+    if (prev_filter_handle.IsNull() ||
+        this_filter_handle != prev_filter_handle) {
+      Partition& partition = partitions[num_partitions];
+      s = GetFilterPartitionBlock(nullptr /* prefetch_buffer */,
+                                  this_filter_handle, iter->get_context,
+                                  lookup_context, read_options,
+                                  &partition.block);
+      partition_ok = s.ok() && partition.block.GetValue()->filter_bits_reader();
+      if (UNLIKELY(!s.ok())) {
+        IGNORE_STATUS_IF_ERROR(s);
+      }
+      if (partition_ok) {
+        partition.start = num_keys;
+        partition.end = num_keys;
+        ++num_partitions;
+      } else {
+        partition.block.Reset();
+      }
       prev_filter_handle = this_filter_handle;
     }
+    if (!partition_ok) {
+      filter_range.SkipKey(iter);
+    } else if (!prefix_extractor) {
+      filter_keys[num_keys++] = iter->ukey_without_ts;
+      ++partitions[num_partitions - 1].end;
+    } else if (prefix_extractor->InDomain(iter->ukey_without_ts)) {
+      filter_keys[num_keys++] =
+          prefix_extractor->Transform(iter->ukey_without_ts);
+      ++partitions[num_partitions - 1].end;
+    } else {
+      filter_range.SkipKey(iter);
+    }
   }
-  if (!prev_filter_handle.IsNull()) {
-    MultiGetRange subrange(*range, start_iter_same_handle, range->end());
-    MayMatchPartition(&subrange, prefix_extractor, prev_filter_handle,
-                      lookup_context, read_options, filter_function);
-    range->AddSkipsFrom(subrange);
-  }
-}
 
-void PartitionedFilterBlockReader::MayMatchPartition(
-    MultiGetRange* range, const SliceTransform* prefix_extractor,
-    BlockHandle filter_handle, BlockCacheLookupContext* lookup_context,
-    const ReadOptions& read_options, FilterManyFunction filter_function) const {
-  CachableEntry<ParsedFullFilterBlock> filter_partition_block;
-  Status s = GetFilterPartitionBlock(
-      nullptr /* prefetch_buffer */, filter_handle, range->begin()->get_context,
-      lookup_context, read_options, &filter_partition_block);
-  if (UNLIKELY(!s.ok())) {
-    IGNORE_STATUS_IF_ERROR(s);
-    return;  // Any/all may match
+  for (int p = 0; p < num_partitions; ++p) {
+    BuiltinFilterBitsReader* const reader =
+        partitions[p].block.GetValue()->builtin_filter_bits_reader();
+    if (reader) {
+      for (int i = partitions[p].start; i < partitions[p].end; ++i) {
+        reader->PrepareMayMatch(filter_keys[i], &queries[i]);
+      }
+    }
+  }
+  for (int p = 0; p < num_partitions; ++p) {
+    const ParsedFullFilterBlock* const block = partitions[p].block.GetValue();
+    const int start = partitions[p].start;
+    const int end = partitions[p].end;
+    if (block->builtin_filter_bits_reader()) {
+      for (int i = start; i < end; ++i) {
+        may_match[i] =
+            block->builtin_filter_bits_reader()->MayMatchPrepared(queries[i]);
+      }
+    } else if (start < end) {
+      for (int i = start; i < end; ++i) {
+        filter_key_ptrs[i] = &filter_keys[i];
+      }
+      block->filter_bits_reader()->MayMatch(
+          end - start, &filter_key_ptrs[start], &may_match[start]);
+    }
   }
 
-  FullFilterBlockReader filter_partition(table(),
-                                         std::move(filter_partition_block));
-  (filter_partition.*filter_function)(range, prefix_extractor, lookup_context,
-                                      read_options);
+  int i = 0;
+  for (auto iter = filter_range.begin(); iter != filter_range.end(); ++iter) {
+    if (!may_match[i]) {
+      range->SkipKey(iter);
+      PERF_COUNTER_ADD(bloom_sst_miss_count, 1);
+    } else {
+      PerfContext* perf_ctx = get_perf_context();
+      perf_ctx->bloom_sst_hit_count++;
+    }
+    ++i;
+  }
 }
 
 size_t PartitionedFilterBlockReader::ApproximateMemoryUsage() const {
@@ -178,19 +178,9 @@ class PartitionedFilterBlockReader
                 BlockCacheLookupContext* lookup_context,
                 const ReadOptions& read_options,
                 FilterFunction filter_function) const;
-  using FilterManyFunction = void (FullFilterBlockReader::*)(
-      MultiGetRange* range, const SliceTransform* prefix_extractor,
-      BlockCacheLookupContext* lookup_context, const ReadOptions& read_options);
   void MayMatch(MultiGetRange* range, const SliceTransform* prefix_extractor,
                 BlockCacheLookupContext* lookup_context,
-                const ReadOptions& read_options,
-                FilterManyFunction filter_function) const;
-  void MayMatchPartition(MultiGetRange* range,
-                         const SliceTransform* prefix_extractor,
-                         BlockHandle filter_handle,
-                         BlockCacheLookupContext* lookup_context,
-                         const ReadOptions& read_options,
-                         FilterManyFunction filter_function) const;
+                const ReadOptions& read_options) const;
   Status CacheDependencies(const ReadOptions& ro, bool pin,
                            FilePrefetchBuffer* tail_prefetch_buffer) override;
   void EraseFromCacheBeforeDestruction(
@@ -13,6 +13,7 @@
 #include "table/block_based/block_based_table_reader.h"
 #include "table/block_based/filter_policy_internal.h"
 #include "table/format.h"
+#include "table/multiget_context.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/coding.h"
@@ -244,6 +245,43 @@ class PartitionedFilterBlockTest
             /*lookup_context=*/nullptr, test::kReadOptionsNoIo));
       }
     }
+    // Querying all keys in one batch, which probes the partitions together
+    std::vector<std::string> all_keys(keys_without_ts,
+                                      keys_without_ts + kKeyNum);
+    all_keys.insert(all_keys.end(), missing_keys_without_ts,
+                    missing_keys_without_ts + kMissingKeyNum);
+    std::sort(all_keys.begin(), all_keys.end());
+    std::string min_ts(ts_sz_, '\0');
+    Slice min_ts_slice = min_ts;
+    ReadOptions read_options = test::kReadOptionsNoIo;
+    if (ts_sz_ > 0) {
+      read_options.timestamp = &min_ts_slice;
+    }
+    autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_contexts;
+    autovector<KeyContext*, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+    std::vector<Slice> key_slices(all_keys.begin(), all_keys.end());
+    for (const auto& key : key_slices) {
+      key_contexts.emplace_back(/*col_family=*/nullptr, key, /*val=*/nullptr,
+                                /*cols=*/nullptr, /*ts=*/nullptr,
+                                /*stat=*/nullptr);
+    }
+    for (auto& key_context : key_contexts) {
+      sorted_keys.emplace_back(&key_context);
+    }
+    MultiGetContext ctx(&sorted_keys, 0, sorted_keys.size(), kMaxSequenceNumber,
+                        read_options, /*fs=*/nullptr, /*stats=*/nullptr);
+    MultiGetContext::Range range = ctx.GetMultiGetRange();
+    reader->KeysMayMatch(&range, /*lookup_context=*/nullptr, read_options);
+    std::set<std::string> matched;
+    for (auto iter = range.begin(); iter != range.end(); ++iter) {
+      matched.insert(all_keys[iter.index()]);
+    }
+    for (int i = 0; i < kKeyNum; ++i) {
+      ASSERT_EQ(matched.count(keys_without_ts[i]), 1);
+    }
+    for (int i = 0; i < kMissingKeyNum; ++i) {
+      ASSERT_EQ(matched.count(missing_keys_without_ts[i]), empty ? 1 : 0);
+    }
   }
 
   int TestBlockPerKey() {
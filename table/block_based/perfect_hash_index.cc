@@ -0,0 +1,365 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/perfect_hash_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "util/coding.h"
+#include "util/fastrange.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+constexpr uint8_t kPerfectHashIndexFormat = 1;
+constexpr size_t kHeaderSize = 4 + 5 * sizeof(uint32_t);
+constexpr size_t kFingerprintSize = sizeof(uint16_t);
+constexpr size_t kBlockEntrySize = 2 * sizeof(uint64_t);
+// Average number of keys per bucket.
+constexpr uint32_t kKeysPerBucket = 4;
+// As in PTHash, 60% of the keys go to the first 30% of buckets, so that the
+// large buckets, placed first while the table is nearly empty, take most of
+// the keys.
+constexpr uint32_t kDenseKeysThreshold = 2576980377U;  // 0.6 * 2^32
+// Give up (and build no index) if a bucket cannot be placed with any pilot
+// below this bound. Practically only happens on 64-bit hash collisions, which
+// are detected up front.
+constexpr uint32_t kMaxPilot = uint32_t{1} << 24;
+
+// Finalizer of splitmix64.
+inline uint64_t Remix(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+inline uint64_t PilotMix(uint32_t pilot) {
+  return Remix(uint64_t{pilot} + 0x9e3779b97f4a7c15ULL);
+}
+
+inline uint32_t BucketOf(uint64_t h, uint32_t num_buckets,
+                         uint32_t num_dense_buckets) {
+  const uint32_t lower = static_cast<uint32_t>(h);
+  if (static_cast<uint32_t>(h >> 32) < kDenseKeysThreshold) {
+    return FastRange32(lower, num_dense_buckets);
+  }
+  return num_dense_buckets +
+         FastRange32(lower, num_buckets - num_dense_buckets);
+}
+
+inline uint32_t PositionOf(uint64_t h, uint64_t pilot_mix,
+                           uint32_t table_size) {
+  return static_cast<uint32_t>(FastRange64(Remix(h ^ pilot_mix), table_size));
+}
+
+inline uint16_t FingerprintOf(uint64_t h) {
+  return static_cast<uint16_t>((h * 0x9e3779b97f4a7c15ULL) >> 48);
+}
+
+uint32_t BytesFor(uint64_t max_value) {
+  uint32_t bytes = 1;
+  while (bytes < sizeof(uint32_t) && (max_value >> (8 * bytes)) != 0) {
+    ++bytes;
+  }
+  return bytes;
+}
+
+void PutUnsigned(std::string* dst, uint64_t v, uint32_t bytes) {
+  for (uint32_t i = 0; i < bytes; ++i) {
+    dst->push_back(static_cast<char>(v >> (8 * i)));
+  }
+}
+}  // namespace
+
+PerfectHashIndexBuilder::PerfectHashIndexBuilder(
+    uint32_t block_restart_interval)
+    : block_restart_interval_(std::max(block_restart_interval, uint32_t{1})) {}
+
+void PerfectHashIndexBuilder::AddKey(const Slice& user_key) {
+  const uint32_t restart = keys_in_block_ / block_restart_interval_;
+  ++keys_in_block_;
+  if (has_last_user_key_ && user_key == Slice(last_user_key_)) {
+    // Older version of the same user key. Lookups start from the newest.
+    return;
+  }
+  last_user_key_.assign(user_key.data(), user_key.size());
+  has_last_user_key_ = true;
+  entries_.push_back({GetSliceHash64(user_key),
+                      static_cast<uint32_t>(blocks_.size()), restart});
+  max_restart_ = std::max(max_restart_, restart);
+}
+
+void PerfectHashIndexBuilder::FinishBlock(const BlockHandle& handle) {
+  blocks_.push_back(handle);
+  keys_in_block_ = 0;
+}
+
+bool PerfectHashIndexBuilder::Finish(std::string* contents) {
+  assert(contents != nullptr);
+  contents->clear();
+  const size_t n = entries_.size();
+  if (n == 0 || n > (size_t{1} << 31) || blocks_.empty() ||
+      entries_.back().block >= blocks_.size()) {
+    return false;
+  }
+  const uint32_t num_keys = static_cast<uint32_t>(n);
+  // ~94% load factor keeps the pilot search short.
+  const uint32_t table_size = num_keys + num_keys / 16 + 1;
+  const uint32_t num_buckets =
+      std::max(uint32_t{2}, (num_keys + kKeysPerBucket - 1) / kKeysPerBucket);
+  const uint32_t num_dense_buckets =
+      std::max(uint32_t{1}, static_cast<uint32_t>(uint64_t{num_buckets} * 3 /
+                                                  10));
+
+  // Group keys by bucket (counting sort).
+  std::vector<uint32_t> bucket_begin(num_buckets + 1, 0);
+  std::vector<uint32_t> bucket_of(n);
+  for (size_t i = 0; i < n; ++i) {
+    bucket_of[i] = BucketOf(entries_[i].hash, num_buckets, num_dense_buckets);
+    ++bucket_begin[bucket_of[i] + 1];
+  }
+  for (uint32_t b = 0; b < num_buckets; ++b) {
+    bucket_begin[b + 1] += bucket_begin[b];
+  }
+  std::vector<uint32_t> keys(n);
+  {
+    std::vector<uint32_t> next(bucket_begin.begin(), bucket_begin.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+      keys[next[bucket_of[i]]++] = static_cast<uint32_t>(i);
+    }
+  }
+  bucket_of.clear();
+  bucket_of.shrink_to_fit();
+
+  // Place the largest buckets first.
+  std::vector<uint32_t> bucket_order(num_buckets);
+  for (uint32_t b = 0; b < num_buckets; ++b) {
+    bucket_order[b] = b;
+  }
+  std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                   [&](uint32_t a, uint32_t b) {
+                     return bucket_begin[a + 1] - bucket_begin[a] >
+                            bucket_begin[b + 1] - bucket_begin[b];
+                   });
+
+  std::vector<uint64_t> taken((table_size + 63) / 64, 0);
+  auto is_taken = [&](uint32_t pos) {
+    return (taken[pos / 64] >> (pos % 64)) & 1;
+  };
+  std::vector<uint32_t> pilots(num_buckets, 0);
+  std::vector<uint32_t> position(n);
+  std::vector<uint32_t> candidate;
+  uint32_t max_pilot = 0;
+  for (uint32_t b : bucket_order) {
+    const uint32_t begin = bucket_begin[b];
+    const uint32_t end = bucket_begin[b + 1];
+    if (begin == end) {
+      break;
+    }
+    // Keys with equal hashes can never be separated.
+    for (uint32_t i = begin; i < end; ++i) {
+      for (uint32_t j = begin; j < i; ++j) {
+        if (entries_[keys[i]].hash == entries_[keys[j]].hash) {
+          return false;
+        }
+      }
+    }
+    uint32_t pilot = 0;
+    for (; pilot < kMaxPilot; ++pilot) {
+      const uint64_t pilot_mix = PilotMix(pilot);
+      candidate.clear();
+      bool ok = true;
+      for (uint32_t i = begin; ok && i < end; ++i) {
+        uint32_t pos = PositionOf(entries_[keys[i]].hash, pilot_mix, table_size);
+        ok = !is_taken(pos) &&
+             std::find(candidate.begin(), candidate.end(), pos) ==
+                 candidate.end();
+        candidate.push_back(pos);
+      }
+      if (ok) {
+        break;
+      }
+    }
+    if (pilot == kMaxPilot) {
+      return false;
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+      const uint32_t pos = candidate[i - begin];
+      taken[pos / 64] |= uint64_t{1} << (pos % 64);
+      position[keys[i]] = pos;
+    }
+    pilots[b] = pilot;
+    max_pilot = std::max(max_pilot, pilot);
+  }
+
+  // Make the function minimal: positions past `num_keys` are remapped to the
+  // free slots below `num_keys`, of which there are exactly as many.
+  std::vector<uint32_t> remap(table_size - num_keys, 0);
+  {
+    uint32_t free_slot = 0;
+    for (uint32_t pos = num_keys; pos < table_size; ++pos) {
+      if (!is_taken(pos)) {
+        continue;
+      }
+      while (is_taken(free_slot)) {
+        ++free_slot;
+      }
+      assert(free_slot < num_keys);
+      remap[pos - num_keys] = free_slot++;
+    }
+  }
+
+  const uint32_t pilot_bytes = BytesFor(max_pilot);
+  const uint32_t block_bytes = BytesFor(blocks_.size() - 1);
+  const uint32_t restart_bytes = BytesFor(max_restart_);
+  const uint32_t slot_bytes =
+      static_cast<uint32_t>(kFingerprintSize) + block_bytes + restart_bytes;
+
+  std::string slots(size_t{num_keys} * slot_bytes, '\0');
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t pos = position[i];
+    if (pos >= num_keys) {
+      pos = remap[pos - num_keys];
+    }
+    std::string slot;
+    PutFixed16(&slot, FingerprintOf(entries_[i].hash));
+    PutUnsigned(&slot, entries_[i].block, block_bytes);
+    PutUnsigned(&slot, entries_[i].restart, restart_bytes);
+    assert(slot.size() == slot_bytes);
+    slots.replace(size_t{pos} * slot_bytes, slot_bytes, slot);
+  }
+
+  contents->reserve(kHeaderSize + size_t{num_buckets} * pilot_bytes +
+                    remap.size() * sizeof(uint32_t) + slots.size() +
+                    blocks_.size() * kBlockEntrySize);
+  contents->push_back(static_cast<char>(kPerfectHashIndexFormat));
+  contents->push_back(static_cast<char>(pilot_bytes));
+  contents->push_back(static_cast<char>(block_bytes));
+  contents->push_back(static_cast<char>(restart_bytes));
+  PutFixed32(contents, num_keys);
+  PutFixed32(contents, table_size);
+  PutFixed32(contents, num_buckets);
+  PutFixed32(contents, num_dense_buckets);
+  PutFixed32(contents, static_cast<uint32_t>(blocks_.size()));
+  for (uint32_t pilot : pilots) {
+    PutUnsigned(contents, pilot, pilot_bytes);
+  }
+  for (uint32_t slot : remap) {
+    PutFixed32(contents, slot);
+  }
+  contents->append(slots);
+  for (const auto& handle : blocks_) {
+    PutFixed64(contents, handle.offset());
+    PutFixed64(contents, handle.size());
+  }
+  return true;
+}
+
+Status PerfectHashIndex::Create(const Slice& contents,
+                                std::unique_ptr<PerfectHashIndex>* index) {
+  assert(index != nullptr);
+  if (contents.size() < kHeaderSize) {
+    return Status::Corruption("Perfect hash index block too small");
+  }
+  if (static_cast<uint8_t>(contents[0]) != kPerfectHashIndexFormat) {
+    return Status::NotSupported("Unknown perfect hash index format");
+  }
+  std::unique_ptr<PerfectHashIndex> result(new PerfectHashIndex());
+  result->data_.assign(contents.data(), contents.size());
+  const char* p = result->data_.data();
+  result->pilot_bytes_ = static_cast<uint8_t>(p[1]);
+  result->block_bytes_ = static_cast<uint8_t>(p[2]);
+  result->restart_bytes_ = static_cast<uint8_t>(p[3]);
+  result->num_keys_ = DecodeFixed32(p + 4);
+  result->table_size_ = DecodeFixed32(p + 8);
+  result->num_buckets_ = DecodeFixed32(p + 12);
+  result->num_dense_buckets_ = DecodeFixed32(p + 16);
+  result->num_blocks_ = DecodeFixed32(p + 20);
+  for (uint32_t bytes : {result->pilot_bytes_, result->block_bytes_,
+                         result->restart_bytes_}) {
+    if (bytes == 0 || bytes > sizeof(uint32_t)) {
+      return Status::Corruption("Bad perfect hash index field width");
+    }
+  }
+  result->slot_bytes_ = static_cast<uint32_t>(kFingerprintSize) +
+                        result->block_bytes_ + result->restart_bytes_;
+  const uint64_t expected_size =
+      kHeaderSize + uint64_t{result->num_buckets_} * result->pilot_bytes_ +
+      (uint64_t{result->table_size_} - result->num_keys_) * sizeof(uint32_t) +
+      uint64_t{result->num_keys_} * result->slot_bytes_ +
+      uint64_t{result->num_blocks_} * kBlockEntrySize;
+  if (result->num_keys_ == 0 || result->table_size_ < result->num_keys_ ||
+      result->num_buckets_ < 2 || result->num_dense_buckets_ == 0 ||
+      result->num_dense_buckets_ >= result->num_buckets_ ||
+      result->num_blocks_ == 0 || expected_size != contents.size()) {
+    return Status::Corruption("Bad perfect hash index block");
+  }
+  result->pilots_ = p + kHeaderSize;
+  result->remap_ =
+      result->pilots_ + size_t{result->num_buckets_} * result->pilot_bytes_;
+  result->slots_ =
+      result->remap_ +
+      size_t{result->table_size_ - result->num_keys_} * sizeof(uint32_t);
+  result->blocks_ =
+      result->slots_ + size_t{result->num_keys_} * result->slot_bytes_;
+
+  // Validate everything Lookup() dereferences, so that it never has to.
+  for (uint32_t i = 0; i < result->table_size_ - result->num_keys_; ++i) {
+    if (DecodeFixed32(result->remap_ + i * sizeof(uint32_t)) >=
+        result->num_keys_) {
+      return Status::Corruption("Bad perfect hash index remap entry");
+    }
+  }
+  for (uint32_t i = 0; i < result->num_keys_; ++i) {
+    const char* slot = result->slots_ + size_t{i} * result->slot_bytes_;
+    if (result->ReadUnsigned(slot + kFingerprintSize, result->block_bytes_) >=
+        result->num_blocks_) {
+      return Status::Corruption("Bad perfect hash index slot");
+    }
+  }
+  *index = std::move(result);
+  return Status::OK();
+}
+
+uint64_t PerfectHashIndex::ReadUnsigned(const char* p, uint32_t bytes) const {
+  uint64_t v = 0;
+  for (uint32_t i = 0; i < bytes; ++i) {
+    v |= uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+  }
+  return v;
+}
+
+bool PerfectHashIndex::Lookup(const Slice& user_key, BlockHandle* handle,
+                              uint32_t* restart_index) const {
+  assert(handle != nullptr);
+  assert(restart_index != nullptr);
+  const uint64_t h = GetSliceHash64(user_key);
+  const uint32_t bucket = BucketOf(h, num_buckets_, num_dense_buckets_);
+  const uint32_t pilot = static_cast<uint32_t>(
+      ReadUnsigned(pilots_ + size_t{bucket} * pilot_bytes_, pilot_bytes_));
+  uint32_t pos = PositionOf(h, PilotMix(pilot), table_size_);
+  if (pos >= num_keys_) {
+    pos = DecodeFixed32(remap_ + size_t{pos - num_keys_} * sizeof(uint32_t));
+  }
+  const char* slot = slots_ + size_t{pos} * slot_bytes_;
+  if (DecodeFixed16(slot) != FingerprintOf(h)) {
+    return false;
+  }
+  const uint64_t block = ReadUnsigned(slot + kFingerprintSize, block_bytes_);
+  *restart_index = static_cast<uint32_t>(ReadUnsigned(
+      slot + kFingerprintSize + block_bytes_, restart_bytes_));
+  const char* block_entry = blocks_ + block * kBlockEntrySize;
+  *handle = BlockHandle(DecodeFixed64(block_entry),
+                        DecodeFixed64(block_entry + sizeof(uint64_t)));
+  return true;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,120 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "table/format.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A per-file point lookup index (BlockBasedTableOptions::perfect_hash_index).
+//
+// A minimal perfect hash function (PTHash style: keys are hashed into
+// buckets, and buckets are placed largest first by searching a per-bucket
+// "pilot" value that sends all of the bucket's keys to free slots) maps every
+// distinct user key of the file to a slot. The slot holds a 16-bit
+// fingerprint of the key and the data block and restart interval that hold
+// the key's first (newest) entry, so a point lookup needs neither the index
+// block nor a binary search within the data block. Keys not in the file map
+// to an arbitrary slot and are rejected by the fingerprint with probability
+// 1 - 2^-16; the remaining false positives are rejected by the data block
+// scan, which finds a different user key.
+//
+// Building only keeps a 64-bit hash and the position of each distinct user
+// key, so it streams with the table builder.
+//
+// Block format (integers are little-endian fixed width):
+//
+//   [format: 1][pilot_bytes: 1][block_bytes: 1][restart_bytes: 1]
+//   [num_keys: 4][table_size: 4][num_buckets: 4][num_dense_buckets: 4]
+//   [num_blocks: 4]
+//   pilots:  num_buckets x pilot_bytes
+//   remap:   (table_size - num_keys) x 4, the slot used by positions
+//            >= num_keys
+//   slots:   num_keys x [fingerprint: 2][block: block_bytes]
+//                       [restart: restart_bytes]
+//   blocks:  num_blocks x [offset: 8][size: 8]
+class PerfectHashIndexBuilder {
+ public:
+  // `block_restart_interval` must be the restart interval of data blocks.
+  explicit PerfectHashIndexBuilder(uint32_t block_restart_interval);
+
+  // Adds the next key of the current data block. Only the first entry of
+  // each user key is indexed.
+  void AddKey(const Slice& user_key);
+
+  // Finishes the current data block, which was written at `handle`.
+  void FinishBlock(const BlockHandle& handle);
+
+  // Builds the index over all added keys. Returns false if no index could be
+  // built (e.g. empty file or 64-bit hash collision), in which case readers
+  // use the regular index.
+  bool Finish(std::string* contents);
+
+  size_t NumKeys() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    uint32_t block;
+    uint32_t restart;
+  };
+
+  const uint32_t block_restart_interval_;
+  std::vector<Entry> entries_;
+  std::vector<BlockHandle> blocks_;
+  std::string last_user_key_;
+  bool has_last_user_key_ = false;
+  uint32_t keys_in_block_ = 0;
+  uint32_t max_restart_ = 0;
+};
+
+class PerfectHashIndex {
+ public:
+  // Parses an index block, taking ownership of a copy of `contents`.
+  static Status Create(const Slice& contents,
+                       std::unique_ptr<PerfectHashIndex>* index);
+
+  // Returns false if `user_key` is definitely not in the file. Otherwise sets
+  // the data block and the restart interval at which to start scanning for
+  // `user_key`.
+  bool Lookup(const Slice& user_key, BlockHandle* handle,
+              uint32_t* restart_index) const;
+
+  uint32_t NumKeys() const { return num_keys_; }
+
+  size_t ApproximateMemoryUsage() const {
+    return sizeof(*this) + data_.capacity();
+  }
+
+ private:
+  PerfectHashIndex() = default;
+
+  uint64_t ReadUnsigned(const char* p, uint32_t bytes) const;
+
+  std::string data_;
+  uint32_t pilot_bytes_ = 0;
+  uint32_t block_bytes_ = 0;
+  uint32_t restart_bytes_ = 0;
+  uint32_t slot_bytes_ = 0;
+  uint32_t num_keys_ = 0;
+  uint32_t table_size_ = 0;
+  uint32_t num_buckets_ = 0;
+  uint32_t num_dense_buckets_ = 0;
+  uint32_t num_blocks_ = 0;
+  const char* pilots_ = nullptr;
+  const char* remap_ = nullptr;
+  const char* slots_ = nullptr;
+  const char* blocks_ = nullptr;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
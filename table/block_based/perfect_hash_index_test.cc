@@ -0,0 +1,223 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/perfect_hash_index.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+#include "rocksdb/table.h"
+#include "test_util/testharness.h"
+#include "util/random.h"
+#include "utilities/merge_operators.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+std::string Key(int i) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "key%08d", i);
+  return buf;
+}
+
+struct Position {
+  BlockHandle handle;
+  uint32_t restart;
+};
+
+// Feeds `num_keys` keys in blocks of `keys_per_block` entries, repeating
+// every third key `versions` times, and returns where each user key starts.
+std::map<std::string, Position> AddKeys(PerfectHashIndexBuilder* builder,
+                                        int num_keys, uint32_t keys_per_block,
+                                        uint32_t restart_interval,
+                                        int versions) {
+  std::map<std::string, Position> expected;
+  uint64_t offset = 0;
+  uint32_t in_block = 0;
+  auto finish_block = [&]() {
+    BlockHandle handle(offset, 1000);
+    builder->FinishBlock(handle);
+    for (auto& e : expected) {
+      if (e.second.handle.offset() == ~uint64_t{0}) {
+        e.second.handle = handle;
+      }
+    }
+    offset += 1005;
+    in_block = 0;
+  };
+  for (int i = 0; i < num_keys; ++i) {
+    std::string key = Key(i);
+    int n = (i % 3 == 0) ? versions : 1;
+    for (int v = 0; v < n; ++v) {
+      if (v == 0) {
+        expected[key] = Position{BlockHandle(), in_block / restart_interval};
+      }
+      builder->AddKey(key);
+      if (++in_block == keys_per_block) {
+        finish_block();
+      }
+    }
+  }
+  if (in_block > 0) {
+    finish_block();
+  }
+  return expected;
+}
+}  // namespace
+
+// Params: number of keys, restart interval
+class PerfectHashIndexTest
+    : public testing::Test,
+      public testing::WithParamInterface<std::tuple<int, uint32_t>> {};
+
+TEST_P(PerfectHashIndexTest, LookupAllKeys) {
+  const int num_keys = std::get<0>(GetParam());
+  const uint32_t restart_interval = std::get<1>(GetParam());
+  PerfectHashIndexBuilder builder(restart_interval);
+  auto expected = AddKeys(&builder, num_keys, 37, restart_interval, 5);
+  ASSERT_EQ(builder.NumKeys(), static_cast<size_t>(num_keys));
+
+  std::string contents;
+  ASSERT_TRUE(builder.Finish(&contents));
+  std::unique_ptr<PerfectHashIndex> index;
+  ASSERT_OK(PerfectHashIndex::Create(contents, &index));
+  ASSERT_EQ(index->NumKeys(), static_cast<uint32_t>(num_keys));
+
+  for (const auto& e : expected) {
+    BlockHandle handle;
+    uint32_t restart = 0;
+    ASSERT_TRUE(index->Lookup(e.first, &handle, &restart)) << e.first;
+    ASSERT_EQ(handle.offset(), e.second.handle.offset()) << e.first;
+    ASSERT_EQ(handle.size(), e.second.handle.size());
+    ASSERT_EQ(restart, e.second.restart) << e.first;
+  }
+
+  // Absent keys are almost always rejected by the fingerprint.
+  int false_positives = 0;
+  for (int i = 0; i < 100000; ++i) {
+    BlockHandle handle;
+    uint32_t restart = 0;
+    if (index->Lookup(Key(num_keys + i), &handle, &restart)) {
+      ++false_positives;
+    }
+  }
+  ASSERT_LE(false_positives, 20);
+}
+
+INSTANTIATE_TEST_CASE_P(PerfectHashIndexTest, PerfectHashIndexTest,
+                        ::testing::Combine(::testing::Values(1, 2, 100, 10000),
+                                           ::testing::Values(1u, 16u)));
+
+TEST(PerfectHashIndexBuilderTest, Empty) {
+  PerfectHashIndexBuilder builder(16);
+  std::string contents;
+  ASSERT_FALSE(builder.Finish(&contents));
+}
+
+TEST(PerfectHashIndexBuilderTest, BadBlock) {
+  PerfectHashIndexBuilder builder(16);
+  AddKeys(&builder, 1000, 50, 16, 1);
+  std::string contents;
+  ASSERT_TRUE(builder.Finish(&contents));
+
+  std::unique_ptr<PerfectHashIndex> index;
+  ASSERT_TRUE(PerfectHashIndex::Create(Slice(contents.data(), 10), &index)
+                  .IsCorruption());
+  ASSERT_TRUE(PerfectHashIndex::Create(
+                  Slice(contents.data(), contents.size() - 1), &index)
+                  .IsCorruption());
+  std::string bad_format = contents;
+  bad_format[0] = 99;
+  ASSERT_TRUE(PerfectHashIndex::Create(bad_format, &index).IsNotSupported());
+  ASSERT_EQ(index, nullptr);
+  ASSERT_OK(PerfectHashIndex::Create(contents, &index));
+}
+
+class DBPerfectHashIndexTest : public DBTestBase {
+ public:
+  DBPerfectHashIndexTest()
+      : DBTestBase("db_perfect_hash_index_test", /*env_do_fsync=*/false) {}
+};
+
+TEST_F(DBPerfectHashIndexTest, GetMatchesRegularIndex) {
+  Options options = CurrentOptions();
+  options.merge_operator = MergeOperators::CreateStringAppendOperator();
+  options.disable_auto_compactions = true;
+  BlockBasedTableOptions table_options;
+  table_options.perfect_hash_index = true;
+  table_options.block_size = 256;
+  table_options.block_restart_interval = 4;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Merge operands and snapshots keep several entries per user key, so some
+  // keys span data blocks.
+  Random rnd(301);
+  std::vector<const Snapshot*> snapshots;
+  std::map<std::string, std::string> expected;
+  for (int round = 0; round < 4; ++round) {
+    for (int i = 0; i < 500; i += 1 + round) {
+      std::string value = rnd.RandomString(20);
+      if (i % 5 == 0) {
+        ASSERT_OK(db_->Merge(WriteOptions(), Key(i), value));
+        expected[Key(i)] = expected.count(Key(i))
+                               ? expected[Key(i)] + "," + value
+                               : value;
+      } else if (i % 7 == 0 && round > 0) {
+        ASSERT_OK(Delete(Key(i)));
+        expected.erase(Key(i));
+      } else {
+        ASSERT_OK(Put(Key(i), value));
+        expected[Key(i)] = value;
+      }
+    }
+    snapshots.push_back(db_->GetSnapshot());
+  }
+  ASSERT_OK(Flush());
+
+  for (int i = 0; i < 600; ++i) {
+    std::string value;
+    Status s = db_->Get(ReadOptions(), Key(i), &value);
+    auto it = expected.find(Key(i));
+    if (it == expected.end()) {
+      ASSERT_TRUE(s.IsNotFound()) << Key(i);
+    } else {
+      ASSERT_OK(s);
+      ASSERT_EQ(value, it->second) << Key(i);
+    }
+  }
+  // Reads at an old snapshot must skip newer entries of the same key.
+  for (int i = 0; i < 500; ++i) {
+    ReadOptions ro;
+    ro.snapshot = snapshots[0];
+    std::string value;
+    Status s = db_->Get(ro, Key(i), &value);
+    ASSERT_TRUE(s.ok() || s.IsNotFound());
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    iter->Seek(Key(i));
+    if (s.ok()) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(iter->key(), Key(i));
+      ASSERT_EQ(iter->value(), value);
+    } else {
+      ASSERT_TRUE(!iter->Valid() || iter->key() != Key(i));
+    }
+  }
+  for (auto* snapshot : snapshots) {
+    db_->ReleaseSnapshot(snapshot);
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -90,6 +90,11 @@ void PropertyBlockBuilder::AddTableProperty(const TableProperties& props) {
     Add(TablePropertiesNames::kIndexPartitions, props.index_partitions);
     Add(TablePropertiesNames::kTopLevelIndexSize, props.top_level_index_size);
   }
+  if (props.learned_index_size != 0) {
+    Add(TablePropertiesNames::kLearnedIndexSize, props.learned_index_size);
+    Add(TablePropertiesNames::kLearnedIndexMaxError,
+        props.learned_index_max_error);
+  }
   Add(TablePropertiesNames::kIndexKeyIsUserKey, props.index_key_is_user_key);
   Add(TablePropertiesNames::kIndexValueIsDeltaEncoded,
       props.index_value_is_delta_encoded);
@@ -108,6 +113,10 @@ void PropertyBlockBuilder::AddTableProperty(const TableProperties& props) {
   if (props.file_creation_time > 0) {
     Add(TablePropertiesNames::kFileCreationTime, props.file_creation_time);
   }
+  if (props.oldest_tombstone_time > 0) {
+    Add(TablePropertiesNames::kOldestTombstoneTime,
+        props.oldest_tombstone_time);
+  }
   if (props.slow_compression_estimated_data_size > 0) {
     Add(TablePropertiesNames::kSlowCompressionEstimatedDataSize,
         props.slow_compression_estimated_data_size);
@@ -297,6 +306,10 @@ Status ReadTablePropertiesHelper(
        &new_table_properties->index_partitions},
       {TablePropertiesNames::kTopLevelIndexSize,
        &new_table_properties->top_level_index_size},
+      {TablePropertiesNames::kLearnedIndexSize,
+       &new_table_properties->learned_index_size},
+      {TablePropertiesNames::kLearnedIndexMaxError,
+       &new_table_properties->learned_index_max_error},
       {TablePropertiesNames::kIndexKeyIsUserKey,
        &new_table_properties->index_key_is_user_key},
       {TablePropertiesNames::kIndexValueIsDeltaEncoded,
@@ -328,6 +341,8 @@ Status ReadTablePropertiesHelper(
        &new_table_properties->oldest_key_time},
       {TablePropertiesNames::kFileCreationTime,
        &new_table_properties->file_creation_time},
+      {TablePropertiesNames::kOldestTombstoneTime,
+       &new_table_properties->oldest_tombstone_time},
       {TablePropertiesNames::kSlowCompressionEstimatedDataSize,
        &new_table_properties->slow_compression_estimated_data_size},
       {TablePropertiesNames::kFastCompressionEstimatedDataSize,
@@ -34,6 +34,13 @@ struct KeyContext {
   Status* s;
   MergeContext merge_context;
   SequenceNumber max_covering_tombstone_seq;
+  // Newest range tombstone covering the key according to the Version's range
+  // tombstone index, and the level and file of the tombstone, from which the
+  // lookup applies it to `max_covering_tombstone_seq`. Zero if the index is
+  // not used.
+  SequenceNumber indexed_tombstone_seq;
+  int indexed_tombstone_level;
+  uint64_t indexed_tombstone_file_number;
   bool key_exists;
   bool is_blob_index;
   void* cb_arg;
@@ -50,6 +57,9 @@ struct KeyContext {
         column_family(col_family),
         s(stat),
         max_covering_tombstone_seq(0),
+        indexed_tombstone_seq(0),
+        indexed_tombstone_level(0),
+        indexed_tombstone_file_number(0),
         key_exists(false),
         is_blob_index(false),
         cb_arg(nullptr),
@@ -11,6 +11,7 @@
 
 #include <stdint.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -154,6 +155,8 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   // BEGIN for FilterBuildingContext
   const bool is_bottommost;
   const TableFileCreationReason reason;
+  // Bytes in each level of the current version, if known
+  std::vector<uint64_t> level_bytes;
   // END for FilterBuildingContext
 
   // XXX: only used by BlockBasedTableBuilder for SstFileWriter. If you
@@ -163,6 +166,21 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   const uint64_t cur_file_num;
 };
 
+// A data block of a table as stored, with its uncompressed contents, for
+// writing it unchanged into another table. See
+// TableReader::ReadRawDataBlock() and TableBuilder::OfferRawDataBlock().
+struct RawDataBlock {
+  // First and last internal keys in the block
+  std::string first_key;
+  std::string last_key;
+  // As stored, without the block trailer
+  std::string raw;
+  CompressionType compression_type = kNoCompression;
+  // Of `raw`, see GetCompressFormatForVersion()
+  uint32_t compress_format_version = 2;
+  std::string uncompressed;
+};
+
 // TableBuilder provides the interface used to build a Table
 // (an immutable and sorted map from keys to values).
 //
@@ -199,6 +217,18 @@ class TableBuilder {
   // Number of calls to Add() so far.
   virtual uint64_t NumEntries() const = 0;
 
+  // Offers a data block of another table for the next keys added. If they
+  // fill a data block with exactly the uncompressed contents of `block`, it
+  // is written as stored in the other table instead of being compressed
+  // again. An offer replaces the previous one. Returns false if this builder
+  // cannot use the offer.
+  virtual bool OfferRawDataBlock(std::unique_ptr<RawDataBlock>&& /*block*/) {
+    return false;
+  }
+
+  // Number of data blocks written from offers so far
+  virtual uint64_t NumRawDataBlocksCopied() const { return 0; }
+
   // Whether the output file is completely empty. It has neither entries
   // or tombstones.
   virtual bool IsEmpty() const {
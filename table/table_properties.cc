@@ -77,6 +77,12 @@ std::string TableProperties::ToString(const std::string& prop_delim,
     AppendProperty(result, "top-level index size", top_level_index_size,
                    prop_delim, kv_delim);
   }
+  if (learned_index_size != 0) {
+    AppendProperty(result, "learned index size", learned_index_size,
+                   prop_delim, kv_delim);
+    AppendProperty(result, "learned index max error", learned_index_max_error,
+                   prop_delim, kv_delim);
+  }
   AppendProperty(result, "filter block size", filter_size, prop_delim,
                  kv_delim);
   AppendProperty(result, "# entries for filter", num_filter_entries, prop_delim,
@@ -142,6 +148,9 @@ std::string TableProperties::ToString(const std::string& prop_delim,
   AppendProperty(result, "file creation time", file_creation_time, prop_delim,
                  kv_delim);
 
+  AppendProperty(result, "oldest tombstone time", oldest_tombstone_time,
+                 prop_delim, kv_delim);
+
   AppendProperty(result, "slow compression estimated data size",
                  slow_compression_estimated_data_size, prop_delim, kv_delim);
   AppendProperty(result, "fast compression estimated data size",
@@ -259,6 +268,10 @@ const std::string TablePropertiesNames::kIndexPartitions =
     "rocksdb.index.partitions";
 const std::string TablePropertiesNames::kTopLevelIndexSize =
     "rocksdb.top-level.index.size";
+const std::string TablePropertiesNames::kLearnedIndexSize =
+    "rocksdb.learned.index.size";
+const std::string TablePropertiesNames::kLearnedIndexMaxError =
+    "rocksdb.learned.index.max.error";
 const std::string TablePropertiesNames::kIndexKeyIsUserKey =
     "rocksdb.index.key.is.user.key";
 const std::string TablePropertiesNames::kIndexValueIsDeltaEncoded =
@@ -301,6 +314,8 @@ const std::string TablePropertiesNames::kOldestKeyTime =
     "rocksdb.oldest.key.time";
 const std::string TablePropertiesNames::kFileCreationTime =
     "rocksdb.file.creation.time";
+const std::string TablePropertiesNames::kOldestTombstoneTime =
+    "rocksdb.oldest.tombstone.time";
 const std::string TablePropertiesNames::kSlowCompressionEstimatedDataSize =
     "rocksdb.sample_for_compression.slow.data.size";
 const std::string TablePropertiesNames::kFastCompressionEstimatedDataSize =
@@ -8,6 +8,7 @@
 // found in the LICENSE file. See the AUTHORS file for names of contributors.
 
 #pragma once
+#include <functional>
 #include <memory>
 
 #include "db/range_tombstone_fragmenter.h"
@@ -31,6 +32,7 @@ struct ReadOptions;
 struct TableProperties;
 class GetContext;
 class MultiGetContext;
+struct RawDataBlock;
 
 // A Table (also referred to as SST) is a sorted map from strings to strings.
 // Tables are immutable and persistent.  A Table may be safely accessed from
@@ -178,6 +180,30 @@ class TableReader {
     return Status::OK();
   }
 
+  // Loads the data blocks at `block_offsets`, which must be sorted, into the
+  // block cache. The offsets are those recovered from block cache keys (see
+  // BlockBasedTable::GetBlockOffset()), and ones of no data block are
+  // ignored.
+  // `before_read` is called with the size of each block that is not already
+  // cached before reading it, and loading stops with Status::Incomplete() if
+  // it returns false.
+  virtual Status WarmUpBlockCache(
+      const ReadOptions& /*read_options*/,
+      const std::vector<uint64_t>& /*block_offsets*/,
+      const std::function<bool(uint64_t)>& /*before_read*/) {
+    return Status::NotSupported("WarmUpBlockCache() not supported.");
+  }
+
+  // Reads, as stored, the first data block that may hold keys >= the
+  // internal key `key`, for copying it unchanged into another table.
+  // NotFound if there is no such block, and NotSupported if the table's
+  // blocks cannot be used outside of it.
+  virtual Status ReadRawDataBlock(const ReadOptions& /*read_options*/,
+                                  const Slice& /*key*/,
+                                  RawDataBlock* /*block*/) {
+    return Status::NotSupported("ReadRawDataBlock() not supported.");
+  }
+
   // convert db file to a human readable form
   virtual Status DumpTable(WritableFile* /*out_file*/) {
     return Status::NotSupported("DumpTable() not supported");
@@ -30,6 +30,7 @@
 #include <atomic>
 #include <cinttypes>
 #include <condition_variable>
+#include <csignal>
 #include <cstddef>
 #include <iostream>
 #include <memory>
@@ -63,6 +64,7 @@
 #include "rocksdb/stats_history.h"
 #include "rocksdb/table.h"
 #include "rocksdb/utilities/backup_engine.h"
+#include "rocksdb/utilities/local_compaction_service.h"
 #include "rocksdb/utilities/object_registry.h"
 #include "rocksdb/utilities/optimistic_transaction_db.h"
 #include "rocksdb/utilities/options_type.h"
@@ -553,6 +555,10 @@ DEFINE_bool(universal_allow_trivial_move, false,
 DEFINE_bool(universal_incremental, false,
             "Enable incremental compactions in universal compaction.");
 
+DEFINE_uint32(universal_lazy_leveling_tiering_factor, 0,
+              "If at least 2, the number of sorted runs per tier of lazy "
+              "leveling in universal compaction.");
+
 DEFINE_int32(
     universal_stop_style,
     (int32_t)ROCKSDB_NAMESPACE::CompactionOptionsUniversal().stop_style,
@@ -576,6 +582,10 @@ DEFINE_double(cache_low_pri_pool_ratio, 0.0,
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(cache_frequency_admission, false,
+            "Enable frequency-based (TinyLFU) admission in the block cache. "
+            "See ShardedCacheOptions::frequency_admission.");
+
 DEFINE_bool(use_compressed_secondary_cache, false,
             "Use the CompressedSecondaryCache as the secondary cache.");
 
@@ -653,6 +663,13 @@ DEFINE_bool(partition_index, false, "Partition index blocks");
 
 DEFINE_bool(index_with_first_key, false, "Include first key in the index");
 
+DEFINE_bool(perfect_hash_index, false,
+            "Store a minimal perfect hash point lookup index in each SST");
+
+DEFINE_bool(use_learned_index, false,
+            "Use kLearnedIndex, a piecewise-linear model over the index "
+            "block, instead of kBinarySearch");
+
 DEFINE_bool(
     optimize_filters_for_memory,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().optimize_filters_for_memory,
@@ -748,6 +765,16 @@ DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_uint64(compaction_memory_limit,
+              ROCKSDB_NAMESPACE::Options().compaction_memory_limit,
+              "If non-zero, the estimated memory of running compactions and "
+              "flushes is kept within this many bytes");
+
+DEFINE_uint64(compaction_async_readahead_depth,
+              ROCKSDB_NAMESPACE::Options().compaction_async_readahead_depth,
+              "If non-zero, compactions keep this many asynchronous reads "
+              "of compaction_readahead_size in flight per input file");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(random_access_max_buffer_size, 1024 * 1024,
@@ -901,6 +928,11 @@ DEFINE_uint64(periodic_compaction_seconds,
               "Files older than this will be picked up for compaction and"
               " rewritten to the same level");
 
+DEFINE_uint64(max_delete_persistence_seconds,
+              ROCKSDB_NAMESPACE::Options().max_delete_persistence_seconds,
+              "Upper bound on the time for a tombstone to reach the last"
+              " level. 0 means no deadline.");
+
 DEFINE_uint64(ttl_seconds, ROCKSDB_NAMESPACE::Options().ttl, "Set options.ttl");
 
 static bool ValidateInt32Percent(const char* flagname, int32_t value) {
@@ -936,6 +968,37 @@ DEFINE_bool(optimize_filters_for_hits,
             "a value. For now this doesn't create bloom filters for the max "
             "level of the LSM to reduce metadata that should fit in RAM. ");
 
+DEFINE_uint64(level_search_index_min_files,
+              ROCKSDB_NAMESPACE::Options().level_search_index_min_files,
+              "Build a cache-friendly file search index for each sorted level "
+              "with at least this many files. 0 disables it.");
+
+DEFINE_uint64(range_tombstone_index_min_tombstones,
+              ROCKSDB_NAMESPACE::Options().range_tombstone_index_min_tombstones,
+              "Index the range tombstones of all files of a Version together "
+              "for point lookups once they number at least this many. 0 "
+              "disables it.");
+
+DEFINE_double(l0_key_filter_bits_per_key,
+              ROCKSDB_NAMESPACE::Options().l0_key_filter_bits_per_key,
+              "Bits per key of the in-memory filter over the keys of L0 "
+              "files written by flush. 0 disables it.");
+
+DEFINE_bool(compaction_copy_data_blocks,
+            ROCKSDB_NAMESPACE::Options().compaction_copy_data_blocks,
+            "Let compaction write input data blocks unchanged into its output "
+            "when their contents would be rebuilt exactly.");
+
+DEFINE_bool(flush_to_lowest_nonoverlapping_level,
+            ROCKSDB_NAMESPACE::Options().flush_to_lowest_nonoverlapping_level,
+            "Let flush write its output file to the deepest level it does not "
+            "overlap instead of to L0, with level compaction.");
+
+DEFINE_int32(max_flush_partitions,
+             ROCKSDB_NAMESPACE::Options().max_flush_partitions,
+             "Maximum number of key ranges a large flush is split into, whose "
+             "files are built in parallel.");
+
 DEFINE_bool(paranoid_checks, ROCKSDB_NAMESPACE::Options().paranoid_checks,
             "RocksDB will aggressively check consistency of the data.");
 
@@ -1155,6 +1218,16 @@ DEFINE_bool(open_as_follower, false,
 
 DEFINE_string(leader_path, "", "Path to the directory of the leader DB");
 
+DEFINE_int32(local_compaction_workers, 0,
+             "If positive, run compactions in up to this many worker "
+             "processes, started as db_bench with the same flags, through a "
+             "LocalCompactionService. Compare the foreground latencies with "
+             "those of a run without it to measure the isolation gained.");
+
+DEFINE_string(compaction_worker_job_dir, "",
+              "Internal: run as a compaction worker on the job in this "
+              "directory, and exit.");
+
 DEFINE_bool(report_bg_io_stats, false,
             "Measure times spents on I/Os while in compactions. ");
 
@@ -1411,6 +1484,9 @@ static std::shared_ptr<ROCKSDB_NAMESPACE::Env> env_guard;
 
 static ROCKSDB_NAMESPACE::Env* FLAGS_env = ROCKSDB_NAMESPACE::Env::Default();
 
+// The arguments db_bench was started with
+static std::vector<std::string> command_line;
+
 DEFINE_int64(stats_interval, 0,
              "Stats are reported every N operations when this is greater than "
              "zero. When 0 the interval grows over time.");
@@ -3150,6 +3226,7 @@ class Benchmark {
       HyperClockCacheOptions opts(FLAGS_cache_size, estimated_entry_charge,
                                   FLAGS_cache_numshardbits);
       opts.hash_seed = GetCacheHashSeed();
+      opts.frequency_admission = FLAGS_cache_frequency_admission;
       if (use_tiered_cache) {
         TieredCacheOptions tiered_opts;
         tiered_opts.cache_type = PrimaryCacheType::kCacheTypeHCC;
@@ -3178,6 +3255,7 @@ class Benchmark {
           GetCacheAllocator(), kDefaultToAdaptiveMutex,
           kDefaultCacheMetadataChargePolicy, FLAGS_cache_low_pri_pool_ratio);
       opts.hash_seed = GetCacheHashSeed();
+      opts.frequency_admission = FLAGS_cache_frequency_admission;
       if (use_tiered_cache) {
         TieredCacheOptions tiered_opts;
         tiered_opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
@@ -4290,6 +4368,9 @@ class Benchmark {
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_memory_limit = FLAGS_compaction_memory_limit;
+    options.compaction_async_readahead_depth =
+        static_cast<size_t>(FLAGS_compaction_async_readahead_depth);
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.random_access_max_buffer_size = FLAGS_random_access_max_buffer_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
@@ -4387,6 +4468,8 @@ class Benchmark {
       } else if (FLAGS_index_with_first_key) {
         block_based_options.index_type =
             BlockBasedTableOptions::kBinarySearchWithFirstKey;
+      } else if (FLAGS_use_learned_index) {
+        block_based_options.index_type = BlockBasedTableOptions::kLearnedIndex;
       }
       BlockBasedTableOptions::IndexShorteningMode index_shortening =
           block_based_options.index_shortening;
@@ -4486,6 +4569,7 @@ class Benchmark {
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
       block_based_options.prepopulate_block_cache = prepopulate_block_cache;
+      block_based_options.perfect_hash_index = FLAGS_perfect_hash_index;
       if (FLAGS_use_disc_bit_block_index) {
         block_based_options.data_block_index_type =
             ROCKSDB_NAMESPACE::BlockBasedTableOptions::kDataBlockDiscBit;
@@ -4637,9 +4721,19 @@ class Benchmark {
     options.max_compaction_bytes = FLAGS_max_compaction_bytes;
     options.disable_auto_compactions = FLAGS_disable_auto_compactions;
     options.optimize_filters_for_hits = FLAGS_optimize_filters_for_hits;
+    options.level_search_index_min_files = FLAGS_level_search_index_min_files;
+    options.range_tombstone_index_min_tombstones =
+        FLAGS_range_tombstone_index_min_tombstones;
+    options.l0_key_filter_bits_per_key = FLAGS_l0_key_filter_bits_per_key;
+    options.compaction_copy_data_blocks = FLAGS_compaction_copy_data_blocks;
+    options.flush_to_lowest_nonoverlapping_level =
+        FLAGS_flush_to_lowest_nonoverlapping_level;
+    options.max_flush_partitions = FLAGS_max_flush_partitions;
     options.paranoid_checks = FLAGS_paranoid_checks;
     options.force_consistency_checks = FLAGS_force_consistency_checks;
     options.periodic_compaction_seconds = FLAGS_periodic_compaction_seconds;
+    options.max_delete_persistence_seconds =
+        FLAGS_max_delete_persistence_seconds;
     options.ttl = FLAGS_ttl_seconds;
     // fill storage options
     options.advise_random_on_open = FLAGS_advise_random_on_open;
@@ -4688,6 +4782,8 @@ class Benchmark {
         FLAGS_universal_allow_trivial_move;
     options.compaction_options_universal.incremental =
         FLAGS_universal_incremental;
+    options.compaction_options_universal.lazy_leveling_tiering_factor =
+        FLAGS_universal_lazy_leveling_tiering_factor;
     options.compaction_options_universal.stop_style =
         static_cast<CompactionStopStyle>(FLAGS_universal_stop_style);
     if (FLAGS_thread_status_per_interval > 0) {
@@ -4821,6 +4917,21 @@ class Benchmark {
       }
     }
 
+    if (options.compaction_service == nullptr &&
+        FLAGS_local_compaction_workers > 0) {
+      LocalCompactionServiceOptions service_options;
+      service_options.worker_command = command_line;
+      service_options.worker_command.emplace_back(
+          "--compaction_worker_job_dir");
+      service_options.work_dir = FLAGS_db + "_compaction_jobs";
+      service_options.max_workers = FLAGS_local_compaction_workers;
+      options.compaction_service = NewLocalCompactionService(service_options);
+      if (options.compaction_service == nullptr) {
+        fprintf(stderr, "LocalCompactionService is not supported\n");
+        exit(1);
+      }
+    }
+
     options.listeners.emplace_back(listener_);
 
     if (options.file_checksum_gen_factory == nullptr) {
@@ -8581,6 +8692,29 @@ class Benchmark {
 
 };
 
+static std::atomic<bool> compaction_worker_canceled{false};
+
+static void CancelCompactionWorker(int /*sig*/) {
+  compaction_worker_canceled.store(true, std::memory_order_relaxed);
+}
+
+// Runs the job of a LocalCompactionService started with
+// --local_compaction_workers
+static int RunCompactionWorker() {
+  std::signal(SIGTERM, CancelCompactionWorker);
+  CompactionServiceOptionsOverride override_options;
+  override_options.env = FLAGS_env;
+  override_options.statistics = dbstats;
+  Status s = RunLocalCompactionWorker(FLAGS_compaction_worker_job_dir,
+                                      override_options,
+                                      &compaction_worker_canceled);
+  if (!s.ok()) {
+    fprintf(stderr, "Compaction worker failed: %s\n", s.ToString().c_str());
+    return 1;
+  }
+  return 0;
+}
+
 int db_bench_tool(int argc, char** argv) {
   ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
   ConfigOptions config_options;
@@ -8591,6 +8725,7 @@ int db_bench_tool(int argc, char** argv) {
     SetVersionString(GetRocksVersionAsString(true));
     initialized = true;
   }
+  command_line.assign(argv, argv + argc);
   ParseCommandLineFlags(&argc, &argv, true);
   FLAGS_compaction_style_e =
       (ROCKSDB_NAMESPACE::CompactionStyle)FLAGS_compaction_style;
@@ -8667,6 +8802,10 @@ int db_bench_tool(int argc, char** argv) {
     FLAGS_env = composite_env.get();
   }
 
+  if (!FLAGS_compaction_worker_job_dir.empty()) {
+    return RunCompactionWorker();
+  }
+
   // Let -readonly imply -use_existing_db
   FLAGS_use_existing_db |= FLAGS_readonly;
 
@@ -1193,6 +1193,117 @@ TEST(RibbonTest, RibbonTestLevelThreshold) {
   }
 }
 
+TEST(BinaryFuseTest, BuildAndQuery) {
+  BlockBasedTableOptions opts;
+  FilterBuildingContext ctx(opts);
+  char buffer[sizeof(int)];
+  for (double bits_per_key : {10.0, 16.0}) {
+    std::unique_ptr<const FilterPolicy> policy{
+        NewBinaryFuseFilterPolicy(bits_per_key)};
+    // 8- or 16-bit fingerprints
+    const double expected_fp_rate = bits_per_key < 12 ? 1.0 / 256 : 1.0 / 65536;
+    for (int num_keys : {1, 2, 10, 1000, 10000, 100000}) {
+      SCOPED_TRACE("bits_per_key=" + std::to_string(bits_per_key) +
+                   " num_keys=" + std::to_string(num_keys));
+      std::unique_ptr<FilterBitsBuilder> builder{
+          policy->GetBuilderWithContext(ctx)};
+      for (int i = 0; i < num_keys; ++i) {
+        builder->AddKey(Key(i, buffer));
+        // Non-adjacent duplicates
+        builder->AddKey(Key(i / 2, buffer));
+      }
+      std::unique_ptr<const char[]> buf;
+      Slice filter = builder->Finish(&buf);
+      std::unique_ptr<FilterBitsReader> reader{
+          policy->GetFilterBitsReader(filter)};
+      for (int i = 0; i < num_keys; ++i) {
+        ASSERT_TRUE(reader->MayMatch(Key(i, buffer)));
+      }
+      if (num_keys < 10000) {
+        // Might be a Bloom filter
+        continue;
+      }
+      // -3 = marker for binary fuse filter
+      ASSERT_EQ(filter[filter.size() - 5], static_cast<char>(-3));
+      double bits = filter.size() * 8.0 / num_keys;
+      ASSERT_LT(bits, (bits_per_key < 12 ? 8 : 16) * 1.4);
+      int fps = 0;
+      constexpr int kQueries = 100000;
+      for (int i = 0; i < kQueries; ++i) {
+        fps += reader->MayMatch(Key(i + 1000000000, buffer));
+      }
+      ASSERT_LT(fps, kQueries * expected_fp_rate * 2 + 5);
+      ASSERT_NEAR(builder->ApproximateNumEntries(filter.size()), num_keys,
+                  num_keys / 10);
+
+      // Unsupported metadata is read as always true
+      std::string bad = filter.ToString();
+      bad[bad.size() - 1] = 1;
+      reader.reset(policy->GetFilterBitsReader(bad));
+      ASSERT_TRUE(reader->MayMatch(Key(1000000000, buffer)));
+    }
+  }
+}
+
+TEST(LevelOptimizedFilterTest, LevelBitsPerKey) {
+  // Empty L0, then levels growing 10x
+  const std::vector<uint64_t> level_bytes = {
+      0, uint64_t{1} << 20, uint64_t{10} << 20, uint64_t{100} << 20,
+      uint64_t{1000} << 20};
+  for (double bits_per_key : {0.2, 2.0, 10.0}) {
+    SCOPED_TRACE("bits_per_key=" + std::to_string(bits_per_key));
+    std::vector<double> bits;
+    double total_bits = 0;
+    double total_bytes = 0;
+    for (int level = 0; level < 5; ++level) {
+      bits.push_back(LevelOptimizedFilterPolicy::GetLevelBitsPerKey(
+          bits_per_key, level_bytes, level));
+      total_bits += bits.back() * static_cast<double>(level_bytes[level]);
+      total_bytes += static_cast<double>(level_bytes[level]);
+    }
+    // The budget is spent, with more bits for smaller levels
+    ASSERT_NEAR(total_bits / total_bytes, bits_per_key, 1e-6);
+    ASSERT_EQ(bits[0], bits[1]);
+    for (int level = 2; level < 5; ++level) {
+      ASSERT_LT(bits[level], bits[level - 1]);
+    }
+    // Unknown level
+    ASSERT_EQ(LevelOptimizedFilterPolicy::GetLevelBitsPerKey(
+                  bits_per_key, level_bytes, -1),
+              bits_per_key);
+    ASSERT_EQ(
+        LevelOptimizedFilterPolicy::GetLevelBitsPerKey(bits_per_key, {}, 1),
+        bits_per_key);
+  }
+  // Too small a budget for the last level
+  ASSERT_EQ(
+      LevelOptimizedFilterPolicy::GetLevelBitsPerKey(0.2, level_bytes, 4), 0);
+}
+
+TEST(LevelOptimizedFilterTest, BuilderByLevel) {
+  BlockBasedTableOptions opts;
+  FilterBuildingContext ctx(opts);
+  ctx.level_bytes = {0, uint64_t{1} << 20, uint64_t{10} << 20,
+                     uint64_t{100} << 20, uint64_t{1000} << 20};
+  std::unique_ptr<const FilterPolicy> policy{NewLevelOptimizedFilterPolicy(10)};
+  std::unique_ptr<FilterBitsBuilder> builder;
+
+  ctx.compaction_style = kCompactionStyleLevel;
+  SetTestingLevel(1, &ctx);
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_GT(GetEffectiveBitsPerKey(builder.get()), 20);
+  SetTestingLevel(4, &ctx);
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_LT(GetEffectiveBitsPerKey(builder.get()), 10);
+
+  // Level sizes are ignored under other compaction styles
+  ctx.compaction_style = kCompactionStyleUniversal;
+  SetTestingLevel(1, &ctx);
+  builder.reset(policy->GetBuilderWithContext(ctx));
+  ASSERT_GT(GetEffectiveBitsPerKey(builder.get()), 9);
+  ASSERT_LT(GetEffectiveBitsPerKey(builder.get()), 11);
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
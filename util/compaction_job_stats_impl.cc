@@ -17,6 +17,8 @@ void CompactionJobStats::Reset() {
   num_blobs_read = 0;
   num_input_files = 0;
   num_input_files_at_output_level = 0;
+  num_range_deleted_input_files = 0;
+  range_deleted_input_bytes = 0;
 
   num_output_records = 0;
   num_output_files = 0;
@@ -44,6 +46,13 @@ void CompactionJobStats::Reset() {
   file_range_sync_nanos = 0;
   file_fsync_nanos = 0;
   file_prepare_write_nanos = 0;
+  file_read_nanos = 0;
+  block_decompress_nanos = 0;
+  merge_operator_nanos = 0;
+  compaction_filter_nanos = 0;
+  block_compress_nanos = 0;
+  filter_build_nanos = 0;
+  index_build_nanos = 0;
 
   smallest_output_key_prefix.clear();
   largest_output_key_prefix.clear();
@@ -61,6 +70,8 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   num_blobs_read += stats.num_blobs_read;
   num_input_files += stats.num_input_files;
   num_input_files_at_output_level += stats.num_input_files_at_output_level;
+  num_range_deleted_input_files += stats.num_range_deleted_input_files;
+  range_deleted_input_bytes += stats.range_deleted_input_bytes;
 
   num_output_records += stats.num_output_records;
   num_output_files += stats.num_output_files;
@@ -85,6 +96,13 @@ void CompactionJobStats::Add(const CompactionJobStats& stats) {
   file_range_sync_nanos += stats.file_range_sync_nanos;
   file_fsync_nanos += stats.file_fsync_nanos;
   file_prepare_write_nanos += stats.file_prepare_write_nanos;
+  file_read_nanos += stats.file_read_nanos;
+  block_decompress_nanos += stats.block_decompress_nanos;
+  merge_operator_nanos += stats.merge_operator_nanos;
+  compaction_filter_nanos += stats.compaction_filter_nanos;
+  block_compress_nanos += stats.block_compress_nanos;
+  filter_build_nanos += stats.filter_build_nanos;
+  index_build_nanos += stats.index_build_nanos;
 
   num_single_del_fallthru += stats.num_single_del_fallthru;
   num_single_del_mismatch += stats.num_single_del_mismatch;
@@ -11,6 +11,7 @@ int main() {
 }
 #else
 
+#include <algorithm>
 #include <cinttypes>
 #include <iostream>
 #include <sstream>
@@ -26,6 +27,7 @@ int main() {
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/mock_block_based_table.h"
+#include "table/multiget_context.h"
 #include "table/plain/plain_table_bloom.h"
 #include "util/cast_util.h"
 #include "util/gflags_compat.h"
@@ -86,7 +88,8 @@ DEFINE_bool(new_builder, false,
 DEFINE_uint32(impl, 0,
               "Select filter implementation. Without -use_plain_table_bloom:"
               "0 = legacy full Bloom filter, "
-              "1 = format_version 5 Bloom filter, 2 = Ribbon128 filter. With "
+              "1 = format_version 5 Bloom filter, 2 = Ribbon128 filter, "
+              "3 = binary fuse filter. With "
               "-use_plain_table_bloom: 0 = no locality, 1 = locality.");
 
 DEFINE_bool(net_includes_hashing, false,
@@ -141,6 +144,7 @@ void _always_assert_fail(int line, const char *file, const char *expr) {
 #endif
 
 using ROCKSDB_NAMESPACE::Arena;
+using ROCKSDB_NAMESPACE::autovector;
 using ROCKSDB_NAMESPACE::BlockContents;
 using ROCKSDB_NAMESPACE::BloomFilterPolicy;
 using ROCKSDB_NAMESPACE::BloomHash;
@@ -159,8 +163,11 @@ using ROCKSDB_NAMESPACE::FilterPolicy;
 using ROCKSDB_NAMESPACE::FullFilterBlockReader;
 using ROCKSDB_NAMESPACE::GetSliceHash;
 using ROCKSDB_NAMESPACE::GetSliceHash64;
+using ROCKSDB_NAMESPACE::KeyContext;
+using ROCKSDB_NAMESPACE::kMaxSequenceNumber;
 using ROCKSDB_NAMESPACE::Lower32of64;
 using ROCKSDB_NAMESPACE::LRUCacheOptions;
+using ROCKSDB_NAMESPACE::MultiGetContext;
 using ROCKSDB_NAMESPACE::ParsedFullFilterBlock;
 using ROCKSDB_NAMESPACE::PlainTableBloomV1;
 using ROCKSDB_NAMESPACE::Random32;
@@ -296,6 +303,38 @@ static uint32_t DryRunHash64(Slice &s) {
   return Lower32of64(GetSliceHash64(s));
 }
 
+// Queries the keys through the full filter block reader in MultiGet batches
+static void FullBlockReaderMayMatch(FullFilterBlockReader *reader,
+                                    uint32_t num_keys, const Slice *keys,
+                                    bool *may_match) {
+  const ROCKSDB_NAMESPACE::ReadOptions read_options;
+  for (uint32_t start = 0; start < num_keys;
+       start += MultiGetContext::MAX_BATCH_SIZE) {
+    const uint32_t batch_keys = std::min(
+        num_keys - start, uint32_t{MultiGetContext::MAX_BATCH_SIZE});
+    autovector<KeyContext, MultiGetContext::MAX_BATCH_SIZE> key_contexts;
+    autovector<KeyContext *, MultiGetContext::MAX_BATCH_SIZE> sorted_keys;
+    for (uint32_t i = 0; i < batch_keys; ++i) {
+      key_contexts.emplace_back(/*col_family=*/nullptr, keys[start + i],
+                                /*val=*/nullptr, /*cols=*/nullptr,
+                                /*ts=*/nullptr, /*stat=*/nullptr);
+    }
+    for (auto &key_context : key_contexts) {
+      sorted_keys.emplace_back(&key_context);
+    }
+    MultiGetContext ctx(&sorted_keys, 0, batch_keys, kMaxSequenceNumber,
+                        read_options, /*fs=*/nullptr, /*stats=*/nullptr);
+    MultiGetContext::Range range = ctx.GetMultiGetRange();
+    reader->KeysMayMatch(&range, /*lookup_context=*/nullptr, read_options);
+    for (uint32_t i = 0; i < batch_keys; ++i) {
+      may_match[start + i] = false;
+    }
+    for (auto iter = range.begin(); iter != range.end(); ++iter) {
+      may_match[start + iter.index()] = true;
+    }
+  }
+}
+
 const std::shared_ptr<const FilterPolicy> &GetPolicy() {
   static std::shared_ptr<const FilterPolicy> policy;
   if (!policy) {
@@ -360,9 +399,9 @@ void FilterBench::Go() {
           "-impl must currently be >= 0 and <= 1 for Plain table");
     }
   } else {
-    if (FLAGS_impl > 2) {
+    if (FLAGS_impl > 3) {
       throw std::runtime_error(
-          "-impl must currently be >= 0 and <= 2 for Block-based table");
+          "-impl must currently be >= 0 and <= 3 for Block-based table");
     }
   }
 
@@ -685,10 +724,8 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
         info.outside_queries_++;
       }
     }
-    // TODO: implement batched interface to full block reader
     // TODO: implement batched interface to plain table bloom
-    if (mode == kBatchPrepared && !FLAGS_use_full_block_reader &&
-        !FLAGS_use_plain_table_bloom) {
+    if (mode == kBatchPrepared && !FLAGS_use_plain_table_bloom) {
       for (uint32_t i = 0; i < batch_size; ++i) {
         batch_results[i] = false;
       }
@@ -697,6 +734,9 @@ double FilterBench::RandomQueryTest(uint32_t inside_threshold, bool dry_run,
           batch_results[i] = true;
           dry_run_hash += dry_run_hash_fn(batch_slices[i]);
         }
+      } else if (FLAGS_use_full_block_reader) {
+        FullBlockReaderMayMatch(info.full_block_reader_.get(), batch_size,
+                                batch_slices.get(), batch_results.get());
       } else {
         info.reader_->MayMatch(batch_size, batch_slice_ptrs.get(),
                                batch_results.get());
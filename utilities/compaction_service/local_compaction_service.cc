@@ -0,0 +1,330 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#ifndef OS_WIN
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <set>
+
+#include "db/compaction/compaction_job.h"
+#include "file/file_util.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/env.h"
+#include "rocksdb/system_clock.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The files of a job directory
+constexpr const char* kDbNameFile = "/db_name";
+constexpr const char* kInputFile = "/input";
+constexpr const char* kResultFile = "/result";
+constexpr const char* kOutputDir = "/output";
+
+#ifndef OS_WIN
+// How often a job checks whether its worker exited
+constexpr uint64_t kPollMicros = 10 * 1000;
+
+class LocalCompactionServiceImpl : public LocalCompactionService {
+ public:
+  explicit LocalCompactionServiceImpl(const LocalCompactionServiceOptions& opts)
+      : opts_(opts),
+        env_(Env::Default()),
+        clock_(SystemClock::Default().get()),
+        cv_(&mutex_) {
+    // Jobs left by an earlier process cannot be waited for
+    Status s = env_->CreateDirIfMissing(opts_.work_dir);
+    std::vector<std::string> children;
+    if (s.ok()) {
+      s = env_->GetChildren(opts_.work_dir, &children);
+    }
+    for (const auto& child : children) {
+      DestroyDir(env_, opts_.work_dir + "/" + child).PermitUncheckedError();
+    }
+    s.PermitUncheckedError();
+  }
+
+  ~LocalCompactionServiceImpl() override {
+    MutexLock l(&mutex_);
+    for (pid_t pid : workers_) {
+      kill(pid, SIGKILL);
+      int wstatus;
+      waitpid(pid, &wstatus, 0);
+    }
+  }
+
+  CompactionServiceScheduleResponse Schedule(
+      const CompactionServiceJobInfo& info,
+      const std::string& compaction_service_input) override {
+    std::string id;
+    {
+      MutexLock l(&mutex_);
+      id = std::to_string(next_job_++);
+    }
+    const std::string dir = JobDir(id);
+    Status s = env_->CreateDir(dir);
+    if (s.ok()) {
+      s = env_->CreateDir(dir + kOutputDir);
+    }
+    if (s.ok()) {
+      s = WriteStringToFile(env_, info.db_name, dir + kDbNameFile);
+    }
+    if (s.ok()) {
+      s = WriteStringToFile(env_, compaction_service_input, dir + kInputFile);
+    }
+    if (!s.ok()) {
+      DestroyDir(env_, dir).PermitUncheckedError();
+      num_local_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+      return CompactionServiceScheduleResponse(
+          CompactionServiceJobStatus::kUseLocal);
+    }
+    return CompactionServiceScheduleResponse(
+        id, CompactionServiceJobStatus::kSuccess);
+  }
+
+  CompactionServiceJobStatus Wait(const std::string& scheduled_job_id,
+                                  std::string* result) override {
+    const std::string dir = JobDir(scheduled_job_id);
+    const int attempts = std::max(opts_.max_attempts, 1);
+    for (int i = 0; i < attempts; ++i) {
+      RunResult run = RunWorker(dir, result);
+      if (run == RunResult::kSucceeded) {
+        // The job directory is removed on installation
+        return CompactionServiceJobStatus::kSuccess;
+      } else if (run == RunResult::kCompactionFailed) {
+        DestroyDir(env_, dir).PermitUncheckedError();
+        return CompactionServiceJobStatus::kFailure;
+      } else if (run == RunResult::kCanceled) {
+        break;
+      }
+      num_failed_runs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    result->clear();
+    DestroyDir(env_, dir).PermitUncheckedError();
+    num_local_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+    return CompactionServiceJobStatus::kUseLocal;
+  }
+
+  void OnInstallation(const std::string& scheduled_job_id,
+                      CompactionServiceJobStatus /*status*/) override {
+    DestroyDir(env_, JobDir(scheduled_job_id)).PermitUncheckedError();
+  }
+
+  void CancelAwaitingJobs() override {
+    MutexLock l(&mutex_);
+    canceled_ = true;
+    for (pid_t pid : workers_) {
+      kill(pid, SIGTERM);
+    }
+    cv_.SignalAll();
+  }
+
+  void Resume() override {
+    MutexLock l(&mutex_);
+    canceled_ = false;
+  }
+
+  uint64_t GetNumFailedRuns() const override {
+    return num_failed_runs_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t GetNumLocalFallbacks() const override {
+    return num_local_fallbacks_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  enum class RunResult {
+    kSucceeded,
+    // The worker returned a result with a failed status
+    kCompactionFailed,
+    // The worker crashed, was killed or did not write a result
+    kRunFailed,
+    kCanceled,
+  };
+
+  std::string JobDir(const std::string& id) const {
+    return opts_.work_dir + "/" + id;
+  }
+
+  // Starts a worker on `dir` and returns its pid, or -1. Requires mutex_
+  // held.
+  pid_t StartWorker(const std::string& dir) {
+    std::vector<std::string> args = opts_.worker_command;
+    args.push_back(dir);
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+      argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    return pid;
+  }
+
+  // Runs one worker on the job in `dir` and reads its result
+  RunResult RunWorker(const std::string& dir, std::string* result) {
+    int wstatus = -1;
+    bool canceled;
+    {
+      MutexLock l(&mutex_);
+      while (!canceled_ &&
+             workers_.size() >= static_cast<size_t>(opts_.max_workers)) {
+        cv_.Wait();
+      }
+      if (canceled_) {
+        return RunResult::kCanceled;
+      }
+      pid_t pid = StartWorker(dir);
+      if (pid < 0) {
+        return RunResult::kRunFailed;
+      }
+      workers_.insert(pid);
+
+      // The pid is reaped with mutex_ held, so that it is not signaled after
+      // it may have been reused
+      const uint64_t deadline =
+          opts_.timeout_seconds > 0
+              ? clock_->NowMicros() + opts_.timeout_seconds * 1000000
+              : 0;
+      bool killed = false;
+      for (;;) {
+        pid_t r = waitpid(pid, &wstatus, WNOHANG);
+        if (r == pid || (r < 0 && errno != EINTR)) {
+          break;
+        }
+        if (deadline > 0 && !killed && clock_->NowMicros() > deadline) {
+          kill(pid, SIGKILL);
+          killed = true;
+        }
+        cv_.TimedWait(clock_->NowMicros() + kPollMicros);
+      }
+      workers_.erase(pid);
+      cv_.SignalAll();
+      canceled = canceled_;
+    }
+
+    if (!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
+      return canceled ? RunResult::kCanceled : RunResult::kRunFailed;
+    }
+    CompactionServiceResult compaction_result;
+    Status s = ReadFileToString(env_, dir + kResultFile, result);
+    if (s.ok()) {
+      s = CompactionServiceResult::Read(*result, &compaction_result);
+    }
+    if (!s.ok()) {
+      compaction_result.status.PermitUncheckedError();
+      return canceled ? RunResult::kCanceled : RunResult::kRunFailed;
+    }
+    if (compaction_result.status.ok()) {
+      return RunResult::kSucceeded;
+    }
+    return canceled ? RunResult::kCanceled : RunResult::kCompactionFailed;
+  }
+
+  const LocalCompactionServiceOptions opts_;
+  Env* const env_;
+  SystemClock* const clock_;
+
+  port::Mutex mutex_;
+  // Signaled when a worker exits or jobs are canceled
+  port::CondVar cv_;
+  // The running workers
+  std::set<pid_t> workers_;
+  bool canceled_ = false;
+  uint64_t next_job_ = 0;
+
+  std::atomic<uint64_t> num_failed_runs_{0};
+  std::atomic<uint64_t> num_local_fallbacks_{0};
+};
+#endif  // !OS_WIN
+}  // namespace
+
+std::shared_ptr<LocalCompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& opts) {
+#ifndef OS_WIN
+  if (opts.worker_command.empty() || opts.work_dir.empty() ||
+      opts.max_workers <= 0) {
+    return nullptr;
+  }
+  return std::make_shared<LocalCompactionServiceImpl>(opts);
+#else
+  (void)opts;
+  return nullptr;
+#endif  // !OS_WIN
+}
+
+Status RunLocalCompactionWorker(
+    const std::string& job_dir,
+    const CompactionServiceOptionsOverride& override_options,
+    std::atomic<bool>* canceled) {
+  Env* env = Env::Default();
+  std::string db_name;
+  std::string input;
+  Status s = ReadFileToString(env, job_dir + kDbNameFile, &db_name);
+  if (s.ok()) {
+    s = ReadFileToString(env, job_dir + kInputFile, &input);
+  }
+  CompactionServiceInput compaction_input;
+  if (s.ok()) {
+    s = CompactionServiceInput::Read(input, &compaction_input);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  CompactionServiceOptionsOverride options = override_options;
+  const ColumnFamilyOptions& cf_options =
+      compaction_input.column_family.options;
+  if (options.table_factory == nullptr) {
+    options.table_factory = cf_options.table_factory;
+  }
+  if (options.merge_operator == nullptr) {
+    options.merge_operator = cf_options.merge_operator;
+  }
+  if (options.prefix_extractor == nullptr) {
+    options.prefix_extractor = cf_options.prefix_extractor;
+  }
+  if (options.compaction_filter_factory == nullptr) {
+    options.compaction_filter_factory = cf_options.compaction_filter_factory;
+  }
+  if (options.sst_partitioner_factory == nullptr) {
+    options.sst_partitioner_factory = cf_options.sst_partitioner_factory;
+  }
+
+  OpenAndCompactOptions open_options;
+  open_options.canceled = canceled;
+  std::string result;
+  s = DB::OpenAndCompact(open_options, db_name, job_dir + kOutputDir, input,
+                         &result, options);
+  if (result.empty()) {
+    // The DB could not be opened
+    return s.ok() ? Status::Incomplete("No compaction result") : s;
+  }
+  // The status of a failed compaction is in the result
+  s.PermitUncheckedError();
+
+  // A result is only found complete
+  const std::string tmp_file = job_dir + kResultFile + ".tmp";
+  s = WriteStringToFile(env, result, tmp_file, /*should_sync=*/true);
+  if (s.ok()) {
+    s = env->RenameFile(tmp_file, job_dir + kResultFile);
+  }
+  return s;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
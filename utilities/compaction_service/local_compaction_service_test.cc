@@ -0,0 +1,172 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#ifndef OS_WIN
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "db/db_test_util.h"
+#include "file/file_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// The test binary, which also runs the workers (see main())
+std::string test_binary;
+
+std::atomic<bool> worker_canceled{false};
+
+void HandleSigterm(int /*sig*/) {
+  worker_canceled.store(true, std::memory_order_relaxed);
+}
+}  // namespace
+
+class LocalCompactionServiceTest : public DBTestBase {
+ public:
+  LocalCompactionServiceTest()
+      : DBTestBase("local_compaction_service_test", /*env_do_fsync=*/true),
+        work_dir_(dbname_ + "_jobs") {}
+
+  ~LocalCompactionServiceTest() override {
+    EXPECT_OK(DestroyDir(env_, work_dir_));
+  }
+
+ protected:
+  // Starts the workers as the test binary with `mode`
+  LocalCompactionServiceOptions ServiceOptions(const std::string& mode) {
+    LocalCompactionServiceOptions opts;
+    opts.worker_command = {test_binary, mode};
+    opts.work_dir = work_dir_;
+    return opts;
+  }
+
+  // Opens the DB with `service`, and writes overlapping files on L0
+  void OpenAndLoad(std::shared_ptr<LocalCompactionService> service) {
+    ASSERT_NE(service, nullptr);
+    Options options = CurrentOptions();
+    options.disable_auto_compactions = true;
+    statistics_ = CreateDBStatistics();
+    options.statistics = statistics_;
+    options.compaction_service = service;
+    DestroyAndReopen(options);
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 100; ++j) {
+        ASSERT_OK(Put(Key(j), "value" + std::to_string(i)));
+      }
+      ASSERT_OK(Flush());
+    }
+  }
+
+  void VerifyCompacted() {
+    ASSERT_EQ(NumTableFilesAtLevel(0), 0);
+    ASSERT_GT(NumTableFilesAtLevel(1), 0);
+    for (int j = 0; j < 100; ++j) {
+      ASSERT_EQ(Get(Key(j)), "value2");
+    }
+    std::vector<std::string> jobs;
+    ASSERT_OK(env_->GetChildren(work_dir_, &jobs));
+    ASSERT_TRUE(jobs.empty());
+  }
+
+  const std::string work_dir_;
+  std::shared_ptr<Statistics> statistics_;
+};
+
+TEST_F(LocalCompactionServiceTest, CompactInWorker) {
+  auto service = NewLocalCompactionService(ServiceOptions("--worker"));
+  OpenAndLoad(service);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyCompacted();
+  ASSERT_EQ(service->GetNumFailedRuns(), 0);
+  ASSERT_EQ(service->GetNumLocalFallbacks(), 0);
+  ASSERT_GT(statistics_->getTickerCount(REMOTE_COMPACT_WRITE_BYTES), 0);
+}
+
+TEST_F(LocalCompactionServiceTest, RetryCrashedWorker) {
+  LocalCompactionServiceOptions opts = ServiceOptions("--crashing_worker");
+  opts.max_attempts = 3;
+  auto service = NewLocalCompactionService(opts);
+  OpenAndLoad(service);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  // Compacted in the DB process after the last run crashed
+  VerifyCompacted();
+  ASSERT_EQ(service->GetNumFailedRuns(), 3);
+  ASSERT_EQ(service->GetNumLocalFallbacks(), 1);
+  ASSERT_EQ(statistics_->getTickerCount(REMOTE_COMPACT_WRITE_BYTES), 0);
+}
+
+TEST_F(LocalCompactionServiceTest, KillWorkerOnTimeout) {
+  LocalCompactionServiceOptions opts = ServiceOptions("--hanging_worker");
+  opts.max_attempts = 1;
+  opts.timeout_seconds = 1;
+  auto service = NewLocalCompactionService(opts);
+  OpenAndLoad(service);
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  VerifyCompacted();
+  ASSERT_EQ(service->GetNumFailedRuns(), 1);
+  ASSERT_EQ(service->GetNumLocalFallbacks(), 1);
+}
+
+TEST_F(LocalCompactionServiceTest, CancelAwaitingJobs) {
+  auto service = NewLocalCompactionService(ServiceOptions("--hanging_worker"));
+  OpenAndLoad(service);
+  port::Thread canceler([&]() {
+    // Whether or not the worker started, the job falls back
+    env_->SleepForMicroseconds(100 * 1000);
+    service->CancelAwaitingJobs();
+  });
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  canceler.join();
+  VerifyCompacted();
+  ASSERT_EQ(service->GetNumFailedRuns(), 0);
+  ASSERT_EQ(service->GetNumLocalFallbacks(), 1);
+
+  // Canceled jobs are not started
+  for (int j = 0; j < 100; ++j) {
+    ASSERT_OK(Put(Key(j), "value2"));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(service->GetNumLocalFallbacks(), 2);
+  service->Resume();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  using namespace ROCKSDB_NAMESPACE;
+  // Worker processes get a mode and the job directory
+  if (argc == 3 && strcmp(argv[1], "--worker") == 0) {
+    signal(SIGTERM, HandleSigterm);
+    Status s = RunLocalCompactionWorker(
+        argv[2], CompactionServiceOptionsOverride(), &worker_canceled);
+    return s.ok() ? 0 : 1;
+  } else if (argc == 3 && strcmp(argv[1], "--crashing_worker") == 0) {
+    raise(SIGKILL);
+  } else if (argc == 3 && strcmp(argv[1], "--hanging_worker") == 0) {
+    for (;;) {
+      pause();
+    }
+  }
+  test_binary = argv[0];
+
+  port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#else
+#include <stdio.h>
+
+int main(int /*argc*/, char** /*argv*/) {
+  fprintf(stderr,
+          "SKIPPED as LocalCompactionService is not supported on Windows\n");
+  return 0;
+}
+#endif  // !OS_WIN
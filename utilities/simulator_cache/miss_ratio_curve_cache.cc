@@ -0,0 +1,321 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/miss_ratio_curve_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <unordered_map>
+
+#include "monitoring/statistics_impl.h"
+#include "port/port.h"
+#include "util/hash.h"
+#include "util/math.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+
+// Keys are sampled if the top kSamplingBits bits of their hash are below a
+// threshold
+constexpr int kSamplingBits = 24;
+constexpr uint64_t kSamplingModulus = uint64_t{1} << kSamplingBits;
+
+// Reuse distances are kept in a histogram with kSubBuckets buckets per power
+// of two
+constexpr int kSubBucketBits = 2;
+constexpr int kSubBuckets = 1 << kSubBucketBits;
+constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+size_t BucketIndex(uint64_t distance) {
+  if (distance < kSubBuckets) {
+    return static_cast<size_t>(distance);
+  }
+  int msb = FloorLog2(distance);
+  uint64_t sub = (distance >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+  return static_cast<size_t>((msb - kSubBucketBits + 1) * kSubBuckets + sub);
+}
+
+// The smallest distance in the bucket
+uint64_t BucketLowerBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  int msb = static_cast<int>(index / kSubBuckets) + kSubBucketBits - 1;
+  uint64_t sub = index % kSubBuckets;
+  return (uint64_t{1} << msb) | (sub << (msb - kSubBucketBits));
+}
+
+// Sum of charges by last access time of the sampled keys, so that the bytes
+// accessed since a time are found in logarithmic time
+class FenwickTree {
+ public:
+  void Reset(size_t size) { tree_.assign(size + 1, 0); }
+  size_t size() const { return tree_.size() - 1; }
+
+  void Add(uint64_t time, int64_t delta) {
+    for (size_t i = static_cast<size_t>(time); i < tree_.size();
+         i += i & (~i + 1)) {
+      tree_[i] += delta;
+    }
+  }
+
+  // Sum over times [1, time]
+  int64_t PrefixSum(uint64_t time) const {
+    int64_t sum = 0;
+    for (size_t i = static_cast<size_t>(time); i > 0; i -= i & (~i + 1)) {
+      sum += tree_[i];
+    }
+    return sum;
+  }
+
+ private:
+  std::vector<int64_t> tree_;
+};
+
+class MissRatioCurveCacheImpl : public MissRatioCurveCache {
+ public:
+  MissRatioCurveCacheImpl(std::shared_ptr<Cache> cache,
+                          const MissRatioCurveCacheOptions& opts)
+      : MissRatioCurveCache(std::move(cache)),
+        max_sampled_keys_(std::max(opts.max_sampled_keys, size_t{1})) {
+    double rate = std::min(std::max(opts.sampling_rate, 0.0), 1.0);
+    uint64_t threshold = static_cast<uint64_t>(rate * kSamplingModulus);
+    threshold_.store(std::max(threshold, uint64_t{1}),
+                     std::memory_order_relaxed);
+    // Room for as many accesses as keys between renumberings
+    times_.Reset(2 * max_sampled_keys_);
+  }
+
+  Status Insert(const Slice& key, ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge,
+                Handle** handle = nullptr, Priority priority = Priority::LOW,
+                const Slice& compressed = {},
+                CompressionType type = kNoCompression) override {
+    uint64_t hash = GetSliceHash64(key);
+    if (IsSampled(hash)) {
+      MutexLock l(&mutex_);
+      if (IsSampled(hash)) {
+        Access(hash, charge, /*is_lookup=*/false, /*stats=*/nullptr);
+      }
+    }
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed, type);
+  }
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper = nullptr,
+                 CreateContext* create_context = nullptr,
+                 Priority priority = Priority::LOW,
+                 Statistics* stats = nullptr) override {
+    Handle* handle =
+        target_->Lookup(key, helper, create_context, priority, stats);
+    uint64_t hash = GetSliceHash64(key);
+    if (IsSampled(hash)) {
+      // Charge 0 keeps the charge recorded for the key, if any. A missing
+      // key is charged once inserted.
+      size_t charge = handle != nullptr ? target_->GetCharge(handle) : 0;
+      MutexLock l(&mutex_);
+      if (IsSampled(hash)) {
+        Access(hash, charge, /*is_lookup=*/true, stats);
+      }
+    }
+    return handle;
+  }
+
+  void StartAsyncLookup(AsyncLookupHandle& async_handle) override {
+    uint64_t hash = GetSliceHash64(async_handle.key);
+    if (IsSampled(hash)) {
+      MutexLock l(&mutex_);
+      if (IsSampled(hash)) {
+        Access(hash, /*charge=*/0, /*is_lookup=*/true, async_handle.stats);
+      }
+    }
+    target_->StartAsyncLookup(async_handle);
+  }
+
+  void GetMissRatioCurve(const std::vector<size_t>& capacities,
+                         std::vector<double>* miss_ratios) const override {
+    std::array<double, kNumBuckets> weights;
+    double cold_weight;
+    double total_weight;
+    {
+      MutexLock l(&mutex_);
+      weights = distance_weights_;
+      cold_weight = cold_weight_;
+      total_weight = total_weight_;
+    }
+    miss_ratios->assign(capacities.size(), 0.0);
+    if (total_weight == 0) {
+      return;
+    }
+    for (size_t i = 0; i < capacities.size(); ++i) {
+      double miss_weight = cold_weight;
+      for (size_t b = 0; b < kNumBuckets; ++b) {
+        uint64_t lower = BucketLowerBound(b);
+        uint64_t upper = b + 1 < kNumBuckets ? BucketLowerBound(b + 1)
+                                             : std::numeric_limits<uint64_t>::max();
+        if (lower > capacities[i]) {
+          miss_weight += weights[b];
+        } else if (upper > capacities[i] + 1) {
+          // Assume distances are spread evenly within the bucket
+          miss_weight += weights[b] *
+                         static_cast<double>(upper - 1 - capacities[i]) /
+                         static_cast<double>(upper - lower);
+        }
+      }
+      (*miss_ratios)[i] = std::min(1.0, miss_weight / total_weight);
+    }
+  }
+
+  uint64_t GetNumSampledLookups() const override {
+    MutexLock l(&mutex_);
+    return num_sampled_lookups_;
+  }
+
+  void ResetMissRatioCurve() override {
+    MutexLock l(&mutex_);
+    distance_weights_.fill(0);
+    cold_weight_ = 0;
+    total_weight_ = 0;
+    num_sampled_lookups_ = 0;
+  }
+
+  std::string GetPrintableOptions() const override {
+    std::string ret = target_->GetPrintableOptions();
+    char buffer[200];
+    snprintf(buffer, sizeof(buffer),
+             "    mrc_sampling_rate : %g\n"
+             "    mrc_max_sampled_keys : %" ROCKSDB_PRIszt "\n",
+             SamplingRate(), max_sampled_keys_);
+    ret.append(buffer);
+    return ret;
+  }
+
+ private:
+  struct SampledKey {
+    uint64_t last_access;
+    size_t charge;
+  };
+
+  bool IsSampled(uint64_t hash) const {
+    return (hash >> (64 - kSamplingBits)) <
+           threshold_.load(std::memory_order_relaxed);
+  }
+
+  double SamplingRate() const {
+    return static_cast<double>(threshold_.load(std::memory_order_relaxed)) /
+           kSamplingModulus;
+  }
+
+  // Requires mutex_ held
+  void Access(uint64_t hash, size_t charge, bool is_lookup, Statistics* stats) {
+    const double rate = SamplingRate();
+    auto it = keys_.find(hash);
+    if (it == keys_.end()) {
+      if (is_lookup) {
+        // A miss for any capacity
+        cold_weight_ += 1 / rate;
+        total_weight_ += 1 / rate;
+        ++num_sampled_lookups_;
+      }
+      it = keys_.emplace(hash, SampledKey{0, charge}).first;
+    } else {
+      SampledKey& sampled = it->second;
+      if (is_lookup) {
+        // Bytes of the distinct keys accessed since the previous access, and
+        // of the key itself, i.e. the smallest LRU cache holding the key
+        uint64_t distance =
+            static_cast<uint64_t>(times_.PrefixSum(times_.size()) -
+                                  times_.PrefixSum(sampled.last_access)) +
+            std::max(sampled.charge, charge);
+        distance = static_cast<uint64_t>(static_cast<double>(distance) / rate);
+        distance_weights_[BucketIndex(distance)] += 1 / rate;
+        total_weight_ += 1 / rate;
+        ++num_sampled_lookups_;
+        RecordInHistogram(stats, BLOCK_CACHE_SAMPLED_REUSE_DISTANCE, distance);
+      }
+      times_.Add(sampled.last_access, -static_cast<int64_t>(sampled.charge));
+      if (charge > 0) {
+        sampled.charge = charge;
+      }
+    }
+    if (next_time_ > times_.size()) {
+      Renumber();
+    }
+    it->second.last_access = next_time_++;
+    times_.Add(it->second.last_access,
+               static_cast<int64_t>(it->second.charge));
+    if (keys_.size() > max_sampled_keys_) {
+      LowerSamplingRate();
+    }
+  }
+
+  // Assigns consecutive times to the keys in access order, making room for
+  // new accesses. Requires mutex_ held.
+  void Renumber() {
+    std::vector<SampledKey*> by_time;
+    by_time.reserve(keys_.size());
+    for (auto& key : keys_) {
+      if (key.second.last_access != 0) {
+        by_time.push_back(&key.second);
+      }
+    }
+    std::sort(by_time.begin(), by_time.end(),
+              [](const SampledKey* a, const SampledKey* b) {
+                return a->last_access < b->last_access;
+              });
+    times_.Reset(times_.size());
+    next_time_ = 1;
+    for (SampledKey* key : by_time) {
+      key->last_access = next_time_++;
+      times_.Add(key->last_access, static_cast<int64_t>(key->charge));
+    }
+  }
+
+  // Halves the sampling rate, dropping the keys no longer sampled. Requires
+  // mutex_ held.
+  void LowerSamplingRate() {
+    uint64_t threshold = threshold_.load(std::memory_order_relaxed);
+    if (threshold <= 1) {
+      return;
+    }
+    threshold_.store(threshold / 2, std::memory_order_relaxed);
+    for (auto it = keys_.begin(); it != keys_.end();) {
+      if (!IsSampled(it->first)) {
+        times_.Add(it->second.last_access,
+                   -static_cast<int64_t>(it->second.charge));
+        it = keys_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  const size_t max_sampled_keys_;
+  std::atomic<uint64_t> threshold_;
+
+  mutable port::Mutex mutex_;
+  std::unordered_map<uint64_t, SampledKey> keys_;
+  FenwickTree times_;
+  uint64_t next_time_ = 1;
+  // Lookups weighted by the inverse of the sampling rate at the time, by
+  // reuse distance
+  std::array<double, kNumBuckets> distance_weights_{};
+  double cold_weight_ = 0;
+  double total_weight_ = 0;
+  uint64_t num_sampled_lookups_ = 0;
+};
+
+}  // namespace
+
+std::shared_ptr<MissRatioCurveCache> NewMissRatioCurveCache(
+    std::shared_ptr<Cache> cache, const MissRatioCurveCacheOptions& opts) {
+  return std::make_shared<MissRatioCurveCacheImpl>(std::move(cache), opts);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
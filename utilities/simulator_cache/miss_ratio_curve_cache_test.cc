@@ -0,0 +1,156 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/miss_ratio_curve_cache.h"
+
+#include "db/db_test_util.h"
+#include "port/stack_trace.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class MissRatioCurveCacheTest : public DBTestBase {
+ public:
+  MissRatioCurveCacheTest()
+      : DBTestBase("miss_ratio_curve_cache_test", /*env_do_fsync=*/true) {}
+
+ protected:
+  static std::string Key(int i) {
+    char buf[17];
+    snprintf(buf, sizeof(buf), "key%013d", i);
+    return buf;
+  }
+
+  // Looks up the key and inserts it on a miss, like the block cache users
+  static void Access(Cache* cache, int i, size_t charge,
+                     Statistics* stats = nullptr) {
+    std::string key = Key(i);
+    Cache::Handle* handle = cache->Lookup(key, &kNoopCacheItemHelper,
+                                          /*create_context=*/nullptr,
+                                          Cache::Priority::LOW, stats);
+    if (handle == nullptr) {
+      ASSERT_OK(cache->Insert(key, /*obj=*/nullptr, &kNoopCacheItemHelper,
+                              charge, &handle));
+    }
+    cache->Release(handle);
+  }
+};
+
+TEST_F(MissRatioCurveCacheTest, CyclicAccesses) {
+  MissRatioCurveCacheOptions opts;
+  opts.sampling_rate = 1.0;
+  auto cache = NewMissRatioCurveCache(NewLRUCache(1 << 20, 0), opts);
+  auto stats = CreateDBStatistics();
+
+  // Each lookup after the first round has a reuse distance of all the keys
+  constexpr int kNumKeys = 100;
+  constexpr size_t kCharge = 100;
+  constexpr int kRounds = 10;
+  for (int round = 0; round < kRounds; ++round) {
+    for (int i = 0; i < kNumKeys; ++i) {
+      Access(cache.get(), i, kCharge, stats.get());
+    }
+  }
+  ASSERT_EQ(cache->GetNumSampledLookups(), kNumKeys * kRounds);
+  HistogramData reuse_distance;
+  stats->histogramData(BLOCK_CACHE_SAMPLED_REUSE_DISTANCE, &reuse_distance);
+  ASSERT_EQ(reuse_distance.count, kNumKeys * (kRounds - 1));
+  ASSERT_EQ(reuse_distance.min, kNumKeys * kCharge);
+  ASSERT_EQ(reuse_distance.max, kNumKeys * kCharge);
+
+  std::vector<double> miss_ratios;
+  cache->GetMissRatioCurve({kNumKeys * kCharge / 2, kNumKeys * kCharge * 2},
+                           &miss_ratios);
+  ASSERT_EQ(miss_ratios.size(), 2);
+  // Everything misses in a cache too small for the cycle, and only first
+  // lookups miss in a large enough one
+  ASSERT_DOUBLE_EQ(miss_ratios[0], 1.0);
+  ASSERT_DOUBLE_EQ(miss_ratios[1], 1.0 / kRounds);
+
+  cache->ResetMissRatioCurve();
+  ASSERT_EQ(cache->GetNumSampledLookups(), 0);
+  cache->GetMissRatioCurve({kNumKeys * kCharge}, &miss_ratios);
+  ASSERT_EQ(miss_ratios[0], 0.0);
+}
+
+TEST_F(MissRatioCurveCacheTest, SampledKeysAreBounded) {
+  MissRatioCurveCacheOptions opts;
+  opts.sampling_rate = 1.0;
+  opts.max_sampled_keys = 500;
+  auto cache = NewMissRatioCurveCache(NewLRUCache(1 << 20, 0), opts);
+
+  // A hot set of 100 keys, each looked up 20 times as often as each of 2000
+  // cold keys. The sampling rate is lowered to about 1/8.
+  constexpr size_t kCharge = 10;
+  constexpr int kLookups = 100000;
+  Random rnd(301);
+  for (int i = 0; i < kLookups; ++i) {
+    int key = rnd.OneIn(2) ? static_cast<int>(rnd.Uniform(100))
+                           : 100 + static_cast<int>(rnd.Uniform(2000));
+    Access(cache.get(), key, kCharge);
+  }
+  ASSERT_GT(cache->GetNumSampledLookups(), 0);
+  ASSERT_LT(cache->GetNumSampledLookups(), kLookups / 4);
+
+  std::vector<double> miss_ratios;
+  cache->GetMissRatioCurve({kCharge * 10, kCharge * 500, kCharge * 100000},
+                           &miss_ratios);
+  ASSERT_GE(miss_ratios[0], miss_ratios[1]);
+  ASSERT_GE(miss_ratios[1], miss_ratios[2]);
+  // The hot keys fit, but not the cold keys
+  ASSERT_GT(miss_ratios[1], 0.25);
+  ASSERT_LT(miss_ratios[1], 0.75);
+  // With all keys cached, only the first lookups miss
+  ASSERT_LT(miss_ratios[2], 0.2);
+}
+
+TEST_F(MissRatioCurveCacheTest, DBProperty) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  BlockBasedTableOptions table_options;
+  std::string value;
+  std::map<std::string, std::string> values;
+
+  // Not available without a MissRatioCurveCache
+  table_options.block_cache = NewLRUCache(1 << 20);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  ASSERT_FALSE(
+      db_->GetProperty(DB::Properties::kBlockCacheMissRatioCurve, &value));
+
+  MissRatioCurveCacheOptions opts;
+  opts.sampling_rate = 1.0;
+  table_options.block_cache =
+      NewMissRatioCurveCache(NewLRUCache(1 << 20), opts);
+  table_options.block_size = 100;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_OK(Put(Key(i), std::string(100, 'v')));
+  }
+  ASSERT_OK(Flush());
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_EQ(Get(Key(i)), std::string(100, 'v'));
+    }
+  }
+  ASSERT_TRUE(
+      db_->GetProperty(DB::Properties::kBlockCacheMissRatioCurve, &value));
+  ASSERT_NE(value.find("capacity 1.00 MB: miss ratio"), std::string::npos);
+  ASSERT_TRUE(db_->GetMapProperty(DB::Properties::kBlockCacheMissRatioCurve,
+                                  &values));
+  ASSERT_EQ(values.size(), 8);
+  ASSERT_GT(std::stoull(values["sampled_lookups"]), 0);
+  // Half of the data block lookups are first ones
+  ASSERT_NEAR(std::stod(values["capacity." + std::to_string(1 << 20)]), 0.5,
+              0.1);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}